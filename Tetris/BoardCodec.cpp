@@ -0,0 +1,325 @@
+#include "BoardCodec.h"
+#include "BoardEvaluator.h"
+#include "HeadlessGame.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+BoardCodec::BitWriter::BitWriter(unsigned char* data)
+	: data{ data }
+{
+}
+
+void BoardCodec::BitWriter::write(unsigned int value, int bits)
+{
+	for (int bit = bits - 1; bit >= 0; bit--)
+	{
+		int byte = bitCount / 8;
+		if (bitCount % 8 == 0)
+		{
+			data[byte] = 0;
+		}
+		if ((value >> bit) & 1)
+		{
+			data[byte] |= static_cast<unsigned char>(0x80 >> (bitCount % 8));
+		}
+		bitCount++;
+	}
+}
+
+int BoardCodec::BitWriter::getByteCount() const { return (bitCount + 7) / 8; }
+
+BoardCodec::BitReader::BitReader(const unsigned char* data, int size)
+	: data{ data }, bitLimit{ size * 8 }
+{
+}
+
+unsigned int BoardCodec::BitReader::read(int bits)
+{
+	unsigned int value{ 0 };
+	for (int bit{ 0 }; bit < bits; bit++)
+	{
+		value <<= 1;
+		if (bitCount >= bitLimit)
+		{
+			overrun = true;
+			continue;
+		}
+		value |= (data[bitCount / 8] >> (7 - bitCount % 8)) & 1;
+		bitCount++;
+	}
+	return value;
+}
+
+int BoardCodec::BitReader::getByteCount() const { return (bitCount + 7) / 8; }
+
+bool BoardCodec::BitReader::hasOverrun() const { return overrun; }
+
+int BoardCodec::encode(const Gameboard& board, const Gameboard* base, unsigned char* out)
+{
+	BitWriter writer(out);
+	bool literalRows[Gameboard::MAX_Y]{};
+	writer.write(base != nullptr ? 1 : 0, 1);
+
+	if (base == nullptr)
+	{
+		unsigned int rowMask{ 0 };
+		for (int y = Gameboard::MAX_Y - 1; y >= 0; y--)
+		{
+			literalRows[y] = getOccupancy(board, y) != 0;
+			rowMask = (rowMask << 1) | (literalRows[y] ? 1 : 0);
+		}
+		writer.write(rowMask, Gameboard::MAX_Y);
+		for (int y = Gameboard::MAX_Y - 1; y >= 0; y--)
+		{
+			if (literalRows[y])
+			{
+				writer.write(getOccupancy(board, y), Gameboard::MAX_X);
+			}
+		}
+	}
+	else
+	{
+		bool changedRows[Gameboard::MAX_Y]{};
+		unsigned int rowMask{ 0 };
+		for (int y = Gameboard::MAX_Y - 1; y >= 0; y--)
+		{
+			changedRows[y] = !rowsEqual(board, y, *base, y);
+			rowMask = (rowMask << 1) | (changedRows[y] ? 1 : 0);
+		}
+		writer.write(rowMask, Gameboard::MAX_Y);
+		for (int y = Gameboard::MAX_Y - 1; y >= 0; y--)
+		{
+			if (!changedRows[y])
+			{
+				continue;
+			}
+			int distance{ 0 };
+			for (int d{ 1 }; d <= MAX_COPY_DISTANCE && y - d >= 0 && distance == 0; d++)
+			{
+				distance = rowsEqual(board, y, *base, y - d) ? d : 0;
+			}
+			if (distance > 0)
+			{
+				writer.write(1, 1);
+				writer.write(static_cast<unsigned int>(distance - 1), 2);
+			}
+			else
+			{
+				literalRows[y] = true;
+				writer.write(0, 1);
+				writer.write(getOccupancy(board, y), Gameboard::MAX_X);
+			}
+		}
+	}
+	writeColourRuns(writer, board, literalRows);
+	return writer.getByteCount();
+}
+
+int BoardCodec::decode(const unsigned char* data, int size, const Gameboard* base, Gameboard& board)
+{
+	BitReader reader(data, size);
+	bool literalRows[Gameboard::MAX_Y]{};
+	bool delta = reader.read(1) != 0;
+	if (delta && base == nullptr)
+	{
+		return -1;
+	}
+	unsigned int rowMask = reader.read(Gameboard::MAX_Y);
+
+	// bottom up: a copied row's source (above it) hasn't been overwritten yet, even in place
+	for (int y = Gameboard::MAX_Y - 1; y >= 0; y--)
+	{
+		bool flagged = ((rowMask >> y) & 1) != 0;
+		if (!delta)
+		{
+			literalRows[y] = flagged;
+		}
+		else if (!flagged)
+		{
+			if (base != &board)
+			{
+				for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+				{
+					board.setContent(x, y, base->getContent(x, y));
+				}
+			}
+			continue;
+		}
+		else if (reader.read(1) != 0)
+		{
+			int source = y - 1 - static_cast<int>(reader.read(2));
+			if (source < 0)
+			{
+				return -1;
+			}
+			for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+			{
+				board.setContent(x, y, base->getContent(x, source));
+			}
+			continue;
+		}
+		else
+		{
+			literalRows[y] = true;
+		}
+
+		// a literal row: the occupied cells get their colours from the runs
+		unsigned int occupancy = literalRows[y] ? reader.read(Gameboard::MAX_X) : 0;
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			bool occupied = ((occupancy >> (Gameboard::MAX_X - 1 - x)) & 1) != 0;
+			board.setContent(x, y, occupied ? 0 : Gameboard::EMPTY_BLOCK);
+		}
+	}
+	if (!readColourRuns(reader, board, literalRows) || reader.hasOverrun())
+	{
+		return -1;
+	}
+	return reader.getByteCount();
+}
+
+bool BoardCodec::isDelta(const unsigned char* data, int size)
+{
+	return size > 0 && (data[0] & 0x80) != 0;
+}
+
+void BoardCodec::runBenchmark(int boards)
+{
+	// board states from bot games, one per placement
+	std::vector<Gameboard> states;
+	states.reserve(static_cast<size_t>(boards));
+	HeadlessGame game;
+	BoardEvaluator evaluator;
+	unsigned int seed{ 1 };
+	game.reset(seed);
+	while (static_cast<int>(states.size()) < boards)
+	{
+		Placement placement;
+		if (!evaluator.choosePlacement(game.getBoard(), game.getCurrentShape().getShape(), placement) || !game.applyPlacement(placement))
+		{
+			game.reset(++seed);
+		}
+		states.push_back(game.getBoard());
+	}
+
+	unsigned char buffer[MAX_ENCODED_BYTES];
+	Gameboard decoded;
+	typedef std::chrono::steady_clock Clock;
+	for (int pass{ 0 }; pass < 2; pass++)
+	{
+		bool deltas = pass == 1;
+		unsigned long long bytes{ 0 };
+		double encodeSeconds{ 0.0 };
+		double decodeSeconds{ 0.0 };
+		int mismatches{ 0 };
+		for (int i{ 0 }; i < boards; i++)
+		{
+			const Gameboard* base = (deltas && i > 0) ? &states[i - 1] : nullptr;
+			Clock::time_point start = Clock::now();
+			int size = encode(states[i], base, buffer);
+			Clock::time_point encoded = Clock::now();
+			int read = decode(buffer, size, base, decoded);
+			Clock::time_point end = Clock::now();
+			encodeSeconds += std::chrono::duration<double>(encoded - start).count();
+			decodeSeconds += std::chrono::duration<double>(end - encoded).count();
+			bytes += static_cast<unsigned long long>(size);
+			mismatches += (read != size || decoded.getHash() != states[i].getHash()) ? 1 : 0;
+		}
+		double average = static_cast<double>(bytes) / boards;
+		std::cout << (deltas ? "deltas: " : "full boards: ") << average << " bytes on average ("
+			<< RAW_BYTES / average << "x smaller than " << RAW_BYTES << "), encode "
+			<< (encodeSeconds > 0 ? boards / encodeSeconds : 0.0) << " boards/sec, decode "
+			<< (decodeSeconds > 0 ? boards / decodeSeconds : 0.0) << " boards/sec"
+			<< (mismatches > 0 ? ", " + std::to_string(mismatches) + " MISMATCHES" : "") << "\n";
+	}
+}
+
+bool BoardCodec::rowsEqual(const Gameboard& a, int rowA, const Gameboard& b, int rowB)
+{
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+	{
+		if (a.getContent(x, rowA) != b.getContent(x, rowB))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+unsigned int BoardCodec::getOccupancy(const Gameboard& board, int row)
+{
+	unsigned int occupancy{ 0 };
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+	{
+		occupancy = (occupancy << 1) | (board.getContent(x, row) != Gameboard::EMPTY_BLOCK ? 1 : 0);
+	}
+	return occupancy;
+}
+
+void BoardCodec::writeColourRuns(BitWriter& writer, const Gameboard& board, const bool* literalRows)
+{
+	int runColour{ -1 };
+	int runLength{ 0 };
+	for (int y = Gameboard::MAX_Y - 1; y >= 0; y--)
+	{
+		if (!literalRows[y])
+		{
+			continue;
+		}
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			int content = board.getContent(x, y);
+			if (content == Gameboard::EMPTY_BLOCK)
+			{
+				continue;
+			}
+			int colour = content & MAX_COLOUR;
+			if (colour != runColour || runLength == MAX_RUN)
+			{
+				if (runLength > 0)
+				{
+					writer.write(static_cast<unsigned int>(runColour), 3);
+					writer.write(static_cast<unsigned int>(runLength - 1), 5);
+				}
+				runColour = colour;
+				runLength = 0;
+			}
+			runLength++;
+		}
+	}
+	if (runLength > 0)
+	{
+		writer.write(static_cast<unsigned int>(runColour), 3);
+		writer.write(static_cast<unsigned int>(runLength - 1), 5);
+	}
+}
+
+bool BoardCodec::readColourRuns(BitReader& reader, Gameboard& board, const bool* literalRows)
+{
+	int runColour{ 0 };
+	int runLeft{ 0 };
+	for (int y = Gameboard::MAX_Y - 1; y >= 0; y--)
+	{
+		if (!literalRows[y])
+		{
+			continue;
+		}
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			if (board.getContent(x, y) == Gameboard::EMPTY_BLOCK)
+			{
+				continue;
+			}
+			if (runLeft == 0)
+			{
+				runColour = static_cast<int>(reader.read(3));
+				runLeft = static_cast<int>(reader.read(5)) + 1;
+			}
+			board.setContent(x, y, runColour);
+			runLeft--;
+		}
+	}
+	// a run that goes past the last cell means the data is corrupt
+	return runLeft == 0;
+}
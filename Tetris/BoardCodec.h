@@ -0,0 +1,125 @@
+// The BoardCodec packs a Gameboard into a few dozen bytes for the network, instead of the
+// 190 ints (760 bytes) of the grid.  Everything is written MSB first into a bit stream:
+//
+//  FULL:	[0: 1 bit]
+//			[non-empty rows: 19 bits]
+//			for each non-empty row: [occupancy: 10 bits]
+//			[colour runs]
+//  DELTA:	[1: 1 bit]							relative to a base board the receiver already has
+//			[changed rows: 19 bits]				rows that differ from the same row of the base
+//			for each changed row: [0][occupancy: 10 bits]		a literal row
+//							   or [1][distance - 1: 2 bits]		a copy of the base row 1-4 rows above
+//			[colour runs]
+//
+// Rows are visited bottom up.  Colour runs cover the occupied cells of the FULL or literal rows
+// in that order: [colour: 3 bits][run length - 1: 5 bits], so a row of one colour costs a byte.
+// Copied rows are what makes line clears cheap: every row above a clear moves down, and each
+// of them is sent as 3 bits.  Because of the bottom up order, a delta can be decoded in place
+// (ie. into the base board itself).
+//
+// Colours must be 0-7 (the TetColors, see MAX_COLOUR).  Nothing is allocated: encode() writes
+// into the caller's buffer of at least MAX_ENCODED_BYTES.
+
+#ifndef BOARDCODEC_H
+#define BOARDCODEC_H
+
+#include "Gameboard.h"
+
+class BoardCodec
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int MAX_ENCODED_BYTES = 256;		// the most any board or delta can take
+	static const int RAW_BYTES = Gameboard::MAX_X * Gameboard::MAX_Y * static_cast<int>(sizeof(int));	// the grid as ints
+	static const int MAX_COLOUR = 7;				// colours are 3 bits
+	static const int MAX_RUN = 32;					// run lengths are 5 bits
+	static const int MAX_COPY_DISTANCE = 4;			// copies are from 1-4 rows above (the most one shape clears)
+
+private:
+	/// <summary>
+	/// Writes bits MSB first into a byte buffer.
+	/// </summary>
+	class BitWriter
+	{
+	private:
+		unsigned char* data;
+		int bitCount{ 0 };
+	public:
+		explicit BitWriter(unsigned char* data);
+		void write(unsigned int value, int bits);
+		int getByteCount() const;
+	};
+
+	/// <summary>
+	/// Reads bits MSB first; reading past the end returns 0s and sets the overrun flag.
+	/// </summary>
+	class BitReader
+	{
+	private:
+		const unsigned char* data;
+		int bitLimit;
+		int bitCount{ 0 };
+		bool overrun{ false };
+	public:
+		BitReader(const unsigned char* data, int size);
+		unsigned int read(int bits);
+		int getByteCount() const;
+		bool hasOverrun() const;
+	};
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Encodes a board, as a FULL board or as a DELTA from a base board.
+	/// </summary>
+	/// <param name="board">the board to send</param>
+	/// <param name="base">the board the receiver has (nullptr for a FULL board)</param>
+	/// <param name="out">at least MAX_ENCODED_BYTES</param>
+	/// <returns>the # of bytes written</returns>
+	static int encode(const Gameboard& board, const Gameboard* base, unsigned char* out);
+
+	/// <summary>
+	/// Decodes a FULL board or a DELTA.
+	/// </summary>
+	/// <param name="base">the board a DELTA was made from (may be the same object as board)</param>
+	/// <param name="board">receives the board</param>
+	/// <returns>the # of bytes read, or -1 if the data is invalid (or a DELTA has no base)</returns>
+	static int decode(const unsigned char* data, int size, const Gameboard* base, Gameboard& board);
+
+	/// <summary>
+	/// Gets whether encoded data is a DELTA (rather than a FULL board).
+	/// </summary>
+	static bool isDelta(const unsigned char* data, int size);
+
+	/// <summary>
+	/// Encodes and decodes boards from bot games, and reports the sizes and boards/sec.
+	/// </summary>
+	/// <param name="boards">the # of board states to use</param>
+	static void runBenchmark(int boards);
+
+private:
+	/// <summary>
+	/// Gets whether row rowA of board a is the same as row rowB of board b.
+	/// </summary>
+	static bool rowsEqual(const Gameboard& a, int rowA, const Gameboard& b, int rowB);
+
+	/// <summary>
+	/// Gets the 10 bit occupancy of a row (bit 9 is x = 0).
+	/// </summary>
+	static unsigned int getOccupancy(const Gameboard& board, int row);
+
+	/// <summary>
+	/// Writes the colour runs of the flagged rows' occupied cells, bottom up.
+	/// </summary>
+	static void writeColourRuns(BitWriter& writer, const Gameboard& board, const bool* literalRows);
+
+	/// <summary>
+	/// Reads the colour runs into the flagged rows' occupied cells, bottom up.
+	/// </summary>
+	/// <returns>false if the runs don't match the cells</returns>
+	static bool readColourRuns(BitReader& reader, Gameboard& board, const bool* literalRows);
+};
+
+#endif /* BOARDCODEC_H */
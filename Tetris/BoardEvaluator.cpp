@@ -0,0 +1,99 @@
+#include "BoardEvaluator.h"
+#include <cstdlib>
+
+EvalWeights EvalWeights::getDefaults()
+{
+	EvalWeights defaults;
+	defaults[EvalFeature::AGGREGATE_HEIGHT] = -0.510066;
+	defaults[EvalFeature::COMPLETED_LINES] = 0.760666;
+	defaults[EvalFeature::HOLES] = -0.35663;
+	defaults[EvalFeature::BUMPINESS] = -0.184483;
+	return defaults;
+}
+
+BoardEvaluator::BoardEvaluator() : BoardEvaluator(EvalWeights::getDefaults()) {}
+
+BoardEvaluator::BoardEvaluator(const EvalWeights& weights) : weights{ weights }
+{
+	placements.reserve(64);
+}
+
+void BoardEvaluator::setWeights(const EvalWeights& weights) { this->weights = weights; }
+
+const EvalWeights& BoardEvaluator::getWeights() const { return weights; }
+
+void BoardEvaluator::getFeatures(const Gameboard& board, int completedLines, double features[EvalWeights::COUNT])
+{
+	int aggregateHeight{ 0 };
+	int holes{ 0 };
+	int bumpiness{ 0 };
+	int previousHeight{ -1 };
+
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+	{
+		// the column height is measured from the bottom of the board to its highest block
+		int height{ 0 };
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+		{
+			if (board.getContent(x, y) != Gameboard::EMPTY_BLOCK)
+			{
+				if (height == 0)
+				{
+					height = Gameboard::MAX_Y - y;
+				}
+			}
+			else if (height != 0)
+			{
+				holes++;
+			}
+		}
+		aggregateHeight += height;
+		if (previousHeight >= 0)
+		{
+			bumpiness += std::abs(height - previousHeight);
+		}
+		previousHeight = height;
+	}
+
+	features[static_cast<int>(EvalFeature::AGGREGATE_HEIGHT)] = aggregateHeight;
+	features[static_cast<int>(EvalFeature::COMPLETED_LINES)] = completedLines;
+	features[static_cast<int>(EvalFeature::HOLES)] = holes;
+	features[static_cast<int>(EvalFeature::BUMPINESS)] = bumpiness;
+}
+
+double BoardEvaluator::evaluate(const Gameboard& board, int completedLines) const
+{
+	double features[EvalWeights::COUNT];
+	getFeatures(board, completedLines, features);
+
+	double score{ 0.0 };
+	for (int i{ 0 }; i < EvalWeights::COUNT; i++)
+	{
+		score += weights.values[i] * features[i];
+	}
+	return score;
+}
+
+bool BoardEvaluator::choosePlacement(const Gameboard& board, TetShape shape, Placement& best)
+{
+	generator.generate(board, shape, placements);
+	if (placements.empty())
+	{
+		return false;
+	}
+
+	double bestScore{ 0.0 };
+	for (size_t i{ 0 }; i < placements.size(); i++)
+	{
+		scratchBoard = board;
+		generator.lockPlacement(scratchBoard, shape, placements[i]);
+		int completedLines = scratchBoard.removeCompletedRows();
+		double score = evaluate(scratchBoard, completedLines);
+		if (i == 0 || score > bestScore)
+		{
+			bestScore = score;
+			best = placements[i];
+		}
+	}
+	return true;
+}
@@ -0,0 +1,89 @@
+// The BoardEvaluator scores gameboards with a weighted sum of simple features,
+// and uses that score to pick the best placement for a shape (a 1-ply greedy bot).
+//
+// Features (per board, after the shape has been locked and completed rows removed):
+//  - aggregate height: the sum of the column heights
+//  - completed lines: the # of rows the placement completed
+//  - holes: empty blocks with a filled block somewhere above them
+//  - bumpiness: the sum of the height differences between neighbouring columns
+//
+// The weights are kept separate (EvalWeights) so they can be tuned (see WeightTuner).
+
+#ifndef BOARDEVALUATOR_H
+#define BOARDEVALUATOR_H
+
+#include "Gameboard.h"
+#include "PlacementGenerator.h"
+#include <vector>
+
+enum class EvalFeature { AGGREGATE_HEIGHT, COMPLETED_LINES, HOLES, BUMPINESS, COUNT };
+
+/// <summary>
+/// One weight per EvalFeature.
+/// </summary>
+struct EvalWeights
+{
+	static const int COUNT = static_cast<int>(EvalFeature::COUNT);
+	double values[COUNT]{};
+
+	/// <summary>
+	/// Hand tuned weights that clear lines reasonably well.
+	/// </summary>
+	/// <returns>the default weights</returns>
+	static EvalWeights getDefaults();
+
+	double& operator[](EvalFeature feature) { return values[static_cast<int>(feature)]; }
+	double operator[](EvalFeature feature) const { return values[static_cast<int>(feature)]; }
+};
+
+class BoardEvaluator
+{
+	friend class TestSuite;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	EvalWeights weights;					// the weight of each feature
+	PlacementGenerator generator;			// finds and locks the candidate placements
+	std::vector<Placement> placements;		// scratch: candidate placements (capacity is reused)
+	Gameboard scratchBoard;					// scratch: the board with a candidate placement locked in
+
+public:
+	// METHODS -------------------------------------------------
+	BoardEvaluator();
+
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="weights">the weights used to score boards</param>
+	explicit BoardEvaluator(const EvalWeights& weights);
+
+	void setWeights(const EvalWeights& weights);
+	const EvalWeights& getWeights() const;
+
+	/// <summary>
+	/// Calculates the value of each EvalFeature for a board.
+	/// </summary>
+	/// <param name="board">the board to measure</param>
+	/// <param name="completedLines">the # of rows completed to reach this board</param>
+	/// <param name="features">filled with one value per EvalFeature</param>
+	static void getFeatures(const Gameboard& board, int completedLines, double features[EvalWeights::COUNT]);
+
+	/// <summary>
+	/// Scores a board (higher is better).
+	/// </summary>
+	/// <param name="board">the board to score</param>
+	/// <param name="completedLines">the # of rows completed to reach this board</param>
+	/// <returns>the weighted sum of the board's features</returns>
+	double evaluate(const Gameboard& board, int completedLines) const;
+
+	/// <summary>
+	/// Tries every placement of a shape on the board, and returns the one that scores highest.
+	/// </summary>
+	/// <param name="board">the board to place the shape on</param>
+	/// <param name="shape">the shape to place</param>
+	/// <param name="best">set to the best placement found</param>
+	/// <returns>false if the shape has no placements (ie. it can't spawn), true otherwise</returns>
+	bool choosePlacement(const Gameboard& board, TetShape shape, Placement& best);
+};
+
+#endif /* BOARDEVALUATOR_H */
@@ -0,0 +1,84 @@
+#include "BoardMesh.h"
+
+BoardMesh::BoardMesh(const sf::Texture* tiles, int blockWidth, int blockHeight)
+	: tiles{ tiles }, blockWidth{ blockWidth }, blockHeight{ blockHeight }
+{
+	const int cellCount{ Gameboard::MAX_X * Gameboard::MAX_Y };
+	vertexArray.resize(cellCount * 4);
+	useVertexBuffer = sf::VertexBuffer::isAvailable() && vertexBuffer.create(cellCount * 4);
+}
+
+void BoardMesh::update(Gameboard& board)
+{
+	int firstCell, lastCell;
+	if (!board.getDirtyCells(firstCell, lastCell))
+	{
+		return;
+	}
+	buildCells(board, firstCell, lastCell);
+	board.clearDirtyCells();
+}
+
+void BoardMesh::rebuild(Gameboard& board)
+{
+	buildCells(board, 0, Gameboard::MAX_X * Gameboard::MAX_Y - 1);
+	board.clearDirtyCells();
+}
+
+bool BoardMesh::isUsingVertexBuffer() const { return useVertexBuffer; }
+
+unsigned int BoardMesh::getUploadedCellCount() const { return uploadedCellCount; }
+
+void BoardMesh::buildCells(const Gameboard& board, int firstCell, int lastCell)
+{
+	for (int cell{ firstCell }; cell <= lastCell; cell++)
+	{
+		buildCell(board, cell);
+	}
+	if (useVertexBuffer)
+	{
+		// only this range is sent to the GPU
+		vertexBuffer.update(&vertexArray[firstCell * 4], (lastCell - firstCell + 1) * 4, firstCell * 4);
+	}
+	uploadedCellCount += lastCell - firstCell + 1;
+}
+
+void BoardMesh::buildCell(const Gameboard& board, int cell)
+{
+	int x{ cell % Gameboard::MAX_X };
+	int y{ cell / Gameboard::MAX_X };
+	int content{ board.getContent(x, y) };
+	float left = static_cast<float>(x * blockWidth);
+	float top = static_cast<float>(y * blockHeight);
+	sf::Vertex* quad = &vertexArray[cell * 4];
+
+	if (content == Gameboard::EMPTY_BLOCK)
+	{
+		for (int corner{ 0 }; corner < 4; corner++)
+		{
+			quad[corner] = sf::Vertex(sf::Vector2f(left, top), sf::Color::Transparent);
+		}
+		return;
+	}
+
+	float width = static_cast<float>(blockWidth);
+	float height = static_cast<float>(blockHeight);
+	float tileLeft = static_cast<float>(content * blockWidth);
+	quad[0] = sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(tileLeft, 0.f));
+	quad[1] = sf::Vertex(sf::Vector2f(left + width, top), sf::Vector2f(tileLeft + width, 0.f));
+	quad[2] = sf::Vertex(sf::Vector2f(left + width, top + height), sf::Vector2f(tileLeft + width, height));
+	quad[3] = sf::Vertex(sf::Vector2f(left, top + height), sf::Vector2f(tileLeft, height));
+}
+
+void BoardMesh::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	states.transform *= getTransform();
+	states.texture = tiles;
+	if (useVertexBuffer)
+	{
+		target.draw(vertexBuffer, states);
+	}
+	else {
+		target.draw(vertexArray, states);
+	}
+}
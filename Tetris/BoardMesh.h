@@ -0,0 +1,82 @@
+// The BoardMesh keeps the geometry of a gameboard's locked blocks on the GPU:
+// one quad per cell, in a single sf::VertexBuffer that is created once.
+// Each frame only the cells the Gameboard reports as dirty are re-uploaded
+// (VertexBuffer::update() with an offset), so a board that hasn't changed costs
+// one draw call and no uploads - this is what lets many boards be drawn at once.
+//
+// Empty cells are degenerate quads (all 4 corners on one point), so they draw nothing.
+// If the GL driver has no vertex buffer support, the same vertices are kept in an
+// sf::VertexArray instead (updated in place the same way).
+
+#ifndef BOARDMESH_H
+#define BOARDMESH_H
+
+#include "Gameboard.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+class BoardMesh : public sf::Drawable, public sf::Transformable
+{
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	const sf::Texture* tiles;				// the block atlas (one tile per TetColor, in a row)
+	int blockWidth;							// pixel width of a block
+	int blockHeight;						// pixel height of a block
+	bool useVertexBuffer;					// false if VertexBuffer::isAvailable() was false
+	sf::VertexBuffer vertexBuffer{ sf::Quads, sf::VertexBuffer::Dynamic };
+	sf::VertexArray vertexArray{ sf::Quads };	// the fallback (and the staging area for uploads)
+	unsigned int uploadedCellCount{ 0 };	// # of cells uploaded (for measuring)
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Creates the geometry for an empty board.
+	/// </summary>
+	/// <param name="tiles">the block atlas texture</param>
+	/// <param name="blockWidth">pixel width of a block</param>
+	/// <param name="blockHeight">pixel height of a block</param>
+	BoardMesh(const sf::Texture* tiles, int blockWidth, int blockHeight);
+
+	/// <summary>
+	/// Brings the geometry up to date with the board:
+	/// the board's dirty cells are rebuilt and uploaded, then the board's dirty range is cleared.
+	/// </summary>
+	/// <param name="board">the board this mesh draws</param>
+	void update(Gameboard& board);
+
+	/// <summary>
+	/// Rebuilds and uploads every cell, then clears the board's dirty range
+	/// (ie. when switching to the mesh after the board was drawn some other way).
+	/// </summary>
+	/// <param name="board">the board this mesh draws</param>
+	void rebuild(Gameboard& board);
+
+	/// <summary>
+	/// Gets whether the geometry is in a vertex buffer (true) or the vertex array fallback (false).
+	/// </summary>
+	bool isUsingVertexBuffer() const;
+
+	/// <summary>
+	/// Gets the total # of cells uploaded by update() so far.
+	/// </summary>
+	unsigned int getUploadedCellCount() const;
+
+private:
+	/// <summary>
+	/// Writes the quads for a range of cells into the vertexArray,
+	/// and uploads them to the vertexBuffer (if it's being used).
+	/// </summary>
+	void buildCells(const Gameboard& board, int firstCell, int lastCell);
+
+	/// <summary>
+	/// Writes the quad for one cell into the vertexArray.
+	/// </summary>
+	void buildCell(const Gameboard& board, int cell);
+
+	/// <summary>
+	/// Draws the board with a single draw call (sf::Drawable).
+	/// </summary>
+	virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+};
+
+#endif /* BOARDMESH_H */
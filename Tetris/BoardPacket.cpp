@@ -0,0 +1,96 @@
+#include "BoardPacket.h"
+#include <chrono>
+#include <iostream>
+
+int BoardPacket::append(sf::Packet& packet, const Gameboard& board, const Gameboard* base)
+{
+	unsigned char buffer[BoardCodec::MAX_ENCODED_BYTES];
+	int size = BoardCodec::encode(board, base, buffer);
+	packet << static_cast<sf::Uint8>(size);
+	packet.append(buffer, static_cast<size_t>(size));
+	return size + 1;
+}
+
+bool BoardPacket::extract(sf::Packet& packet, const Gameboard* base, Gameboard& board)
+{
+	sf::Uint8 size{ 0 };
+	if (!(packet >> size) || packet.getDataSize() - packet.getReadPosition() < size)
+	{
+		return false;
+	}
+	const unsigned char* data = static_cast<const unsigned char*>(packet.getData()) + packet.getReadPosition();
+	if (BoardCodec::decode(data, size, base, board) < 0)
+	{
+		return false;
+	}
+	// sf::Packet can't skip ahead, so the encoded bytes are read through
+	sf::Uint8 skipped;
+	for (int i{ 0 }; i < size; i++)
+	{
+		packet >> skipped;
+	}
+	return true;
+}
+
+void BoardPacket::runBenchmark(int boards)
+{
+	BoardCodec::runBenchmark(boards);
+
+	// the same board, over and over: a packet of grid ints vs a packet of deltas (every other board empty)
+	typedef std::chrono::steady_clock Clock;
+	Gameboard board;
+	for (int x{ 0 }; x < Gameboard::MAX_X - 1; x++)
+	{
+		for (int y = Gameboard::MAX_Y - 4; y < Gameboard::MAX_Y; y++)
+		{
+			board.setContent(x, y, (x + y) % 7);
+		}
+	}
+	Gameboard empty;
+	Gameboard received;
+	sf::Packet packet;
+
+	Clock::time_point start = Clock::now();
+	size_t rawBytes{ 0 };
+	for (int i{ 0 }; i < boards; i++)
+	{
+		packet.clear();
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+		{
+			for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+			{
+				packet << static_cast<sf::Int32>(board.getContent(x, y));
+			}
+		}
+		rawBytes += packet.getDataSize();
+		sf::Int32 content;
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+		{
+			for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+			{
+				packet >> content;
+				received.setContent(x, y, content);
+			}
+		}
+	}
+	double rawSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	start = Clock::now();
+	size_t deltaBytes{ 0 };
+	bool valid{ true };
+	for (int i{ 0 }; i < boards; i++)
+	{
+		const Gameboard& next = (i % 2 == 0) ? board : empty;
+		const Gameboard& previous = (i % 2 == 0) ? empty : board;
+		packet.clear();
+		append(packet, next, i > 0 ? &previous : nullptr);
+		deltaBytes += packet.getDataSize();
+		valid = extract(packet, &received, received) && valid;
+	}
+	double deltaSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::cout << "sf::Packet of ints: " << rawBytes / boards << " bytes, " << (rawSeconds > 0 ? boards / rawSeconds : 0.0)
+		<< " round trips/sec\n";
+	std::cout << "sf::Packet of deltas: " << static_cast<double>(deltaBytes) / boards << " bytes, "
+		<< (deltaSeconds > 0 ? boards / deltaSeconds : 0.0) << " round trips/sec" << (valid ? "" : " (DECODE FAILED)") << "\n";
+}
@@ -0,0 +1,38 @@
+// BoardPacket puts BoardCodec encoded boards into sf::Packets: [size: Uint8][encoded bytes].
+// The board is encoded into a buffer on the stack and appended to the packet, so a packet
+// that's reused (cleared and refilled) never allocates; extract() decodes straight out of
+// the packet's data.
+
+#ifndef BOARDPACKET_H
+#define BOARDPACKET_H
+
+#include <SFML/Network.hpp>
+#include "BoardCodec.h"
+
+class BoardPacket
+{
+	friend class TestSuite;
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Appends a FULL board, or a DELTA from a base board.
+	/// </summary>
+	/// <param name="base">the board the receiver has (nullptr for a FULL board)</param>
+	/// <returns>the # of bytes appended</returns>
+	static int append(sf::Packet& packet, const Gameboard& board, const Gameboard* base);
+
+	/// <summary>
+	/// Reads a board appended by append(), at the packet's read position.
+	/// </summary>
+	/// <param name="base">the board a DELTA was made from (may be the same object as board)</param>
+	/// <returns>false if the packet doesn't hold a valid board</returns>
+	static bool extract(sf::Packet& packet, const Gameboard* base, Gameboard& board);
+
+	/// <summary>
+	/// Runs BoardCodec::runBenchmark(), then compares packets of encoded boards with packets of the grid's ints.
+	/// </summary>
+	static void runBenchmark(int boards);
+};
+
+#endif /* BOARDPACKET_H */
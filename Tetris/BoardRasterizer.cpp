@@ -0,0 +1,140 @@
+#include "BoardRasterizer.h"
+#include "BoardEvaluator.h"
+#include "HeadlessGame.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+BoardRasterizer::BoardRasterizer(const RgbaImage& tiles, int blockWidth, int blockHeight, Rgba background)
+	: tiles{ tiles }, blockWidth{ blockWidth }, blockHeight{ blockHeight }, background{ background }
+{
+}
+
+void BoardRasterizer::drawGameboard(const Gameboard& board, RgbaImage& image) const
+{
+	image.create(Gameboard::MAX_X * blockWidth, Gameboard::MAX_Y * blockHeight, background);
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			int content = board.getContent(x, y);
+			if (content != Gameboard::EMPTY_BLOCK)
+			{
+				drawBlock(image, x, y, static_cast<TetColor>(content));
+			}
+		}
+	}
+}
+
+void BoardRasterizer::drawTetromino(const GridTetromino& tetromino, RgbaImage& image, unsigned char alpha) const
+{
+	for (const Point& pt : tetromino.getBlockLocsMappedToGrid())
+	{
+		drawBlock(image, pt.getX(), pt.getY(), tetromino.getColor(), alpha);
+	}
+}
+
+void BoardRasterizer::drawBlock(RgbaImage& image, int xOffset, int yOffset, TetColor colour, unsigned char alpha) const
+{
+	int tileLeft = static_cast<int>(colour) * blockWidth;
+	if (tileLeft + blockWidth > tiles.getWidth() || blockHeight > tiles.getHeight())
+	{
+		return;
+	}
+	int left = xOffset * blockWidth;
+	int top = yOffset * blockHeight;
+	for (int y{ 0 }; y < blockHeight; y++)
+	{
+		int imageY = top + y;
+		if (imageY < 0 || imageY >= image.getHeight())
+		{
+			continue;
+		}
+		for (int x{ 0 }; x < blockWidth; x++)
+		{
+			int imageX = left + x;
+			if (imageX < 0 || imageX >= image.getWidth())
+			{
+				continue;
+			}
+			Rgba source = tiles.getPixel(tileLeft + x, y);
+			int opacity = source.a * alpha / 255;
+			if (opacity == 255)
+			{
+				image.setPixel(imageX, imageY, source);
+				continue;
+			}
+			// source over destination
+			Rgba dest = image.getPixel(imageX, imageY);
+			Rgba blended;
+			blended.r = static_cast<unsigned char>((source.r * opacity + dest.r * (255 - opacity)) / 255);
+			blended.g = static_cast<unsigned char>((source.g * opacity + dest.g * (255 - opacity)) / 255);
+			blended.b = static_cast<unsigned char>((source.b * opacity + dest.b * (255 - opacity)) / 255);
+			blended.a = static_cast<unsigned char>(opacity + dest.a * (255 - opacity) / 255);
+			image.setPixel(imageX, imageY, blended);
+		}
+	}
+}
+
+void BoardRasterizer::runBenchmark(const RgbaImage& tiles, int blockWidth, int blockHeight, int framesPerThread)
+{
+	const Rgba background{ 0, 0, 0, 255 };
+	BoardRasterizer rasterizer(tiles, blockWidth, blockHeight, background);
+	int threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	std::vector<RgbaImage> lastFrames(threadCount);
+
+	// a bot plays before the clock starts, so the boards look like real games and only drawing is timed
+	const int BOARD_COUNT{ 1024 };
+	std::vector<Gameboard> boards;
+	std::vector<GridTetromino> shapes;
+	boards.reserve(BOARD_COUNT);
+	shapes.reserve(BOARD_COUNT);
+	HeadlessGame game;
+	BoardEvaluator evaluator;
+	Placement placement;
+	game.reset(1);
+	for (int board{ 0 }; board < BOARD_COUNT; board++)
+	{
+		boards.push_back(game.getBoard());
+		shapes.push_back(game.getCurrentShape());
+		if (!evaluator.choosePlacement(game.getBoard(), game.getCurrentShape().getShape(), placement) ||
+			!game.applyPlacement(placement))
+		{
+			game.reset(static_cast<unsigned int>(board + 2));
+		}
+	}
+
+	std::cout << "rendering " << framesPerThread << " frames on each of " << threadCount << " threads\n";
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for (int t{ 0 }; t < threadCount; t++)
+	{
+		threads.emplace_back([&rasterizer, &lastFrames, &boards, &shapes, t, framesPerThread]()
+			{
+				// each thread starts at a different board
+				RgbaImage& image = lastFrames[t];
+				int board = t * BOARD_COUNT / std::max(1, static_cast<int>(lastFrames.size()));
+				for (int frame{ 0 }; frame < framesPerThread; frame++)
+				{
+					rasterizer.drawGameboard(boards[board], image);
+					rasterizer.drawTetromino(shapes[board], image);
+					board = (board + 1) % BOARD_COUNT;
+				}
+			});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double frames = static_cast<double>(framesPerThread) * threadCount;
+	std::cout << frames << " frames in " << seconds << " sec: " << (seconds > 0.0 ? frames / seconds : 0.0)
+		<< " frames/sec\n";
+
+	if (lastFrames[0].writePng("render.png") && lastFrames[0].writePpm("render.ppm"))
+	{
+		std::cout << "wrote render.png and render.ppm\n";
+	}
+}
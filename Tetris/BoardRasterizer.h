@@ -0,0 +1,80 @@
+// The BoardRasterizer draws a gameboard and tetrominoes into an RgbaImage on the CPU,
+// copying blocks out of the tiles atlas the same way TetrisGame::drawBlock() does
+// (tile n of the atlas is the block for TetColor n).  No window, GL context or display
+// is needed, so it can make replay thumbnails, bug report images and golden images
+// on headless servers.
+//
+// Rendering doesn't change the rasterizer (all methods are const), so one instance
+// can be shared by any number of threads, as long as each thread draws into its own image.
+
+#ifndef BOARDRASTERIZER_H
+#define BOARDRASTERIZER_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "RgbaImage.h"
+#include <string>
+
+class BoardRasterizer
+{
+	friend class TestSuite;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	const RgbaImage& tiles;		// the block atlas (one blockWidth x blockHeight tile per TetColor, in a row)
+	int blockWidth;				// pixel width of a block
+	int blockHeight;			// pixel height of a block
+	Rgba background;			// colour of the empty cells
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="tiles">the block atlas (must outlive the rasterizer)</param>
+	/// <param name="blockWidth">pixel width of a block</param>
+	/// <param name="blockHeight">pixel height of a block</param>
+	/// <param name="background">colour of the empty cells</param>
+	BoardRasterizer(const RgbaImage& tiles, int blockWidth, int blockHeight, Rgba background);
+
+	/// <summary>
+	/// Draws a board into an image.  The image is resized to fit the board
+	/// (MAX_X * blockWidth by MAX_Y * blockHeight) and filled with the background first.
+	/// </summary>
+	/// <param name="board">the board to draw</param>
+	/// <param name="image">the image to draw into (its memory is reused)</param>
+	void drawGameboard(const Gameboard& board, RgbaImage& image) const;
+
+	/// <summary>
+	/// Draws a tetromino's mapped blocks into an image (ie. the falling shape, or a hint).
+	/// Blocks above the board, or outside the image, are clipped.
+	/// </summary>
+	/// <param name="tetromino">the tetromino to draw</param>
+	/// <param name="image">the image to draw into</param>
+	/// <param name="alpha">the opacity of the blocks (255 is opaque)</param>
+	void drawTetromino(const GridTetromino& tetromino, RgbaImage& image, unsigned char alpha = 255) const;
+
+	/// <summary>
+	/// Draws one block into an image, blending it over the image by its atlas alpha times alpha
+	/// (integer maths, so the results are exact and the same on every machine).
+	/// </summary>
+	/// <param name="image">the image to draw into</param>
+	/// <param name="xOffset">the block's x offset (in blocks, not pixels)</param>
+	/// <param name="yOffset">the block's y offset (in blocks, not pixels)</param>
+	/// <param name="colour">the block's colour (its tile in the atlas)</param>
+	/// <param name="alpha">the opacity of the block (255 is opaque)</param>
+	void drawBlock(RgbaImage& image, int xOffset, int yOffset, TetColor colour, unsigned char alpha = 255) const;
+
+	/// <summary>
+	/// Renders bot-played games (board + falling shape, played before the timing starts) on every
+	/// hardware thread and reports frames/sec.
+	/// The last frame is written to render.png and render.ppm.
+	/// </summary>
+	/// <param name="tiles">the block atlas</param>
+	/// <param name="blockWidth">pixel width of a block</param>
+	/// <param name="blockHeight">pixel height of a block</param>
+	/// <param name="framesPerThread">the # of frames each thread renders</param>
+	static void runBenchmark(const RgbaImage& tiles, int blockWidth, int blockHeight, int framesPerThread);
+};
+
+#endif /* BOARDRASTERIZER_H */
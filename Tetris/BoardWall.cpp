@@ -0,0 +1,67 @@
+#include "BoardWall.h"
+#include <algorithm>
+
+const double BoardWall::SECONDS_PER_PIECE{ 0.25 };
+
+BoardWall::BoardWall(int boardCount)
+{
+	boardCount = std::max(static_cast<int>(MIN_BOARDS), std::min(static_cast<int>(MAX_BOARDS), boardCount));
+	games.resize(boardCount);
+	secondsUntilPiece.resize(boardCount);
+	gamesPlayed.assign(boardCount, 0);
+	for (int board{ 0 }; board < boardCount; board++)
+	{
+		restartGame(board);
+		// staggered, so the placements are spread over the frames
+		secondsUntilPiece[board] = SECONDS_PER_PIECE * board / boardCount;
+	}
+}
+
+void BoardWall::update(double seconds)
+{
+	for (int board{ 0 }; board < getBoardCount(); board++)
+	{
+		secondsUntilPiece[board] -= seconds;
+		while (secondsUntilPiece[board] <= 0.0)
+		{
+			secondsUntilPiece[board] += SECONDS_PER_PIECE;
+			HeadlessGame& game = games[board];
+			if (!evaluator.choosePlacement(game.getBoard(), game.getCurrentShape().getShape(), placement) ||
+				!game.applyPlacement(placement))
+			{
+				gamesPlayed[board]++;
+				restartGame(board);
+			}
+		}
+	}
+}
+
+int BoardWall::getBoardCount() const { return static_cast<int>(games.size()); }
+
+const HeadlessGame& BoardWall::getGame(int board) const { return games[board]; }
+
+void BoardWall::computeGrid(int boardCount, double boardWidth, double boardHeight,
+	double windowWidth, double windowHeight, int& columns, int& rows)
+{
+	columns = 1;
+	rows = std::max(1, boardCount);
+	double bestScale{ 0.0 };
+	for (int tryColumns{ 1 }; tryColumns <= std::max(1, boardCount); tryColumns++)
+	{
+		int tryRows = (boardCount + tryColumns - 1) / tryColumns;
+		double scale = std::min(windowWidth / (tryColumns * boardWidth), windowHeight / (tryRows * boardHeight));
+		// ties go to fewer columns (ie. fewer empty cells)
+		if (scale > bestScale)
+		{
+			bestScale = scale;
+			columns = tryColumns;
+			rows = tryRows;
+		}
+	}
+}
+
+void BoardWall::restartGame(int board)
+{
+	// board b's games use seeds b+1, b+1+MAX_BOARDS, ... so no two boards ever play the same game
+	games[board].reset(static_cast<unsigned int>(board + 1 + gamesPlayed[board] * MAX_BOARDS));
+}
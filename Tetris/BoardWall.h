@@ -0,0 +1,80 @@
+// The BoardWall is a "bot wall": N games (2 to 64) played side by side by the bot,
+// for showing tournaments or many bots at once in one window (see BoardWallRenderer).
+//
+// Every game is a HeadlessGame, so the wall is cheap to simulate: each game places a
+// shape every SECONDS_PER_PIECE (the games are staggered so they don't all move on the same frame),
+// and starts over with a new seed when it tops out.
+//
+// It also works out the grid the boards are laid out in, for any window shape.
+
+#ifndef BOARDWALL_H
+#define BOARDWALL_H
+
+#include "BoardEvaluator.h"
+#include "HeadlessGame.h"
+#include <vector>
+
+class BoardWall
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int MIN_BOARDS = 2;
+	static const int MAX_BOARDS = 64;
+	static const double SECONDS_PER_PIECE;		// how often each bot places a shape, init to 0.25
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	std::vector<HeadlessGame> games;
+	std::vector<double> secondsUntilPiece;		// per game: time until its next placement
+	std::vector<int> gamesPlayed;				// per game: # of games finished (also picks the next seed)
+	BoardEvaluator evaluator;					// shared by every game (they're played one at a time)
+	Placement placement;						// scratch
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor, starts every game.
+	/// </summary>
+	/// <param name="boardCount">the # of games (clamped to MIN_BOARDS..MAX_BOARDS)</param>
+	explicit BoardWall(int boardCount);
+
+	/// <summary>
+	/// Advances every game: each places a shape whenever its SECONDS_PER_PIECE is up.
+	/// </summary>
+	/// <param name="seconds">the time since the last update</param>
+	void update(double seconds);
+
+	/// <summary>
+	/// Gets the # of games on the wall.
+	/// </summary>
+	int getBoardCount() const;
+
+	/// <summary>
+	/// Gets one of the games.
+	/// </summary>
+	const HeadlessGame& getGame(int board) const;
+
+	/// <summary>
+	/// Picks the grid that shows the boards as large as possible in a window
+	/// (every board is the same size and keeps its aspect ratio).
+	/// </summary>
+	/// <param name="boardCount">the # of boards</param>
+	/// <param name="boardWidth">the width of one board (any units)</param>
+	/// <param name="boardHeight">the height of one board (same units)</param>
+	/// <param name="windowWidth">the window width (any units)</param>
+	/// <param name="windowHeight">the window height (same units)</param>
+	/// <param name="columns">set to the # of columns</param>
+	/// <param name="rows">set to the # of rows (columns * rows >= boardCount)</param>
+	static void computeGrid(int boardCount, double boardWidth, double boardHeight,
+		double windowWidth, double windowHeight, int& columns, int& rows);
+
+private:
+	/// <summary>
+	/// Starts a board's next game (with a seed no other board is using).
+	/// </summary>
+	void restartGame(int board);
+};
+
+#endif /* BOARDWALL_H */
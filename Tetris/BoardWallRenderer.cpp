@@ -0,0 +1,190 @@
+#include "BoardWallRenderer.h"
+#include <algorithm>
+#include <iostream>
+
+const int BoardWallRenderer::BOARD_MARGIN{ 16 };
+const sf::Color BoardWallRenderer::BACKGROUND_TINT{ 24, 24, 24 };
+const int BoardWallRenderer::FRAME_REPORT_INTERVAL{ 300 };
+
+BoardWallRenderer::BoardWallRenderer(const sf::Texture& tiles, int blockWidth, int blockHeight)
+	: tiles{ tiles }, blockWidth{ blockWidth }, blockHeight{ blockHeight }
+{
+	mappedLocs.reserve(4);
+}
+
+void BoardWallRenderer::layout(int boardCount, sf::Vector2u windowSize)
+{
+	sf::Vector2f cell = getCellSize();
+	BoardWall::computeGrid(boardCount, cell.x, cell.y, windowSize.x, windowSize.y, columns, rows);
+
+	// the wall view shows the whole grid, letterboxed so the blocks stay square
+	sf::Vector2f wallSize(columns * cell.x, rows * cell.y);
+	float scale = std::min(windowSize.x / wallSize.x, windowSize.y / wallSize.y);
+	sf::FloatRect viewport((1.f - wallSize.x * scale / windowSize.x) / 2, (1.f - wallSize.y * scale / windowSize.y) / 2,
+		wallSize.x * scale / windowSize.x, wallSize.y * scale / windowSize.y);
+	wallView.reset(sf::FloatRect(0.f, 0.f, wallSize.x, wallSize.y));
+	wallView.setViewport(viewport);
+
+	// each board view shows one cell, in that cell's part of the wall viewport
+	boardViews.resize(boardCount);
+	for (int board{ 0 }; board < boardCount; board++)
+	{
+		int column = board % columns;
+		int row = board / columns;
+		boardViews[board].reset(sf::FloatRect(column * cell.x, row * cell.y, cell.x, cell.y));
+		boardViews[board].setViewport(sf::FloatRect(viewport.left + viewport.width * column / columns,
+			viewport.top + viewport.height * row / rows, viewport.width / columns, viewport.height / rows));
+	}
+
+	// a background, every cell full, and the current shape: allocated once, only the used part is drawn
+	size_t quadsPerBoard = 1 + Gameboard::MAX_X * Gameboard::MAX_Y + 4;
+	vertices.resize(boardCount * quadsPerBoard * 4);
+	boardFirstVertex.assign(boardCount, 0);
+	boardVertexCount.assign(boardCount, 0);
+}
+
+void BoardWallRenderer::update(const BoardWall& wall)
+{
+	sf::Vector2f cell = getCellSize();
+	sf::FloatRect background(blockWidth / 2.f, blockHeight / 2.f, 1.f, 1.f);
+	vertexCount = 0;
+	int boardCount = std::min(wall.getBoardCount(), static_cast<int>(boardFirstVertex.size()));
+	for (int board{ 0 }; board < boardCount; board++)
+	{
+		boardFirstVertex[board] = vertexCount;
+		float left = (board % columns) * cell.x + BOARD_MARGIN;
+		float top = (board / columns) * cell.y + BOARD_MARGIN;
+		const HeadlessGame& game = wall.getGame(board);
+
+		addQuad(left, top, static_cast<float>(Gameboard::MAX_X * blockWidth), static_cast<float>(Gameboard::MAX_Y * blockHeight),
+			background, BACKGROUND_TINT);
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+		{
+			for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+			{
+				int content = game.getBoard().getContent(x, y);
+				if (content != Gameboard::EMPTY_BLOCK)
+				{
+					sf::FloatRect tile(static_cast<float>(content * blockWidth), 0.f, static_cast<float>(blockWidth), static_cast<float>(blockHeight));
+					addQuad(left + x * blockWidth, top + y * blockHeight, static_cast<float>(blockWidth), static_cast<float>(blockHeight),
+						tile, sf::Color::White);
+				}
+			}
+		}
+		const GridTetromino& shape = game.getCurrentShape();
+		sf::FloatRect tile(static_cast<float>(static_cast<int>(shape.getColor()) * blockWidth), 0.f,
+			static_cast<float>(blockWidth), static_cast<float>(blockHeight));
+		shape.getBlockLocsMappedToGrid(mappedLocs);
+		for (const Point& pt : mappedLocs)
+		{
+			// blocks above the board aren't drawn
+			if (pt.getY() >= 0)
+			{
+				addQuad(left + pt.getX() * blockWidth, top + pt.getY() * blockHeight, static_cast<float>(blockWidth), static_cast<float>(blockHeight),
+					tile, sf::Color::White);
+			}
+		}
+		boardVertexCount[board] = vertexCount - boardFirstVertex[board];
+	}
+}
+
+void BoardWallRenderer::draw(sf::RenderTarget& target, bool singlePass)
+{
+	if (vertexCount == 0)
+	{
+		return;
+	}
+	sf::View previousView = target.getView();
+	sf::RenderStates states;
+	states.texture = &tiles;
+	if (singlePass)
+	{
+		target.setView(wallView);
+		target.draw(&vertices[0], vertexCount, sf::Quads, states);
+	}
+	else
+	{
+		for (size_t board{ 0 }; board < boardViews.size(); board++)
+		{
+			target.setView(boardViews[board]);
+			target.draw(&vertices[boardFirstVertex[board]], boardVertexCount[board], sf::Quads, states);
+		}
+	}
+	target.setView(previousView);
+}
+
+void BoardWallRenderer::runInWindow(sf::RenderWindow& window, const sf::Texture& tiles, int blockWidth, int blockHeight, int boardCount)
+{
+	BoardWall wall(boardCount);
+	BoardWallRenderer renderer(tiles, blockWidth, blockHeight);
+	renderer.layout(wall.getBoardCount(), window.getSize());
+	window.setFramerateLimit(0);
+	window.setVerticalSyncEnabled(false);
+
+	bool singlePass{ true };
+	sf::Clock clock;
+	sf::Clock frameClock;
+	double frameSeconds{ 0.0 };
+	int frameCount{ 0 };
+	while (window.isOpen())
+	{
+		sf::Event event;
+		while (window.pollEvent(event))
+		{
+			if (event.type == sf::Event::Closed)
+			{
+				window.close();
+			}
+			else if (event.type == sf::Event::Resized)
+			{
+				window.setView(sf::View(sf::FloatRect(0.f, 0.f, static_cast<float>(event.size.width), static_cast<float>(event.size.height))));
+				renderer.layout(wall.getBoardCount(), window.getSize());
+			}
+			else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F1)
+			{
+				singlePass = !singlePass;
+				frameSeconds = 0.0;
+				frameCount = 0;
+			}
+		}
+		wall.update(clock.restart().asSeconds());
+
+		frameClock.restart();
+		renderer.update(wall);
+		window.clear(sf::Color::Black);
+		renderer.draw(window, singlePass);
+		// measured before display(), which may wait for vsync
+		frameSeconds += frameClock.getElapsedTime().asSeconds();
+		window.display();
+
+		if (++frameCount == FRAME_REPORT_INTERVAL)
+		{
+			std::cout << wall.getBoardCount() << " boards, " << (singlePass ? "1 draw call" : "1 draw call per board view")
+				<< ": " << (frameSeconds / frameCount) * 1000.0 << " ms/frame (update + clear + draw)\n";
+			frameSeconds = 0.0;
+			frameCount = 0;
+		}
+	}
+}
+
+sf::Vector2f BoardWallRenderer::getCellSize() const
+{
+	return sf::Vector2f(static_cast<float>(Gameboard::MAX_X * blockWidth + 2 * BOARD_MARGIN),
+		static_cast<float>(Gameboard::MAX_Y * blockHeight + 2 * BOARD_MARGIN));
+}
+
+void BoardWallRenderer::addQuad(float left, float top, float width, float height, const sf::FloatRect& textureRect, sf::Color tint)
+{
+	if (vertexCount + 4 > vertices.getVertexCount())
+	{
+		return;
+	}
+	float textureRight = textureRect.left + textureRect.width;
+	float textureBottom = textureRect.top + textureRect.height;
+	sf::Vertex* quad = &vertices[vertexCount];
+	quad[0] = sf::Vertex(sf::Vector2f(left, top), tint, sf::Vector2f(textureRect.left, textureRect.top));
+	quad[1] = sf::Vertex(sf::Vector2f(left + width, top), tint, sf::Vector2f(textureRight, textureRect.top));
+	quad[2] = sf::Vertex(sf::Vector2f(left + width, top + height), tint, sf::Vector2f(textureRight, textureBottom));
+	quad[3] = sf::Vertex(sf::Vector2f(left, top + height), tint, sf::Vector2f(textureRect.left, textureBottom));
+	vertexCount += 4;
+}
@@ -0,0 +1,106 @@
+// The BoardWallRenderer draws every board of a BoardWall in one pass:
+//
+//  - the boards are laid out in a grid (BoardWall::computeGrid()) in "wall" space, at full block size.
+//  - every block of every board goes into one vertex array, textured from the shared block atlas,
+//    so the whole wall is a single draw call whatever the # of boards.
+//  - one sf::View maps the wall onto the window, scaled to fit (and letterboxed), so resizing
+//    the window rescales every board at once.
+//
+// For comparison, the boards can also be drawn one at a time, each through its own sf::View
+// (its viewport is its cell of the grid) - N draw calls instead of 1.
+//
+// A board's background is a quad tinted almost black, sampled from a single pixel in the middle
+// of a tile (so it comes from the same texture as the blocks).
+
+#ifndef BOARDWALLRENDERER_H
+#define BOARDWALLRENDERER_H
+
+#include "BoardWall.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+class BoardWallRenderer
+{
+public:
+	// CONSTANTS
+	static const int BOARD_MARGIN;				// pixels around each board (wall space), init to 16
+	static const sf::Color BACKGROUND_TINT;		// the tint of a board's background, init to (24, 24, 24)
+	static const int FRAME_REPORT_INTERVAL;		// frames between the timing reports in runInWindow(), init to 300
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	const sf::Texture& tiles;					// the block atlas (tiles in a row at the top left)
+	int blockWidth;
+	int blockHeight;
+	int columns{ 1 };
+	int rows{ 1 };
+	sf::VertexArray vertices{ sf::Quads };		// every board's quads, allocated by layout()
+	size_t vertexCount{ 0 };					// # of vertices used this frame
+	std::vector<size_t> boardFirstVertex;		// where each board's quads start
+	std::vector<size_t> boardVertexCount;		// # of vertices in each board's quads
+	sf::View wallView;							// the whole wall, fitted to the window
+	std::vector<sf::View> boardViews;			// one per board, for drawing them one at a time
+	std::vector<Point> mappedLocs;				// scratch: the current shape's blocks
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="tiles">the block atlas texture (must outlive the renderer)</param>
+	/// <param name="blockWidth">pixel width of a block</param>
+	/// <param name="blockHeight">pixel height of a block</param>
+	BoardWallRenderer(const sf::Texture& tiles, int blockWidth, int blockHeight);
+
+	/// <summary>
+	/// Lays the boards out for a window size: picks the grid, sets up the views,
+	/// and allocates the vertices (called again when the window is resized).
+	/// </summary>
+	/// <param name="boardCount">the # of boards</param>
+	/// <param name="windowSize">the window size in pixels</param>
+	void layout(int boardCount, sf::Vector2u windowSize);
+
+	/// <summary>
+	/// Rebuilds the quads of every board (the locked blocks and the current shape).
+	/// </summary>
+	/// <param name="wall">the wall (with the same # of boards as layout())</param>
+	void update(const BoardWall& wall);
+
+	/// <summary>
+	/// Draws the wall, either in one draw call through the wall view, or one draw call per board view.
+	/// The target's view is restored afterwards.
+	/// </summary>
+	/// <param name="target">the window</param>
+	/// <param name="singlePass">true to draw every board with one draw call</param>
+	void draw(sf::RenderTarget& target, bool singlePass);
+
+	/// <summary>
+	/// Opens a window showing a wall of bots.  F1 switches between one draw call and one per board;
+	/// the time spent drawing a frame is printed every FRAME_REPORT_INTERVAL frames.
+	/// </summary>
+	/// <param name="window">the window to draw in</param>
+	/// <param name="tiles">the block atlas texture</param>
+	/// <param name="blockWidth">pixel width of a block</param>
+	/// <param name="blockHeight">pixel height of a block</param>
+	/// <param name="boardCount">the # of boards (2 to 64)</param>
+	static void runInWindow(sf::RenderWindow& window, const sf::Texture& tiles, int blockWidth, int blockHeight, int boardCount);
+
+private:
+	/// <summary>
+	/// Gets the size of one board's cell in wall space (the board plus its margin).
+	/// </summary>
+	sf::Vector2f getCellSize() const;
+
+	/// <summary>
+	/// Adds a quad to the vertices.
+	/// </summary>
+	/// <param name="left">wall space x</param>
+	/// <param name="top">wall space y</param>
+	/// <param name="width">wall space width</param>
+	/// <param name="height">wall space height</param>
+	/// <param name="textureRect">the part of the atlas</param>
+	/// <param name="tint">the vertex colour</param>
+	void addQuad(float left, float top, float width, float height, const sf::FloatRect& textureRect, sf::Color tint);
+};
+
+#endif /* BOARDWALLRENDERER_H */
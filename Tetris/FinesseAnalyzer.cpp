@@ -0,0 +1,230 @@
+#include "FinesseAnalyzer.h"
+#include <algorithm>
+
+FinesseAnalyzer::FinesseAnalyzer()
+{
+	cache.resize(CACHE_SLOTS);
+	distance.resize(STATE_COUNT);
+	parent.resize(STATE_COUNT);
+	parentInput.resize(STATE_COUNT);
+	queue.reserve(STATE_COUNT);
+	mappedLocs.reserve(4);
+}
+
+bool FinesseAnalyzer::findInputs(const Gameboard& board, TetShape shape, const Placement& placement, std::vector<FinesseInput>& inputs)
+{
+	PlacementGenerator::placeShape(scratchShape, shape, placement);
+	scratchShape.getBlockLocsMappedToGrid(mappedLocs);
+	unsigned int key = PlacementGenerator::getPlacementKey(mappedLocs);
+
+	for (const FinesseEntry& entry : analyze(board, shape))
+	{
+		if (entry.placementKey == key)
+		{
+			inputs = entry.inputs;
+			return true;
+		}
+	}
+	inputs.clear();
+	return false;
+}
+
+int FinesseAnalyzer::getMinimalInputCount(const Gameboard& board, TetShape shape, const Placement& placement)
+{
+	PlacementGenerator::placeShape(scratchShape, shape, placement);
+	scratchShape.getBlockLocsMappedToGrid(mappedLocs);
+	unsigned int key = PlacementGenerator::getPlacementKey(mappedLocs);
+
+	for (const FinesseEntry& entry : analyze(board, shape))
+	{
+		if (entry.placementKey == key)
+		{
+			return static_cast<int>(entry.inputs.size());
+		}
+	}
+	return -1;
+}
+
+unsigned long long FinesseAnalyzer::getSurfaceKey(const Gameboard& board, TetShape shape)
+{
+	// 5 bits per column height (0-19), then 3 bits for the shape
+	unsigned long long key{ 0 };
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+	{
+		int height{ 0 };
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+		{
+			if (board.getContent(x, y) != Gameboard::EMPTY_BLOCK)
+			{
+				height = Gameboard::MAX_Y - y;
+				break;
+			}
+		}
+		key = (key << 5) | static_cast<unsigned long long>(height);
+	}
+	return (key << 3) | static_cast<unsigned long long>(shape);
+}
+
+size_t FinesseAnalyzer::getCacheSize() const { return cacheSize; }
+
+void FinesseAnalyzer::clearCache()
+{
+	for (CacheSlot& slot : cache)
+	{
+		slot.used = false;
+		slot.entries.clear();
+	}
+	cacheSize = 0;
+}
+
+const std::vector<FinesseAnalyzer::FinesseEntry>& FinesseAnalyzer::analyze(const Gameboard& board, TetShape shape)
+{
+	unsigned long long key = getSurfaceKey(board, shape);
+	CacheSlot& slot = cache[getCacheSlot(key)];
+	if (slot.used && slot.key == key)
+	{
+		return slot.entries;
+	}
+	cacheSize += slot.used ? 0 : 1;
+	slot.key = key;
+	slot.used = true;
+	slot.entries.clear();
+	search(board, shape, slot.entries);
+	return slot.entries;
+}
+
+void FinesseAnalyzer::search(const Gameboard& board, TetShape shape, std::vector<FinesseEntry>& entries)
+{
+	// reduce the board to its surface: everything below the top block of a column is filled
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+	{
+		bool belowSurface{ false };
+		for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+		{
+			belowSurface = belowSurface || board.getContent(x, y) != Gameboard::EMPTY_BLOCK;
+			filled[y][x] = belowSurface;
+		}
+	}
+
+	// the block offsets of each rotation (rotations of the 'O' are all the same)
+	scratchShape.setShape(shape);
+	for (int rotation{ 0 }; rotation < 4; rotation++)
+	{
+		std::vector<Point> blockLocs = scratchShape.getBlockLocs();
+		for (int block{ 0 }; block < 4; block++)
+		{
+			blockOffsets[rotation][block][0] = blockLocs[block].getX();
+			blockOffsets[rotation][block][1] = blockLocs[block].getY();
+		}
+		scratchShape.rotateClockwise();
+	}
+
+	Point spawn = board.getSpawnLoc();
+	if (!isLegal(0, spawn.getX(), spawn.getY()))
+	{
+		return;
+	}
+
+	std::fill(distance.begin(), distance.end(), -1);
+	queue.clear();
+	int start = getStateIndex(0, spawn.getX(), spawn.getY());
+	distance[start] = 0;
+	parent[start] = -1;
+	queue.push_back(start);
+
+	for (size_t head{ 0 }; head < queue.size(); head++)
+	{
+		int state = queue[head];
+		int rotation = state / (STATE_WIDTH * STATE_HEIGHT);
+		int x = (state / STATE_HEIGHT) % STATE_WIDTH - MARGIN;
+		int y = state % STATE_HEIGHT - MARGIN;
+
+		// hard drop from here: states come off the queue in order of distance,
+		// so the first path found to a placement is a shortest one
+		int dropY{ y };
+		while (isLegal(rotation, x, dropY + 1))
+		{
+			dropY++;
+		}
+		mappedLocs.clear();
+		for (int block{ 0 }; block < 4; block++)
+		{
+			mappedLocs.push_back(Point(x + blockOffsets[rotation][block][0], dropY + blockOffsets[rotation][block][1]));
+		}
+		unsigned int placementKey = PlacementGenerator::getPlacementKey(mappedLocs);
+		bool known = std::any_of(entries.begin(), entries.end(),
+			[placementKey](const FinesseEntry& entry) { return entry.placementKey == placementKey; });
+		if (!known)
+		{
+			FinesseEntry entry;
+			entry.placementKey = placementKey;
+			entry.inputs.push_back(FinesseInput::HARD_DROP);
+			for (int step = state; parent[step] >= 0; step = parent[step])
+			{
+				entry.inputs.push_back(parentInput[step]);
+			}
+			std::reverse(entry.inputs.begin(), entry.inputs.end());
+			entries.push_back(entry);
+		}
+
+		// every other input leads to another state
+		for (int input{ 0 }; input < static_cast<int>(FinesseInput::HARD_DROP); input++)
+		{
+			int nextRotation{ rotation };
+			int nextX{ x };
+			int nextY{ y };
+			switch (static_cast<FinesseInput>(input))
+			{
+				case FinesseInput::LEFT: nextX--; break;
+				case FinesseInput::RIGHT: nextX++; break;
+				case FinesseInput::DAS_LEFT: while (isLegal(rotation, nextX - 1, y)) { nextX--; } break;
+				case FinesseInput::DAS_RIGHT: while (isLegal(rotation, nextX + 1, y)) { nextX++; } break;
+				case FinesseInput::ROTATE: nextRotation = (rotation + 1) % 4; break;
+				case FinesseInput::SOFT_DROP: nextY++; break;
+				default: break;
+			}
+			if ((nextRotation == rotation && nextX == x && nextY == y) || !isLegal(nextRotation, nextX, nextY))
+			{
+				continue;
+			}
+			int next = getStateIndex(nextRotation, nextX, nextY);
+			if (distance[next] < 0)
+			{
+				distance[next] = distance[state] + 1;
+				parent[next] = state;
+				parentInput[next] = static_cast<FinesseInput>(input);
+				queue.push_back(next);
+			}
+		}
+	}
+}
+
+bool FinesseAnalyzer::isLegal(int rotation, int x, int y) const
+{
+	for (int block{ 0 }; block < 4; block++)
+	{
+		int blockX = x + blockOffsets[rotation][block][0];
+		int blockY = y + blockOffsets[rotation][block][1];
+		// the upper border is ignored so that shapes can drop in from the top of the gameboard
+		if (blockX < 0 || blockX >= Gameboard::MAX_X || blockY >= Gameboard::MAX_Y)
+		{
+			return false;
+		}
+		if (blockY >= 0 && filled[blockY][blockX])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int FinesseAnalyzer::getCacheSlot(unsigned long long key)
+{
+	// Fibonacci hashing: the column heights are in the high bits of the key, so they're mixed down
+	return static_cast<int>((key * 11400714819323198485ull) >> 54) & (CACHE_SLOTS - 1);
+}
+
+int FinesseAnalyzer::getStateIndex(int rotation, int x, int y)
+{
+	return (rotation * STATE_WIDTH + (x + MARGIN)) * STATE_HEIGHT + (y + MARGIN);
+}
@@ -0,0 +1,141 @@
+// The FinesseAnalyzer works out the shortest sequence of inputs that takes a shape from
+// its spawn location to a final placement - the same inputs a player has:
+//  - LEFT / RIGHT:			a single tap (TetrisGame::attemptMove() by 1 column)
+//  - DAS_LEFT / DAS_RIGHT:	holding the key until the shape hits something (delayed auto shift)
+//  - ROTATE:				a clockwise rotation (TetrisGame::attemptRotate())
+//  - SOFT_DROP:			a single step down
+//  - HARD_DROP:			drop and lock (always the last input)
+//
+// The search is a breadth first search over (rotation, x, y) states, using the same
+// legality rules as TetrisGame::isPositionLegal().  One search finds the shortest sequence
+// for every placement of the shape, and the results are cached by (shape, board surface):
+// the board is reduced to its column heights, so boards that differ only below their
+// surface share a cache entry.  Because of this, placements tucked under overhangs are not found.
+// The cache is a fixed size direct mapped table (a search whose slot is in use replaces what's
+// there), so a long session doesn't grow it without bound.
+//
+// Used to score how efficiently a player placed their shapes (in replays), and to let the
+// autoplayer press keys like a player would instead of teleporting shapes into place.
+
+#ifndef FINESSEANALYZER_H
+#define FINESSEANALYZER_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "PlacementGenerator.h"
+#include <vector>
+
+enum class FinesseInput { LEFT, RIGHT, DAS_LEFT, DAS_RIGHT, ROTATE, SOFT_DROP, HARD_DROP, COUNT };
+
+class FinesseAnalyzer
+{
+	friend class TestSuite;
+
+private:
+	// STATE SPACE CONSTANTS
+	// a shape's gridLoc can sit up to 2 blocks outside the board (its blocks can't), so the
+	// state space has a margin of 3 around the board.
+	static const int MARGIN = 3;
+	static const int STATE_WIDTH = Gameboard::MAX_X + 2 * MARGIN;
+	static const int STATE_HEIGHT = Gameboard::MAX_Y + 2 * MARGIN;
+	static const int STATE_COUNT = 4 * STATE_WIDTH * STATE_HEIGHT;
+
+	// CACHE CONSTANTS
+	static const int CACHE_SLOTS = 1024;		// a power of 2
+
+	/// <summary>
+	/// The shortest inputs for one placement.
+	/// </summary>
+	struct FinesseEntry
+	{
+		unsigned int placementKey;				// see PlacementGenerator::getPlacementKey()
+		std::vector<FinesseInput> inputs;
+	};
+
+	/// <summary>
+	/// The searched placements for one (shape, surface).
+	/// </summary>
+	struct CacheSlot
+	{
+		unsigned long long key{ 0 };			// see getSurfaceKey()
+		bool used{ false };
+		std::vector<FinesseEntry> entries;
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	std::vector<CacheSlot> cache;				// CACHE_SLOTS, indexed by getCacheSlot()
+	size_t cacheSize{ 0 };						// # of slots in use
+
+	// search scratch (allocated once) ---------------------------------
+	bool filled[Gameboard::MAX_Y][Gameboard::MAX_X];	// the board surface being searched
+	int blockOffsets[4][4][2];							// [rotation][block][x or y] for the shape being searched
+	std::vector<int> distance;							// # of inputs to reach each state (-1 = not reached)
+	std::vector<int> parent;							// the state each state was reached from
+	std::vector<FinesseInput> parentInput;				// the input that reached each state
+	std::vector<int> queue;								// the BFS queue
+	std::vector<Point> mappedLocs;						// scratch: mapped block locations
+	GridTetromino scratchShape;
+
+public:
+	// METHODS -------------------------------------------------
+	FinesseAnalyzer();
+
+	/// <summary>
+	/// Finds the shortest input sequence from spawn to a placement.
+	/// </summary>
+	/// <param name="board">the board the shape is placed on</param>
+	/// <param name="shape">the shape</param>
+	/// <param name="placement">the final placement (ie. from PlacementGenerator)</param>
+	/// <param name="inputs">set to the inputs (ending with HARD_DROP)</param>
+	/// <returns>false if the placement can't be reached from spawn, true otherwise</returns>
+	bool findInputs(const Gameboard& board, TetShape shape, const Placement& placement, std::vector<FinesseInput>& inputs);
+
+	/// <summary>
+	/// Gets the # of inputs in the shortest sequence (used to score how efficiently a player placed a shape).
+	/// </summary>
+	/// <returns>the # of inputs, or -1 if the placement can't be reached</returns>
+	int getMinimalInputCount(const Gameboard& board, TetShape shape, const Placement& placement);
+
+	/// <summary>
+	/// Builds the cache key for a shape on a board: the shape and the height of each column.
+	/// </summary>
+	static unsigned long long getSurfaceKey(const Gameboard& board, TetShape shape);
+
+	/// <summary>
+	/// Gets the # of (shape, surface) searches that are cached (at most CACHE_SLOTS).
+	/// </summary>
+	size_t getCacheSize() const;
+
+	/// <summary>
+	/// Empties the cache.
+	/// </summary>
+	void clearCache();
+
+private:
+	/// <summary>
+	/// Gets the cached results for a shape on a board, searching (and caching) them if needed.
+	/// </summary>
+	const std::vector<FinesseEntry>& analyze(const Gameboard& board, TetShape shape);
+
+	/// <summary>
+	/// The breadth first search from spawn, recording the first (shortest) path to each placement.
+	/// </summary>
+	void search(const Gameboard& board, TetShape shape, std::vector<FinesseEntry>& entries);
+
+	/// <summary>
+	/// Tests a state against the board surface (same rules as TetrisGame::isPositionLegal()).
+	/// </summary>
+	bool isLegal(int rotation, int x, int y) const;
+
+	/// <summary>
+	/// Gets the cache slot for a surface key.
+	/// </summary>
+	static int getCacheSlot(unsigned long long key);
+
+	/// <summary>
+	/// Converts a state to its index in the search arrays.
+	/// </summary>
+	static int getStateIndex(int rotation, int x, int y);
+};
+
+#endif /* FINESSEANALYZER_H */
@@ -0,0 +1,145 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+const double FramePacer::SIMULATION_STEP{ 1.0 / 120.0 };
+const int FramePacer::MAX_SIMULATION_STEPS{ 8 };
+const double FramePacer::MIN_SPIN_SECONDS{ 0.002 };
+const double FramePacer::SPIN_SMOOTHING{ 0.1 };
+const double FramePacer::SPIN_MARGIN{ 1.5 };
+const double FramePacer::MAX_SPIN_FRACTION{ 0.5 };
+
+FramePacer::FramePacer(double targetFps)
+{
+	setTargetFps(targetFps);
+}
+
+void FramePacer::setMode(PacingMode mode)
+{
+	this->mode = mode;
+	hasDeadline = false;
+	resetStats();
+}
+
+PacingMode FramePacer::getMode() const { return mode; }
+
+void FramePacer::setTargetFps(double fps)
+{
+	framePeriod = 1.0 / std::max(fps, 1.0);
+	hasDeadline = false;
+}
+
+bool FramePacer::shouldWaitWhenPaused() const { return mode == PacingMode::IDLE; }
+
+void FramePacer::waitForNextFrame()
+{
+	if (mode != PacingMode::LIMITED && mode != PacingMode::IDLE)
+	{
+		return;
+	}
+	Clock::time_point now = Clock::now();
+	Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(framePeriod));
+	if (!hasDeadline)
+	{
+		deadline = now;
+		hasDeadline = true;
+	}
+	deadline += period;
+	if (deadline < now)
+	{
+		// late: start from now rather than rushing frames to catch up
+		deadline = now;
+		return;
+	}
+
+	// sleep for most of the wait, leaving spinSeconds to spin
+	Clock::duration spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spinSeconds));
+	Clock::time_point wakeUp = deadline - spin;
+	if (now < wakeUp)
+	{
+		std::this_thread::sleep_until(wakeUp);
+		adjustSpin(std::chrono::duration<double>(Clock::now() - wakeUp).count());
+	}
+	while (Clock::now() < deadline)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void FramePacer::markFrame()
+{
+	Clock::time_point now = Clock::now();
+	if (hasLastFrame)
+	{
+		recordInterval(std::chrono::duration<double>(now - lastFrame).count());
+	}
+	lastFrame = now;
+	hasLastFrame = true;
+}
+
+int FramePacer::takeSimulationSteps(double elapsedSeconds)
+{
+	simulationSeconds += elapsedSeconds;
+	int steps = static_cast<int>(simulationSeconds / SIMULATION_STEP);
+	simulationSeconds -= steps * SIMULATION_STEP;
+	if (steps > MAX_SIMULATION_STEPS)
+	{
+		steps = MAX_SIMULATION_STEPS;
+		simulationSeconds = 0.0;
+	}
+	return steps;
+}
+
+void FramePacer::resetSimulationTime()
+{
+	simulationSeconds = 0.0;
+	hasDeadline = false;
+	hasLastFrame = false;
+}
+
+PacingStats FramePacer::getStats() const
+{
+	PacingStats stats;
+	stats.frameCount = intervalCount;
+	stats.mean = intervalMean;
+	stats.jitter = intervalCount > 1 ? std::sqrt(intervalM2 / (intervalCount - 1)) : 0.0;
+	stats.max = intervalMax;
+	return stats;
+}
+
+void FramePacer::resetStats()
+{
+	hasLastFrame = false;
+	intervalCount = 0;
+	intervalMean = 0.0;
+	intervalM2 = 0.0;
+	intervalMax = 0.0;
+}
+
+const char* FramePacer::getModeName(PacingMode mode)
+{
+	switch (mode)
+	{
+		case PacingMode::VSYNC: return "vsync";
+		case PacingMode::UNCAPPED: return "uncapped";
+		case PacingMode::LIMITED: return "limited";
+		case PacingMode::IDLE: return "idle";
+		default: return "?";
+	}
+}
+
+void FramePacer::adjustSpin(double overslept)
+{
+	oversleepAverage += SPIN_SMOOTHING * (std::max(overslept, 0.0) - oversleepAverage);
+	spinSeconds = std::min(std::max(oversleepAverage * SPIN_MARGIN, MIN_SPIN_SECONDS), framePeriod * MAX_SPIN_FRACTION);
+}
+
+void FramePacer::recordInterval(double seconds)
+{
+	intervalCount++;
+	double delta = seconds - intervalMean;
+	intervalMean += delta / intervalCount;
+	intervalM2 += delta * (seconds - intervalMean);
+	intervalMax = std::max(intervalMax, seconds);
+}
@@ -0,0 +1,150 @@
+// The FramePacer decides when the next frame starts, and keeps the game simulation
+// independent of the frame rate.
+//
+// Pacing modes:
+//  - VSYNC:	the driver waits for the monitor's refresh (window.setVerticalSyncEnabled(true))
+//  - UNCAPPED:	frames run back to back
+//  - LIMITED:	waitForNextFrame() holds frames to the target rate: it sleeps until just
+//				before the deadline, then spins on the steady clock for the rest.
+//				The sleep margin follows a moving average of recent oversleeps (with a
+//				floor of MIN_SPIN_SECONDS, and at most half a frame), so coarse OS timers
+//				don't make frames late, but one bad sleep doesn't leave it spinning for good.
+//  - IDLE:		like LIMITED, but while the game is paused the main loop blocks in
+//				window.waitEvent() instead of drawing frames.
+// (the window settings for each mode are applied by main(), this class has no SFML dependency)
+//
+// The simulation runs in fixed steps of SIMULATION_STEP seconds: takeSimulationSteps()
+// turns the time since the last frame into a # of steps, carrying the remainder over.
+//
+// The pacer also measures the interval between frames (markFrame()), so the jitter of
+// each mode can be reported.
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+
+enum class PacingMode { VSYNC, UNCAPPED, LIMITED, IDLE, COUNT };
+
+/// <summary>
+/// Frame interval statistics since the last resetStats() (in seconds).
+/// </summary>
+struct PacingStats
+{
+	int frameCount{ 0 };			// # of intervals measured
+	double mean{ 0.0 };				// mean frame interval
+	double jitter{ 0.0 };			// standard deviation of the frame interval
+	double max{ 0.0 };				// longest frame interval
+};
+
+class FramePacer
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const double SIMULATION_STEP;		// seconds simulated per step, init to 1/120
+	static const int MAX_SIMULATION_STEPS;		// most steps per frame (the rest is dropped after a stall), init to 8
+	static const double MIN_SPIN_SECONDS;		// the least time before a deadline the limiter spins, init to 0.002
+	static const double SPIN_SMOOTHING;			// the weight of each new oversleep in the average, init to 0.1
+	static const double SPIN_MARGIN;			// the sleep margin as a multiple of the average oversleep, init to 1.5
+	static const double MAX_SPIN_FRACTION;		// the most of a frame period spent spinning, init to 0.5
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	// MEMBER VARIABLES -------------------------------------------------
+	PacingMode mode{ PacingMode::LIMITED };
+	double framePeriod{ 1.0 / 60.0 };			// seconds per frame for LIMITED and IDLE
+	double spinSeconds{ MIN_SPIN_SECONDS };		// the limiter's sleep margin (follows the oversleeps)
+	double oversleepAverage{ 0.0 };				// moving average of how late sleeps wake up
+	Clock::time_point deadline;					// when the next limited frame may start
+	bool hasDeadline{ false };
+	double simulationSeconds{ 0.0 };			// time not yet simulated
+
+	// interval stats (Welford's running mean and variance)
+	Clock::time_point lastFrame;
+	bool hasLastFrame{ false };
+	int intervalCount{ 0 };
+	double intervalMean{ 0.0 };
+	double intervalM2{ 0.0 };
+	double intervalMax{ 0.0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="targetFps">the frame rate for LIMITED and IDLE</param>
+	explicit FramePacer(double targetFps = 60.0);
+
+	/// <summary>
+	/// Changes the pacing mode.  The stats and the limiter's deadline are reset.
+	/// </summary>
+	void setMode(PacingMode mode);
+	PacingMode getMode() const;
+
+	/// <summary>
+	/// Sets the frame rate for LIMITED and IDLE.
+	/// </summary>
+	void setTargetFps(double fps);
+
+	/// <summary>
+	/// Gets whether the main loop should block on window events while paused (IDLE mode).
+	/// </summary>
+	bool shouldWaitWhenPaused() const;
+
+	/// <summary>
+	/// In LIMITED and IDLE mode: sleeps, then spins, until the next frame's deadline.
+	/// If the frame is already late, the deadline is moved to now (late frames aren't caught up).
+	/// In the other modes returns immediately.
+	/// </summary>
+	void waitForNextFrame();
+
+	/// <summary>
+	/// Records that a frame was presented (call right after window.display()), for the interval stats.
+	/// </summary>
+	void markFrame();
+
+	/// <summary>
+	/// Adds the time since the last frame and takes the # of whole simulation steps that are due
+	/// (at most MAX_SIMULATION_STEPS, any extra time is dropped).
+	/// </summary>
+	/// <param name="elapsedSeconds">the time since the last call</param>
+	/// <returns>the # of SIMULATION_STEP steps to simulate</returns>
+	int takeSimulationSteps(double elapsedSeconds);
+
+	/// <summary>
+	/// Forgets any time not yet simulated, and restarts the limiter and interval timing
+	/// (ie. when unpausing, so the pause isn't simulated or counted as a frame).
+	/// </summary>
+	void resetSimulationTime();
+
+	/// <summary>
+	/// Gets the frame interval stats since the last reset.
+	/// </summary>
+	PacingStats getStats() const;
+
+	/// <summary>
+	/// Resets the frame interval stats.
+	/// </summary>
+	void resetStats();
+
+	/// <summary>
+	/// Gets the name of a mode (for display).
+	/// </summary>
+	static const char* getModeName(PacingMode mode);
+
+private:
+	/// <summary>
+	/// Updates the sleep margin with how late a sleep woke up.
+	/// </summary>
+	void adjustSpin(double overslept);
+
+	/// <summary>
+	/// Adds one frame interval to the stats.
+	/// </summary>
+	void recordInterval(double seconds);
+};
+
+#endif /* FRAMEPACER_H */
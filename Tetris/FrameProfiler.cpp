@@ -0,0 +1,106 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include "LatencyStats.h"
+
+FrameProfiler::ScopedTimer::ScopedTimer(FrameProfiler& profiler, FramePhase phase)
+	: profiler{ profiler }, phase{ phase }, start{ std::chrono::steady_clock::now() }
+{
+}
+
+FrameProfiler::ScopedTimer::~ScopedTimer()
+{
+	profiler.addPhaseTime(phase, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+void FrameProfiler::beginFrame()
+{
+	std::fill(currentPhaseSeconds, currentPhaseSeconds + PHASE_COUNT, 0.0);
+	frameStart = std::chrono::steady_clock::now();
+	frameStarted = true;
+}
+
+void FrameProfiler::endFrame()
+{
+	if (!frameStarted)
+	{
+		return;
+	}
+	frameStarted = false;
+	recordFrame(std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count(), currentPhaseSeconds);
+}
+
+void FrameProfiler::addPhaseTime(FramePhase phase, double seconds)
+{
+	currentPhaseSeconds[static_cast<int>(phase)] += seconds;
+}
+
+void FrameProfiler::recordFrame(double seconds, const double* phases)
+{
+	frameSeconds[nextFrame] = seconds;
+	for (int phase{ 0 }; phase < PHASE_COUNT; phase++)
+	{
+		phaseSeconds[phase][nextFrame] = phases ? phases[phase] : 0.0;
+	}
+	nextFrame = (nextFrame + 1) % HISTORY;
+	recordedFrames = std::min(recordedFrames + 1, static_cast<int>(HISTORY));
+}
+
+int FrameProfiler::getFrameCount() const { return recordedFrames; }
+
+double FrameProfiler::getFrameSeconds(int framesAgo) const
+{
+	if (framesAgo < 0 || framesAgo >= recordedFrames)
+	{
+		return 0.0;
+	}
+	return frameSeconds[(nextFrame - 1 - framesAgo + HISTORY) % HISTORY];
+}
+
+FrameStats FrameProfiler::getStats()
+{
+	FrameStats stats;
+	stats.frameCount = recordedFrames;
+	if (recordedFrames == 0)
+	{
+		return stats;
+	}
+	stats.p50 = getPercentile(0.50);
+	stats.p99 = getPercentile(0.99);
+	stats.max = *std::max_element(frameSeconds, frameSeconds + recordedFrames);
+	for (int phase{ 0 }; phase < PHASE_COUNT; phase++)
+	{
+		double total{ 0.0 };
+		for (int frame{ 0 }; frame < recordedFrames; frame++)
+		{
+			total += phaseSeconds[phase][frame];
+		}
+		stats.phaseMean[phase] = total / recordedFrames;
+	}
+	return stats;
+}
+
+const char* FrameProfiler::getPhaseName(FramePhase phase)
+{
+	switch (phase)
+	{
+		case FramePhase::INPUT: return "input";
+		case FramePhase::SIMULATION: return "simulation";
+		case FramePhase::DRAW: return "draw";
+		case FramePhase::DISPLAY: return "display";
+		default: return "?";
+	}
+}
+
+void FrameProfiler::clear()
+{
+	nextFrame = 0;
+	recordedFrames = 0;
+	frameStarted = false;
+}
+
+double FrameProfiler::getPercentile(double fraction)
+{
+	// the slots in use are always 0 to recordedFrames-1 (the ring only wraps once it's full)
+	std::copy(frameSeconds, frameSeconds + recordedFrames, sortScratch);
+	return LatencyStats::getPercentile(sortScratch, recordedFrames, fraction);
+}
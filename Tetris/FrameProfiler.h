@@ -0,0 +1,136 @@
+// The FrameProfiler records how long each phase of the game loop takes
+// (input, simulation, draw submission, display/present), for the last HISTORY frames,
+// in fixed size ring buffers - nothing is allocated once it's constructed.
+//
+// Phases are timed with a ScopedTimer, usually through the PROFILE_PHASE() macro:
+//     {
+//         PROFILE_PHASE(profiler, FramePhase::SIMULATION);
+//         game.processGameLoop(elapsedTime);
+//     }
+// PROFILE_PHASE() only does anything when TETRIS_PROFILER is defined (see the Debug
+// configurations in Tetris.vcxproj), otherwise it compiles to nothing.
+// A timer costs two reads of the steady clock, so the profiler's overhead is a handful of
+// clock reads per frame.
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <chrono>
+
+enum class FramePhase { INPUT, SIMULATION, DRAW, DISPLAY, COUNT };
+
+/// <summary>
+/// Summary of recent frame times (in seconds).
+/// </summary>
+struct FrameStats
+{
+	int frameCount{ 0 };						// # of frames the stats cover
+	double p50{ 0.0 };							// median frame time
+	double p99{ 0.0 };							// 99th percentile frame time
+	double max{ 0.0 };							// slowest frame
+	double phaseMean[static_cast<int>(FramePhase::COUNT)]{};	// mean time of each phase
+};
+
+class FrameProfiler
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int HISTORY = 256;				// # of frames kept
+	static const int PHASE_COUNT = static_cast<int>(FramePhase::COUNT);
+
+	/// <summary>
+	/// Adds the time between its construction and destruction to a phase of the current frame.
+	/// </summary>
+	class ScopedTimer
+	{
+	private:
+		FrameProfiler& profiler;
+		FramePhase phase;
+		std::chrono::steady_clock::time_point start;
+	public:
+		ScopedTimer(FrameProfiler& profiler, FramePhase phase);
+		~ScopedTimer();
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	double frameSeconds[HISTORY]{};					// ring buffer of whole frame times
+	double phaseSeconds[PHASE_COUNT][HISTORY]{};	// ring buffers of phase times
+	double currentPhaseSeconds[PHASE_COUNT]{};		// phase times of the frame in progress
+	int nextFrame{ 0 };								// ring buffer slot for the next frame
+	int recordedFrames{ 0 };						// # of slots filled (up to HISTORY)
+	bool frameStarted{ false };
+	std::chrono::steady_clock::time_point frameStart;
+	double sortScratch[HISTORY]{};					// scratch for the percentiles
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Starts timing a frame.
+	/// </summary>
+	void beginFrame();
+
+	/// <summary>
+	/// Records the frame started by beginFrame() (its total time, and its phase times) in the ring buffers.
+	/// Does nothing if no frame was started.
+	/// </summary>
+	void endFrame();
+
+	/// <summary>
+	/// Adds time to a phase of the current frame (a phase can be timed more than once per frame).
+	/// </summary>
+	void addPhaseTime(FramePhase phase, double seconds);
+
+	/// <summary>
+	/// Records a whole frame at once (for tests and tools that time frames themselves).
+	/// </summary>
+	/// <param name="seconds">the frame time</param>
+	/// <param name="phases">the time of each phase (PHASE_COUNT values), or nullptr</param>
+	void recordFrame(double seconds, const double* phases = nullptr);
+
+	/// <summary>
+	/// Gets the # of frames recorded (up to HISTORY).
+	/// </summary>
+	int getFrameCount() const;
+
+	/// <summary>
+	/// Gets a recorded frame time, 0 being the most recent frame.
+	/// </summary>
+	double getFrameSeconds(int framesAgo) const;
+
+	/// <summary>
+	/// Works out the percentiles and phase means of the recorded frames.
+	/// </summary>
+	FrameStats getStats();
+
+	/// <summary>
+	/// Gets the name of a phase (for display).
+	/// </summary>
+	static const char* getPhaseName(FramePhase phase);
+
+	/// <summary>
+	/// Forgets every recorded frame.
+	/// </summary>
+	void clear();
+
+private:
+	/// <summary>
+	/// Gets a percentile (0-1) of the recorded frame times, using nearest rank.
+	/// </summary>
+	double getPercentile(double fraction);
+};
+
+// PROFILE_PHASE(profiler, phase) times the rest of the enclosing scope as a phase
+#ifdef TETRIS_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_PHASE(profiler, phase) FrameProfiler::ScopedTimer PROFILE_CONCAT(phaseTimer, __LINE__)(profiler, phase)
+#else
+#define PROFILE_PHASE(profiler, phase)
+#endif
+
+#endif /* FRAMEPROFILER_H */
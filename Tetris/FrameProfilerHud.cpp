@@ -0,0 +1,71 @@
+#include "FrameProfilerHud.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+const int FrameProfilerHud::TEXT_REFRESH_FRAMES{ 15 };
+const float FrameProfilerHud::GRAPH_HEIGHT{ 60.f };
+const double FrameProfilerHud::GRAPH_SECONDS{ 0.05 };
+
+FrameProfilerHud::FrameProfilerHud(FrameProfiler& profiler, const sf::Font& font, sf::Vector2f position)
+	: profiler{ profiler }, position{ position }
+{
+	text.setFont(font);
+	text.setCharacterSize(12);
+	text.setFillColor(sf::Color::White);
+	text.setPosition(position.x + 4.f, position.y + 2.f);
+
+	panel.setPosition(position);
+	panel.setSize(sf::Vector2f(static_cast<float>(FrameProfiler::HISTORY) + 8.f, 80.f + GRAPH_HEIGHT));
+	panel.setFillColor(sf::Color(0, 0, 0, 160));
+
+	// 2 vertices per bar, 2 for the reference line
+	graph.resize(FrameProfiler::HISTORY * 2 + 2);
+}
+
+void FrameProfilerHud::draw(sf::RenderTarget& target)
+{
+	if (--framesUntilRefresh <= 0)
+	{
+		refreshText();
+		framesUntilRefresh = TEXT_REFRESH_FRAMES;
+	}
+	refreshGraph();
+	target.draw(panel);
+	target.draw(text);
+	target.draw(graph);
+}
+
+void FrameProfilerHud::refreshText()
+{
+	FrameStats stats = profiler.getStats();
+	char line[96];
+	std::snprintf(line, sizeof(line), "frame ms  p50 %.2f  p99 %.2f  max %.2f\n",
+		stats.p50 * 1000.0, stats.p99 * 1000.0, stats.max * 1000.0);
+	std::string lines{ line };
+	for (int phase{ 0 }; phase < FrameProfiler::PHASE_COUNT; phase++)
+	{
+		std::snprintf(line, sizeof(line), "%-11s %.3f ms\n",
+			FrameProfiler::getPhaseName(static_cast<FramePhase>(phase)), stats.phaseMean[phase] * 1000.0);
+		lines += line;
+	}
+	text.setString(lines);
+}
+
+void FrameProfilerHud::refreshGraph()
+{
+	float bottom = position.y + 76.f + GRAPH_HEIGHT;
+	float left = position.x + 4.f;
+	for (int bar{ 0 }; bar < FrameProfiler::HISTORY; bar++)
+	{
+		// newest frame on the right
+		double seconds = profiler.getFrameSeconds(FrameProfiler::HISTORY - 1 - bar);
+		float height = static_cast<float>(std::min(seconds / GRAPH_SECONDS, 1.0)) * GRAPH_HEIGHT;
+		sf::Color colour = seconds > 1.0 / 30.0 ? sf::Color::Red : sf::Color::Green;
+		graph[bar * 2] = sf::Vertex(sf::Vector2f(left + bar, bottom), colour);
+		graph[bar * 2 + 1] = sf::Vertex(sf::Vector2f(left + bar, bottom - height), colour);
+	}
+	float budget = bottom - static_cast<float>((1.0 / 30.0) / GRAPH_SECONDS) * GRAPH_HEIGHT;
+	graph[FrameProfiler::HISTORY * 2] = sf::Vertex(sf::Vector2f(left, budget), sf::Color::Yellow);
+	graph[FrameProfiler::HISTORY * 2 + 1] = sf::Vertex(sf::Vector2f(left + FrameProfiler::HISTORY, budget), sf::Color::Yellow);
+}
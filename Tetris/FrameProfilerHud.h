@@ -0,0 +1,56 @@
+// The FrameProfilerHud draws a FrameProfiler's numbers over the game:
+// p50/p99/max frame times, the mean time of each phase, and a graph of the recent
+// frame times (one bar per frame, with a line at 1/30 sec).
+// The text is only rebuilt every TEXT_REFRESH_FRAMES frames, and the graph's vertices
+// are allocated once, so the HUD costs little more than its two draw calls.
+
+#ifndef FRAMEPROFILERHUD_H
+#define FRAMEPROFILERHUD_H
+
+#include "FrameProfiler.h"
+#include <SFML/Graphics.hpp>
+
+class FrameProfilerHud
+{
+private:
+	// CONSTANTS
+	static const int TEXT_REFRESH_FRAMES;	// how often the text is rebuilt, init to 15
+	static const float GRAPH_HEIGHT;		// pixel height of the graph, init to 60
+	static const double GRAPH_SECONDS;		// frame time at the top of the graph, init to 0.05
+
+	// MEMBER VARIABLES -------------------------------------------------
+	FrameProfiler& profiler;
+	sf::Vector2f position;					// pixel position of the HUD's top left
+	sf::RectangleShape panel;				// the translucent background
+	sf::Text text;
+	sf::VertexArray graph{ sf::Lines };		// one bar per frame, plus the 1/30 sec line
+	int framesUntilRefresh{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="profiler">the profiler to show</param>
+	/// <param name="font">the font for the text (must outlive the HUD)</param>
+	/// <param name="position">pixel position of the HUD's top left</param>
+	FrameProfilerHud(FrameProfiler& profiler, const sf::Font& font, sf::Vector2f position);
+
+	/// <summary>
+	/// Draws the HUD (called once per frame).
+	/// </summary>
+	void draw(sf::RenderTarget& target);
+
+private:
+	/// <summary>
+	/// Rebuilds the text from the profiler's stats.
+	/// </summary>
+	void refreshText();
+
+	/// <summary>
+	/// Rebuilds the graph bars from the profiler's recent frame times.
+	/// </summary>
+	void refreshGraph();
+};
+
+#endif /* FRAMEPROFILERHUD_H */
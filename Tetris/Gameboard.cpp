@@ -1,4 +1,5 @@
 #include "Gameboard.h"
+#include <algorithm>
 
 Gameboard::Gameboard() {
 	Gameboard::empty();
@@ -50,6 +51,7 @@ void Gameboard::setContent(Point xy, int content) {
 	if (isValidPoint(xy.getX(), xy.getY()))
 	{
 		grid[xy.getY()][xy.getX()] = content;
+		markDirty(xy.getY() * MAX_X + xy.getX(), xy.getY() * MAX_X + xy.getX());
 	}
 };
 
@@ -57,6 +59,7 @@ void Gameboard::setContent(int x, int y, int content) {
 	if (isValidPoint(x, y))
 	{
 		grid[y][x] = content;
+		markDirty(y * MAX_X + x, y * MAX_X + x);
 	}
 };
 
@@ -68,8 +71,8 @@ void Gameboard::setContent(std::vector<Point>& locations, const int content) {
 	}
 };
 
-bool Gameboard::areAllLocsEmpty(std::vector<Point> locationsToTest) const {
-	for (Point& xy : locationsToTest)
+bool Gameboard::areAllLocsEmpty(const std::vector<Point>& locationsToTest) const {
+	for (const Point& xy : locationsToTest)
 	{
 		if (isValidPoint(xy))
 		{
@@ -82,20 +85,128 @@ bool Gameboard::areAllLocsEmpty(std::vector<Point> locationsToTest) const {
 	return true;
 };
 
-int Gameboard::removeCompletedRows() {
-	std::vector<int> completedRows = getCompletedRowIndices(); 
+int Gameboard::removeCompletedRows(ClearedRows* cleared) {
+	if (cleared)
+	{
+		cleared->count = 0;
+	}
+	// walk up the board, copying each incomplete row down to the next free target row
+	int targetRowIndex{ MAX_Y - 1 };
+	for (int y{ MAX_Y - 1 }; y >= 0; y--)
+	{
+		if (isRowCompleted(y))
+		{
+			// recorded before any row is copied over it
+			if (cleared && cleared->count < ClearedRows::MAX_ROWS)
+			{
+				cleared->rows[cleared->count] = y;
+				std::copy(grid[y], grid[y] + MAX_X, cleared->contents[cleared->count]);
+				cleared->count++;
+			}
+		}
+		else
+		{
+			if (targetRowIndex != y)
+			{
+				copyRowIntoRow(y, targetRowIndex);
+			}
+			targetRowIndex--;
+		}
+	}
+	// every row left above the target was freed up by a completed row
+	int completedRowCount{ targetRowIndex + 1 };
+	for (int y{ targetRowIndex }; y >= 0; y--)
+	{
+		fillRow(y, EMPTY_BLOCK);
+	}
+	return completedRowCount;
+};
+
+bool Gameboard::insertGarbageRows(int count, int holeColumn, int content) {
+	count = std::min(count, static_cast<int>(MAX_Y));
+	if (count <= 0)
+	{
+		return false;
+	}
+	bool toppedOut{ false };
+	for (int y{ 0 }; y < count; y++)
+	{
+		for (int x{ 0 }; x < MAX_X; x++)
+		{
+			toppedOut = toppedOut || grid[y][x] != EMPTY_BLOCK;
+		}
+	}
+	shiftRowsUp(count);
 
-	for (int i{ 0 }; i < completedRows.size(); i++)
+	// the first garbage row is built cell by cell, the rest are copies of it
+	fillRow(MAX_Y - 1, content);
+	if (holeColumn >= 0 && holeColumn < MAX_X)
 	{
-		removeRows(completedRows);
+		grid[MAX_Y - 1][holeColumn] = EMPTY_BLOCK;
 	}
-	return completedRows.size();
+	for (int y{ MAX_Y - count }; y < MAX_Y - 1; y++)
+	{
+		copyRowIntoRow(MAX_Y - 1, y);
+	}
+	return toppedOut;
 };
 
 Point Gameboard::getSpawnLoc() const {
 	return spawnLoc;
 };
 
+bool Gameboard::getDirtyCells(int& firstCell, int& lastCell) const {
+	firstCell = firstDirtyCell;
+	lastCell = lastDirtyCell;
+	return firstDirtyCell <= lastDirtyCell;
+};
+
+void Gameboard::clearDirtyCells() {
+	firstDirtyCell = MAX_X * MAX_Y;
+	lastDirtyCell = -1;
+};
+
+int Gameboard::copyChangedCells(const Gameboard& source) {
+	int changed{ 0 };
+	for (int y{ 0 }; y < MAX_Y; y++)
+	{
+		for (int x{ 0 }; x < MAX_X; x++)
+		{
+			if (grid[y][x] != source.grid[y][x])
+			{
+				setContent(x, y, source.grid[y][x]);
+				changed++;
+			}
+		}
+	}
+	return changed;
+};
+
+unsigned long long Gameboard::getHash() const {
+	unsigned long long hash{ 14695981039346656037ull };
+	for (int y{ 0 }; y < MAX_Y; y++)
+	{
+		for (int x{ 0 }; x < MAX_X; x++)
+		{
+			// 1 byte per cell is enough: contents are EMPTY_BLOCK or a TetColor
+			hash ^= static_cast<unsigned char>(grid[y][x]);
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+void Gameboard::markDirty(int firstCell, int lastCell) {
+	if (firstCell < firstDirtyCell)
+	{
+		firstDirtyCell = firstCell;
+	}
+	if (lastCell > lastDirtyCell)
+	{
+		lastDirtyCell = lastCell;
+	}
+};
+
 bool Gameboard::isValidPoint(Point pointObj) const {
 	return isValidPoint(pointObj.getX(), pointObj.getY());
 };
@@ -123,6 +234,7 @@ void Gameboard::fillRow(const int rowIndex, const int content)
 	{
 		grid[rowIndex][x] = content;
 	}
+	markDirty(rowIndex * MAX_X, rowIndex * MAX_X + MAX_X - 1);
 };
 
 std::vector<int> Gameboard::getCompletedRowIndices() const {
@@ -137,11 +249,22 @@ std::vector<int> Gameboard::getCompletedRowIndices() const {
 	return completedRows;
 };
 
+void Gameboard::shiftRowsUp(int distance) {
+	assert(distance > 0 && distance <= MAX_Y);
+	if (distance < MAX_Y)
+	{
+		// rows distance ... MAX_Y - 1 move to rows 0 ... MAX_Y - 1 - distance (the ranges overlap going down in memory, which std::copy allows)
+		std::copy(&grid[distance][0], &grid[0][0] + MAX_Y * MAX_X, &grid[0][0]);
+	}
+	markDirty(0, MAX_Y * MAX_X - 1);
+};
+
 void Gameboard::copyRowIntoRow(const int srcRowIndex, const int targetRowIndex) {
 	for (int x { 0 }; x < MAX_X; x++)
 	{
 		grid[targetRowIndex][x] = grid[srcRowIndex][x];
 	}
+	markDirty(targetRowIndex * MAX_X, targetRowIndex * MAX_X + MAX_X - 1);
 };
 
 void Gameboard::removeRow(const int rowIndex) {
@@ -9,7 +9,7 @@
 
 class Gameboard
 {
-	friend int main();
+	friend int main(int argc, char* argv[]);
 	friend class TestSuite;
 
 public:
@@ -18,6 +18,17 @@ public:
 	static const int MAX_Y = 19;		// gameboard y dimension
 	static const int EMPTY_BLOCK = -1;	// contents of an empty block
 
+	/// <summary>
+	/// The rows taken off the board by removeCompletedRows() (ie. for line clear animations).
+	/// </summary>
+	struct ClearedRows
+	{
+		static const int MAX_ROWS = 4;		// a tetromino covers at most 4 rows (any more are counted, not recorded)
+		int count{ 0 };						// # of rows recorded
+		int rows[MAX_ROWS]{};				// the row indices before the board collapsed, bottom row first
+		int contents[MAX_ROWS][MAX_X]{};	// the contents of each row
+	};
+
 private:
 	// MEMBER VARIABLES -------------------------------------------------
 
@@ -25,7 +36,12 @@ private:
 	//  ([0][0] is top left, [MAX_Y-1][MAX_X-1] is bottom right) 
 	int grid[MAX_Y][MAX_X];
 	// the gameboard offset to spawn a new tetromino at.
-	const Point spawnLoc{ MAX_X / 2, 0 };
+	// (not const, so that boards can be assigned to one another - the bots copy boards to test placements)
+	Point spawnLoc{ MAX_X / 2, 0 };
+	// the range of cells written since clearDirtyCells() (cell index = y * MAX_X + x).
+	// Renderers use it to re-upload only the cells that changed.
+	int firstDirtyCell{ MAX_X * MAX_Y };
+	int lastDirtyCell{ -1 };
 
 public:
 	// METHODS -------------------------------------------------
@@ -93,14 +109,27 @@ public:
 	/// </summary>
 	/// <param name="locationsToTest"></param>
 	/// <returns>true if the content at all valid points is EMPTY_BLOCK, false otherwise</returns>
-	bool areAllLocsEmpty(std::vector<Point> locationsToTest) const;
+	bool areAllLocsEmpty(const std::vector<Point>& locationsToTest) const;
 
 	/// <summary>
 	/// Removes all completed rows from the board
-	/// Does so using getCompletedRowIndices() and removeRows()
+	/// Incomplete rows are compacted downwards in a single bottom-up pass (no allocation),
+	/// and the rows left over at the top are filled with EMPTY_BLOCK.
 	/// </summary>
+	/// <param name="cleared">if given, set to the rows removed (and what was in them)</param>
 	/// <returns>the count of completed rows removed</returns>
-	int removeCompletedRows();
+	int removeCompletedRows(ClearedRows* cleared = nullptr);
+
+	/// <summary>
+	/// Pushes garbage rows in from the bottom (a versus attack): the whole board moves up
+	/// in one block move (see shiftRowsUp()), then the bottom rows are filled with content,
+	/// except for one empty cell in the hole column.
+	/// </summary>
+	/// <param name="count">the # of rows to push in (up to MAX_Y)</param>
+	/// <param name="holeColumn">the x of the gap in each garbage row</param>
+	/// <param name="content">what the garbage rows are filled with</param>
+	/// <returns>true if any blocks were pushed off the top of the board (the player has topped out)</returns>
+	bool insertGarbageRows(int count, int holeColumn, int content);
 
 	/// <summary>
 	/// Gets the spawn location
@@ -108,7 +137,45 @@ public:
 	/// <returns>A point, representing the private spawnLoc</returns>
 	Point getSpawnLoc() const;
 
+	/// <summary>
+	/// Gets the range of cells that have been written since the last clearDirtyCells().
+	/// Cell indices are y * MAX_X + x, so a range covers whole rows in between.
+	/// (a new board starts with every cell dirty)
+	/// </summary>
+	/// <param name="firstCell">set to the first dirty cell index</param>
+	/// <param name="lastCell">set to the last dirty cell index</param>
+	/// <returns>true if any cell is dirty, false otherwise</returns>
+	bool getDirtyCells(int& firstCell, int& lastCell) const;
+
+	/// <summary>
+	/// Marks every cell as clean (called once a renderer has caught up with the board).
+	/// </summary>
+	void clearDirtyCells();
+
+	/// <summary>
+	/// Makes this board match another by writing only the cells that differ,
+	/// so the dirty range covers exactly what changed (ie. a renderer's copy of a board
+	/// owned by another thread).
+	/// </summary>
+	/// <param name="source">the board to copy</param>
+	/// <returns>the # of cells that changed</returns>
+	int copyChangedCells(const Gameboard& source);
+
+	/// <summary>
+	/// Hashes the contents of the board (FNV-1a over every cell), so two copies of a game
+	/// (ie. lockstep peers) can check they still match without sending the whole board.
+	/// </summary>
+	/// <returns>the hash (the same on every platform)</returns>
+	unsigned long long getHash() const;
+
 private:
+	/// <summary>
+	/// Grows the dirty range to include the given cells.
+	/// </summary>
+	/// <param name="firstCell">the first cell index written</param>
+	/// <param name="lastCell">the last cell index written</param>
+	void markDirty(int firstCell, int lastCell);
+
 	/// <summary>
 	/// Determines if a given point is a valid grid location
 	/// </summary>
@@ -146,6 +213,14 @@ private:
 	/// <returns>a vector of completed row indices (ints)</returns>
 	std::vector<int> getCompletedRowIndices() const;
 
+	/// <summary>
+	/// Moves every row up by distance rows (the top distance rows are lost).  The grid is
+	/// contiguous, so this is a single std::copy of the rows below, not a copy per cell.
+	/// The bottom distance rows are left as they were, for the caller to fill.
+	/// </summary>
+	/// <param name="distance">the # of rows to move up (1 to MAX_Y)</param>
+	void shiftRowsUp(int distance);
+
 	/// <summary>
 	/// Copy a source row's contents into a target row
 	/// </summary>
@@ -0,0 +1,37 @@
+#include "GarbageExchange.h"
+
+bool GarbageExchange::send(int fromPlayer, unsigned int frame, int rows)
+{
+	if (rows <= 0)
+	{
+		return true;
+	}
+	Attack attack;
+	attack.frame = frame;
+	attack.rows = rows;
+	return incoming[1 - fromPlayer].push(attack);
+}
+
+int GarbageExchange::receive(int player, unsigned int frame)
+{
+	int rows{ 0 };
+	Attack attack;
+	// attacks are queued in frame order, so the first one too new ends the walk
+	while (incoming[player].peek(attack) && attack.frame <= frame)
+	{
+		rows += attack.rows;
+		incoming[player].pop(attack);
+	}
+	return rows;
+}
+
+void GarbageExchange::clear()
+{
+	Attack attack;
+	for (int player{ 0 }; player < PLAYER_COUNT; player++)
+	{
+		while (incoming[player].pop(attack))
+		{
+		}
+	}
+}
@@ -0,0 +1,60 @@
+// A GarbageExchange carries versus attacks between the two games of a match without a lock,
+// so each game can be stepped on whichever thread gets to it: one SpscQueue per direction,
+// and each game's thread only ever push()es to the opponent's queue and pop()s its own.
+//
+// An attack is a # of garbage rows, stamped with the frame it was sent on.  receive() only
+// takes attacks sent before the receiver's current frame, so it doesn't matter which game of
+// the match was stepped first (or whether they were stepped at the same time): the garbage
+// arrives on the same frame every run.  If the opponent's queue is full, send() fails and the
+// attacker keeps the rows to send on its next step, so attacks are late but never lost.
+// clear() is only safe while neither game is being stepped (ie. when a match restarts).
+
+#ifndef GARBAGEEXCHANGE_H
+#define GARBAGEEXCHANGE_H
+
+#include "SpscQueue.h"
+
+class GarbageExchange
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int PLAYER_COUNT = 2;
+	static const size_t CAPACITY = 16;				// attacks in flight per direction
+
+	/// <summary>
+	/// One attack in flight.
+	/// </summary>
+	struct Attack
+	{
+		unsigned int frame{ 0 };					// the sender's frame after the step that sent it
+		int rows{ 0 };
+	};
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	SpscQueue<Attack, CAPACITY> incoming[PLAYER_COUNT];	// attacks waiting for each player
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Sends an attack to the other player (call from fromPlayer's thread).
+	/// </summary>
+	/// <returns>false if the opponent's queue is full (send it again later)</returns>
+	bool send(int fromPlayer, unsigned int frame, int rows);
+
+	/// <summary>
+	/// Takes the attacks waiting for a player that were sent on or before a frame
+	/// (call from that player's thread, with its frame before it steps).
+	/// </summary>
+	/// <returns>the total garbage rows received</returns>
+	int receive(int player, unsigned int frame);
+
+	/// <summary>
+	/// Drops every attack in flight (only while neither player is being stepped).
+	/// </summary>
+	void clear();
+};
+
+#endif /* GARBAGEEXCHANGE_H */
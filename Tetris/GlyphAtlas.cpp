@@ -0,0 +1,73 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <cstring>
+
+const char* const GlyphAtlas::HUD_CHARACTERS{ "0123456789abcdefghijklmnopqrstuvwxyz:.- " };
+const unsigned int GlyphAtlas::ATLAS_WIDTH{ 256 };
+
+bool GlyphAtlas::build(const sf::Image& tiles, const sf::Font& font, unsigned int characterSize)
+{
+	lineSpacing = font.getLineSpacing(characterSize);
+
+	// rasterize every glyph first, so the font's page texture holds them all when it's copied
+	size_t characterCount = std::strlen(HUD_CHARACTERS);
+	int tallestGlyph{ 0 };
+	for (size_t i{ 0 }; i < characterCount; i++)
+	{
+		const sf::Glyph& glyph = font.getGlyph(static_cast<sf::Uint32>(HUD_CHARACTERS[i]), characterSize, false);
+		tallestGlyph = std::max(tallestGlyph, glyph.textureRect.height);
+	}
+	sf::Image page = font.getTexture(characterSize).copyToImage();
+
+	// shelf packing: glyphs left to right in rows below the tiles
+	unsigned int width = std::max(ATLAS_WIDTH, tiles.getSize().x);
+	unsigned int rowHeight = static_cast<unsigned int>(tallestGlyph + 2 * PADDING);
+	unsigned int penX{ 0 };
+	unsigned int penY{ tiles.getSize().y };
+	for (size_t i{ 0 }; i < characterCount; i++)
+	{
+		const sf::Glyph& glyph = font.getGlyph(static_cast<sf::Uint32>(HUD_CHARACTERS[i]), characterSize, false);
+		unsigned int glyphWidth = static_cast<unsigned int>(glyph.textureRect.width) + 2 * PADDING;
+		if (penX + glyphWidth > width)
+		{
+			penX = 0;
+			penY += rowHeight;
+		}
+		AtlasGlyph& baked = glyphs[static_cast<unsigned char>(HUD_CHARACTERS[i])];
+		baked.present = true;
+		baked.advance = glyph.advance;
+		baked.textureRect = sf::FloatRect(static_cast<float>(penX), static_cast<float>(penY),
+			static_cast<float>(glyphWidth), static_cast<float>(glyph.textureRect.height + 2 * PADDING));
+		baked.bounds = sf::FloatRect(glyph.bounds.left - PADDING, glyph.bounds.top - PADDING,
+			glyph.bounds.width + 2 * PADDING, glyph.bounds.height + 2 * PADDING);
+		penX += glyphWidth;
+	}
+
+	sf::Image atlas;
+	atlas.create(width, penY + rowHeight, sf::Color(255, 255, 255, 0));
+	atlas.copy(tiles, 0, 0);
+	for (size_t i{ 0 }; i < characterCount; i++)
+	{
+		const sf::Glyph& glyph = font.getGlyph(static_cast<sf::Uint32>(HUD_CHARACTERS[i]), characterSize, false);
+		const AtlasGlyph& baked = glyphs[static_cast<unsigned char>(HUD_CHARACTERS[i])];
+		if (glyph.textureRect.width > 0 && glyph.textureRect.height > 0)
+		{
+			// the font's page already pads its glyphs, so the padding is copied along with the glyph
+			sf::IntRect source(glyph.textureRect.left - PADDING, glyph.textureRect.top - PADDING,
+				glyph.textureRect.width + 2 * PADDING, glyph.textureRect.height + 2 * PADDING);
+			atlas.copy(page, static_cast<unsigned int>(baked.textureRect.left), static_cast<unsigned int>(baked.textureRect.top), source);
+		}
+	}
+	return texture.loadFromImage(atlas);
+}
+
+const sf::Texture& GlyphAtlas::getTexture() const { return texture; }
+
+const AtlasGlyph& GlyphAtlas::getGlyph(char c) const
+{
+	static const AtlasGlyph MISSING;
+	unsigned char index = static_cast<unsigned char>(c);
+	return index < 128 ? glyphs[index] : MISSING;
+}
+
+float GlyphAtlas::getLineSpacing() const { return lineSpacing; }
@@ -0,0 +1,68 @@
+// The GlyphAtlas is a single texture holding the block tiles and the HUD's glyphs,
+// so the blocks and the HUD text can be drawn from one vertex batch in one draw call.
+//
+//  - the tiles are copied to the top left, so their texture rects don't change
+//    (the block sprite, BoardMesh and the batch all use the atlas in place of tiles.png).
+//  - the glyphs for HUD_CHARACTERS are rasterized once by the font, at one size, and
+//    copied into rows below the tiles.  Characters that aren't in the atlas are skipped when drawn.
+//
+// Built once at startup, and shared by every game (like the block sprite).
+
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <SFML/Graphics.hpp>
+
+/// <summary>
+/// Where a character is in the atlas, and how to place it on a line.
+/// </summary>
+struct AtlasGlyph
+{
+	bool present{ false };			// false if the character wasn't baked
+	sf::FloatRect textureRect;		// in the atlas (including a pixel of padding)
+	sf::FloatRect bounds;			// relative to the pen position on the baseline (with the same padding)
+	float advance{ 0.f };			// how far the pen moves to the next character
+};
+
+class GlyphAtlas
+{
+public:
+	// CONSTANTS
+	static const char* const HUD_CHARACTERS;	// the characters baked into the atlas (digits, lowercase, ':', '.', ' ', '-')
+	static const unsigned int ATLAS_WIDTH;		// pixel width of the atlas (at least the tiles' width), init to 256
+	static const int PADDING = 1;				// transparent pixels around each glyph (so they can be filtered)
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	sf::Texture texture;
+	AtlasGlyph glyphs[128];						// indexed by (ASCII) character
+	float lineSpacing{ 0.f };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Bakes the tiles and the glyphs into the atlas texture.
+	/// </summary>
+	/// <param name="tiles">the block tiles (ie. images/tiles.png)</param>
+	/// <param name="font">the HUD font (only used here: the atlas doesn't need it afterwards)</param>
+	/// <param name="characterSize">the glyph size, in pixels</param>
+	/// <returns>false if the atlas texture couldn't be created</returns>
+	bool build(const sf::Image& tiles, const sf::Font& font, unsigned int characterSize);
+
+	/// <summary>
+	/// Gets the atlas texture (tiles at the top left, glyphs below).
+	/// </summary>
+	const sf::Texture& getTexture() const;
+
+	/// <summary>
+	/// Gets a character's glyph (not present if it wasn't baked).
+	/// </summary>
+	const AtlasGlyph& getGlyph(char c) const;
+
+	/// <summary>
+	/// Gets the distance between the baselines of two lines of text.
+	/// </summary>
+	float getLineSpacing() const;
+};
+
+#endif /* GLYPHATLAS_H */
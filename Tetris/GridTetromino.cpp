@@ -38,3 +38,11 @@ std::vector<Point> GridTetromino::getBlockLocsMappedToGrid() const
 	return mappedLocs;
 }
 
+void GridTetromino::getBlockLocsMappedToGrid(std::vector<Point>& mappedLocs) const
+{
+	mappedLocs.clear();
+	for (auto& pt : blockLocs)
+	{
+		mappedLocs.push_back(Point(gridLoc.getX() + pt.getX(), gridLoc.getY() + pt.getY()));
+	}
+}
\ No newline at end of file
@@ -55,6 +55,13 @@ public:
 	/// <returns>a vector of point objects</returns>
 	std::vector<Point> getBlockLocsMappedToGrid() const;
 
+	/// <summary>
+	/// Same as above, but fills a caller-owned vector instead of building a new one.
+	/// The vector is cleared first, so reusing it across calls keeps its capacity (no reallocation).
+	/// </summary>
+	/// <param name="mappedLocs">the vector to fill with the mapped block locations</param>
+	void getBlockLocsMappedToGrid(std::vector<Point>& mappedLocs) const;
+
 };
 
 #endif /* GRIDTETROMINO_H */
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "HeadlessGame.h"
+
+HeadlessGame::HeadlessGame()
+{
+	reset(0);
+}
+
+void HeadlessGame::reset(unsigned int seed)
+{
+	score = 0;
+	linesCleared = 0;
+	lastClearedRows = 0;
+	piecesPlaced = 0;
+	randomGenerator.seed(seed);
+	board.empty();
+	pickNextShape();
+	gameOver = !spawnNextShape();
+	pickNextShape();
+}
+
+void HeadlessGame::getPlacements(std::vector<Placement>& placements)
+{
+	if (gameOver)
+	{
+		placements.clear();
+		return;
+	}
+	generator.generate(board, currentShape.getShape(), placements);
+}
+
+bool HeadlessGame::applyPlacement(const Placement& placement, int garbageRows, int garbageHole)
+{
+	if (gameOver)
+	{
+		return false;
+	}
+	generator.lockPlacement(board, currentShape.getShape(), placement);
+	piecesPlaced++;
+
+	int completedRows = board.removeCompletedRows();
+	linesCleared += completedRows;
+	lastClearedRows = completedRows;
+	// 100 points for each completed row
+	score += (completedRows * 100);
+
+	// garbage only comes in on a placement that doesn't clear (clearing holds it back)
+	if (completedRows == 0 && garbageRows > 0 && board.insertGarbageRows(garbageRows, garbageHole, GARBAGE_CONTENT))
+	{
+		gameOver = true;
+	}
+	else if (spawnNextShape())
+	{
+		pickNextShape();
+	}
+	else {
+		gameOver = true;
+	}
+	return !gameOver;
+}
+
+const Gameboard& HeadlessGame::getBoard() const { return board; }
+
+const GridTetromino& HeadlessGame::getCurrentShape() const { return currentShape; }
+
+const GridTetromino& HeadlessGame::getNextShape() const { return nextShape; }
+
+int HeadlessGame::getScore() const { return score; }
+
+int HeadlessGame::getLinesCleared() const { return linesCleared; }
+
+int HeadlessGame::getLastClearedRows() const { return lastClearedRows; }
+
+int HeadlessGame::getPiecesPlaced() const { return piecesPlaced; }
+
+bool HeadlessGame::isGameOver() const { return gameOver; }
+
+void HeadlessGame::pickNextShape()
+{
+	// the modulo (rather than a std::uniform_int_distribution) keeps the
+	// shape sequence identical across standard library implementations
+	nextShape.setShape(static_cast<TetShape>(randomGenerator() % static_cast<unsigned int>(TetShape::COUNT)));
+}
+
+bool HeadlessGame::spawnNextShape()
+{
+	currentShape = nextShape;
+	currentShape.setGridLoc(board.getSpawnLoc());
+	return generator.isPositionLegal(board, currentShape);
+}
@@ -0,0 +1,96 @@
+// The HeadlessGame is a tetris game without a window, font or sprites.
+// It follows the same rules as TetrisGame (spawning, locking, removing rows, scoring),
+// but the shapes are placed directly (see PlacementGenerator) rather than moved by ticks and keypresses.
+// Used by the bots and the tools that play thousands of games (ie. the weight tuner).
+//
+// Each game has its own seeded random number generator, so the same seed always
+// produces the same sequence of shapes.  An instance can be reset() and reused
+// for any number of games without allocating.
+
+#ifndef HEADLESSGAME_H
+#define HEADLESSGAME_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "PlacementGenerator.h"
+#include <random>
+
+class HeadlessGame
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int GARBAGE_CONTENT = static_cast<int>(TetColor::BLUE_DARK);	// what garbage rows are made of
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	Gameboard board;					// the gameboard (grid) to represent where all the blocks are.
+	GridTetromino currentShape;			// the tetromino that is waiting to be placed.
+	GridTetromino nextShape;			// the tetromino shape that is "on deck".
+	PlacementGenerator generator;		// used to find and lock placements
+	std::mt19937 randomGenerator;		// picks the shapes (seeded by reset())
+
+	int score{ 0 };						// the current game score (100 points per completed row)
+	int linesCleared{ 0 };				// total # of rows removed
+	int lastClearedRows{ 0 };			// # of rows removed by the last placement
+	int piecesPlaced{ 0 };				// total # of shapes locked onto the board
+	bool gameOver{ false };				// true once a shape can't be spawned
+
+public:
+	// METHODS -------------------------------------------------
+	HeadlessGame();
+
+	/// <summary>
+	/// Resets everything for a new game
+	///		- the score and counters are set to 0
+	///		- the random generator is re-seeded
+	///		- the gameboard is cleared
+	///		- the current shape is spawned, and the next shape picked
+	/// </summary>
+	/// <param name="seed">the seed for the shape sequence</param>
+	void reset(unsigned int seed);
+
+	/// <summary>
+	/// Finds all the placements for the current shape.
+	/// </summary>
+	/// <param name="placements">filled with the placements found (capacity is reused)</param>
+	void getPlacements(std::vector<Placement>& placements);
+
+	/// <summary>
+	/// Places the current shape:
+	///		1) locks it onto the board at the placement
+	///		2) removes completed rows and updates the score
+	///		3) if no rows were removed, pushes in any garbage rows (versus play; if blocks are pushed off the top, the game is over)
+	///		4) spawns the next shape (if it can't be spawned, the game is over)
+	/// </summary>
+	/// <param name="placement">where to place the current shape (should come from getPlacements())</param>
+	/// <param name="garbageRows">the # of garbage rows waiting (see Gameboard::insertGarbageRows())</param>
+	/// <param name="garbageHole">the hole column of the garbage rows</param>
+	/// <returns>false if the game is over, true otherwise</returns>
+	bool applyPlacement(const Placement& placement, int garbageRows = 0, int garbageHole = 0);
+
+	// Getters
+	const Gameboard& getBoard() const;
+	const GridTetromino& getCurrentShape() const;
+	const GridTetromino& getNextShape() const;
+	int getScore() const;
+	int getLinesCleared() const;
+	int getLastClearedRows() const;
+	int getPiecesPlaced() const;
+	bool isGameOver() const;
+
+private:
+	/// <summary>
+	/// Assign nextShape a random shape (from this game's own random generator).
+	/// </summary>
+	void pickNextShape();
+
+	/// <summary>
+	/// Copies the nextShape into the currentShape, and positions it at the spawn location.
+	/// </summary>
+	/// <returns>true if the spawned shape is in a legal position, false otherwise</returns>
+	bool spawnNextShape();
+};
+
+#endif /* HEADLESSGAME_H */
@@ -0,0 +1,83 @@
+#include "HintWorker.h"
+
+HintWorker::HintWorker()
+{
+	worker = std::thread(&HintWorker::run, this);
+}
+
+HintWorker::~HintWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(requestMutex);
+		stopping = true;
+	}
+	requestReady.notify_one();
+	worker.join();
+}
+
+void HintWorker::requestHint(const Gameboard& board, TetShape shape, unsigned int serial)
+{
+	latestSerial.store(serial, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(requestMutex);
+		requestBoard = board;
+		requestShape = shape;
+		requestSerial = serial;
+		requestPending = true;
+	}
+	requestReady.notify_one();
+}
+
+bool HintWorker::tryGetHint(unsigned int serial, Placement& hint) const
+{
+	unsigned long long value = mailbox.load(std::memory_order_acquire);
+	bool valid = ((value >> 24) & 0xFF) != 0;
+	if (!valid || static_cast<unsigned int>(value >> 32) != serial)
+	{
+		return false;
+	}
+	hint.rotations = static_cast<int>((value >> 16) & 0xFF);
+	hint.x = static_cast<int>((value >> 8) & 0xFF) - 128;
+	hint.y = static_cast<int>(value & 0xFF) - 128;
+	return true;
+}
+
+void HintWorker::run()
+{
+	for (;;)
+	{
+		TetShape shape;
+		unsigned int serial;
+		{
+			std::unique_lock<std::mutex> lock(requestMutex);
+			requestReady.wait(lock, [this] { return requestPending || stopping; });
+			if (stopping)
+			{
+				return;
+			}
+			searchBoard = requestBoard;
+			shape = requestShape;
+			serial = requestSerial;
+			requestPending = false;
+		}
+
+		Placement best;
+		if (evaluator.choosePlacement(searchBoard, shape, best))
+		{
+			// the shape may have been placed while we were searching
+			if (latestSerial.load(std::memory_order_relaxed) == serial)
+			{
+				mailbox.store(pack(serial, best), std::memory_order_release);
+			}
+		}
+	}
+}
+
+unsigned long long HintWorker::pack(unsigned int serial, const Placement& placement)
+{
+	return (static_cast<unsigned long long>(serial) << 32)
+		| (1ULL << 24)
+		| (static_cast<unsigned long long>(placement.rotations & 0xFF) << 16)
+		| (static_cast<unsigned long long>((placement.x + 128) & 0xFF) << 8)
+		| static_cast<unsigned long long>((placement.y + 128) & 0xFF);
+}
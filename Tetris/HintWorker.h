@@ -0,0 +1,93 @@
+// The HintWorker finds the best placement for a shape on a background thread,
+// so the game can show a "best placement" ghost without ever waiting on the search.
+//
+//  - requestHint() hands the worker a copy of the board and the shape to place.
+//    The request lock is only held while the board is copied, never during a search.
+//  - the result is published through a lock-free single-slot mailbox (one std::atomic),
+//    tagged with the serial # of the shape it was computed for.
+//  - tryGetHint() only returns a hint whose serial matches the caller's current shape,
+//    so a hint for a shape that has since been placed (a stale hint) is never shown.
+
+#ifndef HINTWORKER_H
+#define HINTWORKER_H
+
+#include "BoardEvaluator.h"
+#include "Gameboard.h"
+#include "PlacementGenerator.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class HintWorker
+{
+	friend class TestSuite;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+
+	// Request members (guarded by requestMutex) -------------------------
+	std::mutex requestMutex;
+	std::condition_variable requestReady;
+	Gameboard requestBoard;					// a copy of the board to search
+	TetShape requestShape{ TetShape::S };	// the shape to place
+	unsigned int requestSerial{ 0 };		// the serial # of the requested shape
+	bool requestPending{ false };			// true until the worker picks up the request
+	bool stopping{ false };					// true when the worker should exit
+
+	// Worker members (only touched by the worker thread) ----------------
+	BoardEvaluator evaluator;				// picks the best placement
+	Gameboard searchBoard;					// the worker's copy of the requested board
+
+	// the mailbox: [serial:32][valid:8][rotations:8][x+128:8][y+128:8]
+	std::atomic<unsigned long long> mailbox{ 0 };
+	std::atomic<unsigned int> latestSerial{ 0 };	// the most recently requested serial (to skip stale requests)
+
+	std::thread worker;
+
+public:
+	// METHODS -------------------------------------------------
+
+	/// <summary>
+	/// Constructor, starts the worker thread.
+	/// </summary>
+	HintWorker();
+
+	/// <summary>
+	/// Destructor, stops and joins the worker thread.
+	/// </summary>
+	~HintWorker();
+
+	HintWorker(const HintWorker&) = delete;
+	HintWorker& operator=(const HintWorker&) = delete;
+
+	/// <summary>
+	/// Asks the worker for the best placement of a shape.
+	/// Any request the worker hasn't started yet is replaced.
+	/// </summary>
+	/// <param name="board">the board to search (copied)</param>
+	/// <param name="shape">the shape to place</param>
+	/// <param name="serial">identifies the shape (should change every time a new shape spawns)</param>
+	void requestHint(const Gameboard& board, TetShape shape, unsigned int serial);
+
+	/// <summary>
+	/// Reads the mailbox without blocking.
+	/// </summary>
+	/// <param name="serial">the serial # of the shape the caller wants a hint for</param>
+	/// <param name="hint">set to the hint, if there is one</param>
+	/// <returns>true if a hint for this serial is ready, false otherwise</returns>
+	bool tryGetHint(unsigned int serial, Placement& hint) const;
+
+private:
+	/// <summary>
+	/// The worker thread: wait for a request, search, publish the result (unless it is already stale).
+	/// </summary>
+	void run();
+
+	/// <summary>
+	/// Packs a placement into a mailbox value.
+	/// </summary>
+	static unsigned long long pack(unsigned int serial, const Placement& placement);
+};
+
+#endif /* HINTWORKER_H */
@@ -0,0 +1,85 @@
+#include "HudText.h"
+#include <cmath>
+
+void HudText::clear()
+{
+	length = 0;
+}
+
+HudText& HudText::append(const char* text)
+{
+	for (; *text != '\0'; text++)
+	{
+		appendChar(*text);
+	}
+	return *this;
+}
+
+HudText& HudText::appendInt(long long value, int minDigits)
+{
+	// negated as unsigned, so the most negative value works too
+	unsigned long long magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+	if (value < 0)
+	{
+		appendChar('-');
+	}
+	// digits come out backwards
+	char digits[20];
+	int count{ 0 };
+	do
+	{
+		digits[count++] = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude > 0);
+	for (int pad{ count }; pad < minDigits; pad++)
+	{
+		appendChar('0');
+	}
+	while (count > 0)
+	{
+		appendChar(digits[--count]);
+	}
+	return *this;
+}
+
+HudText& HudText::appendFixed(double value, int decimals)
+{
+	long long scale{ 1 };
+	for (int i{ 0 }; i < decimals; i++)
+	{
+		scale *= 10;
+	}
+	long long scaled = std::llround(std::fabs(value) * scale);
+	if (value < 0 && scaled > 0)
+	{
+		appendChar('-');
+	}
+	appendInt(scaled / scale);
+	if (decimals > 0)
+	{
+		appendChar('.');
+		appendInt(scaled % scale, decimals);
+	}
+	return *this;
+}
+
+HudText& HudText::appendTime(double seconds)
+{
+	long long wholeSeconds = seconds > 0 ? static_cast<long long>(seconds) : 0;
+	appendInt(wholeSeconds / 60);
+	appendChar(':');
+	appendInt(wholeSeconds % 60, 2);
+	return *this;
+}
+
+int HudText::getLength() const { return length; }
+
+const char* HudText::getChars() const { return chars; }
+
+void HudText::appendChar(char c)
+{
+	if (length < CAPACITY)
+	{
+		chars[length++] = c;
+	}
+}
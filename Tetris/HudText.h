@@ -0,0 +1,78 @@
+// A HudText is one line of HUD text (ie. "score 1200") in a fixed size char buffer.
+// Numbers are written straight into the buffer - no std::string, no snprintf, no allocation -
+// so a HUD field can be rebuilt whenever its value changes without touching the heap.
+// Text past CAPACITY is dropped.
+//
+// The characters are drawn as quads from the GlyphAtlas.
+
+#ifndef HUDTEXT_H
+#define HUDTEXT_H
+
+class HudText
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int CAPACITY = 24;			// the most characters in a line
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	char chars[CAPACITY]{};
+	int length{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Empties the line.
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Appends text (ie. a label).
+	/// </summary>
+	/// <param name="text">a null terminated string</param>
+	/// <returns>this line (so appends can be chained)</returns>
+	HudText& append(const char* text);
+
+	/// <summary>
+	/// Appends an integer (with a '-' if it's negative).
+	/// </summary>
+	/// <param name="value">the integer</param>
+	/// <param name="minDigits">pads with leading zeros up to this many digits (ie. 2 for seconds)</param>
+	/// <returns>this line</returns>
+	HudText& appendInt(long long value, int minDigits = 1);
+
+	/// <summary>
+	/// Appends a number with a fixed # of decimals (rounded).
+	/// </summary>
+	/// <param name="value">the number</param>
+	/// <param name="decimals">digits after the '.'</param>
+	/// <returns>this line</returns>
+	HudText& appendFixed(double value, int decimals);
+
+	/// <summary>
+	/// Appends a time as minutes:seconds (ie. "3:05"), rounded down to the second.
+	/// </summary>
+	/// <param name="seconds">the time in seconds</param>
+	/// <returns>this line</returns>
+	HudText& appendTime(double seconds);
+
+	/// <summary>
+	/// Gets the # of characters in the line.
+	/// </summary>
+	int getLength() const;
+
+	/// <summary>
+	/// Gets the characters (not null terminated, see getLength()).
+	/// </summary>
+	const char* getChars() const;
+
+private:
+	/// <summary>
+	/// Appends one character, if there's room.
+	/// </summary>
+	void appendChar(char c);
+};
+
+#endif /* HUDTEXT_H */
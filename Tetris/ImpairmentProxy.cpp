@@ -0,0 +1,320 @@
+#include "ImpairmentProxy.h"
+#include "LatencyStats.h"
+#include "LockstepConnection.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+ImpairmentProxy::ImpairmentProxy(Protocol protocol, const ImpairmentSettings& settings)
+	: protocol{ protocol }, toTarget{ settings, protocol == Protocol::TCP },
+	toClient{ getReturnSettings(settings), protocol == Protocol::TCP }
+{
+	releaseBuffer.reserve(MAX_DATAGRAM);
+}
+
+bool ImpairmentProxy::start(unsigned short listenPort, const sf::IpAddress& targetAddress, unsigned short targetPort)
+{
+	this->targetAddress = targetAddress;
+	this->targetPort = targetPort;
+	startTime = std::chrono::steady_clock::now();
+	if (protocol == Protocol::TCP)
+	{
+		if (listener.listen(listenPort, sf::IpAddress::LocalHost) != sf::Socket::Done)
+		{
+			return false;
+		}
+		listener.setBlocking(false);
+		return true;
+	}
+	if (clientSide.bind(listenPort, sf::IpAddress::LocalHost) != sf::Socket::Done || targetSide.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+	{
+		return false;
+	}
+	clientSide.setBlocking(false);
+	targetSide.setBlocking(false);
+	return true;
+}
+
+bool ImpairmentProxy::update()
+{
+	if (protocol == Protocol::TCP)
+	{
+		return updateTcp();
+	}
+	updateUdp();
+	return true;
+}
+
+unsigned short ImpairmentProxy::getListenPort() const
+{
+	return protocol == Protocol::TCP ? listener.getLocalPort() : clientSide.getLocalPort();
+}
+
+const NetworkImpairment& ImpairmentProxy::getToTarget() const { return toTarget; }
+
+const NetworkImpairment& ImpairmentProxy::getToClient() const { return toClient; }
+
+bool ImpairmentProxy::isConnected() const { return protocol == Protocol::TCP ? connected : clientPort != 0; }
+
+ImpairmentSettings ImpairmentProxy::getReturnSettings(const ImpairmentSettings& settings)
+{
+	ImpairmentSettings returnSettings = settings;
+	returnSettings.seed = settings.seed + 1;
+	return returnSettings;
+}
+
+double ImpairmentProxy::getNowMs() const
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+bool ImpairmentProxy::updateTcp()
+{
+	if (!connected)
+	{
+		if (listener.accept(clientSocket) != sf::Socket::Done)
+		{
+			return true;
+		}
+		if (targetSocket.connect(targetAddress, targetPort, sf::seconds(5.0f)) != sf::Socket::Done)
+		{
+			std::cout << "proxy: couldn't connect to " << targetAddress << ":" << targetPort << "\n";
+			clientSocket.disconnect();
+			return true;
+		}
+		clientSocket.setBlocking(false);
+		targetSocket.setBlocking(false);
+		connected = true;
+	}
+
+	double nowMs = getNowMs();
+	if (!relayStream(clientSocket, toTarget, targetSocket, targetBacklog, nowMs)
+		|| !relayStream(targetSocket, toClient, clientSocket, clientBacklog, nowMs))
+	{
+		disconnect();
+		return false;
+	}
+	return true;
+}
+
+bool ImpairmentProxy::relayStream(sf::TcpSocket& from, NetworkImpairment& impairment, sf::TcpSocket& to, std::vector<unsigned char>& backlog, double nowMs)
+{
+	for (;;)
+	{
+		std::size_t received{ 0 };
+		sf::Socket::Status status = from.receive(receiveBuffer, MAX_DATAGRAM, received);
+		if (status == sf::Socket::Done)
+		{
+			impairment.submit(receiveBuffer, received, nowMs);
+		}
+		else if (status == sf::Socket::NotReady)
+		{
+			break;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while (impairment.release(nowMs, releaseBuffer))
+	{
+		backlog.insert(backlog.end(), releaseBuffer.begin(), releaseBuffer.end());
+	}
+	if (!backlog.empty())
+	{
+		std::size_t sent{ 0 };
+		sf::Socket::Status status = to.send(backlog.data(), backlog.size(), sent);
+		if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+		{
+			return false;
+		}
+		backlog.erase(backlog.begin(), backlog.begin() + static_cast<std::ptrdiff_t>(sent));
+	}
+	return true;
+}
+
+void ImpairmentProxy::disconnect()
+{
+	clientSocket.disconnect();
+	targetSocket.disconnect();
+	toTarget.clear();
+	toClient.clear();
+	clientBacklog.clear();
+	targetBacklog.clear();
+	connected = false;
+}
+
+void ImpairmentProxy::updateUdp()
+{
+	double nowMs = getNowMs();
+	std::size_t received{ 0 };
+	sf::IpAddress sender;
+	unsigned short senderPort{ 0 };
+	while (clientSide.receive(receiveBuffer, MAX_DATAGRAM, received, sender, senderPort) == sf::Socket::Done)
+	{
+		// the first address to send to the proxy is its client
+		if (clientPort == 0)
+		{
+			clientAddress = sender;
+			clientPort = senderPort;
+		}
+		if (sender == clientAddress && senderPort == clientPort)
+		{
+			toTarget.submit(receiveBuffer, received, nowMs);
+		}
+	}
+	while (targetSide.receive(receiveBuffer, MAX_DATAGRAM, received, sender, senderPort) == sf::Socket::Done)
+	{
+		if (sender == targetAddress && senderPort == targetPort)
+		{
+			toClient.submit(receiveBuffer, received, nowMs);
+		}
+	}
+
+	while (toTarget.release(nowMs, releaseBuffer))
+	{
+		targetSide.send(releaseBuffer.data(), releaseBuffer.size(), targetAddress, targetPort);
+	}
+	while (clientPort != 0 && toClient.release(nowMs, releaseBuffer))
+	{
+		clientSide.send(releaseBuffer.data(), releaseBuffer.size(), clientAddress, clientPort);
+	}
+}
+
+void ImpairmentProxy::runProxy(Protocol protocol, unsigned short listenPort, const sf::IpAddress& targetAddress, unsigned short targetPort,
+	const ImpairmentSettings& settings)
+{
+	ImpairmentProxy proxy(protocol, settings);
+	if (!proxy.start(listenPort, targetAddress, targetPort))
+	{
+		std::cout << "couldn't listen on port " << listenPort << "\n";
+		return;
+	}
+	std::cout << (protocol == Protocol::TCP ? "tcp" : "udp") << " proxy on 127.0.0.1:" << proxy.getListenPort() << " -> " << targetAddress << ":" << targetPort
+		<< " (latency " << settings.latencyMs << " ms, jitter " << settings.jitterMs << " ms, loss " << settings.lossPercent << "%, duplicates "
+		<< settings.duplicatePercent << "%, reordering " << settings.reorderPercent << "%)\n";
+
+	const double REPORT_MS{ 5000.0 };
+	double nextReportMs{ REPORT_MS };
+	for (;;)
+	{
+		if (!proxy.update())
+		{
+			std::cout << "connection closed, waiting for a new client\n";
+		}
+		if (proxy.getNowMs() >= nextReportMs)
+		{
+			nextReportMs += REPORT_MS;
+			const NetworkImpairment* directions[]{ &proxy.getToTarget(), &proxy.getToClient() };
+			for (const NetworkImpairment* direction : directions)
+			{
+				std::cout << (direction == &proxy.getToTarget() ? "to target: " : "to client: ") << direction->getPacketsReleased() << " of "
+					<< direction->getPacketsSubmitted() << " packets relayed (" << direction->getBytesReleased() << " bytes), "
+					<< direction->getPacketsDropped() << " dropped, " << direction->getPacketsRetransmitted() << " retransmitted, "
+					<< direction->getPacketsDuplicated() << " duplicated, " << direction->getPacketsReordered() << " reordered, "
+					<< direction->getHeldCount() << " in flight\n";
+			}
+		}
+		sf::sleep(sf::microseconds(500));
+	}
+}
+
+void ImpairmentProxy::runHarness(const ImpairmentSettings& settings, double seconds)
+{
+	const double FRAME_MS{ 1000.0 / 60.0 };
+
+	// host <- proxy <- joiner, all on 127.0.0.1
+	sf::TcpListener hostListener;
+	ImpairmentProxy proxy(Protocol::TCP, settings);
+	sf::TcpSocket hostSocket;
+	sf::TcpSocket joinSocket;
+	if (hostListener.listen(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done
+		|| !proxy.start(sf::Socket::AnyPort, sf::IpAddress::LocalHost, hostListener.getLocalPort())
+		|| joinSocket.connect(sf::IpAddress::LocalHost, proxy.getListenPort(), sf::seconds(5.0f)) != sf::Socket::Done)
+	{
+		std::cout << "couldn't set up the proxy over loopback\n";
+		return;
+	}
+	for (int attempt{ 0 }; attempt < 5000 && !proxy.isConnected(); attempt++)
+	{
+		proxy.update();
+		sf::sleep(sf::milliseconds(1));
+	}
+	if (!proxy.isConnected() || hostListener.accept(hostSocket) != sf::Socket::Done)
+	{
+		std::cout << "the proxy couldn't connect the peers\n";
+		return;
+	}
+
+	LockstepPeer peers[LockstepPeer::PLAYER_COUNT]{ LockstepPeer(0), LockstepPeer(1) };
+	LockstepConnection connections[LockstepPeer::PLAYER_COUNT]{ LockstepConnection(hostSocket, peers[0]), LockstepConnection(joinSocket, peers[1]) };
+	peers[0].host(2024);
+
+	std::mt19937 random[LockstepPeer::PLAYER_COUNT]{ std::mt19937(1), std::mt19937(2) };
+	const unsigned char INPUTS[]{ LockstepGame::INPUT_LEFT, LockstepGame::INPUT_RIGHT, LockstepGame::INPUT_ROTATE,
+		LockstepGame::INPUT_SOFT_DROP, LockstepGame::INPUT_HARD_DROP };
+
+	LatencyStats delays(LockstepPeer::PLAYER_COUNT, LockstepPeer::INPUT_DELAY, static_cast<size_t>(seconds * 60.0 * LockstepPeer::PLAYER_COUNT) + 1);
+	unsigned long long stalls[LockstepPeer::PLAYER_COUNT]{};
+	unsigned long long ticks{ 0 };
+
+	bool connected{ true };
+	double nextFrameMs{ proxy.getNowMs() };
+	double endMs{ nextFrameMs + seconds * 1000.0 };
+	while (connected && proxy.getNowMs() < endMs)
+	{
+		connected = proxy.update();
+		for (int player{ 0 }; player < LockstepPeer::PLAYER_COUNT; player++)
+		{
+			connected = connections[player].pump() && connected;
+		}
+
+		double nowMs = proxy.getNowMs();
+		if (nowMs < nextFrameMs)
+		{
+			sf::sleep(sf::microseconds(250));
+			continue;
+		}
+		// a game tick: each peer enters an input, and simulates what it can
+		nextFrameMs += FRAME_MS;
+		ticks++;
+		for (int player{ 0 }; player < LockstepPeer::PLAYER_COUNT; player++)
+		{
+			LockstepPeer& peer = peers[player];
+			if (peer.canAddLocalInput())
+			{
+				unsigned int roll = random[player]() % 16;
+				delays.inputEntered(player, nowMs);
+				peer.addLocalInput(roll < 5 ? INPUTS[roll] : 0);
+			}
+			unsigned int before = peer.getFrame();
+			while (peer.advance()) {};
+			if (peer.getFrame() == before && peer.isStarted())
+			{
+				stalls[player]++;
+			}
+			for (unsigned int frame{ before }; frame < peer.getFrame(); frame++)
+			{
+				delays.frameSimulated(player, frame, nowMs);
+			}
+		}
+	}
+
+	double averageMs = delays.getAverage();
+
+	std::cout << "network: latency " << settings.latencyMs << " ms, jitter " << settings.jitterMs << " ms, loss " << settings.lossPercent
+		<< "% (tcp, so lost chunks stall " << NetworkImpairment::RETRANSMIT_MS << " ms), each way\n";
+	std::cout << std::min(peers[0].getFrame(), peers[1].getFrame()) << " frames in " << ticks << " ticks ("
+		<< seconds << " sec at 60 fps)" << (connected ? "" : ", connection lost") << "\n";
+	std::cout << "input delay: avg " << averageMs << " ms (" << averageMs / FRAME_MS << " frames), p95 " << delays.getPercentile(0.95) << " ms, max " << delays.getMax()
+		<< " ms (the fixed delay is " << LockstepPeer::INPUT_DELAY << " frames)\n";
+	for (int player{ 0 }; player < LockstepPeer::PLAYER_COUNT; player++)
+	{
+		std::cout << (player == 0 ? "host: " : "join: ") << stalls[player] << " stalled ticks (" << (ticks > 0 ? 100.0 * stalls[player] / ticks : 0.0)
+			<< "%), 0 rollbacks (lockstep waits instead), " << (peers[player].isDesynced() ? "DESYNC at frame " + std::to_string(peers[player].getDesyncFrame()) : "no desync")
+			<< "\n";
+	}
+	std::cout << "proxy: " << proxy.getToTarget().getPacketsRetransmitted() + proxy.getToClient().getPacketsRetransmitted() << " of "
+		<< proxy.getToTarget().getPacketsSubmitted() + proxy.getToClient().getPacketsSubmitted() << " chunks retransmitted\n";
+}
@@ -0,0 +1,136 @@
+// The ImpairmentProxy is a local relay that makes a good network bad, so online play can be
+// tested (and tuned) against the same latency, jitter, loss, duplication and reordering every run,
+// without any outside infrastructure.  A client connects to the proxy instead of the game it wants,
+// the proxy forwards its traffic to the target, and each direction goes through a NetworkImpairment:
+//  - TCP: the proxy accepts one client on its sf::TcpListener, connects to the target, and relays
+//    the byte stream both ways (an ordered impairment: loss shows up as retransmission stalls).
+//  - UDP: datagrams from the client (the first address that sends to the proxy) go to the target
+//    from a second sf::UdpSocket, and the target's replies go back to the client.  Every
+//    impairment applies.
+// Everything is non-blocking: update() moves whatever has arrived into the impairments, and sends
+// whatever is due.  It should be called at least once a millisecond or so (the delays are only as
+// fine as the calls).
+//
+// runHarness() plays two headless LockstepPeers through a TCP proxy in real time (60 frames/sec)
+// and reports the input delay (from entering an input to it being simulated), the frames each peer
+// stalled waiting for the other, the rollbacks (lockstep waits rather than rolling back, so these
+// stay 0) and any desyncs.
+
+#ifndef IMPAIRMENTPROXY_H
+#define IMPAIRMENTPROXY_H
+
+#include <SFML/Network.hpp>
+#include <chrono>
+#include <vector>
+#include "NetworkImpairment.h"
+
+class ImpairmentProxy
+{
+	friend class TestSuite;
+
+public:
+	enum class Protocol { TCP, UDP };
+
+	// CONSTANTS
+	static const size_t MAX_DATAGRAM = 2048;		// the largest packet relayed (and the TCP read size)
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	Protocol protocol;
+	NetworkImpairment toTarget;					// client -> target
+	NetworkImpairment toClient;					// target -> client
+	sf::IpAddress targetAddress;
+	unsigned short targetPort{ 0 };
+	std::chrono::steady_clock::time_point startTime;
+
+	// TCP members -------------------------------------------------------
+	sf::TcpListener listener;
+	sf::TcpSocket clientSocket;
+	sf::TcpSocket targetSocket;
+	bool connected{ false };
+	std::vector<unsigned char> clientBacklog;		// released to the client, not yet sent (a Partial send)
+	std::vector<unsigned char> targetBacklog;		// released to the target, not yet sent
+
+	// UDP members -------------------------------------------------------
+	sf::UdpSocket clientSide;					// bound to the proxy's port
+	sf::UdpSocket targetSide;					// talks to the target
+	sf::IpAddress clientAddress;
+	unsigned short clientPort{ 0 };				// 0 until the client has sent something
+
+	unsigned char receiveBuffer[MAX_DATAGRAM];
+	std::vector<unsigned char> releaseBuffer;	// reused by every release()
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="protocol">TCP or UDP</param>
+	/// <param name="settings">the impairment of each direction (the target -> client direction
+	/// gets the seed + 1, so the two directions aren't identical)</param>
+	ImpairmentProxy(Protocol protocol, const ImpairmentSettings& settings);
+
+	/// <summary>
+	/// Starts listening for the client, on 127.0.0.1.
+	/// </summary>
+	/// <param name="listenPort">the proxy's port (sf::Socket::AnyPort picks a free one)</param>
+	/// <param name="targetAddress">where the client's traffic goes</param>
+	/// <param name="targetPort">and the port</param>
+	/// <returns>false if the port couldn't be bound</returns>
+	bool start(unsigned short listenPort, const sf::IpAddress& targetAddress, unsigned short targetPort);
+
+	/// <summary>
+	/// Relays whatever has arrived and whatever is due (never blocks, except to connect to the
+	/// target when a TCP client arrives).
+	/// </summary>
+	/// <returns>false if a TCP connection has closed (the proxy listens for a new client)</returns>
+	bool update();
+
+	/// <summary>
+	/// Gets the port the proxy is listening on.
+	/// </summary>
+	unsigned short getListenPort() const;
+
+	const NetworkImpairment& getToTarget() const;
+	const NetworkImpairment& getToClient() const;
+	bool isConnected() const;
+
+	/// <summary>
+	/// Runs a proxy until the process is stopped, printing the traffic every 5 sec.
+	/// </summary>
+	static void runProxy(Protocol protocol, unsigned short listenPort, const sf::IpAddress& targetAddress, unsigned short targetPort,
+		const ImpairmentSettings& settings);
+
+	/// <summary>
+	/// Plays two headless lockstep peers through a TCP proxy for a while, and reports the
+	/// input delay, stalls, rollbacks and desyncs.
+	/// </summary>
+	static void runHarness(const ImpairmentSettings& settings, double seconds);
+
+private:
+	/// <summary>
+	/// Gets the settings of the target -> client direction (the same, with the next seed).
+	/// </summary>
+	static ImpairmentSettings getReturnSettings(const ImpairmentSettings& settings);
+
+	/// <summary>
+	/// Gets the time since start(), in ms.
+	/// </summary>
+	double getNowMs() const;
+
+	/// <summary>
+	/// TCP: reads the socket into the impairment, and sends the backlog and what's due.
+	/// </summary>
+	/// <returns>false if the socket has closed</returns>
+	bool relayStream(sf::TcpSocket& from, NetworkImpairment& impairment, sf::TcpSocket& to, std::vector<unsigned char>& backlog, double nowMs);
+
+	/// <summary>
+	/// Closes the TCP connections and drops what was in flight.
+	/// </summary>
+	void disconnect();
+
+	bool updateTcp();
+	void updateUdp();
+};
+
+#endif /* IMPAIRMENTPROXY_H */
@@ -0,0 +1,57 @@
+#include "LatencyStats.h"
+#include <algorithm>
+#include <cmath>
+
+LatencyStats::LatencyStats(int playerCount, int inputDelay, size_t expectedSamples)
+	: inputDelay{ inputDelay }, enteredMs(static_cast<size_t>(playerCount) * DELAY_RING), inputsEntered(static_cast<size_t>(playerCount))
+{
+	samples.reserve(expectedSamples);
+}
+
+void LatencyStats::inputEntered(int player, double nowMs)
+{
+	enteredMs[player * DELAY_RING + inputsEntered[player] % DELAY_RING] = nowMs;
+	inputsEntered[player]++;
+}
+
+void LatencyStats::frameSimulated(int player, unsigned int frame, double nowMs)
+{
+	if (frame >= static_cast<unsigned int>(inputDelay))
+	{
+		add(nowMs - enteredMs[player * DELAY_RING + (frame - inputDelay) % DELAY_RING]);
+	}
+}
+
+void LatencyStats::add(double sample) { samples.push_back(sample); }
+
+size_t LatencyStats::getCount() const { return samples.size(); }
+
+double LatencyStats::getAverage() const
+{
+	double total{ 0.0 };
+	for (double sample : samples)
+	{
+		total += sample;
+	}
+	return samples.empty() ? 0.0 : total / samples.size();
+}
+
+double LatencyStats::getMax() const { return samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end()); }
+
+double LatencyStats::getPercentile(double fraction)
+{
+	sortScratch = samples;
+	return getPercentile(sortScratch.data(), static_cast<int>(sortScratch.size()), fraction);
+}
+
+double LatencyStats::getPercentile(double* samples, int count, double fraction)
+{
+	if (count <= 0)
+	{
+		return 0.0;
+	}
+	int rank = static_cast<int>(std::ceil(fraction * count)) - 1;
+	rank = std::max(0, std::min(rank, count - 1));
+	std::nth_element(samples, samples + rank, samples + count);
+	return samples[rank];
+}
@@ -0,0 +1,74 @@
+// LatencyStats collects latency samples for the network harnesses' reports: the average, a
+// percentile and the max.  It also turns simulated frames into input delays: a peer's local input
+// k is simulated at frame k + inputDelay, so inputEntered() records when each input went in (in a
+// ring of DELAY_RING per player), and frameSimulated() adds the delay once its frame is simulated.
+//
+// getPercentile() is the one nearest rank percentile, shared with the FrameProfiler, the
+// MatchServer and MatchmakingLoad (which keep their own preallocated samples).
+
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <cstddef>
+#include <vector>
+
+class LatencyStats
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int DELAY_RING = 256;			// more than the inputs a peer can have waiting
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	int inputDelay;								// the frames between entering an input and simulating it
+	std::vector<double> enteredMs;				// a DELAY_RING for each player: when each input was entered
+	std::vector<unsigned int> inputsEntered;	// per player
+	std::vector<double> samples;
+	std::vector<double> sortScratch;			// scratch for the percentiles
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor.
+	/// </summary>
+	/// <param name="playerCount">the # of players entering inputs</param>
+	/// <param name="inputDelay">the frames between entering an input and simulating it</param>
+	/// <param name="expectedSamples">the # of samples to reserve room for</param>
+	LatencyStats(int playerCount, int inputDelay, size_t expectedSamples);
+
+	/// <summary>
+	/// Records when a player entered their next local input.
+	/// </summary>
+	void inputEntered(int player, double nowMs);
+
+	/// <summary>
+	/// Records a player's frame being simulated: adds the delay of the input it simulates
+	/// (frames before inputDelay have no local input).
+	/// </summary>
+	void frameSimulated(int player, unsigned int frame, double nowMs);
+
+	/// <summary>
+	/// Adds a sample.
+	/// </summary>
+	void add(double sample);
+
+	// Getters (0 with no samples)
+	size_t getCount() const;
+	double getAverage() const;
+	double getMax() const;
+
+	/// <summary>
+	/// Gets a percentile (0-1) of the samples.
+	/// </summary>
+	double getPercentile(double fraction);
+
+	/// <summary>
+	/// Gets a percentile (0-1) of the first count samples using nearest rank (0 if count is 0).
+	/// The samples are reordered.
+	/// </summary>
+	static double getPercentile(double* samples, int count, double fraction);
+};
+
+#endif /* LATENCYSTATS_H */
@@ -0,0 +1,132 @@
+#include "LineClearAnimator.h"
+#include <algorithm>
+
+const double LineClearAnimator::FLASH_SECONDS{ 0.15 };
+const double LineClearAnimator::BLINK_SECONDS{ 0.05 };
+const double LineClearAnimator::COLLAPSE_SECONDS{ 0.2 };
+const double LineClearAnimator::PARTICLE_SECONDS{ 0.6 };
+const float LineClearAnimator::PARTICLE_SIZE{ 0.3f };
+const float LineClearAnimator::GRAVITY{ 40.f };
+
+LineClearAnimator::LineClearAnimator()
+{
+	quads.reserve(MAX_EFFECTS);
+}
+
+void LineClearAnimator::start(const Gameboard::ClearedRows& cleared)
+{
+	for (int row{ 0 }; row < cleared.count; row++)
+	{
+		float y = static_cast<float>(cleared.rows[row]);
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			int colour = cleared.contents[row][x];
+			float left = static_cast<float>(x);
+			spawn(EffectKind::FLASH, left, y, colour, 0.0, FLASH_SECONDS);
+			spawn(EffectKind::COLLAPSE, left, y, colour, FLASH_SECONDS, COLLAPSE_SECONDS);
+			for (int particle{ 0 }; particle < PARTICLES_PER_BLOCK; particle++)
+			{
+				float centre = 0.5f - PARTICLE_SIZE / 2;
+				Effect* effect = spawn(EffectKind::PARTICLE, left + centre, y + centre, colour, FLASH_SECONDS, PARTICLE_SECONDS);
+				if (effect)
+				{
+					effect->velocityX = getRandom(-4.f, 4.f);
+					effect->velocityY = getRandom(-10.f, -3.f);
+				}
+			}
+		}
+	}
+}
+
+void LineClearAnimator::update(double seconds)
+{
+	for (int i{ 0 }; i < activeCount; )
+	{
+		Effect& effect = effects[i];
+		effect.age += seconds;
+		if (effect.age >= effect.delay + effect.duration)
+		{
+			// swap the last effect into this slot (order doesn't matter), and look at this slot again
+			effect = effects[--activeCount];
+			continue;
+		}
+		if (effect.kind == EffectKind::PARTICLE && effect.age > effect.delay)
+		{
+			// only the part of the step after the delay moves the particle
+			float moving = static_cast<float>(std::min(seconds, effect.age - effect.delay));
+			effect.velocityY += GRAVITY * moving;
+			effect.x += effect.velocityX * moving;
+			effect.y += effect.velocityY * moving;
+		}
+		i++;
+	}
+}
+
+const std::vector<EffectQuad>& LineClearAnimator::buildQuads()
+{
+	quads.clear();
+	for (int i{ 0 }; i < activeCount; i++)
+	{
+		const Effect& effect = effects[i];
+		if (effect.age < effect.delay)
+		{
+			continue;
+		}
+		float progress = static_cast<float>((effect.age - effect.delay) / effect.duration);
+		EffectQuad quad;
+		quad.x = effect.x;
+		quad.y = effect.y;
+		quad.colour = effect.colour;
+		switch (effect.kind)
+		{
+			case EffectKind::FLASH:
+				// on for a blink, off for a blink
+				if (static_cast<int>(effect.age / BLINK_SECONDS) % 2 == 1)
+				{
+					continue;
+				}
+				break;
+			case EffectKind::COLLAPSE:
+				quad.height = 1.f - progress;
+				quad.y += progress / 2;
+				quad.alpha = static_cast<unsigned char>(255 * (1.f - progress));
+				break;
+			case EffectKind::PARTICLE:
+				quad.width = PARTICLE_SIZE;
+				quad.height = PARTICLE_SIZE;
+				quad.alpha = static_cast<unsigned char>(255 * (1.f - progress));
+				break;
+		}
+		quads.push_back(quad);
+	}
+	return quads;
+}
+
+int LineClearAnimator::getActiveCount() const { return activeCount; }
+
+void LineClearAnimator::clear() { activeCount = 0; }
+
+LineClearAnimator::Effect* LineClearAnimator::spawn(EffectKind kind, float x, float y, int colour, double delay, double duration)
+{
+	if (activeCount == MAX_EFFECTS)
+	{
+		return nullptr;
+	}
+	Effect& effect = effects[activeCount++];
+	effect = Effect();
+	effect.kind = kind;
+	effect.x = x;
+	effect.y = y;
+	effect.colour = colour;
+	effect.delay = delay;
+	effect.duration = duration;
+	return &effect;
+}
+
+float LineClearAnimator::getRandom(float low, float high)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return low + (high - low) * static_cast<float>(randomState & 0xFFFFFF) / static_cast<float>(0x1000000);
+}
@@ -0,0 +1,118 @@
+// The LineClearAnimator plays the line clear effects on the render side, so the
+// simulation never waits for an animation (the rows are gone from the board straight away,
+// the effects are drawn over it).
+//
+// It's driven by the rows Gameboard::removeCompletedRows() reports: each cleared block
+//  - FLASHes (blinks) in place,
+//  - then COLLAPSEs (shrinks to its centre line and fades),
+//  - and throws off PARTICLEs that fall away under gravity.
+//
+// The effects live in a fixed pool (no allocation while playing; when it's full, new effects
+// are dropped) and are advanced with the frame delta by update().  buildQuads() turns them
+// into one quad each, which the game adds to the same batch as the blocks.
+
+#ifndef LINECLEARANIMATOR_H
+#define LINECLEARANIMATOR_H
+
+#include "Gameboard.h"
+#include <vector>
+
+enum class EffectKind { FLASH, COLLAPSE, PARTICLE };
+
+/// <summary>
+/// One effect, ready to draw as a (tile textured) quad.  Units are blocks, from the top left of the gameboard.
+/// </summary>
+struct EffectQuad
+{
+	float x{ 0.f };
+	float y{ 0.f };
+	float width{ 1.f };
+	float height{ 1.f };
+	int colour{ 0 };				// the tile to draw (a TetColor)
+	unsigned char alpha{ 255 };
+};
+
+class LineClearAnimator
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int MAX_EFFECTS = 512;			// the pool size (a 4 row clear uses 160)
+	static const int PARTICLES_PER_BLOCK = 2;
+	static const double FLASH_SECONDS;			// how long a cleared block blinks, init to 0.15
+	static const double BLINK_SECONDS;			// half a blink, init to 0.05
+	static const double COLLAPSE_SECONDS;		// how long a block takes to collapse (after the flash), init to 0.2
+	static const double PARTICLE_SECONDS;		// how long a particle lives (after the flash), init to 0.6
+	static const float PARTICLE_SIZE;			// in blocks, init to 0.3
+	static const float GRAVITY;					// particle acceleration, in blocks/sec/sec, init to 40
+
+private:
+	/// <summary>
+	/// An effect in the pool.
+	/// </summary>
+	struct Effect
+	{
+		EffectKind kind{ EffectKind::FLASH };
+		float x{ 0.f };						// top left, in blocks
+		float y{ 0.f };
+		float velocityX{ 0.f };				// PARTICLE: in blocks/sec
+		float velocityY{ 0.f };
+		int colour{ 0 };
+		double age{ 0.0 };					// seconds since the effect was started
+		double delay{ 0.0 };				// seconds before it's drawn (ie. a collapse waits for the flash)
+		double duration{ 0.0 };				// seconds it's drawn for
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	Effect effects[MAX_EFFECTS];			// effects[0 .. activeCount) are playing
+	int activeCount{ 0 };
+	std::vector<EffectQuad> quads;			// buildQuads() output (reserved for MAX_EFFECTS)
+	unsigned int randomState{ 0x9E3779B9u };	// xorshift state for the particle velocities
+
+public:
+	// METHODS -------------------------------------------------
+	LineClearAnimator();
+
+	/// <summary>
+	/// Starts the effects for rows that were just cleared.
+	/// </summary>
+	/// <param name="cleared">the rows (see Gameboard::removeCompletedRows())</param>
+	void start(const Gameboard::ClearedRows& cleared);
+
+	/// <summary>
+	/// Advances every effect, removing the ones that have finished.
+	/// </summary>
+	/// <param name="seconds">the time since the last update (ie. the frame delta)</param>
+	void update(double seconds);
+
+	/// <summary>
+	/// Builds a quad for every effect that's showing (effects still in their delay, or blinked off, are skipped).
+	/// </summary>
+	/// <returns>the quads, valid until the next buildQuads()</returns>
+	const std::vector<EffectQuad>& buildQuads();
+
+	/// <summary>
+	/// Gets the # of effects playing (including ones waiting out their delay).
+	/// </summary>
+	int getActiveCount() const;
+
+	/// <summary>
+	/// Stops every effect.
+	/// </summary>
+	void clear();
+
+private:
+	/// <summary>
+	/// Adds an effect to the pool.
+	/// </summary>
+	/// <returns>the effect to fill in, or nullptr if the pool is full</returns>
+	Effect* spawn(EffectKind kind, float x, float y, int colour, double delay, double duration);
+
+	/// <summary>
+	/// Gets a random float in [low, high) (xorshift: cheap, and the same every run).
+	/// </summary>
+	float getRandom(float low, float high);
+};
+
+#endif /* LINECLEARANIMATOR_H */
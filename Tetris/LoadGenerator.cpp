@@ -0,0 +1,157 @@
+#include "LoadGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "FramePacer.h"
+#include "LockstepGame.h"
+#include "MatchServer.h"
+
+LoadGenerator::LoadGenerator(int matches, unsigned int seed)
+	: randomState{ seed != 0 ? seed : 1 }
+{
+	int clientCount = (matches + MATCHES_PER_CLIENT - 1) / MATCHES_PER_CLIENT;
+	for (int i{ 0 }; i < clientCount; i++)
+	{
+		clients.push_back(std::unique_ptr<Client>(new Client()));
+		clients.back()->matchesRequested = std::min(static_cast<int>(MATCHES_PER_CLIENT), matches - i * MATCHES_PER_CLIENT);
+	}
+}
+
+bool LoadGenerator::connect(const sf::IpAddress& address, unsigned short port)
+{
+	for (std::unique_ptr<Client>& client : clients)
+	{
+		if (client->socket.connect(address, port, sf::seconds(5.0f)) != sf::Socket::Done)
+		{
+			return false;
+		}
+		client->socket.setBlocking(false);
+		client->open = true;
+		client->outgoing << MatchServer::MESSAGE_OPEN << static_cast<sf::Uint16>(client->matchesRequested);
+	}
+	return true;
+}
+
+void LoadGenerator::tick()
+{
+	const unsigned char KEYS[]{ LockstepGame::INPUT_LEFT, LockstepGame::INPUT_RIGHT, LockstepGame::INPUT_ROTATE,
+		LockstepGame::INPUT_SOFT_DROP, LockstepGame::INPUT_HARD_DROP };
+	for (std::unique_ptr<Client>& client : clients)
+	{
+		if (!client->open)
+		{
+			continue;
+		}
+		for (int match{ 0 }; match < client->matchesOpened; match++)
+		{
+			sf::Uint8 bits[2]{};
+			for (sf::Uint8& playerBits : bits)
+			{
+				unsigned int roll = nextRandom();
+				playerBits = (roll % INPUT_CHANCE == 0) ? KEYS[(roll / INPUT_CHANCE) % 5] : 0;
+			}
+			// nothing pressed is the same as no message
+			if (bits[0] != 0 || bits[1] != 0)
+			{
+				client->outgoing << MatchServer::MESSAGE_INPUT << static_cast<sf::Uint16>(match) << bits[0] << bits[1];
+				inputsSent++;
+			}
+		}
+
+		// inputs made while the last packet is still going out are dropped, like a congested link would
+		if (!client->inFlight && client->outgoing.getDataSize() > 0)
+		{
+			client->sending = client->outgoing;
+			client->inFlight = true;
+		}
+		client->outgoing.clear();
+		if (client->inFlight)
+		{
+			sf::Socket::Status status = client->socket.send(client->sending);
+			client->inFlight = status == sf::Socket::Partial || status == sf::Socket::NotReady;
+			client->open = status != sf::Socket::Disconnected && status != sf::Socket::Error;
+		}
+
+		for (sf::Socket::Status status = client->socket.receive(client->received); status == sf::Socket::Done;
+			status = client->socket.receive(client->received))
+		{
+			handleMessages(*client);
+		}
+	}
+}
+
+void LoadGenerator::run(const std::atomic<bool>& stop)
+{
+	FramePacer pacer(MatchServer::TICKS_PER_SECOND);
+	pacer.setMode(PacingMode::LIMITED);
+	while (!stop)
+	{
+		tick();
+		pacer.waitForNextFrame();
+	}
+}
+
+int LoadGenerator::getClientCount() const { return static_cast<int>(clients.size()); }
+
+int LoadGenerator::getMatchesOpened() const
+{
+	int opened{ 0 };
+	for (const std::unique_ptr<Client>& client : clients)
+	{
+		opened += client->matchesOpened;
+	}
+	return opened;
+}
+
+unsigned long long LoadGenerator::getInputsSent() const { return inputsSent; }
+
+unsigned long long LoadGenerator::getStatusReceived() const { return statusReceived; }
+
+void LoadGenerator::runLoadGenerator(const sf::IpAddress& address, unsigned short port, int matches)
+{
+	LoadGenerator load(matches, static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
+	if (!load.connect(address, port))
+	{
+		std::cout << "couldn't connect to " << address << ":" << port << "\n";
+		return;
+	}
+	std::cout << "playing " << matches << " matches over " << load.getClientCount() << " connections\n";
+	std::atomic<bool> stop{ false };
+	load.run(stop);
+}
+
+unsigned int LoadGenerator::nextRandom()
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+void LoadGenerator::handleMessages(Client& client)
+{
+	while (!client.received.endOfPacket())
+	{
+		sf::Uint8 type{ 0 };
+		client.received >> type;
+		if (type == MatchServer::MESSAGE_OPENED)
+		{
+			sf::Uint16 first{ 0 };
+			sf::Uint16 count{ 0 };
+			client.received >> first >> count;
+			client.matchesOpened = first + count;
+		}
+		else if (type == MatchServer::MESSAGE_STATUS)
+		{
+			sf::Uint16 match{ 0 };
+			sf::Uint32 frame{ 0 };
+			sf::Uint32 scores[2]{};
+			client.received >> match >> frame >> scores[0] >> scores[1];
+			statusReceived++;
+		}
+		else
+		{
+			return;
+		}
+	}
+}
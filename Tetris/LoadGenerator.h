@@ -0,0 +1,96 @@
+// The LoadGenerator is a local client for load testing the MatchServer: it opens a number of
+// matches over a few connections (MATCHES_PER_CLIENT per connection, since select() limits how
+// many sockets the server can watch), then plays every match like a pair of players tapping keys
+// - each tick, each player of each match presses a random key with a chance of 1 in INPUT_CHANCE.
+// A client's inputs for a tick go out in one packet.
+//
+// Used by MatchServer::runBenchmark() (on its own thread) and by the --loadgen mode.
+
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <SFML/Network.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class LoadGenerator
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int MATCHES_PER_CLIENT = 50;
+	static const int INPUT_CHANCE = 8;				// a player presses a key on 1 in 8 ticks
+
+private:
+	/// <summary>
+	/// A connection to the server, and the matches it opened.
+	/// </summary>
+	struct Client
+	{
+		sf::TcpSocket socket;
+		sf::Packet outgoing;						// this tick's inputs
+		sf::Packet sending;							// the packet being sent
+		sf::Packet received;
+		bool inFlight{ false };
+		int matchesRequested{ 0 };
+		int matchesOpened{ 0 };
+		bool open{ false };
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	std::vector<std::unique_ptr<Client>> clients;
+	unsigned int randomState;						// xorshift
+	unsigned long long inputsSent{ 0 };
+	unsigned long long statusReceived{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="matches">the # of matches to open (spread over the clients)</param>
+	/// <param name="seed">seeds the random inputs</param>
+	LoadGenerator(int matches, unsigned int seed);
+
+	/// <summary>
+	/// Connects every client, and asks for its matches.
+	/// </summary>
+	/// <returns>false if a client couldn't connect</returns>
+	bool connect(const sf::IpAddress& address, unsigned short port);
+
+	/// <summary>
+	/// Sends one tick of inputs for every match, and reads what the server sent.
+	/// </summary>
+	void tick();
+
+	/// <summary>
+	/// Runs ticks at the server's rate until stop is set.
+	/// </summary>
+	void run(const std::atomic<bool>& stop);
+
+	// Getters
+	int getClientCount() const;
+	int getMatchesOpened() const;
+	unsigned long long getInputsSent() const;
+	unsigned long long getStatusReceived() const;
+
+	/// <summary>
+	/// Loads a server until it's stopped (the --loadgen mode).
+	/// </summary>
+	static void runLoadGenerator(const sf::IpAddress& address, unsigned short port, int matches);
+
+private:
+	/// <summary>
+	/// Gets the next random #.
+	/// </summary>
+	unsigned int nextRandom();
+
+	/// <summary>
+	/// Reads the OPENED and STATUS messages in a packet.
+	/// </summary>
+	void handleMessages(Client& client);
+};
+
+#endif /* LOADGENERATOR_H */
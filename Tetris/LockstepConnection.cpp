@@ -0,0 +1,202 @@
+#include "LockstepConnection.h"
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include "FramePacer.h"
+#include "TerminalInput.h"
+#include "TerminalRenderer.h"
+
+LockstepConnection::LockstepConnection(sf::TcpSocket& socket, LockstepPeer& peer)
+	: socket{ socket }, peer{ peer }
+{
+	socket.setBlocking(false);
+}
+
+bool LockstepConnection::pump()
+{
+	// messages queued while a packet is still going out wait for the next one
+	if (!sending && !peer.getOutgoing().empty())
+	{
+		sendPacket.clear();
+		for (const LockstepMessage& message : peer.getOutgoing())
+		{
+			sendPacket.append(message.bytes, static_cast<size_t>(message.size));
+		}
+		peer.clearOutgoing();
+		bytesSent += sendPacket.getDataSize() + PACKET_HEADER_BYTES;
+		packetsSent++;
+		sending = true;
+	}
+	if (sending)
+	{
+		sf::Socket::Status status = socket.send(sendPacket);
+		if (status == sf::Socket::Done)
+		{
+			sending = false;
+		}
+		else if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+		{
+			return false;
+		}
+	}
+
+	while (true)
+	{
+		sf::Socket::Status status = socket.receive(receivePacket);
+		if (status == sf::Socket::Done)
+		{
+			if (!peer.receive(static_cast<const unsigned char*>(receivePacket.getData()), receivePacket.getDataSize()))
+			{
+				return false;
+			}
+		}
+		else if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+		{
+			return false;
+		}
+		else
+		{
+			return true;
+		}
+	}
+}
+
+unsigned long long LockstepConnection::getBytesSent() const { return bytesSent; }
+
+unsigned long long LockstepConnection::getPacketsSent() const { return packetsSent; }
+
+void LockstepConnection::runLoopbackTest(int frames)
+{
+	const double TIMEOUT_SECONDS{ 60.0 };
+	sf::TcpListener listener;
+	sf::TcpSocket hostSocket;
+	sf::TcpSocket joinSocket;
+	if (listener.listen(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done
+		|| joinSocket.connect(sf::IpAddress::LocalHost, listener.getLocalPort(), sf::seconds(5.0f)) != sf::Socket::Done
+		|| listener.accept(hostSocket) != sf::Socket::Done)
+	{
+		std::cout << "couldn't connect over loopback\n";
+		return;
+	}
+
+	LockstepPeer peers[LockstepPeer::PLAYER_COUNT]{ LockstepPeer(0), LockstepPeer(1) };
+	LockstepConnection connections[LockstepPeer::PLAYER_COUNT]{ LockstepConnection(hostSocket, peers[0]), LockstepConnection(joinSocket, peers[1]) };
+	peers[0].host(2024);
+
+	// each player taps a random input every few frames
+	std::mt19937 random[LockstepPeer::PLAYER_COUNT]{ std::mt19937(1), std::mt19937(2) };
+	const unsigned char INPUTS[]{ LockstepGame::INPUT_LEFT, LockstepGame::INPUT_RIGHT, LockstepGame::INPUT_ROTATE,
+		LockstepGame::INPUT_SOFT_DROP, LockstepGame::INPUT_HARD_DROP };
+
+	auto start = std::chrono::steady_clock::now();
+	double seconds{ 0.0 };
+	bool connected{ true };
+	unsigned int target = static_cast<unsigned int>(frames);
+	while (connected && (peers[0].getFrame() < target || peers[1].getFrame() < target) && seconds < TIMEOUT_SECONDS)
+	{
+		for (int player{ 0 }; player < LockstepPeer::PLAYER_COUNT; player++)
+		{
+			if (peers[player].canAddLocalInput())
+			{
+				unsigned int roll = random[player]() % 16;
+				peers[player].addLocalInput(roll < 5 ? INPUTS[roll] : 0);
+			}
+			connected = connected && connections[player].pump();
+			while (peers[player].getFrame() < target && peers[player].advance()) {};
+		}
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	unsigned int simulated = std::min(peers[0].getFrame(), peers[1].getFrame());
+	bool matched = peers[0].getFrame() == peers[1].getFrame() && peers[0].getStateHash() == peers[1].getStateHash();
+	std::cout << simulated << " frames over loopback in " << seconds << " sec (" << (seconds > 0 ? simulated / seconds : 0.0) << " frames/sec)\n";
+	for (int player{ 0 }; player < LockstepPeer::PLAYER_COUNT; player++)
+	{
+		std::cout << (player == 0 ? "host: " : "join: ") << connections[player].getBytesSent() << " bytes in "
+			<< connections[player].getPacketsSent() << " packets, "
+			<< (simulated > 0 ? static_cast<double>(connections[player].getBytesSent()) / simulated : 0.0) << " bytes/frame, score "
+			<< peers[player].getGame(player).getScore() << (peers[player].isDesynced() ? ", DESYNC at frame " + std::to_string(peers[player].getDesyncFrame()) : "") << "\n";
+	}
+	std::cout << (simulated / LockstepPeer::HASH_INTERVAL) << " state hashes compared, final states "
+		<< (matched ? "match" : "DIFFER") << (connected ? "" : " (connection lost)") << "\n";
+}
+
+void LockstepConnection::runInTerminal(bool hosting, const std::string& address, unsigned short port)
+{
+	sf::TcpSocket socket;
+	if (hosting)
+	{
+		sf::TcpListener listener;
+		std::cout << "waiting for a player on port " << port << "...\n";
+		if (listener.listen(port) != sf::Socket::Done || listener.accept(socket) != sf::Socket::Done)
+		{
+			std::cout << "couldn't accept a connection\n";
+			return;
+		}
+	}
+	else if (socket.connect(sf::IpAddress(address), port, sf::seconds(10.0f)) != sf::Socket::Done)
+	{
+		std::cout << "couldn't connect to " << address << ":" << port << "\n";
+		return;
+	}
+
+	LockstepPeer peer(hosting ? 0 : 1);
+	LockstepConnection connection(socket, peer);
+	if (hosting)
+	{
+		peer.host(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
+	}
+
+	const int BOARD_WIDTH{ Gameboard::MAX_X * TerminalRenderer::CELL_WIDTH + 2 };
+	TerminalRenderer renderer(BOARD_WIDTH * 2 + 6, Gameboard::MAX_Y + 5);
+	TerminalInput input;
+	FramePacer pacer(60.0);
+	pacer.setMode(PacingMode::LIMITED);
+	unsigned char heldBits{ 0 };		// keys pressed since the last input was entered
+	bool connected{ true };
+	bool quit{ false };
+	while (!quit && connected)
+	{
+		for (TerminalKey key = input.readKey(); key != TerminalKey::NONE; key = input.readKey())
+		{
+			switch (key)
+			{
+				case TerminalKey::LEFT: heldBits |= LockstepGame::INPUT_LEFT; break;
+				case TerminalKey::RIGHT: heldBits |= LockstepGame::INPUT_RIGHT; break;
+				case TerminalKey::UP: heldBits |= LockstepGame::INPUT_ROTATE; break;
+				case TerminalKey::DOWN: heldBits |= LockstepGame::INPUT_SOFT_DROP; break;
+				case TerminalKey::SPACE: heldBits |= LockstepGame::INPUT_HARD_DROP; break;
+				case TerminalKey::QUIT: quit = true; break;
+				default: break;
+			}
+		}
+		if (peer.addLocalInput(heldBits))
+		{
+			heldBits = 0;
+		}
+		connected = connection.pump();
+		while (peer.advance()) {};
+
+		renderer.clear();
+		for (int player{ 0 }; player < LockstepPeer::PLAYER_COUNT; player++)
+		{
+			const LockstepGame& game = peer.getGame(player);
+			int left = 1 + player * (BOARD_WIDTH + 4);
+			renderer.drawGameboard(game.getBoard(), left, 1);
+			renderer.drawTetromino(game.getFallingShape(), left, 1);
+			std::string label = (player == peer.getLocalPlayer() ? "you: " : "them: ") + std::to_string(game.getScore());
+			renderer.drawText(left, Gameboard::MAX_Y + 2, game.isGameOver() ? label + " (over)" : label);
+		}
+		std::string status = !peer.isStarted() ? "waiting for the host..."
+			: peer.isDesynced() ? "DESYNC at frame " + std::to_string(peer.getDesyncFrame())
+			: "frame " + std::to_string(peer.getFrame()) + ", " + std::to_string(peer.getFrame() > 0 ? connection.getBytesSent() / peer.getFrame() : 0) + " bytes/frame";
+		renderer.drawText(1, Gameboard::MAX_Y + 3, status);
+		renderer.writeFrame(stdout);
+		pacer.waitForNextFrame();
+	}
+	std::fputs(TerminalRenderer::getRestoreSequence(), stdout);
+	std::cout << (connected ? "" : "connection lost, ") << peer.getFrame() << " frames, " << connection.getBytesSent() << " bytes sent"
+		<< (peer.isDesynced() ? ", desynced at frame " + std::to_string(peer.getDesyncFrame()) : "") << "\n";
+}
@@ -0,0 +1,69 @@
+// A LockstepConnection carries a LockstepPeer's messages over an sf::TcpSocket.
+// The socket is non-blocking, so pump() never waits: the messages the peer queued since the
+// last pump are sent together as one sf::Packet (a 4 byte length, then ~2 bytes per frame),
+// and every packet that has arrived is handed to the peer.  A Partial send keeps its packet
+// until the rest of it goes out (SFML needs the same packet to be sent again).
+//
+// TCP keeps the inputs in order (the peers rely on that to know which frame an input is for),
+// and SFML turns off Nagle's algorithm, so each frame's packet goes out right away.
+//
+// runLoopbackTest() plays two peers against each other through a real socket on 127.0.0.1
+// in one process, and runInTerminal() plays a versus match between two terminals.
+
+#ifndef LOCKSTEPCONNECTION_H
+#define LOCKSTEPCONNECTION_H
+
+#include <SFML/Network.hpp>
+#include <string>
+#include "LockstepPeer.h"
+
+class LockstepConnection
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const unsigned short DEFAULT_PORT = 53000;
+	static const int PACKET_HEADER_BYTES = 4;		// sf::Packet's length prefix
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	sf::TcpSocket& socket;
+	LockstepPeer& peer;
+	sf::Packet sendPacket;							// the packet being sent (reused)
+	bool sending{ false };							// true while sendPacket hasn't all gone out
+	sf::Packet receivePacket;						// reused
+	unsigned long long bytesSent{ 0 };				// including the packets' length prefixes
+	unsigned long long packetsSent{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor: the socket must be connected, it's switched to non-blocking.
+	/// </summary>
+	LockstepConnection(sf::TcpSocket& socket, LockstepPeer& peer);
+
+	/// <summary>
+	/// Sends the peer's outgoing messages and receives the other peer's (never blocks).
+	/// </summary>
+	/// <returns>false if the connection was lost or the other peer sent something invalid</returns>
+	bool pump();
+
+	unsigned long long getBytesSent() const;
+	unsigned long long getPacketsSent() const;
+
+	/// <summary>
+	/// Plays two peers (with random inputs) over a TCP connection to 127.0.0.1 in this process,
+	/// and reports the frames/sec, the bytes per frame, and whether the state hashes matched.
+	/// </summary>
+	/// <param name="frames">the # of frames to simulate</param>
+	static void runLoopbackTest(int frames);
+
+	/// <summary>
+	/// Plays a versus match in a text terminal: the host listens on the port, the other player
+	/// connects to the host's address.  Both boards are shown, with the desync status.
+	/// </summary>
+	static void runInTerminal(bool hosting, const std::string& address, unsigned short port);
+};
+
+#endif /* LOCKSTEPCONNECTION_H */
@@ -0,0 +1,182 @@
+#include "LockstepGame.h"
+#include <algorithm>
+
+const int LockstepGame::ATTACK_ROWS[]{ 0, 0, 1, 2, 4 };
+
+LockstepGame::LockstepGame()
+{
+	reset(0);
+}
+
+void LockstepGame::reset(unsigned int seed)
+{
+	game.reset(seed);
+	fallingShape = game.getCurrentShape();
+	fallingRotations = 0;
+	framesUntilFall = FRAMES_PER_ROW;
+	frame = 0;
+	pendingGarbage = 0;
+	attack = 0;
+	holeRandom = seed * 2654435761u + 1;
+}
+
+void LockstepGame::step(unsigned char inputs)
+{
+	if (game.isGameOver())
+	{
+		return;
+	}
+	frame++;
+	if (inputs & INPUT_ROTATE)
+	{
+		attemptRotate();
+	}
+	if (inputs & INPUT_LEFT)
+	{
+		attemptMove(-1, 0);
+	}
+	if (inputs & INPUT_RIGHT)
+	{
+		attemptMove(1, 0);
+	}
+	if (inputs & INPUT_SOFT_DROP)
+	{
+		attemptMove(0, 1);
+	}
+	if (inputs & INPUT_HARD_DROP)
+	{
+		while (attemptMove(0, 1)) {};
+		lock();
+		return;
+	}
+	if (--framesUntilFall <= 0)
+	{
+		framesUntilFall = FRAMES_PER_ROW;
+		// if the shape can't fall, it's locked
+		if (!attemptMove(0, 1))
+		{
+			lock();
+		}
+	}
+}
+
+unsigned long long LockstepGame::getStateHash() const
+{
+	unsigned long long hash = game.getBoard().getHash();
+	unsigned long long values[]{
+		static_cast<unsigned long long>(static_cast<int>(fallingShape.getShape())),
+		static_cast<unsigned long long>(fallingRotations),
+		static_cast<unsigned long long>(fallingShape.getGridLoc().getX() & 0xFF),
+		static_cast<unsigned long long>(fallingShape.getGridLoc().getY() & 0xFF),
+		static_cast<unsigned long long>(game.getScore()),
+		static_cast<unsigned long long>(frame),
+		static_cast<unsigned long long>(pendingGarbage),
+		static_cast<unsigned long long>(attack),
+		static_cast<unsigned long long>(framesUntilFall),
+		static_cast<unsigned long long>(holeRandom)
+	};
+	// FNV-1a, continued from the board's hash
+	for (unsigned long long value : values)
+	{
+		hash ^= value;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+void LockstepGame::receiveGarbage(int rows)
+{
+	pendingGarbage += std::max(0, rows);
+}
+
+int LockstepGame::getAttack() const { return attack; }
+
+void LockstepGame::clearAttack() { attack = 0; }
+
+int LockstepGame::applyVersusPlacement(HeadlessGame& game, const Placement& placement, int& pendingGarbage, unsigned int& holeRandom)
+{
+	int garbage = std::min(pendingGarbage, static_cast<int>(MAX_GARBAGE_PER_LOCK));
+	int hole{ 0 };
+	if (garbage > 0)
+	{
+		holeRandom = holeRandom * 1103515245u + 12345u;
+		hole = static_cast<int>((holeRandom >> 16) % Gameboard::MAX_X);
+	}
+	game.applyPlacement(placement, garbage, hole);
+
+	int cleared = std::min(game.getLastClearedRows(), 4);
+	if (cleared == 0)
+	{
+		pendingGarbage -= garbage;
+		return 0;
+	}
+	// an attack cancels the garbage waiting to come in before any of it is sent
+	int cancelled = std::min(ATTACK_ROWS[cleared], pendingGarbage);
+	pendingGarbage -= cancelled;
+	return ATTACK_ROWS[cleared] - cancelled;
+}
+
+void LockstepGame::exchangeAttacks(LockstepGame& first, LockstepGame& second)
+{
+	int firstAttack = first.attack;
+	first.receiveGarbage(second.attack);
+	second.receiveGarbage(firstAttack);
+	first.attack = 0;
+	second.attack = 0;
+}
+
+const Gameboard& LockstepGame::getBoard() const { return game.getBoard(); }
+
+const GridTetromino& LockstepGame::getFallingShape() const { return fallingShape; }
+
+int LockstepGame::getFallingRotations() const { return fallingRotations; }
+
+const GridTetromino& LockstepGame::getNextShape() const { return game.getNextShape(); }
+
+int LockstepGame::getScore() const { return game.getScore(); }
+
+int LockstepGame::getLinesCleared() const { return game.getLinesCleared(); }
+
+unsigned int LockstepGame::getFrame() const { return frame; }
+
+int LockstepGame::getPendingGarbage() const { return pendingGarbage; }
+
+bool LockstepGame::isGameOver() const { return game.isGameOver(); }
+
+bool LockstepGame::attemptMove(int x, int y)
+{
+	GridTetromino temp = fallingShape;
+	temp.move(x, y);
+	if (generator.isPositionLegal(game.getBoard(), temp))
+	{
+		fallingShape = temp;
+		return true;
+	}
+	return false;
+}
+
+bool LockstepGame::attemptRotate()
+{
+	GridTetromino temp = fallingShape;
+	temp.rotateClockwise();
+	if (generator.isPositionLegal(game.getBoard(), temp))
+	{
+		fallingShape = temp;
+		fallingRotations = (fallingRotations + 1) % 4;
+		return true;
+	}
+	return false;
+}
+
+void LockstepGame::lock()
+{
+	Placement placement;
+	placement.rotations = fallingRotations;
+	placement.x = fallingShape.getGridLoc().getX();
+	placement.y = fallingShape.getGridLoc().getY();
+
+	attack += applyVersusPlacement(game, placement, pendingGarbage, holeRandom);
+	fallingShape = game.getCurrentShape();
+	fallingRotations = 0;
+	framesUntilFall = FRAMES_PER_ROW;
+}
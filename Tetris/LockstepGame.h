@@ -0,0 +1,138 @@
+// The LockstepGame is one player's game in a lockstep versus match: it's advanced one frame
+// at a time by step(), and the only thing that changes it is the input bitmask for that frame.
+// Everything is integer (gravity is counted in frames, not seconds) and the shapes come from a
+// HeadlessGame's seeded generator, so two machines given the same seed and the same inputs
+// always end up in exactly the same state - that's what lets lockstep peers send only inputs.
+//
+// The rules are the same as TerminalGame's: the falling shape is moved here, and its
+// placement is handed to HeadlessGame::applyPlacement() when it locks.
+//
+// Versus garbage: clearing 2, 3 or 4 rows at once attacks the opponent with 1, 2 or 4 rows
+// (ATTACK_ROWS), which first cancel any garbage waiting to come in, and the rest is collected
+// by getAttack()/clearAttack().  Garbage received (receiveGarbage()) waits until a shape locks
+// without clearing, then up to MAX_GARBAGE_PER_LOCK rows are pushed in under the board, with a
+// hole column picked by the game's own generator (so lockstep peers agree on it).
+
+#ifndef LOCKSTEPGAME_H
+#define LOCKSTEPGAME_H
+
+#include "HeadlessGame.h"
+#include "PlacementGenerator.h"
+
+class LockstepGame
+{
+	friend class TestSuite;
+
+public:
+	// INPUT BITS (one byte per frame)
+	static const unsigned char INPUT_LEFT = 1;
+	static const unsigned char INPUT_RIGHT = 2;
+	static const unsigned char INPUT_ROTATE = 4;
+	static const unsigned char INPUT_SOFT_DROP = 8;
+	static const unsigned char INPUT_HARD_DROP = 16;
+
+	// CONSTANTS
+	static const int FRAMES_PER_ROW = 30;		// gravity: the shape falls a row every 30 frames (0.5 sec at 60 fps)
+	static const int ATTACK_ROWS[];				// garbage rows sent for 0-4 rows cleared, init to { 0, 0, 1, 2, 4 }
+	static const int MAX_GARBAGE_PER_LOCK = 8;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	HeadlessGame game;							// the board, shape sequence and score
+	GridTetromino fallingShape;					// the current shape where the player has moved it
+	int fallingRotations{ 0 };					// # of clockwise rotations of the fallingShape (0-3)
+	PlacementGenerator generator;				// legality tests
+	int framesUntilFall{ FRAMES_PER_ROW };
+	unsigned int frame{ 0 };					// # of frames stepped since reset()
+	int pendingGarbage{ 0 };					// garbage rows received and not yet pushed in
+	int attack{ 0 };							// garbage rows to send to the opponent
+	unsigned int holeRandom{ 1 };				// picks the garbage hole columns (seeded by reset())
+
+public:
+	// METHODS -------------------------------------------------
+	LockstepGame();
+
+	/// <summary>
+	/// Starts a new game.
+	/// </summary>
+	/// <param name="seed">the seed for the shape sequence (both players of a match get the same one)</param>
+	void reset(unsigned int seed);
+
+	/// <summary>
+	/// Advances one frame: the inputs are applied in a fixed order (rotate, left, right,
+	/// soft drop, hard drop), then gravity.  Does nothing once the game is over.
+	/// </summary>
+	/// <param name="inputs">the INPUT_ bits held this frame</param>
+	void step(unsigned char inputs);
+
+	/// <summary>
+	/// Queues garbage rows from the opponent (pushed in at the next lock that doesn't clear).
+	/// </summary>
+	void receiveGarbage(int rows);
+
+	/// <summary>
+	/// Applies a placement under the versus garbage rules (shared with Tournament's turn based
+	/// matches): up to MAX_GARBAGE_PER_LOCK pending rows are pushed in if the placement doesn't clear,
+	/// otherwise the attack cancels pending garbage first.
+	/// </summary>
+	/// <param name="game">the game to place in</param>
+	/// <param name="placement">the placement</param>
+	/// <param name="pendingGarbage">the game's garbage waiting to come in, updated</param>
+	/// <param name="holeRandom">the game's hole column generator state, updated</param>
+	/// <returns>the garbage rows to send to the opponent</returns>
+	static int applyVersusPlacement(HeadlessGame& game, const Placement& placement, int& pendingGarbage, unsigned int& holeRandom);
+
+	/// <summary>
+	/// Sends each game's attack to the other, once both have stepped a frame (peers do this for
+	/// both games of a match, so they agree on it).
+	/// </summary>
+	static void exchangeAttacks(LockstepGame& first, LockstepGame& second);
+
+	/// <summary>
+	/// Gets the garbage rows this game is sending (collected since clearAttack()).
+	/// </summary>
+	int getAttack() const;
+
+	/// <summary>
+	/// Clears the attack, once it has been sent.
+	/// </summary>
+	void clearAttack();
+
+	/// <summary>
+	/// Hashes everything step() depends on (the board, the falling shape, the score, the frame,
+	/// the garbage and attack rows, the gravity countdown and the hole generator), for the lockstep
+	/// desync detector.  The shape sequence isn't hashed, it only depends on the seed.
+	/// </summary>
+	unsigned long long getStateHash() const;
+
+	// Getters
+	const Gameboard& getBoard() const;
+	const GridTetromino& getFallingShape() const;
+	int getFallingRotations() const;
+	const GridTetromino& getNextShape() const;
+	int getScore() const;
+	int getLinesCleared() const;
+	unsigned int getFrame() const;
+	int getPendingGarbage() const;
+	bool isGameOver() const;
+
+private:
+	/// <summary>
+	/// Moves the fallingShape if the new position is legal.
+	/// </summary>
+	/// <returns>true if it moved</returns>
+	bool attemptMove(int x, int y);
+
+	/// <summary>
+	/// Rotates the fallingShape clockwise if the rotation is legal.
+	/// </summary>
+	/// <returns>true if it rotated</returns>
+	bool attemptRotate();
+
+	/// <summary>
+	/// Locks the fallingShape where it is, and spawns the next shape.
+	/// </summary>
+	void lock();
+};
+
+#endif /* LOCKSTEPGAME_H */
@@ -0,0 +1,177 @@
+#include "LockstepPeer.h"
+
+LockstepPeer::LockstepPeer(int localPlayer)
+	: localPlayer{ localPlayer }
+{
+	outgoing.reserve(64);
+}
+
+void LockstepPeer::host(unsigned int seed)
+{
+	start(seed);
+	queueMessage(MESSAGE_HELLO, seed, 4);
+}
+
+bool LockstepPeer::receive(const unsigned char* data, size_t size)
+{
+	int remotePlayer = 1 - localPlayer;
+	size_t position{ 0 };
+	while (position < size)
+	{
+		unsigned char type = data[position];
+		size_t remaining = size - position;
+		if (type == MESSAGE_HELLO && remaining >= 5)
+		{
+			// only the joiner is sent a HELLO, and only once: another one would restart the match
+			if (localPlayer == 0 || started)
+			{
+				return false;
+			}
+			start(static_cast<unsigned int>(readValue(data + position + 1, 4)));
+			position += 5;
+		}
+		else if (type == MESSAGE_INPUT && remaining >= 2 && started)
+		{
+			// the other peer can't get more than INPUT_DELAY frames past this one's inputs, so the ring never fills
+			if (inputFrames[remotePlayer] - frame >= static_cast<unsigned int>(INPUT_RING))
+			{
+				return false;
+			}
+			inputs[remotePlayer][inputFrames[remotePlayer] % INPUT_RING] = data[position + 1];
+			inputFrames[remotePlayer]++;
+			position += 2;
+		}
+		else if (type == MESSAGE_HASH && remaining >= 13 && started)
+		{
+			unsigned int hashFrame = static_cast<unsigned int>(readValue(data + position + 1, 4));
+			recordHash(remoteHashes, localHashes, hashFrame, readValue(data + position + 5, 8));
+			position += 13;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool LockstepPeer::canAddLocalInput() const
+{
+	return started && inputFrames[localPlayer] < frame + INPUT_DELAY + 1;
+}
+
+bool LockstepPeer::addLocalInput(unsigned char bits)
+{
+	if (!canAddLocalInput())
+	{
+		return false;
+	}
+	inputs[localPlayer][inputFrames[localPlayer] % INPUT_RING] = bits;
+	inputFrames[localPlayer]++;
+	queueMessage(MESSAGE_INPUT, bits, 1);
+	return true;
+}
+
+bool LockstepPeer::advance()
+{
+	if (!started || frame >= inputFrames[0] || frame >= inputFrames[1])
+	{
+		return false;
+	}
+	for (int player{ 0 }; player < PLAYER_COUNT; player++)
+	{
+		games[player].step(inputs[player][frame % INPUT_RING]);
+	}
+	// garbage crosses once both games have stepped (as in MatchPool), both peers do the same
+	LockstepGame::exchangeAttacks(games[0], games[1]);
+	frame++;
+	if (frame % HASH_INTERVAL == 0)
+	{
+		unsigned long long hash = getStateHash();
+		recordHash(localHashes, remoteHashes, frame, hash);
+		queueMessage(MESSAGE_HASH, frame, 4, hash, 8);
+	}
+	return true;
+}
+
+const std::vector<LockstepMessage>& LockstepPeer::getOutgoing() const { return outgoing; }
+
+void LockstepPeer::clearOutgoing() { outgoing.clear(); }
+
+unsigned long long LockstepPeer::getStateHash() const
+{
+	return games[0].getStateHash() * 31 + games[1].getStateHash();
+}
+
+bool LockstepPeer::isStarted() const { return started; }
+
+bool LockstepPeer::isDesynced() const { return desynced; }
+
+unsigned int LockstepPeer::getDesyncFrame() const { return desyncFrame; }
+
+unsigned int LockstepPeer::getFrame() const { return frame; }
+
+int LockstepPeer::getLocalPlayer() const { return localPlayer; }
+
+const LockstepGame& LockstepPeer::getGame(int player) const { return games[player]; }
+
+void LockstepPeer::start(unsigned int seed)
+{
+	this->seed = seed;
+	for (int player{ 0 }; player < PLAYER_COUNT; player++)
+	{
+		games[player].reset(seed);
+		for (int i{ 0 }; i < INPUT_DELAY; i++)
+		{
+			inputs[player][i] = 0;
+		}
+		inputFrames[player] = INPUT_DELAY;
+	}
+	for (int i{ 0 }; i < HASH_RING; i++)
+	{
+		localHashes[i] = HashRecord();
+		remoteHashes[i] = HashRecord();
+	}
+	frame = 0;
+	desynced = false;
+	started = true;
+}
+
+void LockstepPeer::recordHash(HashRecord* records, const HashRecord* otherRecords, unsigned int hashFrame, unsigned long long hash)
+{
+	int slot = static_cast<int>((hashFrame / HASH_INTERVAL) % HASH_RING);
+	records[slot].frame = hashFrame;
+	records[slot].hash = hash;
+	records[slot].present = true;
+	const HashRecord& other = otherRecords[slot];
+	if (other.present && other.frame == hashFrame && other.hash != hash && !desynced)
+	{
+		desynced = true;
+		desyncFrame = hashFrame;
+	}
+}
+
+void LockstepPeer::queueMessage(unsigned char type, unsigned long long value, int valueBytes, unsigned long long extra, int extraBytes)
+{
+	LockstepMessage message;
+	message.bytes[message.size++] = type;
+	for (int i{ 0 }; i < valueBytes; i++)
+	{
+		message.bytes[message.size++] = static_cast<unsigned char>(value >> (8 * i));
+	}
+	for (int i{ 0 }; i < extraBytes; i++)
+	{
+		message.bytes[message.size++] = static_cast<unsigned char>(extra >> (8 * i));
+	}
+	outgoing.push_back(message);
+}
+
+unsigned long long LockstepPeer::readValue(const unsigned char* data, int bytes)
+{
+	unsigned long long value{ 0 };
+	for (int i{ 0 }; i < bytes; i++)
+	{
+		value |= static_cast<unsigned long long>(data[i]) << (8 * i);
+	}
+	return value;
+}
@@ -0,0 +1,166 @@
+// A LockstepPeer is one side of a deterministic lockstep versus match.  Both peers
+// simulate both players' games (LockstepGames); the only things sent are:
+//  - HELLO:	the seed (host -> joiner, once, any other HELLO is an error)	[1][seed x4]
+//  - INPUT:	this peer's input bitmask for its next frame				[1][bits]
+//  - HASH:		the match's state hash every HASH_INTERVAL frames			[1][frame x4][hash x8]
+// so a frame costs 2 bytes of messages (plus the transport's framing), instead of board states.
+// Messages are self-delimiting (a fixed size per type) so several can share one packet, and
+// frame #s are implied by the order inputs arrive in (the transport must be ordered, ie. TCP).
+//
+// A local input is applied INPUT_DELAY frames after it's entered, which hides the round trip:
+// a frame is only simulated once both players' inputs for it are known.
+//
+// Each frame, once both games have stepped, the rows one game's clears attack with are sent to
+// the other's garbage (receiveGarbage()), so versus works the same as on the MatchServer.
+//
+// The desync detector: each peer hashes the Gameboards (and falling shapes, scores) every
+// HASH_INTERVAL frames and sends the hash; if the other peer's hash for the same frame differs,
+// the games have diverged and isDesynced() is set (with the first frame it was seen at).
+//
+// The peer doesn't touch sockets: receive() takes the bytes that arrived, and getOutgoing()
+// holds the messages to send (see LockstepConnection for sf::TcpSocket).
+
+#ifndef LOCKSTEPPEER_H
+#define LOCKSTEPPEER_H
+
+#include "LockstepGame.h"
+#include <cstddef>
+#include <vector>
+
+/// <summary>
+/// One encoded message.
+/// </summary>
+struct LockstepMessage
+{
+	static const int MAX_SIZE = 13;
+	unsigned char bytes[MAX_SIZE];
+	int size{ 0 };
+};
+
+class LockstepPeer
+{
+	friend class TestSuite;
+
+public:
+	// MESSAGE TYPES
+	static const unsigned char MESSAGE_HELLO = 1;
+	static const unsigned char MESSAGE_INPUT = 2;
+	static const unsigned char MESSAGE_HASH = 3;
+
+	// CONSTANTS
+	static const int PLAYER_COUNT = 2;
+	static const int INPUT_DELAY = 3;			// frames between entering an input and it being applied
+	static const int HASH_INTERVAL = 60;		// frames between state hashes (1 sec at 60 fps)
+	static const int INPUT_RING = 64;			// inputs kept per player (a power of 2, more than the most a peer can run ahead)
+	static const int HASH_RING = 8;				// hashes kept for comparing
+
+private:
+	/// <summary>
+	/// A state hash, for a frame.
+	/// </summary>
+	struct HashRecord
+	{
+		unsigned int frame{ 0 };
+		unsigned long long hash{ 0 };
+		bool present{ false };
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	int localPlayer;							// 0 hosts, 1 joins
+	LockstepGame games[PLAYER_COUNT];
+	bool started{ false };
+	unsigned int seed{ 0 };
+	unsigned int frame{ 0 };					// # of frames simulated
+	unsigned char inputs[PLAYER_COUNT][INPUT_RING]{};
+	unsigned int inputFrames[PLAYER_COUNT]{};	// # of frames each player's inputs are known for
+	HashRecord localHashes[HASH_RING];
+	HashRecord remoteHashes[HASH_RING];
+	bool desynced{ false };
+	unsigned int desyncFrame{ 0 };
+	std::vector<LockstepMessage> outgoing;		// reserved once, emptied by clearOutgoing()
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="localPlayer">0 for the host, 1 for the joiner</param>
+	explicit LockstepPeer(int localPlayer);
+
+	/// <summary>
+	/// Host: starts the match with a seed, and queues the HELLO that starts the joiner.
+	/// </summary>
+	void host(unsigned int seed);
+
+	/// <summary>
+	/// Handles bytes from the other peer (any # of whole messages).
+	/// </summary>
+	/// <returns>false if the bytes aren't valid messages (the connection should be dropped)</returns>
+	bool receive(const unsigned char* data, size_t size);
+
+	/// <summary>
+	/// Gets whether another local input can be entered: the match has started, and this peer
+	/// isn't already INPUT_DELAY frames ahead of the simulation (ie. waiting on the other peer).
+	/// </summary>
+	bool canAddLocalInput() const;
+
+	/// <summary>
+	/// Enters this peer's input for its next frame, and queues it for the other peer.
+	/// </summary>
+	/// <param name="bits">the LockstepGame::INPUT_ bits</param>
+	/// <returns>false if canAddLocalInput() is false (the input is dropped)</returns>
+	bool addLocalInput(unsigned char bits);
+
+	/// <summary>
+	/// Simulates the next frame, if both players' inputs for it are known.
+	/// Every HASH_INTERVAL frames, the state hash is recorded, queued, and checked.
+	/// </summary>
+	/// <returns>true if a frame was simulated</returns>
+	bool advance();
+
+	/// <summary>
+	/// Gets the messages waiting to be sent.
+	/// </summary>
+	const std::vector<LockstepMessage>& getOutgoing() const;
+
+	/// <summary>
+	/// Empties the outgoing messages (once they're sent).
+	/// </summary>
+	void clearOutgoing();
+
+	/// <summary>
+	/// Hashes both games (the value the peers compare).
+	/// </summary>
+	unsigned long long getStateHash() const;
+
+	// Getters
+	bool isStarted() const;
+	bool isDesynced() const;
+	unsigned int getDesyncFrame() const;
+	unsigned int getFrame() const;
+	int getLocalPlayer() const;
+	const LockstepGame& getGame(int player) const;
+
+private:
+	/// <summary>
+	/// Resets both games with the seed, with INPUT_DELAY empty inputs for each player.
+	/// </summary>
+	void start(unsigned int seed);
+
+	/// <summary>
+	/// Records a hash (local or remote) and compares it with the other side's, if it's there.
+	/// </summary>
+	void recordHash(HashRecord* records, const HashRecord* otherRecords, unsigned int hashFrame, unsigned long long hash);
+
+	/// <summary>
+	/// Queues a message: a type byte followed by little endian values.
+	/// </summary>
+	void queueMessage(unsigned char type, unsigned long long value, int valueBytes, unsigned long long extra = 0, int extraBytes = 0);
+
+	/// <summary>
+	/// Reads a little endian value.
+	/// </summary>
+	static unsigned long long readValue(const unsigned char* data, int bytes);
+};
+
+#endif /* LOCKSTEPPEER_H */
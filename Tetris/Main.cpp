@@ -1,38 +1,387 @@
 
 
 #include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 #include "TetrisGame.h"
+#include "BoardPacket.h"
+#include "BoardRasterizer.h"
+#include "BoardWallRenderer.h"
+#include "FramePacer.h"
+#include "GlyphAtlas.h"
+#include "ImpairmentProxy.h"
+#include "LoadGenerator.h"
+#include "LockstepConnection.h"
+#include "MatchmakingLoad.h"
+#include "MatchServer.h"
+#include "FrameProfiler.h"
+#ifdef TETRIS_PROFILER
+#include "FrameProfilerHud.h"
+#endif
+#include "Perft.h"
+#include "RollbackConnection.h"
+#include "SimulationThread.h"
+#include "SpectatorServer.h"
+#include "TerminalGame.h"
 #include "TestSuite.h"
+#include "Tournament.h"
+#include "WeightTuner.h"
 
 
-int main()
+// the command line tools (these run without a window), and the window's modes
+static const char* USAGE =
+	"command line tools (these run without a window):\n"
+	"  --tune [generations]	tune the bot's evaluation weights (resumes from tuner_checkpoint.txt)\n"
+	"  --tournament [roundrobin|swiss] [games]	play the bots against each other (games per pairing), log the replays and ratings\n"
+	"  --perft [depth]		count placement sequences and report nodes/sec\n"
+	"  --render [frames]		render boards on the CPU (no window) and report frames/sec\n"
+	"  --codec [boards]		encode and decode boards for the network and report the sizes and boards/sec\n"
+	"  --terminal [watch]		play in a text terminal (ie. over SSH), or watch the bot play\n"
+	"  --lockstep [frames]	play two lockstep peers over a loopback TCP connection and report bytes/frame\n"
+	"  --versus host [port]	host a lockstep versus match in a text terminal\n"
+	"  --versus join address [port]	join a lockstep versus match\n"
+	"  --server [matches] [port]	host up to that many matches (headless), reporting tick times every 10 sec\n"
+	"  --loadgen [matches] [address] [port]	play that many matches on a server\n"
+	"  --serverbench [matches] [seconds]	load a server with a load generator in this process and report tick percentiles\n"
+	"  --matchmaking [clients/sec] [seconds] [match seconds]	run synthetic clients through the matchmaking queue and report its latency\n"
+	"  --proxy tcp|udp port address port [latency jitter loss duplicates reordering]	relay a connection through a bad network (ms, ms, %, %, %)\n"
+	"  --netharness [latency jitter loss] [seconds]	play two lockstep peers through a tcp proxy, reporting input delay, stalls and desyncs\n"
+	"  --udpharness [latency jitter loss] [seconds]	the same with two rollback peers over udp, reporting bytes/sec, latency and rollbacks\n"
+	"  --spectate match [address] [port]	watch a match on a server in a text terminal\n"
+	"  --spectatorbench [spectators] [seconds]	load a server with players and spectators and report the fan-out\n"
+	"and for the window:\n"
+	"  --threaded				simulate on a separate thread, drawing snapshots of the game (see SimulationThread)\n"
+	"  --wall [boards]		watch 2 to 64 bots play at once, drawn in a single pass (see BoardWallRenderer)\n";
+
+/// <summary>
+/// Reads an optional number from the command line (the value is left as it is if the argument isn't there).
+/// Prints the usage if the argument isn't a number from minimum to maximum.
+/// </summary>
+/// <param name="index">the argument's index in argv</param>
+/// <param name="value">the default, set to the argument</param>
+/// <returns>false if the argument is there and isn't valid</returns>
+static bool readArgument(int argc, char* argv[], int index, double minimum, double maximum, double& value)
+{
+	if (index >= argc)
+	{
+		return true;
+	}
+	char* end{ nullptr };
+	double parsed = std::strtod(argv[index], &end);
+	if (end == argv[index] || *end != '\0' || !(parsed >= minimum && parsed <= maximum))
+	{
+		std::cout << argv[1] << ": \"" << argv[index] << "\" should be a number from " << minimum << " to " << maximum << "\n\n" << USAGE;
+		return false;
+	}
+	value = parsed;
+	return true;
+}
+
+/// <summary>
+/// Same as readArgument() for whole numbers.
+/// </summary>
+static bool readArgument(int argc, char* argv[], int index, int minimum, int maximum, int& value)
+{
+	double parsed{ static_cast<double>(value) };
+	if (!readArgument(argc, argv, index, static_cast<double>(minimum), static_cast<double>(maximum), parsed))
+	{
+		return false;
+	}
+	if (parsed != std::floor(parsed))
+	{
+		std::cout << argv[1] << ": \"" << argv[index] << "\" should be a whole number\n\n" << USAGE;
+		return false;
+	}
+	value = static_cast<int>(parsed);
+	return true;
+}
+
+/// <summary>
+/// Same as readArgument() for a port.
+/// </summary>
+static bool readPort(int argc, char* argv[], int index, unsigned short& port)
+{
+	int value{ port };
+	if (!readArgument(argc, argv, index, 1, 65535, value))
+	{
+		return false;
+	}
+	port = static_cast<unsigned short>(value);
+	return true;
+}
+
+int main(int argc, char* argv[])
 {	
 	// run some sanity tests on our classes to ensure they're working as expected.
 	TestSuite::runTestSuite();
 
+	// command line tools (see USAGE)
+	const double MAX_SECONDS{ 24.0 * 60.0 * 60.0 };
+	std::string mode = (argc > 1) ? argv[1] : "";
+	if (mode == "--help")
+	{
+		std::cout << USAGE;
+		return 0;
+	}
+	if (mode == "--tune")
+	{
+		TunerSettings settings;
+		if (!readArgument(argc, argv, 2, 1, 1000000, settings.generations))
+		{
+			return 1;
+		}
+		WeightTuner tuner(settings);
+		tuner.run();
+		return 0;
+	}
+	if (mode == "--tournament")
+	{
+		int games{ 8 };
+		if (!readArgument(argc, argv, 3, 1, 100000, games))
+		{
+			return 1;
+		}
+		Tournament::runTournament(argc > 2 && std::string(argv[2]) == "swiss" ? TournamentFormat::SWISS : TournamentFormat::ROUND_ROBIN, games);
+		return 0;
+	}
+	if (mode == "--perft")
+	{
+		int depth{ 4 };
+		if (!readArgument(argc, argv, 2, 1, 8, depth))
+		{
+			return 1;
+		}
+		Perft::runBenchmark(depth);
+		return 0;
+	}
+	if (mode == "--codec")
+	{
+		int boards{ 100000 };
+		if (!readArgument(argc, argv, 2, 1, 100000000, boards))
+		{
+			return 1;
+		}
+		BoardPacket::runBenchmark(boards);
+		return 0;
+	}
+	if (mode == "--terminal")
+	{
+		TerminalGame::runInTerminal(argc > 2 && std::string(argv[2]) == "watch");
+		return 0;
+	}
+	if (mode == "--lockstep")
+	{
+		int frames{ 6000 };
+		if (!readArgument(argc, argv, 2, 1, 100000000, frames))
+		{
+			return 1;
+		}
+		LockstepConnection::runLoopbackTest(frames);
+		return 0;
+	}
+	if (mode == "--versus")
+	{
+		bool hosting = argc > 2 && std::string(argv[2]) == "host";
+		std::string address = (!hosting && argc > 3) ? argv[3] : "127.0.0.1";
+		unsigned short port{ LockstepConnection::DEFAULT_PORT };
+		if (!readPort(argc, argv, hosting ? 3 : 4, port))
+		{
+			return 1;
+		}
+		LockstepConnection::runInTerminal(hosting, address, port);
+		return 0;
+	}
+	if (mode == "--server")
+	{
+		int matches{ 4000 };
+		unsigned short port{ MatchServer::DEFAULT_PORT };
+		if (!readArgument(argc, argv, 2, 1, 1000000, matches) || !readPort(argc, argv, 3, port))
+		{
+			return 1;
+		}
+		MatchServer::runServer(port, matches);
+		return 0;
+	}
+	if (mode == "--loadgen")
+	{
+		int matches{ 2000 };
+		unsigned short port{ MatchServer::DEFAULT_PORT };
+		if (!readArgument(argc, argv, 2, 1, 1000000, matches) || !readPort(argc, argv, 4, port))
+		{
+			return 1;
+		}
+		LoadGenerator::runLoadGenerator(sf::IpAddress(argc > 3 ? argv[3] : "127.0.0.1"), port, matches);
+		return 0;
+	}
+	if (mode == "--serverbench")
+	{
+		int matches{ 2000 };
+		double seconds{ 20.0 };
+		if (!readArgument(argc, argv, 2, 1, 1000000, matches) || !readArgument(argc, argv, 3, 0.1, MAX_SECONDS, seconds))
+		{
+			return 1;
+		}
+		MatchServer::runBenchmark(matches, seconds);
+		return 0;
+	}
+	if (mode == "--matchmaking")
+	{
+		MatchmakingLoadSettings settings;
+		if (!readArgument(argc, argv, 2, 0.1, 1000000.0, settings.clientsPerSecond) ||
+			!readArgument(argc, argv, 3, 0.1, MAX_SECONDS, settings.seconds) ||
+			!readArgument(argc, argv, 4, 0.0, MAX_SECONDS, settings.matchSeconds))
+		{
+			return 1;
+		}
+		MatchmakingLoad::runBenchmark(settings);
+		return 0;
+	}
+	if (mode == "--proxy")
+	{
+		if (argc < 6)
+		{
+			std::cout << "--proxy needs a protocol, a port to listen on, and the address and port to relay to\n\n" << USAGE;
+			return 1;
+		}
+		ImpairmentSettings settings;
+		unsigned short listenPort{ 0 };
+		unsigned short targetPort{ 0 };
+		if (!readPort(argc, argv, 3, listenPort) || !readPort(argc, argv, 5, targetPort) ||
+			!readArgument(argc, argv, 6, 0.0, 10000.0, settings.latencyMs) ||
+			!readArgument(argc, argv, 7, 0.0, 10000.0, settings.jitterMs) ||
+			!readArgument(argc, argv, 8, 0.0, 100.0, settings.lossPercent) ||
+			!readArgument(argc, argv, 9, 0.0, 100.0, settings.duplicatePercent) ||
+			!readArgument(argc, argv, 10, 0.0, 100.0, settings.reorderPercent))
+		{
+			return 1;
+		}
+		ImpairmentProxy::runProxy(std::string(argv[2]) == "udp" ? ImpairmentProxy::Protocol::UDP : ImpairmentProxy::Protocol::TCP,
+			listenPort, sf::IpAddress(argv[4]), targetPort, settings);
+		return 0;
+	}
+	if (mode == "--netharness" || mode == "--udpharness")
+	{
+		bool rollback = mode == "--udpharness";
+		ImpairmentSettings settings;
+		settings.latencyMs = 40.0;
+		settings.jitterMs = 10.0;
+		settings.lossPercent = rollback ? 5.0 : 2.0;
+		double seconds{ 20.0 };
+		if (!readArgument(argc, argv, 2, 0.0, 10000.0, settings.latencyMs) ||
+			!readArgument(argc, argv, 3, 0.0, 10000.0, settings.jitterMs) ||
+			!readArgument(argc, argv, 4, 0.0, 100.0, settings.lossPercent) ||
+			!readArgument(argc, argv, 5, 0.1, MAX_SECONDS, seconds))
+		{
+			return 1;
+		}
+		if (rollback)
+		{
+			RollbackConnection::runHarness(settings, seconds);
+		}
+		else
+		{
+			ImpairmentProxy::runHarness(settings, seconds);
+		}
+		return 0;
+	}
+	if (mode == "--spectate")
+	{
+		int match{ 0 };
+		unsigned short port{ SpectatorServer::DEFAULT_PORT };
+		if (!readArgument(argc, argv, 2, 0, 1000000, match) || !readPort(argc, argv, 4, port))
+		{
+			return 1;
+		}
+		SpectatorServer::runViewer(argc > 3 ? argv[3] : "127.0.0.1", port, match);
+		return 0;
+	}
+	if (mode == "--spectatorbench")
+	{
+		int spectators{ 400 };
+		double seconds{ 20.0 };
+		if (!readArgument(argc, argv, 2, 0, 100000, spectators) || !readArgument(argc, argv, 3, 0.1, MAX_SECONDS, seconds))
+		{
+			return 1;
+		}
+		SpectatorServer::runBenchmark(spectators, seconds);
+		return 0;
+	}
+	if (mode == "--render")
+	{
+		int frames{ 1000 };
+		if (!readArgument(argc, argv, 2, 1, 100000000, frames))
+		{
+			return 1;
+		}
+		// sf::Image only decodes the png, it doesn't need a window or a display
+		sf::Image tilesImage;
+		if (!tilesImage.loadFromFile("./images/tiles.png"))
+		{
+			return 1;
+		}
+		RgbaImage tiles(tilesImage.getSize().x, tilesImage.getSize().y, tilesImage.getPixelsPtr());
+		BoardRasterizer::runBenchmark(tiles, TetrisGame::BLOCK_WIDTH, TetrisGame::BLOCK_HEIGHT, frames);
+		return 0;
+	}
+	int wallBoards{ 16 };
+	if (mode == "--wall" && !readArgument(argc, argv, 2, BoardWall::MIN_BOARDS, BoardWall::MAX_BOARDS, wallBoards))
+	{
+		return 1;
+	}
+
 	sf::Sprite blockSprite;			// the tetromino block sprite
-	sf::Texture blockTexture;		// the tetromino block texture
+	sf::Image tilesImage;			// the tetromino block tiles
+	sf::Font hudFont;				// the font for the HUD
+	GlyphAtlas atlas;				// the tiles and the HUD glyphs in one texture (the block sprite's texture)
 	sf::Sprite backgroundSprite;	// the background sprite
 	sf::Texture backgroundTexture;	// the background texture
 
+	// create the game window
+	sf::RenderWindow window(sf::VideoMode(640, 800), "Tetris Game Window");	
+
 	// load images
 	backgroundTexture.loadFromFile("./images/background.png");// load the background sprite
 	backgroundSprite.setTexture(backgroundTexture);
 
-	blockTexture.loadFromFile("./images/tiles.png");	// load the tetris block sprite
-	blockSprite.setTexture(blockTexture);	
+	// the tiles and the HUD font are baked into the atlas once, so the blocks and the HUD text draw in one batch
+	tilesImage.loadFromFile("./images/tiles.png");
+	if (!hudFont.loadFromFile("fonts/RedOctober.ttf") || !atlas.build(tilesImage, hudFont, 18))
+	{
+		return 1;
+	}
+	blockSprite.setTexture(atlas.getTexture());	
 
-	// create the game window
-	sf::RenderWindow window(sf::VideoMode(640, 800), "Tetris Game Window");	
-	
-	window.setFramerateLimit(30);				// set a max framerate of 30 FPS
+	if (mode == "--wall")
+	{
+		BoardWallRenderer::runInWindow(window, atlas.getTexture(), TetrisGame::BLOCK_WIDTH, TetrisGame::BLOCK_HEIGHT, wallBoards);
+		return 0;
+	}
+
+	// frame pacing (F4 cycles through the modes, see FramePacer), P pauses the game
+	FramePacer pacer(60.0);
+	auto applyPacingMode = [&window, &pacer](PacingMode mode)
+	{
+		pacer.setMode(mode);
+		window.setFramerateLimit(0);		// the limiter in FramePacer replaces SFML's sleep-only limit
+		window.setVerticalSyncEnabled(mode == PacingMode::VSYNC);
+	};
+	applyPacingMode(PacingMode::LIMITED);
+	bool paused{ false };
 
 	const Point gameboardOffset{ 54, 125 };		// the pixel offset of the top left of the gameboard 
 	const Point nextShapeOffset{ 490, 210 };	// the pixel offset of the next shape Tetromino
 
 	// set up a tetris game
-	TetrisGame game(window, blockSprite, gameboardOffset, nextShapeOffset);
+	TetrisGame game(window, blockSprite, atlas, gameboardOffset, nextShapeOffset);
+
+	// --threaded: the game is simulated on its own thread, and this thread only draws it
+	bool threaded{ mode == "--threaded" };
+	SimulationThread simulation(game);
+	RenderSnapshot frameSnapshot;				// single threaded: the snapshot drawn this frame
+	const RenderSnapshot* drawnSnapshot{ &frameSnapshot };	// the snapshot drawn this frame (valid until the next acquire)
 
 	// seeding randomizer
 	srand(time_t(NULL));
@@ -40,37 +389,179 @@ int main()
 	// set up a clock so we can determine seconds per game loop
 	sf::Clock clock;		
 
-	// create an event for handling userInput from the GUI (graphical user interface)
-	sf::Event guiEvent;	
+	// frame time comparison: F1 switches between the batched and per-block renderers,
+	// F2 cycles through the ways of drawing the locked blocks (see StackRendering),
+	// and the average time spent drawing a frame is printed every FRAME_REPORT_INTERVAL frames.
+	const int FRAME_REPORT_INTERVAL{ 300 };
+	const char* STACK_RENDERING_NAMES[]{ "redrawn", "render texture", "vertex buffer" };
+	sf::Clock frameClock;
+	double frameSeconds{ 0.0 };
+	int frameCount{ 0 };
+
+	// input latency (key press polled -> first frame showing it displayed) and tick jitter, also reported
+	// every FRAME_REPORT_INTERVAL frames.  The profiler is only used to keep the latency samples.
+	FrameProfiler inputLatency;
+	unsigned long long displayedInputCount{ 0 };
+	FramePacer tickTimer;						// single threaded: measures the interval between simulation steps
+
+#ifdef TETRIS_PROFILER
+	// per-phase frame timing, F3 shows/hides the HUD
+	FrameProfiler profiler;
+	FrameProfilerHud profilerHud(profiler, hudFont, sf::Vector2f(4.f, 4.f));
+	bool showProfilerHud{ false };
+#endif
+
+	// handles a window or keyboard event
+	auto handleEvent = [&](sf::Event& event)
+	{
+		if (event.type == sf::Event::Closed)	// handle close button clicked
+		{
+			window.close();
+		}
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F1)
+		{
+			game.setBatchedRendering(!game.isBatchedRendering());
+			frameSeconds = 0.0;
+			frameCount = 0;
+		}
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F2)
+		{
+			int next = (static_cast<int>(game.getStackRendering()) + 1) % static_cast<int>(StackRendering::COUNT);
+			game.setStackRendering(static_cast<StackRendering>(next));
+			frameSeconds = 0.0;
+			frameCount = 0;
+		}
+#ifdef TETRIS_PROFILER
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
+		{
+			showProfilerHud = !showProfilerHud;
+		}
+#endif
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F4)
+		{
+			int next = (static_cast<int>(pacer.getMode()) + 1) % static_cast<int>(PacingMode::COUNT);
+			applyPacingMode(static_cast<PacingMode>(next));
+			frameSeconds = 0.0;
+			frameCount = 0;
+		}
+		else if (event.type == sf::Event::KeyPressed && threaded)
+		{
+			// the simulation handles the key (P included) on its next tick
+			paused = (event.key.code == sf::Keyboard::P) ? !paused : paused;
+			simulation.pushInput(event, std::chrono::steady_clock::now());
+		}
+		else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P)
+		{
+			paused = !paused;
+			// the time spent paused is never simulated
+			pacer.resetSimulationTime();
+			clock.restart();
+		}
+		else if (event.type == sf::Event::KeyPressed && !paused)
+		{
+			game.onKeyPressed(event, std::chrono::steady_clock::now());	// handle key press
+		}
+	};
+
+	if (threaded)
+	{
+		simulation.start();
+	}
 
 	// the main game loop
 	while (window.isOpen())
 	{
+#ifdef TETRIS_PROFILER
+		profiler.beginFrame();
+#endif
+		// handle any window or keyboard events that have occured since the last game loop
+		{
+			PROFILE_PHASE(profiler, FramePhase::INPUT);
+			sf::Event event;
+			// idle while paused: sleep until something happens instead of drawing frames
+			if (paused && pacer.shouldWaitWhenPaused() && window.waitEvent(event))
+			{
+				handleEvent(event);
+			}
+			while (window.pollEvent(event))
+			{
+				handleEvent(event);
+			}
+		}
+
 		// how long since the last loop (fraction of a second)		
 		float elapsedTime = clock.getElapsedTime().asSeconds();
 		clock.restart();		
 
-		// handle any window or keyboard events that have occured since the last game loop
-		sf::Event event;
-		while (window.pollEvent(event))
+		// the game is simulated in fixed steps, whatever the frame rate
+		{
+			PROFILE_PHASE(profiler, FramePhase::SIMULATION);
+			int steps = (paused || threaded) ? 0 : pacer.takeSimulationSteps(elapsedTime);
+			for (int step{ 0 }; step < steps; step++)
+			{
+				game.processGameLoop(static_cast<float>(FramePacer::SIMULATION_STEP));	// handle tetris game logic in here.
+				tickTimer.markFrame();
+			}
+		}
+
+		// Draw the game to the screen
 		{
-			if (event.type == sf::Event::Closed)	// handle close button clicked
+			PROFILE_PHASE(profiler, FramePhase::DRAW);
+			frameClock.restart();
+			window.clear(sf::Color::White);	// clear the entire window
+			window.draw(backgroundSprite);	// draw the background (onto the window) 				
+			if (!threaded)
 			{
-				window.close();
+				game.captureSnapshot(frameSnapshot);
 			}
-			else if (event.type == sf::Event::KeyPressed)
+			drawnSnapshot = threaded ? &simulation.acquireSnapshot() : &frameSnapshot;
+			game.animate(paused ? 0.f : elapsedTime);	// advance the line clear effects
+			game.drawSnapshot(*drawnSnapshot);	// draw the game (onto the window)
+#ifdef TETRIS_PROFILER
+			if (showProfilerHud)
 			{
-				game.onKeyPressed(event);	// handle key press
+				profilerHud.draw(window);
 			}
+#endif
+			// measured before display(), which may wait for vsync
+			frameSeconds += frameClock.getElapsedTime().asSeconds();
 		}
+		{
+			PROFILE_PHASE(profiler, FramePhase::DISPLAY);
+			pacer.waitForNextFrame();		// hold the frame rate (limited and idle modes)
+			window.display();				// re-display the entire window
+			pacer.markFrame();
+		}
+		// the first frame showing a key press has just been displayed
+		if (drawnSnapshot->inputCount != displayedInputCount)
+		{
+			displayedInputCount = drawnSnapshot->inputCount;
+			std::chrono::duration<double> latency = std::chrono::steady_clock::now() - drawnSnapshot->lastInputReceived;
+			inputLatency.recordFrame(latency.count());
+		}
+#ifdef TETRIS_PROFILER
+		profiler.endFrame();
+#endif
 
-		game.processGameLoop(elapsedTime);	// handle tetris game logic in here.
-
-		// Draw the game to the screen
-		window.clear(sf::Color::White);	// clear the entire window
-		window.draw(backgroundSprite);	// draw the background (onto the window) 				
-		game.draw();					// draw the game (onto the window)
-		window.display();				// re-display the entire window
+		if (++frameCount == FRAME_REPORT_INTERVAL)
+		{
+			PacingStats pacing = pacer.getStats();
+			std::cout << (game.isBatchedRendering() ? "batched" : "per-block")
+				<< ", " << STACK_RENDERING_NAMES[static_cast<int>(game.getStackRendering())] << " stack rendering: "
+				<< (frameSeconds / frameCount) * 1000.0 << " ms/frame (clear + draw)\n"
+				<< FramePacer::getModeName(pacer.getMode()) << " pacing: "
+				<< pacing.mean * 1000.0 << " ms/frame, jitter " << pacing.jitter * 1000.0
+				<< " ms, max " << pacing.max * 1000.0 << " ms\n";
+			FrameStats latency = inputLatency.getStats();
+			PacingStats ticks = threaded ? drawnSnapshot->tickStats : tickTimer.getStats();
+			std::cout << (threaded ? "threaded" : "single threaded") << " simulation: input latency p50 "
+				<< latency.p50 * 1000.0 << " ms, p99 " << latency.p99 * 1000.0 << " ms (" << latency.frameCount
+				<< " key presses), tick jitter " << ticks.jitter * 1000.0 << " ms, max tick " << ticks.max * 1000.0 << " ms\n";
+			frameSeconds = 0.0;
+			frameCount = 0;
+			pacer.resetStats();
+			tickTimer.resetStats();
+		}
 	}
 	return 0;
 }
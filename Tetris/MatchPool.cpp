@@ -0,0 +1,127 @@
+#include "MatchPool.h"
+
+MatchPool::MatchPool(int capacity)
+	: matches(static_cast<size_t>(capacity))
+{
+	freeSlots.reserve(static_cast<size_t>(capacity));
+	// pushed in reverse, so the lowest slots are used first (and active matches stay packed together)
+	for (int slot = capacity - 1; slot >= 0; slot--)
+	{
+		freeSlots.push_back(slot);
+	}
+}
+
+int MatchPool::allocate(unsigned int seed, int owner)
+{
+	if (freeSlots.empty())
+	{
+		return -1;
+	}
+	int slot = freeSlots.back();
+	freeSlots.pop_back();
+	ServerMatch& match = matches[slot];
+	match.seed = seed;
+	match.owner = owner;
+	match.gamesFinished = 0;
+	match.active = true;
+	for (int player{ 0 }; player < ServerMatch::PLAYER_COUNT; player++)
+	{
+		match.games[player].reset(seed);
+		match.pendingInputs[player] = 0;
+	}
+	match.garbage.clear();
+	activeCount++;
+	return slot;
+}
+
+void MatchPool::release(int slot)
+{
+	if (slot < 0 || slot >= getCapacity() || !matches[slot].active)
+	{
+		return;
+	}
+	matches[slot].active = false;
+	matches[slot].owner = -1;
+	matches[slot].feed.restart();
+	matches[slot].generation++;
+	freeSlots.push_back(slot);
+	activeCount--;
+}
+
+void MatchPool::addInputs(int slot, int player, unsigned char bits)
+{
+	if (slot >= 0 && slot < getCapacity() && player >= 0 && player < ServerMatch::PLAYER_COUNT)
+	{
+		matches[slot].pendingInputs[player] |= bits;
+	}
+}
+
+void MatchPool::stepGames(int firstGame, int lastGame)
+{
+	for (int game{ firstGame }; game < lastGame; game++)
+	{
+		ServerMatch& match = matches[game / ServerMatch::PLAYER_COUNT];
+		if (!match.active)
+		{
+			continue;
+		}
+		int player = game % ServerMatch::PLAYER_COUNT;
+		LockstepGame& playerGame = match.games[player];
+		playerGame.receiveGarbage(match.garbage.receive(player, playerGame.getFrame()));
+		playerGame.step(match.pendingInputs[player]);
+		match.pendingInputs[player] = 0;
+		// if the opponent's queue is full, the attack waits for the next step
+		if (playerGame.getAttack() > 0 && match.garbage.send(player, playerGame.getFrame(), playerGame.getAttack()))
+		{
+			playerGame.clearAttack();
+		}
+	}
+}
+
+void MatchPool::finishMatches(int first, int last)
+{
+	for (int slot{ first }; slot < last; slot++)
+	{
+		ServerMatch& match = matches[slot];
+		if (!match.active)
+		{
+			continue;
+		}
+		bool over{ false };
+		for (int player{ 0 }; player < ServerMatch::PLAYER_COUNT; player++)
+		{
+			over = over || match.games[player].isGameOver();
+		}
+		if (over)
+		{
+			match.gamesFinished++;
+			match.seed++;
+			for (int player{ 0 }; player < ServerMatch::PLAYER_COUNT; player++)
+			{
+				match.games[player].reset(match.seed);
+			}
+			match.garbage.clear();
+		}
+		match.feed.publish(match.games[0].getFrame(), match.games[0], match.games[1]);
+	}
+}
+
+void MatchPool::stepRange(int first, int last)
+{
+	stepGames(first * ServerMatch::PLAYER_COUNT, last * ServerMatch::PLAYER_COUNT);
+	finishMatches(first, last);
+}
+
+int MatchPool::getBatchCount() const { return (getCapacity() + BATCH_SIZE - 1) / BATCH_SIZE; }
+
+int MatchPool::getGameBatchCount() const { return (getGameCount() + BATCH_SIZE - 1) / BATCH_SIZE; }
+
+int MatchPool::getCapacity() const { return static_cast<int>(matches.size()); }
+
+int MatchPool::getGameCount() const { return getCapacity() * ServerMatch::PLAYER_COUNT; }
+
+int MatchPool::getActiveCount() const { return activeCount; }
+
+const ServerMatch& MatchPool::getMatch(int slot) const { return matches[slot]; }
+
+SpectatorFeed& MatchPool::getFeed(int slot) { return matches[slot].feed; }
@@ -0,0 +1,118 @@
+// The MatchPool holds the server's matches in one contiguous, preallocated array, so stepping
+// thousands of matches walks memory in order and a match never moves or allocates once the
+// server is up.  Free slots are kept on a stack: allocate() and release() are O(1).
+//
+// A ServerMatch is two LockstepGames (one per player, the same seed) plus the inputs received
+// for each player since the last step.  Inputs are OR-ed together, so a tap that arrives
+// between ticks isn't lost.  When either game ends, the match is restarted with a new seed
+// (and counted in gamesFinished).
+//
+// A tick is two passes, each handed to the MatchServer's WorkerPool in BATCH_SIZE ranges:
+//  1) stepGames() steps games, not matches (game g is player g % 2 of slot g / 2), so the two
+//     games of a match can be stepped on different workers at the same time.  The only thing
+//     they share is the match's GarbageExchange, which is lock-free.
+//  2) finishMatches() restarts the matches that ended and publishes each match's frame to its
+//     SpectatorFeed (only if it has spectators), so the encoding is spread over the workers too.
+// stepRange() runs both passes over a range of slots on the calling thread.
+
+#ifndef MATCHPOOL_H
+#define MATCHPOOL_H
+
+#include "LockstepGame.h"
+#include "SpectatorFeed.h"
+#include "GarbageExchange.h"
+#include <vector>
+
+/// <summary>
+/// One match on the server.
+/// </summary>
+struct ServerMatch
+{
+	static const int PLAYER_COUNT = 2;
+
+	LockstepGame games[PLAYER_COUNT];
+	GarbageExchange garbage;						// attacks between the two games
+	unsigned char pendingInputs[PLAYER_COUNT]{};	// inputs received since the last step
+	SpectatorFeed feed;								// the frames, for spectators
+	unsigned int seed{ 0 };
+	int owner{ -1 };								// the connection that opened the match
+	int gamesFinished{ 0 };
+	unsigned int generation{ 0 };					// incremented by every release(), so spectators of the slot's
+													// previous match can tell it's been reused
+	bool active{ false };
+};
+
+class MatchPool
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int BATCH_SIZE = 64;				// matches per worker batch
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	std::vector<ServerMatch> matches;				// sized once, never reallocated
+	std::vector<int> freeSlots;						// a stack of the inactive slots
+	int activeCount{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor, allocates every slot up front.
+	/// </summary>
+	/// <param name="capacity">the most matches the pool can hold</param>
+	explicit MatchPool(int capacity);
+
+	/// <summary>
+	/// Starts a match in a free slot.
+	/// </summary>
+	/// <returns>the slot, or -1 if the pool is full</returns>
+	int allocate(unsigned int seed, int owner);
+
+	/// <summary>
+	/// Ends the match in a slot, and frees the slot (a new generation of the slot).
+	/// </summary>
+	void release(int slot);
+
+	/// <summary>
+	/// Adds a player's inputs for the next step.
+	/// </summary>
+	void addInputs(int slot, int player, unsigned char bits);
+
+	/// <summary>
+	/// Steps the games firstGame ... lastGame - 1 (of active matches) by one frame: each game takes
+	/// the garbage sent to it, steps with its player's inputs, and sends its attack to the opponent.
+	/// </summary>
+	void stepGames(int firstGame, int lastGame);
+
+	/// <summary>
+	/// Restarts the active matches in slots first ... last - 1 that have ended, and publishes
+	/// their frames (after every game has been stepped).
+	/// </summary>
+	void finishMatches(int first, int last);
+
+	/// <summary>
+	/// Steps the active matches in slots first ... last - 1 by one frame (both passes).
+	/// </summary>
+	void stepRange(int first, int last);
+
+	/// <summary>
+	/// Gets the # of BATCH_SIZE batches that cover every slot.
+	/// </summary>
+	int getBatchCount() const;
+
+	/// <summary>
+	/// Gets the # of BATCH_SIZE batches that cover every game (2 per slot).
+	/// </summary>
+	int getGameBatchCount() const;
+
+	// Getters
+	int getCapacity() const;
+	int getGameCount() const;
+	int getActiveCount() const;
+	const ServerMatch& getMatch(int slot) const;
+	SpectatorFeed& getFeed(int slot);
+};
+
+#endif /* MATCHPOOL_H */
@@ -0,0 +1,356 @@
+#include "MatchServer.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "FramePacer.h"
+#include "LatencyStats.h"
+#include "LoadGenerator.h"
+
+MatchServer::MatchServer(int capacity, int workerThreads)
+	: pool(capacity), workers(workerThreads), spectators(pool),
+	tickSeconds(TICK_HISTORY), stepSeconds(TICK_HISTORY), sortScratch(TICK_HISTORY)
+{
+	connections.reserve(MAX_CONNECTIONS);
+}
+
+bool MatchServer::listen(unsigned short port, unsigned short spectatorPort)
+{
+	if (listener.listen(port) != sf::Socket::Done || !spectators.listen(spectatorPort))
+	{
+		return false;
+	}
+	listener.setBlocking(false);
+	return true;
+}
+
+unsigned short MatchServer::getPort() const { return listener.getLocalPort(); }
+
+unsigned short MatchServer::getSpectatorPort() const { return spectators.getPort(); }
+
+void MatchServer::runTick()
+{
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+
+	// network
+	acceptConnections();
+	for (int connection{ 0 }; connection < static_cast<int>(connections.size()); connection++)
+	{
+		if (connections[connection].open)
+		{
+			receive(connection);
+		}
+	}
+
+	// simulation
+	Clock::time_point stepStart = Clock::now();
+	workers.run(pool.getGameBatchCount(), [this](int batch) {
+		pool.stepGames(batch * MatchPool::BATCH_SIZE, std::min((batch + 1) * MatchPool::BATCH_SIZE, pool.getGameCount()));
+	});
+	workers.run(pool.getBatchCount(), [this](int batch) {
+		pool.finishMatches(batch * MatchPool::BATCH_SIZE, std::min((batch + 1) * MatchPool::BATCH_SIZE, pool.getCapacity()));
+	});
+	Clock::time_point stepEnd = Clock::now();
+
+	// spectators
+	spectators.update();
+
+	// status
+	tick++;
+	for (int connection{ 0 }; connection < static_cast<int>(connections.size()); connection++)
+	{
+		if (connections[connection].open)
+		{
+			if (tick % STATUS_INTERVAL == 0)
+			{
+				queueStatus(connections[connection]);
+			}
+			flush(connection);
+		}
+	}
+
+	int slot = recordedTicks % TICK_HISTORY;
+	tickSeconds[slot] = std::chrono::duration<double>(Clock::now() - start).count();
+	stepSeconds[slot] = std::chrono::duration<double>(stepEnd - stepStart).count();
+	recordedTicks++;
+}
+
+void MatchServer::run(double seconds, double reportSeconds)
+{
+	typedef std::chrono::steady_clock Clock;
+	FramePacer pacer(TICKS_PER_SECOND);
+	pacer.setMode(PacingMode::LIMITED);
+	Clock::time_point start = Clock::now();
+	Clock::time_point lastReport = start;
+	for (;;)
+	{
+		runTick();
+		Clock::time_point now = Clock::now();
+		if (seconds > 0 && std::chrono::duration<double>(now - start).count() >= seconds)
+		{
+			return;
+		}
+		if (reportSeconds > 0 && std::chrono::duration<double>(now - lastReport).count() >= reportSeconds)
+		{
+			printReport(getReport());
+			lastReport = now;
+		}
+		pacer.waitForNextFrame();
+	}
+}
+
+TickReport MatchServer::getReport()
+{
+	TickReport report;
+	report.ticks = std::min(recordedTicks, static_cast<int>(TICK_HISTORY));
+	if (report.ticks > 0)
+	{
+		double period = 1.0 / TICKS_PER_SECOND;
+		for (int i{ 0 }; i < report.ticks; i++)
+		{
+			report.overruns += tickSeconds[i] > period ? 1 : 0;
+		}
+		std::copy(tickSeconds.begin(), tickSeconds.begin() + report.ticks, sortScratch.begin());
+		report.p50 = LatencyStats::getPercentile(sortScratch.data(), report.ticks, 0.5);
+		report.p90 = LatencyStats::getPercentile(sortScratch.data(), report.ticks, 0.9);
+		report.p99 = LatencyStats::getPercentile(sortScratch.data(), report.ticks, 0.99);
+		report.p999 = LatencyStats::getPercentile(sortScratch.data(), report.ticks, 0.999);
+		report.max = *std::max_element(sortScratch.begin(), sortScratch.begin() + report.ticks);
+		std::copy(stepSeconds.begin(), stepSeconds.begin() + report.ticks, sortScratch.begin());
+		report.stepP50 = LatencyStats::getPercentile(sortScratch.data(), report.ticks, 0.5);
+		report.stepP99 = LatencyStats::getPercentile(sortScratch.data(), report.ticks, 0.99);
+	}
+	report.activeMatches = pool.getActiveCount();
+	for (const Connection& connection : connections)
+	{
+		report.connections += connection.open ? 1 : 0;
+	}
+	report.inputsReceived = inputsReceived;
+	report.spectators = spectators.getViewerCount();
+	for (int slot{ 0 }; slot < pool.getCapacity(); slot++)
+	{
+		report.feedBytes += pool.getMatch(slot).feed.getBytesPublished();
+	}
+	report.spectatorBytes = spectators.getBytesSent();
+	report.spectatorsDropped = spectators.getViewersDropped();
+	return report;
+}
+
+void MatchServer::printReport(const TickReport& report)
+{
+	std::cout << report.activeMatches << " matches, " << report.connections << " connections, "
+		<< report.inputsReceived << " inputs; tick ms over " << report.ticks << " ticks: p50 " << report.p50 * 1000.0
+		<< " p90 " << report.p90 * 1000.0 << " p99 " << report.p99 * 1000.0 << " p99.9 " << report.p999 * 1000.0
+		<< " max " << report.max * 1000.0 << " (stepping p50 " << report.stepP50 * 1000.0 << " p99 " << report.stepP99 * 1000.0
+		<< "), " << report.overruns << " overruns\n";
+	if (report.spectators > 0 || report.spectatorBytes > 0)
+	{
+		std::cout << report.spectators << " spectators: " << report.feedBytes << " bytes encoded, " << report.spectatorBytes
+			<< " bytes sent (" << (report.feedBytes > 0 ? static_cast<double>(report.spectatorBytes) / report.feedBytes : 0.0)
+			<< "x fan-out), " << report.spectatorsDropped << " dropped for falling behind\n";
+	}
+}
+
+void MatchServer::runServer(unsigned short port, int capacity)
+{
+	int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+	MatchServer server(capacity, threads);
+	if (!server.listen(port, static_cast<unsigned short>(port + 1)))
+	{
+		std::cout << "couldn't listen on ports " << port << " and " << port + 1 << "\n";
+		return;
+	}
+	std::cout << "serving up to " << capacity << " matches on port " << server.getPort() << " (spectators on "
+		<< server.getSpectatorPort() << ") with " << threads + 1 << " threads\n";
+	server.run(0.0, 10.0);
+}
+
+void MatchServer::runBenchmark(int matches, double seconds)
+{
+	// the load generator gets a core of its own
+	int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 2);
+	MatchServer server(matches, threads);
+	if (!server.listen(sf::Socket::AnyPort, sf::Socket::AnyPort))
+	{
+		std::cout << "couldn't listen\n";
+		return;
+	}
+	unsigned short port = server.getPort();
+	std::atomic<bool> stop{ false };
+	LoadGenerator load(matches, 7);
+	std::thread loadThread([&load, &stop, port]() {
+		if (load.connect(sf::IpAddress::LocalHost, port))
+		{
+			load.run(stop);
+		}
+	});
+
+	std::cout << matches << " matches over " << load.getClientCount() << " connections, " << threads + 1 << " server threads, "
+		<< seconds << " sec\n";
+	server.run(seconds, 5.0);
+	stop = true;
+	loadThread.join();
+	TickReport report = server.getReport();
+	printReport(report);
+	std::cout << "load generator: " << load.getMatchesOpened() << " matches opened, " << load.getInputsSent() << " inputs sent, "
+		<< load.getStatusReceived() << " status messages received\n";
+}
+
+void MatchServer::acceptConnections()
+{
+	for (;;)
+	{
+		std::unique_ptr<sf::TcpSocket> socket(new sf::TcpSocket());
+		if (listener.accept(*socket) != sf::Socket::Done)
+		{
+			return;
+		}
+		int index{ -1 };
+		for (int connection{ 0 }; connection < static_cast<int>(connections.size()) && index < 0; connection++)
+		{
+			index = connections[connection].open ? -1 : connection;
+		}
+		if (index < 0)
+		{
+			if (static_cast<int>(connections.size()) >= MAX_CONNECTIONS)
+			{
+				continue;		// the socket is closed as it goes out of scope
+			}
+			connections.push_back(Connection());
+			index = static_cast<int>(connections.size()) - 1;
+		}
+		Connection& connection = connections[index];
+		socket->setBlocking(false);
+		connection.socket = std::move(socket);
+		connection.matches.clear();
+		connection.outgoing.clear();
+		connection.inFlight = false;
+		connection.open = true;
+	}
+}
+
+void MatchServer::receive(int connection)
+{
+	for (;;)
+	{
+		sf::Socket::Status status = connections[connection].socket->receive(receivePacket);
+		if (status == sf::Socket::Done)
+		{
+			if (!handleMessages(connection, receivePacket))
+			{
+				closeConnection(connection);
+				return;
+			}
+		}
+		else
+		{
+			if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+			{
+				closeConnection(connection);
+			}
+			return;
+		}
+	}
+}
+
+bool MatchServer::handleMessages(int connection, sf::Packet& packet)
+{
+	Connection& client = connections[connection];
+	while (!packet.endOfPacket())
+	{
+		sf::Uint8 type{ 0 };
+		packet >> type;
+		if (type == MESSAGE_OPEN)
+		{
+			sf::Uint16 count{ 0 };
+			if (!(packet >> count))
+			{
+				return false;
+			}
+			sf::Uint16 first = static_cast<sf::Uint16>(client.matches.size());
+			sf::Uint16 opened{ 0 };
+			for (; opened < count; opened++)
+			{
+				int slot = pool.allocate(nextSeed++, connection);
+				if (slot < 0)
+				{
+					break;
+				}
+				client.matches.push_back(slot);
+			}
+			client.outgoing << MESSAGE_OPENED << first << opened;
+		}
+		else if (type == MESSAGE_INPUT)
+		{
+			sf::Uint16 match{ 0 };
+			sf::Uint8 bits[ServerMatch::PLAYER_COUNT]{};
+			if (!(packet >> match >> bits[0] >> bits[1]) || match >= client.matches.size())
+			{
+				return false;
+			}
+			for (int player{ 0 }; player < ServerMatch::PLAYER_COUNT; player++)
+			{
+				pool.addInputs(client.matches[match], player, bits[player]);
+			}
+			inputsReceived++;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void MatchServer::queueStatus(Connection& connection)
+{
+	// a client that hasn't taken the last packet yet skips this status
+	if (connection.inFlight)
+	{
+		return;
+	}
+	for (size_t match{ 0 }; match < connection.matches.size(); match++)
+	{
+		const ServerMatch& serverMatch = pool.getMatch(connection.matches[match]);
+		connection.outgoing << MESSAGE_STATUS << static_cast<sf::Uint16>(match)
+			<< static_cast<sf::Uint32>(serverMatch.games[0].getFrame())
+			<< static_cast<sf::Uint32>(serverMatch.games[0].getScore())
+			<< static_cast<sf::Uint32>(serverMatch.games[1].getScore());
+	}
+}
+
+void MatchServer::flush(int connection)
+{
+	Connection& client = connections[connection];
+	if (!client.inFlight && client.outgoing.getDataSize() > 0)
+	{
+		client.sending = client.outgoing;
+		client.outgoing.clear();
+		client.inFlight = true;
+	}
+	if (client.inFlight)
+	{
+		sf::Socket::Status status = client.socket->send(client.sending);
+		if (status == sf::Socket::Done)
+		{
+			client.inFlight = false;
+		}
+		else if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+		{
+			closeConnection(connection);
+		}
+	}
+}
+
+void MatchServer::closeConnection(int connection)
+{
+	Connection& client = connections[connection];
+	for (int slot : client.matches)
+	{
+		pool.release(slot);
+	}
+	client.matches.clear();
+	client.socket->disconnect();
+	client.open = false;
+}
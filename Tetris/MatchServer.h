@@ -0,0 +1,197 @@
+// The MatchServer hosts thousands of matches in one process, without a window.
+// Each tick (TICKS_PER_SECOND):
+//  - network: new connections are accepted, and the packets that arrived are read.  The listener
+//    and connections are non-blocking and polled (like the SpectatorServer's), not put in an
+//    sf::SocketSelector, whose select() watches at most FD_SETSIZE sockets (64 on Windows).
+//  - simulation: the MatchPool's games are stepped in batches of MatchPool::BATCH_SIZE,
+//    spread over a WorkerPool (the two games of a match may be on different workers), then
+//    the finished matches are restarted in a second pass.
+//  - spectators: the SpectatorServer sends each spectator what's new in its match's feed.
+//  - every STATUS_INTERVAL ticks, each connection is sent the frame and scores of its matches.
+//
+// The protocol (sf::Packets, several messages per packet):
+//  client -> server	OPEN	[type][count: Uint16]						start count matches (the client plays both sides)
+//						INPUT	[type][match: Uint16][bits 0][bits 1]		inputs for a match (LockstepGame::INPUT_ bits)
+//  server -> client	OPENED	[type][first match: Uint16][count: Uint16]	the matches that were started (numbered per connection)
+//						STATUS	[type][match: Uint16][frame: Uint32][score 0: Uint32][score 1: Uint32]
+//
+// Tick times are kept in a ring of the last TICK_HISTORY ticks, for the percentiles in
+// getReport().  runBenchmark() loads the server with a LoadGenerator on another thread.
+
+#ifndef MATCHSERVER_H
+#define MATCHSERVER_H
+
+#include <SFML/Network.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "MatchPool.h"
+#include "SpectatorServer.h"
+#include "WorkerPool.h"
+
+/// <summary>
+/// The server's tick times.
+/// </summary>
+struct TickReport
+{
+	int ticks{ 0 };						// # of ticks the percentiles cover
+	double p50{ 0.0 };					// tick durations (seconds)
+	double p90{ 0.0 };
+	double p99{ 0.0 };
+	double p999{ 0.0 };
+	double max{ 0.0 };
+	double stepP50{ 0.0 };				// the simulation part of the ticks
+	double stepP99{ 0.0 };
+	int overruns{ 0 };					// ticks that took longer than a tick period
+	int activeMatches{ 0 };
+	int connections{ 0 };
+	unsigned long long inputsReceived{ 0 };
+	int spectators{ 0 };
+	unsigned long long feedBytes{ 0 };		// bytes encoded into the spectator feeds (once per match)
+	unsigned long long spectatorBytes{ 0 };	// bytes sent to spectators
+	unsigned long long spectatorsDropped{ 0 };
+};
+
+class MatchServer
+{
+	friend class TestSuite;
+
+public:
+	// MESSAGE TYPES
+	static const sf::Uint8 MESSAGE_OPEN = 1;
+	static const sf::Uint8 MESSAGE_INPUT = 2;
+	static const sf::Uint8 MESSAGE_OPENED = 3;
+	static const sf::Uint8 MESSAGE_STATUS = 4;
+
+	// CONSTANTS
+	static const unsigned short DEFAULT_PORT = 53100;
+	static const int TICKS_PER_SECOND = 60;
+	static const int STATUS_INTERVAL = 30;			// ticks between status messages
+	static const int MAX_CONNECTIONS = 256;
+	static const int TICK_HISTORY = 60 * 60;		// ticks kept for the percentiles (a minute)
+
+private:
+	/// <summary>
+	/// A client connection.
+	/// </summary>
+	struct Connection
+	{
+		std::unique_ptr<sf::TcpSocket> socket;		// heap allocated, so entries can move
+		std::vector<int> matches;					// the connection's match #s -> MatchPool slots
+		sf::Packet outgoing;						// messages waiting to be sent
+		sf::Packet sending;							// the packet being sent (kept until it has all gone out)
+		bool inFlight{ false };
+		bool open{ false };
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	sf::TcpListener listener;
+	std::vector<Connection> connections;			// closed connections' entries are reused
+	MatchPool pool;
+	WorkerPool workers;
+	SpectatorServer spectators;						// (after the pool, which it refers to)
+	sf::Packet receivePacket;						// reused
+	unsigned int tick{ 0 };
+	unsigned int nextSeed{ 1 };
+	unsigned long long inputsReceived{ 0 };
+
+	// tick times (rings of TICK_HISTORY, and a scratch copy for sorting)
+	std::vector<double> tickSeconds;
+	std::vector<double> stepSeconds;
+	std::vector<double> sortScratch;
+	int recordedTicks{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor, allocates the match pool and starts the workers.
+	/// </summary>
+	/// <param name="capacity">the most matches at once</param>
+	/// <param name="workerThreads">the # of worker threads (as well as the server's thread)</param>
+	MatchServer(int capacity, int workerThreads);
+
+	/// <summary>
+	/// Starts listening for players and spectators.
+	/// </summary>
+	/// <param name="port">the players' port, or sf::Socket::AnyPort</param>
+	/// <param name="spectatorPort">the spectators' port, or sf::Socket::AnyPort</param>
+	/// <returns>true if the server is listening</returns>
+	bool listen(unsigned short port, unsigned short spectatorPort);
+
+	/// <summary>
+	/// Gets the port the server is listening on for players.
+	/// </summary>
+	unsigned short getPort() const;
+
+	/// <summary>
+	/// Gets the port the server is listening on for spectators.
+	/// </summary>
+	unsigned short getSpectatorPort() const;
+
+	/// <summary>
+	/// Runs one tick: network, simulation, status.
+	/// </summary>
+	void runTick();
+
+	/// <summary>
+	/// Runs ticks at TICKS_PER_SECOND, for the given time (or forever if seconds <= 0).
+	/// </summary>
+	/// <param name="reportSeconds">how often the TickReport is printed (0 for never)</param>
+	void run(double seconds, double reportSeconds);
+
+	/// <summary>
+	/// Gets the tick time percentiles (over the last TICK_HISTORY ticks) and the load.
+	/// </summary>
+	TickReport getReport();
+
+	/// <summary>
+	/// Prints a TickReport on one line.
+	/// </summary>
+	static void printReport(const TickReport& report);
+
+	/// <summary>
+	/// Runs a server until it's stopped (the --server mode).
+	/// </summary>
+	static void runServer(unsigned short port, int capacity);
+
+	/// <summary>
+	/// Runs a server and a LoadGenerator (on its own thread) in this process, and reports the tick times.
+	/// </summary>
+	/// <param name="matches">the # of matches the load generator opens</param>
+	/// <param name="seconds">how long to run</param>
+	static void runBenchmark(int matches, double seconds);
+
+private:
+	/// <summary>
+	/// Accepts every pending connection.
+	/// </summary>
+	void acceptConnections();
+
+	/// <summary>
+	/// Reads every packet that has arrived on a connection (none is NotReady).
+	/// </summary>
+	void receive(int connection);
+
+	/// <summary>
+	/// Handles the messages in a packet.
+	/// </summary>
+	/// <returns>false if the packet isn't valid (the connection is closed)</returns>
+	bool handleMessages(int connection, sf::Packet& packet);
+
+	/// <summary>
+	/// Queues the STATUS of a connection's matches.
+	/// </summary>
+	void queueStatus(Connection& connection);
+
+	/// <summary>
+	/// Sends a connection's queued messages (or more of the packet in flight).
+	/// </summary>
+	void flush(int connection);
+
+	/// <summary>
+	/// Closes a connection, and ends its matches.
+	/// </summary>
+	void closeConnection(int connection);
+};
+
+#endif /* MATCHSERVER_H */
@@ -0,0 +1,250 @@
+#include "Matchmaker.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+Matchmaker::Matchmaker(MatchPool& pool, int capacity, unsigned int seed)
+	: pool{ pool }, tickets(static_cast<size_t>(capacity)), results(static_cast<size_t>(capacity)), nextSeed{ seed }
+{
+	freeTickets.reserve(static_cast<size_t>(capacity));
+	for (int ticket = capacity - 1; ticket >= 0; ticket--)
+	{
+		freeTickets.push_back(ticket);
+	}
+	std::fill(std::begin(bucketHeads), std::end(bucketHeads), -1);
+	std::fill(std::begin(bucketTails), std::end(bucketTails), -1);
+	std::fill(std::begin(wheelHeads), std::end(wheelHeads), -1);
+}
+
+int Matchmaker::enqueue(int player, int rating, int pingMs, double nowMs)
+{
+	if (freeTickets.empty())
+	{
+		return -1;
+	}
+	int ticket = freeTickets.back();
+	freeTickets.pop_back();
+	Ticket& entry = tickets[ticket];
+	entry.player = player;
+	entry.rating = rating;
+	entry.pingMs = pingMs;
+	entry.enqueuedMs = nowMs;
+	entry.waiting = true;
+	waitingCount++;
+
+	// the back of its bucket's FIFO
+	entry.bucket = getBucket(rating, pingMs);
+	entry.previous = bucketTails[entry.bucket];
+	entry.next = -1;
+	if (entry.previous >= 0)
+	{
+		tickets[entry.previous].next = ticket;
+	}
+	else
+	{
+		bucketHeads[entry.bucket] = ticket;
+	}
+	bucketTails[entry.bucket] = ticket;
+
+	// the front of its wheel slot (the order there doesn't matter)
+	entry.wheelSlot = static_cast<int>(getWheelTick(nowMs) % WHEEL_SLOTS);
+	entry.wheelPrevious = -1;
+	entry.wheelNext = wheelHeads[entry.wheelSlot];
+	if (entry.wheelNext >= 0)
+	{
+		tickets[entry.wheelNext].wheelPrevious = ticket;
+	}
+	wheelHeads[entry.wheelSlot] = ticket;
+
+	search(ticket, nowMs);
+	return ticket;
+}
+
+bool Matchmaker::cancel(int ticket, int player)
+{
+	if (ticket < 0 || ticket >= getCapacity() || !tickets[ticket].waiting || tickets[ticket].player != player)
+	{
+		return false;
+	}
+	removeTicket(ticket);
+	return true;
+}
+
+void Matchmaker::update(double nowMs)
+{
+	long long tick = getWheelTick(nowMs);
+	// after a long gap, each slot is only searched once
+	long long first = std::max(wheelTick + 1, tick - WHEEL_SLOTS + 1);
+	for (long long slotTick{ first }; slotTick <= tick; slotTick++)
+	{
+		// a match can remove the next ticket in the slot, so removeTicket() moves the cursor on
+		wheelCursor = wheelHeads[slotTick % WHEEL_SLOTS];
+		while (wheelCursor >= 0)
+		{
+			int ticket = wheelCursor;
+			wheelCursor = tickets[ticket].wheelNext;
+			// tickets that joined during this slot's time were just searched by enqueue()
+			if (getWheelTick(tickets[ticket].enqueuedMs) != slotTick)
+			{
+				search(ticket, nowMs);
+			}
+		}
+	}
+	wheelTick = std::max(wheelTick, tick);
+}
+
+bool Matchmaker::pollMatch(MatchResult& result)
+{
+	if (resultCount == 0)
+	{
+		return false;
+	}
+	result = results[resultHead];
+	resultHead = (resultHead + 1) % static_cast<int>(results.size());
+	resultCount--;
+	return true;
+}
+
+int Matchmaker::getWindow(double waitMs)
+{
+	int widenings = static_cast<int>(std::max(waitMs, 0.0) / WIDEN_MS);
+	return std::min(BASE_WINDOW + std::min(widenings, MAX_WINDOW / WINDOW_GROWTH) * WINDOW_GROWTH, static_cast<int>(MAX_WINDOW));
+}
+
+int Matchmaker::getBucket(int rating, int pingMs)
+{
+	int ratingBucket = std::min(std::max(rating, 0) / RATING_BUCKET_WIDTH, RATING_BUCKETS - 1);
+	int pingBucket = std::min(std::max(pingMs, 0) / PING_BUCKET_MS, PING_BUCKETS - 1);
+	return pingBucket * RATING_BUCKETS + ratingBucket;
+}
+
+int Matchmaker::getCapacity() const { return static_cast<int>(tickets.size()); }
+
+int Matchmaker::getWaitingCount() const { return waitingCount; }
+
+unsigned long long Matchmaker::getMatchesMade() const { return matchesMade; }
+
+unsigned long long Matchmaker::getSearches() const { return searches; }
+
+unsigned long long Matchmaker::getSearchesDeferred() const { return searchesDeferred; }
+
+bool Matchmaker::search(int ticket, double nowMs)
+{
+	searches++;
+	if (pool.getActiveCount() >= pool.getCapacity() || resultCount >= static_cast<int>(results.size()))
+	{
+		searchesDeferred++;
+		return false;
+	}
+	const Ticket& entry = tickets[ticket];
+	double waitMs = nowMs - entry.enqueuedMs;
+	int window = getWindow(waitMs);
+	int pingBucket = entry.bucket / RATING_BUCKETS;
+	int pingReach = (waitMs >= PING_RELAX_MS) ? 1 : 0;
+	int lowestBucket = getBucket(entry.rating - window, 0);
+	int highestBucket = getBucket(entry.rating + window, 0);
+
+	int best{ -1 };
+	int bestGap{ INT_MAX };
+	for (int distance{ 0 }; distance <= pingReach && best < 0; distance++)
+	{
+		for (int side{ -1 }; side <= 1; side += 2)
+		{
+			int searchedPing = pingBucket + side * distance;
+			if (searchedPing < 0 || searchedPing >= PING_BUCKETS || (distance == 0 && side > 0))
+			{
+				continue;
+			}
+			for (int ratingBucket{ lowestBucket }; ratingBucket <= highestBucket; ratingBucket++)
+			{
+				int candidate = bucketHeads[searchedPing * RATING_BUCKETS + ratingBucket];
+				for (int scanned{ 0 }; candidate >= 0 && scanned < MAX_SCAN; scanned++, candidate = tickets[candidate].next)
+				{
+					if (candidate == ticket)
+					{
+						continue;
+					}
+					int gap = std::abs(tickets[candidate].rating - entry.rating);
+					if (gap <= window && (gap < bestGap || (gap == bestGap && tickets[candidate].enqueuedMs < tickets[best].enqueuedMs)))
+					{
+						best = candidate;
+						bestGap = gap;
+					}
+				}
+			}
+		}
+	}
+	if (best < 0)
+	{
+		return false;
+	}
+	makeMatch(ticket, best, nowMs);
+	return true;
+}
+
+void Matchmaker::makeMatch(int first, int second, double nowMs)
+{
+	MatchResult& result = results[(resultHead + resultCount) % static_cast<int>(results.size())];
+	int matched[ServerMatch::PLAYER_COUNT]{ first, second };
+	for (int player{ 0 }; player < ServerMatch::PLAYER_COUNT; player++)
+	{
+		const Ticket& entry = tickets[matched[player]];
+		result.players[player] = entry.player;
+		result.ratings[player] = entry.rating;
+		result.pingMs[player] = entry.pingMs;
+		result.waitMs[player] = nowMs - entry.enqueuedMs;
+	}
+	result.slot = pool.allocate(nextSeed++, -1);
+	resultCount++;
+	matchesMade++;
+	removeTicket(first);
+	removeTicket(second);
+}
+
+void Matchmaker::removeTicket(int ticket)
+{
+	Ticket& entry = tickets[ticket];
+	if (entry.previous >= 0)
+	{
+		tickets[entry.previous].next = entry.next;
+	}
+	else
+	{
+		bucketHeads[entry.bucket] = entry.next;
+	}
+	if (entry.next >= 0)
+	{
+		tickets[entry.next].previous = entry.previous;
+	}
+	else
+	{
+		bucketTails[entry.bucket] = entry.previous;
+	}
+
+	if (wheelCursor == ticket)
+	{
+		wheelCursor = entry.wheelNext;
+	}
+	if (entry.wheelPrevious >= 0)
+	{
+		tickets[entry.wheelPrevious].wheelNext = entry.wheelNext;
+	}
+	else
+	{
+		wheelHeads[entry.wheelSlot] = entry.wheelNext;
+	}
+	if (entry.wheelNext >= 0)
+	{
+		tickets[entry.wheelNext].wheelPrevious = entry.wheelPrevious;
+	}
+
+	entry.waiting = false;
+	freeTickets.push_back(ticket);
+	waitingCount--;
+}
+
+long long Matchmaker::getWheelTick(double nowMs)
+{
+	return static_cast<long long>(std::floor(nowMs / (static_cast<double>(WIDEN_MS) / WHEEL_SLOTS)));
+}
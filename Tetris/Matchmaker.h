@@ -0,0 +1,174 @@
+// The Matchmaker is an in-process queue that pairs waiting players by rating and ping, and starts
+// each pair's match in a MatchPool.  Every waiting player holds a ticket, and the tickets are kept
+// in buckets: PING_BUCKETS ping ranges (PING_BUCKET_MS wide) x RATING_BUCKETS rating ranges
+// (RATING_BUCKET_WIDTH wide).  Each bucket is a FIFO (an intrusive list), so the player who's
+// waited longest is found first.
+//
+// Two players match when they're in the same ping bucket and their ratings are within the
+// searching player's window: BASE_WINDOW, widened by WINDOW_GROWTH every WIDEN_MS of waiting
+// (up to MAX_WINDOW).  After PING_RELAX_MS the neighbouring ping buckets are searched too (once
+// the player's own has nobody close enough).  Of the candidates, the closest rating wins (the
+// longest waiting breaks ties).  A search looks at the few buckets the window covers, and at most
+// MAX_SCAN tickets in each, so it costs the same however many players are waiting.
+//
+// enqueue() searches for the new player straight away.  Since windows widen, update() searches
+// again for every ticket once per WIDEN_MS: the tickets sit on a timing wheel of WHEEL_SLOTS slots
+// by the time they joined (mod WIDEN_MS), and update() searches the slots whose time has passed.
+// So the work per update is spread out evenly, and each ticket is searched about once a second.
+//
+// A match takes a MatchPool slot (allocate() resets two preallocated games) and is queued as a
+// MatchResult for pollMatch().  Tickets, buckets, the wheel and the results are all arrays sized
+// by the constructor, so enqueue(), cancel(), update() and pollMatch() don't allocate.  When the
+// pool (or the results queue) is full, players keep waiting and are searched again later.
+//
+// See MatchmakingLoad for the synthetic clients that load test it.
+
+#ifndef MATCHMAKER_H
+#define MATCHMAKER_H
+
+#include "MatchPool.h"
+#include <vector>
+
+/// <summary>
+/// Two players that were matched, and the MatchPool slot their match started in.
+/// </summary>
+struct MatchResult
+{
+	int players[ServerMatch::PLAYER_COUNT]{ -1, -1 };	// the player ids given to enqueue()
+	int ratings[ServerMatch::PLAYER_COUNT]{};
+	int pingMs[ServerMatch::PLAYER_COUNT]{};
+	double waitMs[ServerMatch::PLAYER_COUNT]{};		// time in the queue
+	int slot{ -1 };
+};
+
+class Matchmaker
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int RATING_BUCKET_WIDTH = 50;
+	static const int RATING_BUCKETS = 64;			// ratings 0 ... 3199 (others are clamped)
+	static const int PING_BUCKET_MS = 40;
+	static const int PING_BUCKETS = 6;				// the last holds everything 200 ms and up
+	static const int BASE_WINDOW = 50;				// the rating difference accepted straight away
+	static const int WINDOW_GROWTH = 25;			// added to the window every WIDEN_MS
+	static const int MAX_WINDOW = 400;
+	static const int WIDEN_MS = 1000;
+	static const int PING_RELAX_MS = 10000;			// waiting before the neighbouring ping buckets are searched
+	static const int MAX_SCAN = 8;					// tickets looked at per bucket, per search
+	static const int WHEEL_SLOTS = 20;				// so update() handles WIDEN_MS / WHEEL_SLOTS = 50 ms of tickets per slot
+
+private:
+	/// <summary>
+	/// A waiting player.
+	/// </summary>
+	struct Ticket
+	{
+		int player{ -1 };
+		int rating{ 0 };
+		int pingMs{ 0 };
+		double enqueuedMs{ 0.0 };
+		int bucket{ 0 };
+		int previous{ -1 };							// in the bucket's FIFO
+		int next{ -1 };
+		int wheelSlot{ 0 };
+		int wheelPrevious{ -1 };					// in the wheel slot's list
+		int wheelNext{ -1 };
+		bool waiting{ false };
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	MatchPool& pool;
+	std::vector<Ticket> tickets;					// sized once
+	std::vector<int> freeTickets;					// a stack
+	int bucketHeads[PING_BUCKETS * RATING_BUCKETS];
+	int bucketTails[PING_BUCKETS * RATING_BUCKETS];
+	int wheelHeads[WHEEL_SLOTS];
+	int wheelCursor{ -1 };							// the ticket update() searches next (kept valid when it's removed)
+	long long wheelTick{ -1 };						// the last wheel tick update() handled
+	std::vector<MatchResult> results;				// a ring
+	int resultHead{ 0 };
+	int resultCount{ 0 };
+	unsigned int nextSeed;
+	int waitingCount{ 0 };
+
+	// statistics
+	unsigned long long matchesMade{ 0 };
+	unsigned long long searches{ 0 };
+	unsigned long long searchesDeferred{ 0 };		// the pool or the results queue was full
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor, allocates everything up front.
+	/// </summary>
+	/// <param name="pool">where matches are started</param>
+	/// <param name="capacity">the most players that can wait at once</param>
+	/// <param name="seed">the first match's seed (each match after gets the next)</param>
+	Matchmaker(MatchPool& pool, int capacity, unsigned int seed);
+
+	/// <summary>
+	/// Adds a player to the queue, and searches for an opponent.
+	/// </summary>
+	/// <returns>the player's ticket (for cancel()), or -1 if the queue is full</returns>
+	int enqueue(int player, int rating, int pingMs, double nowMs);
+
+	/// <summary>
+	/// Takes a waiting player out of the queue.
+	/// </summary>
+	/// <returns>false if the player wasn't waiting on that ticket (eg. they've been matched)</returns>
+	bool cancel(int ticket, int player);
+
+	/// <summary>
+	/// Searches again for the tickets whose windows have widened since update() was last called.
+	/// </summary>
+	void update(double nowMs);
+
+	/// <summary>
+	/// Takes the oldest match made.
+	/// </summary>
+	/// <returns>false if there isn't one</returns>
+	bool pollMatch(MatchResult& result);
+
+	/// <summary>
+	/// Gets the rating window for a player who's waited a while.
+	/// </summary>
+	static int getWindow(double waitMs);
+
+	/// <summary>
+	/// Gets the bucket for a rating and ping.
+	/// </summary>
+	static int getBucket(int rating, int pingMs);
+
+	// Getters
+	int getCapacity() const;
+	int getWaitingCount() const;
+	unsigned long long getMatchesMade() const;
+	unsigned long long getSearches() const;
+	unsigned long long getSearchesDeferred() const;
+
+private:
+	/// <summary>
+	/// Looks for an opponent for a ticket, and matches them if there's one.
+	/// </summary>
+	/// <returns>true if the ticket was matched</returns>
+	bool search(int ticket, double nowMs);
+
+	/// <summary>
+	/// Starts a match for two tickets, and frees them.
+	/// </summary>
+	void makeMatch(int first, int second, double nowMs);
+
+	/// <summary>
+	/// Takes a ticket out of its bucket and wheel slot, and frees it.
+	/// </summary>
+	void removeTicket(int ticket);
+
+	/// <summary>
+	/// Gets a wheel tick (a WIDEN_MS / WHEEL_SLOTS period) for a time.
+	/// </summary>
+	static long long getWheelTick(double nowMs);
+};
+
+#endif /* MATCHMAKER_H */
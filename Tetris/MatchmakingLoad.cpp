@@ -0,0 +1,167 @@
+#include "MatchmakingLoad.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <utility>
+#include "LatencyStats.h"
+
+MatchmakingReport MatchmakingLoad::run(const MatchmakingLoadSettings& settings)
+{
+	// a synthetic client: its ticket, while it's waiting
+	struct Client
+	{
+		int ticket{ -1 };
+		bool waiting{ false };
+	};
+
+	MatchmakingReport report;
+	MatchPool pool(settings.poolCapacity);
+	Matchmaker matchmaker(pool, settings.queueCapacity, settings.seed);
+	std::mt19937 random(settings.seed);
+	std::exponential_distribution<double> arrivalGapMs(settings.clientsPerSecond / 1000.0);
+	std::normal_distribution<double> ratings(1500.0, 350.0);
+	std::exponential_distribution<double> extraPingMs(1.0 / 45.0);
+	std::uniform_real_distribution<double> percent(0.0, 100.0);
+	std::uniform_real_distribution<double> patienceMs(2000.0, 20000.0);
+
+	// the harness allocates as it likes, the Matchmaker doesn't
+	size_t expectedClients = static_cast<size_t>(settings.clientsPerSecond * settings.seconds * 1.1) + 16;
+	std::vector<Client> clients;
+	clients.reserve(expectedClients);
+	std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<std::pair<double, int>>> giveUps;
+	std::deque<std::pair<double, int>> endings;		// (end time, slot), in order since every match is as long
+	std::vector<double> latenciesUs;
+	latenciesUs.reserve(expectedClients * 2 + static_cast<size_t>(settings.seconds * 1000.0 / UPDATE_MS) * 2);
+	std::vector<double> waitsMs;
+	waitsMs.reserve(expectedClients);
+	unsigned long long totalRatingGap{ 0 };
+
+	auto timed = [&](auto operation)
+	{
+		auto start = std::chrono::steady_clock::now();
+		operation();
+		double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+		latenciesUs.push_back(us);
+		report.operationSeconds += us / 1000000.0;
+	};
+
+	double endMs = settings.seconds * 1000.0;
+	double nextArrivalMs = arrivalGapMs(random);
+	for (double nowMs{ 0.0 }; nowMs <= endMs; nowMs += UPDATE_MS)
+	{
+		while (!endings.empty() && endings.front().first <= nowMs)
+		{
+			pool.release(endings.front().second);
+			endings.pop_front();
+		}
+
+		// new clients join the queue (at their own arrival times)
+		while (nextArrivalMs <= nowMs)
+		{
+			int player = static_cast<int>(clients.size());
+			int rating = static_cast<int>(std::lround(ratings(random)));
+			int pingMs = 15 + static_cast<int>(std::min(extraPingMs(random), 400.0));
+			clients.push_back(Client());
+			report.clients++;
+			int ticket{ -1 };
+			timed([&]() { ticket = matchmaker.enqueue(player, rating, pingMs, nextArrivalMs); });
+			if (ticket < 0)
+			{
+				report.rejected++;
+			}
+			else
+			{
+				clients[player].ticket = ticket;
+				clients[player].waiting = true;
+				if (percent(random) < settings.cancelPercent)
+				{
+					giveUps.emplace(nextArrivalMs + patienceMs(random), player);
+				}
+			}
+			nextArrivalMs += arrivalGapMs(random);
+		}
+
+		// impatient clients leave (unless they've been matched)
+		while (!giveUps.empty() && giveUps.top().first <= nowMs)
+		{
+			int player = giveUps.top().second;
+			giveUps.pop();
+			bool cancelled{ false };
+			timed([&]() { cancelled = matchmaker.cancel(clients[player].ticket, player); });
+			if (cancelled)
+			{
+				clients[player].waiting = false;
+				report.cancelled++;
+			}
+		}
+
+		timed([&]() { matchmaker.update(nowMs); });
+		report.peakWaiting = std::max(report.peakWaiting, matchmaker.getWaitingCount());
+
+		MatchResult result;
+		bool matched{ true };
+		while (true)
+		{
+			timed([&]() { matched = matchmaker.pollMatch(result); });
+			if (!matched)
+			{
+				break;
+			}
+			report.matches++;
+			for (int player{ 0 }; player < ServerMatch::PLAYER_COUNT; player++)
+			{
+				clients[result.players[player]].waiting = false;
+				waitsMs.push_back(result.waitMs[player]);
+			}
+			int gap = std::abs(result.ratings[0] - result.ratings[1]);
+			totalRatingGap += static_cast<unsigned long long>(gap);
+			report.maxRatingGap = std::max(report.maxRatingGap, gap);
+			if (Matchmaker::getBucket(0, result.pingMs[0]) != Matchmaker::getBucket(0, result.pingMs[1]))
+			{
+				report.crossPingMatches++;
+			}
+			if (result.slot >= 0 && pool.getMatch(result.slot).active && pool.getMatch(result.slot).games[0].getFrame() == 0)
+			{
+				report.matchesStarted++;
+				endings.emplace_back(nowMs + settings.matchSeconds * 1000.0, result.slot);
+			}
+		}
+		report.peakActiveMatches = std::max(report.peakActiveMatches, pool.getActiveCount());
+	}
+
+	report.operations = latenciesUs.size();
+	report.searchesDeferred = matchmaker.getSearchesDeferred();
+	report.stillWaiting = matchmaker.getWaitingCount();
+	report.averageRatingGap = report.matches > 0 ? static_cast<double>(totalRatingGap) / report.matches : 0.0;
+	int latencyCount = static_cast<int>(latenciesUs.size());
+	report.latencyP50Us = LatencyStats::getPercentile(latenciesUs.data(), latencyCount, 0.50);
+	report.latencyP99Us = LatencyStats::getPercentile(latenciesUs.data(), latencyCount, 0.99);
+	report.latencyMaxUs = LatencyStats::getPercentile(latenciesUs.data(), latencyCount, 1.0);
+	int waitCount = static_cast<int>(waitsMs.size());
+	report.waitP50Ms = LatencyStats::getPercentile(waitsMs.data(), waitCount, 0.50);
+	report.waitP95Ms = LatencyStats::getPercentile(waitsMs.data(), waitCount, 0.95);
+	report.waitMaxMs = LatencyStats::getPercentile(waitsMs.data(), waitCount, 1.0);
+	return report;
+}
+
+void MatchmakingLoad::runBenchmark(const MatchmakingLoadSettings& settings)
+{
+	std::cout << "matchmaking " << settings.clientsPerSecond << " clients/sec for " << settings.seconds << " sec (simulated), "
+		<< settings.cancelPercent << "% impatient, " << settings.matchSeconds << " sec matches in a pool of " << settings.poolCapacity << "\n";
+	MatchmakingReport report = run(settings);
+	std::cout << report.clients << " clients: " << report.matches << " matches (" << report.matchesStarted << " started in the pool), "
+		<< report.cancelled << " gave up, " << report.rejected << " turned away (queue full), " << report.stillWaiting << " still waiting\n";
+	std::cout << report.operations << " operations in " << report.operationSeconds * 1000.0 << " ms = "
+		<< (report.operationSeconds > 0.0 ? report.operations / report.operationSeconds : 0.0) << " operations/sec\n";
+	std::cout << "operation latency: p50 " << report.latencyP50Us << " us, p99 " << report.latencyP99Us << " us, max " << report.latencyMaxUs << " us\n";
+	std::cout << "queue wait: p50 " << report.waitP50Ms << " ms, p95 " << report.waitP95Ms << " ms, max " << report.waitMaxMs << " ms\n";
+	std::cout << "rating gap: avg " << report.averageRatingGap << ", max " << report.maxRatingGap << "; "
+		<< report.crossPingMatches << " matches across ping buckets\n";
+	std::cout << "peaks: " << report.peakWaiting << " waiting, " << report.peakActiveMatches << " active matches ("
+		<< report.searchesDeferred << " searches deferred on a full pool)\n";
+}
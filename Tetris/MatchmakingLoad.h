@@ -0,0 +1,79 @@
+// MatchmakingLoad load tests a Matchmaker with synthetic clients, in process.  Clients arrive at
+// random (a Poisson process, clientsPerSecond on average) with a rating (normal, around 1500) and
+// a ping (mostly low, with a long tail).  cancelPercent of them give up if they haven't been
+// matched within a random 2 ... 20 sec.  Matches hold their MatchPool slot for matchSeconds, then
+// are released.
+//
+// Time is simulated (in UPDATE_MS steps), so a minute of traffic runs in well under a second, but
+// every call into the Matchmaker is timed on the real clock: the report has the operations per
+// second of matchmaker time and the latency percentiles of single operations, along with the
+// waits, rating gaps and ping mismatches of the matches made.
+
+#ifndef MATCHMAKINGLOAD_H
+#define MATCHMAKINGLOAD_H
+
+#include "Matchmaker.h"
+#include <vector>
+
+/// <summary>
+/// The synthetic traffic.
+/// </summary>
+struct MatchmakingLoadSettings
+{
+	double clientsPerSecond{ 2000.0 };
+	double seconds{ 60.0 };				// simulated
+	double cancelPercent{ 10.0 };
+	double matchSeconds{ 3.0 };			// how long a match holds its pool slot
+	int poolCapacity{ 4096 };
+	int queueCapacity{ 16384 };
+	unsigned int seed{ 1 };
+};
+
+/// <summary>
+/// What happened.
+/// </summary>
+struct MatchmakingReport
+{
+	unsigned long long clients{ 0 };
+	unsigned long long rejected{ 0 };		// the queue was full
+	unsigned long long cancelled{ 0 };
+	unsigned long long matches{ 0 };
+	unsigned long long matchesStarted{ 0 };	// handed a pool slot with both games reset
+	unsigned long long crossPingMatches{ 0 };	// between neighbouring ping buckets
+	unsigned long long operations{ 0 };		// enqueue(), cancel(), update() and pollMatch() calls
+	unsigned long long searchesDeferred{ 0 };
+	double operationSeconds{ 0.0 };			// real time spent in the Matchmaker
+	double latencyP50Us{ 0.0 };				// of single operations
+	double latencyP99Us{ 0.0 };
+	double latencyMaxUs{ 0.0 };
+	double waitP50Ms{ 0.0 };				// time in the queue before a match
+	double waitP95Ms{ 0.0 };
+	double waitMaxMs{ 0.0 };
+	double averageRatingGap{ 0.0 };
+	int maxRatingGap{ 0 };
+	int peakWaiting{ 0 };
+	int peakActiveMatches{ 0 };
+	int stillWaiting{ 0 };
+};
+
+class MatchmakingLoad
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int UPDATE_MS = 10;		// simulated time between Matchmaker::update() calls
+
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Runs the synthetic clients against a new Matchmaker and MatchPool.
+	/// </summary>
+	static MatchmakingReport run(const MatchmakingLoadSettings& settings);
+
+	/// <summary>
+	/// Runs the synthetic clients and prints the report.
+	/// </summary>
+	static void runBenchmark(const MatchmakingLoadSettings& settings);
+};
+
+#endif /* MATCHMAKINGLOAD_H */
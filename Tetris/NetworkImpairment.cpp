@@ -0,0 +1,133 @@
+#include "NetworkImpairment.h"
+#include <algorithm>
+
+const double NetworkImpairment::RETRANSMIT_MS{ 200.0 };
+const double NetworkImpairment::REORDER_MS{ 30.0 };
+
+NetworkImpairment::NetworkImpairment(const ImpairmentSettings& settings, bool ordered)
+	: settings{ settings }, ordered{ ordered }, randomGenerator{ settings.seed }
+{
+}
+
+void NetworkImpairment::submit(const unsigned char* data, size_t size, double nowMs)
+{
+	packetsSubmitted++;
+	double releaseMs = nowMs + settings.latencyMs + getJitter();
+	if (ordered)
+	{
+		if (roll(settings.lossPercent))
+		{
+			packetsRetransmitted++;
+			releaseMs += RETRANSMIT_MS;
+		}
+		// a stream can't deliver a chunk before the ones ahead of it
+		releaseMs = std::max(releaseMs, lastReleaseMs);
+		lastReleaseMs = releaseMs;
+		hold(data, size, releaseMs);
+		return;
+	}
+
+	if (roll(settings.lossPercent))
+	{
+		packetsDropped++;
+		return;
+	}
+	if (roll(settings.reorderPercent))
+	{
+		packetsReordered++;
+		releaseMs += REORDER_MS;
+	}
+	hold(data, size, releaseMs);
+	if (roll(settings.duplicatePercent))
+	{
+		packetsDuplicated++;
+		hold(data, size, nowMs + settings.latencyMs + getJitter());
+	}
+}
+
+bool NetworkImpairment::release(double nowMs, std::vector<unsigned char>& bytes)
+{
+	if (held.empty() || held.front().releaseMs > nowMs)
+	{
+		return false;
+	}
+	std::pop_heap(held.begin(), held.end(), releasesLater);
+	bytes.swap(held.back().bytes);
+	// the caller's old buffer is recycled
+	spareBuffers.push_back(std::vector<unsigned char>());
+	spareBuffers.back().swap(held.back().bytes);
+	held.pop_back();
+
+	packetsReleased++;
+	bytesReleased += bytes.size();
+	return true;
+}
+
+void NetworkImpairment::clear()
+{
+	for (HeldPacket& packet : held)
+	{
+		spareBuffers.push_back(std::vector<unsigned char>());
+		spareBuffers.back().swap(packet.bytes);
+	}
+	held.clear();
+	lastReleaseMs = 0.0;
+}
+
+const ImpairmentSettings& NetworkImpairment::getSettings() const { return settings; }
+
+bool NetworkImpairment::isOrdered() const { return ordered; }
+
+size_t NetworkImpairment::getHeldCount() const { return held.size(); }
+
+unsigned long long NetworkImpairment::getPacketsSubmitted() const { return packetsSubmitted; }
+
+unsigned long long NetworkImpairment::getPacketsReleased() const { return packetsReleased; }
+
+unsigned long long NetworkImpairment::getPacketsDropped() const { return packetsDropped; }
+
+unsigned long long NetworkImpairment::getPacketsRetransmitted() const { return packetsRetransmitted; }
+
+unsigned long long NetworkImpairment::getPacketsDuplicated() const { return packetsDuplicated; }
+
+unsigned long long NetworkImpairment::getPacketsReordered() const { return packetsReordered; }
+
+unsigned long long NetworkImpairment::getBytesReleased() const { return bytesReleased; }
+
+void NetworkImpairment::hold(const unsigned char* data, size_t size, double releaseMs)
+{
+	HeldPacket packet;
+	packet.releaseMs = releaseMs;
+	packet.sequence = nextSequence++;
+	if (!spareBuffers.empty())
+	{
+		packet.bytes.swap(spareBuffers.back());
+		spareBuffers.pop_back();
+	}
+	packet.bytes.assign(data, data + size);
+	held.push_back(std::move(packet));
+	std::push_heap(held.begin(), held.end(), releasesLater);
+}
+
+bool NetworkImpairment::releasesLater(const HeldPacket& a, const HeldPacket& b)
+{
+	return a.releaseMs != b.releaseMs ? a.releaseMs > b.releaseMs : a.sequence > b.sequence;
+}
+
+bool NetworkImpairment::roll(double percent)
+{
+	if (percent <= 0.0)
+	{
+		return false;
+	}
+	return std::uniform_real_distribution<double>(0.0, 100.0)(randomGenerator) < percent;
+}
+
+double NetworkImpairment::getJitter()
+{
+	if (settings.jitterMs <= 0.0)
+	{
+		return 0.0;
+	}
+	return std::uniform_real_distribution<double>(0.0, settings.jitterMs)(randomGenerator);
+}
@@ -0,0 +1,137 @@
+// A NetworkImpairment is one direction of a bad network: packets submit()ted to it come back out
+// of release() late, or not at all, as set by ImpairmentSettings:
+//  - latency + jitter: each packet is held for latencyMs plus a random 0 ... jitterMs.
+//  - loss: the packet is dropped.
+//  - duplication: a second copy is sent (with its own jitter).
+//  - reordering: the packet is held an extra REORDER_MS, so the packets behind it overtake it.
+// The random choices come from a seeded generator, so the same settings and traffic give the
+// same network every run.
+//
+// An ordered impairment stands in for a TCP connection: bytes can't be lost, duplicated or
+// reordered, so a "lost" chunk is held an extra RETRANSMIT_MS (a retransmission timeout) instead,
+// and nothing is released before the chunks ahead of it (head-of-line blocking).
+//
+// Held packets are kept in a heap by release time.  Their buffers are recycled, so once traffic
+// has warmed up, submit() and release() don't allocate.  The ImpairmentProxy runs one per direction.
+
+#ifndef NETWORKIMPAIRMENT_H
+#define NETWORKIMPAIRMENT_H
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+/// <summary>
+/// How bad the network is (one way).
+/// </summary>
+struct ImpairmentSettings
+{
+	double latencyMs{ 0.0 };				// the delay every packet gets
+	double jitterMs{ 0.0 };					// plus a random delay of up to this
+	double lossPercent{ 0.0 };				// chance a packet is dropped (retransmitted, if ordered)
+	double duplicatePercent{ 0.0 };			// chance a packet is sent twice (not if ordered)
+	double reorderPercent{ 0.0 };			// chance a packet is held back REORDER_MS (not if ordered)
+	unsigned int seed{ 1 };
+};
+
+class NetworkImpairment
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const double RETRANSMIT_MS;		// the extra delay of a lost TCP chunk, init to 200 (the usual minimum RTO)
+	static const double REORDER_MS;			// the extra delay of a reordered packet, init to 30
+
+private:
+	/// <summary>
+	/// A packet waiting to be released.
+	/// </summary>
+	struct HeldPacket
+	{
+		double releaseMs{ 0.0 };
+		unsigned long long sequence{ 0 };	// breaks ties, so packets due together keep their order
+		std::vector<unsigned char> bytes;
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	ImpairmentSettings settings;
+	bool ordered;
+	std::mt19937 randomGenerator;
+	std::vector<HeldPacket> held;							// a heap, the earliest release first
+	std::vector<std::vector<unsigned char>> spareBuffers;	// recycled packet buffers
+	unsigned long long nextSequence{ 0 };
+	double lastReleaseMs{ 0.0 };			// (ordered) the release time of the last chunk submitted
+
+	// statistics
+	unsigned long long packetsSubmitted{ 0 };
+	unsigned long long packetsReleased{ 0 };
+	unsigned long long packetsDropped{ 0 };			// lost (unordered)
+	unsigned long long packetsRetransmitted{ 0 };	// lost (ordered)
+	unsigned long long packetsDuplicated{ 0 };
+	unsigned long long packetsReordered{ 0 };
+	unsigned long long bytesReleased{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="settings">how bad the network is</param>
+	/// <param name="ordered">true for a stream (TCP), false for datagrams (UDP)</param>
+	NetworkImpairment(const ImpairmentSettings& settings, bool ordered);
+
+	/// <summary>
+	/// Sends a packet into the network.
+	/// </summary>
+	/// <param name="nowMs">the current time</param>
+	void submit(const unsigned char* data, size_t size, double nowMs);
+
+	/// <summary>
+	/// Takes the next packet that's due.
+	/// </summary>
+	/// <param name="nowMs">the current time</param>
+	/// <param name="bytes">set to the packet (its old buffer is kept for reuse)</param>
+	/// <returns>false if no packet is due yet</returns>
+	bool release(double nowMs, std::vector<unsigned char>& bytes);
+
+	/// <summary>
+	/// Drops every packet in flight (ie. when the connection closes).
+	/// </summary>
+	void clear();
+
+	// Getters
+	const ImpairmentSettings& getSettings() const;
+	bool isOrdered() const;
+	size_t getHeldCount() const;
+	unsigned long long getPacketsSubmitted() const;
+	unsigned long long getPacketsReleased() const;
+	unsigned long long getPacketsDropped() const;
+	unsigned long long getPacketsRetransmitted() const;
+	unsigned long long getPacketsDuplicated() const;
+	unsigned long long getPacketsReordered() const;
+	unsigned long long getBytesReleased() const;
+
+private:
+	/// <summary>
+	/// Adds a copy of a packet to the heap.
+	/// </summary>
+	void hold(const unsigned char* data, size_t size, double releaseMs);
+
+	/// <summary>
+	/// The heap order: true if a is released after b.
+	/// </summary>
+	static bool releasesLater(const HeldPacket& a, const HeldPacket& b);
+
+	/// <summary>
+	/// Rolls the dice: true with the given chance.
+	/// </summary>
+	bool roll(double percent);
+
+	/// <summary>
+	/// Gets a random delay of 0 ... jitterMs.
+	/// </summary>
+	double getJitter();
+};
+
+#endif /* NETWORKIMPAIRMENT_H */
@@ -0,0 +1,164 @@
+#include "Perft.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+Perft::Perft() {}
+
+unsigned long long Perft::count(const Gameboard& board, const std::vector<TetShape>& sequence, int depth)
+{
+	prepare(board, sequence, depth);
+	nodes = 0;
+	return countFrom(0, depth);
+}
+
+unsigned long long Perft::countParallel(const Gameboard& board, const std::vector<TetShape>& sequence, int depth,
+	int threadCount, unsigned long long* totalNodes)
+{
+	if (threadCount <= 0)
+	{
+		threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	if (depth <= 1 || sequence.empty())
+	{
+		Perft perft;
+		unsigned long long leaves = perft.count(board, sequence, depth);
+		if (totalNodes != nullptr)
+		{
+			*totalNodes = perft.getNodes();
+		}
+		return leaves;
+	}
+
+	// the first ply is generated here, and the subtrees below it are shared out between the threads
+	PlacementGenerator rootGenerator;
+	std::vector<Placement> rootPlacements;
+	rootGenerator.generate(board, sequence[0], rootPlacements);
+
+	// the subtrees start with the second shape in the sequence
+	std::vector<TetShape> childSequence(sequence.begin() + 1, sequence.end());
+	childSequence.push_back(sequence[0]);
+
+	std::atomic<size_t> nextPlacement{ 0 };
+	std::atomic<unsigned long long> leaves{ 0 };
+	std::atomic<unsigned long long> nodeCount{ rootPlacements.size() };
+
+	auto workerLoop = [&]()
+	{
+		Perft perft;
+		Gameboard childBoard;
+		for (size_t i = nextPlacement.fetch_add(1); i < rootPlacements.size(); i = nextPlacement.fetch_add(1))
+		{
+			childBoard = board;
+			perft.generator.lockPlacement(childBoard, sequence[0], rootPlacements[i]);
+			childBoard.removeCompletedRows();
+			leaves += perft.count(childBoard, childSequence, depth - 1);
+			nodeCount += perft.getNodes();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i{ 1 }; i < threadCount; i++)
+	{
+		threads.emplace_back(workerLoop);
+	}
+	workerLoop();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (totalNodes != nullptr)
+	{
+		*totalNodes = nodeCount;
+	}
+	return leaves;
+}
+
+unsigned long long Perft::getNodes() const { return nodes; }
+
+void Perft::runBenchmark(int maxDepth)
+{
+	// the 7 shapes in their enum order, repeated
+	std::vector<TetShape> sequence;
+	for (int shape{ 0 }; shape < static_cast<int>(TetShape::COUNT); shape++)
+	{
+		sequence.push_back(static_cast<TetShape>(shape));
+	}
+	// known-good counts for this sequence (all four match TestSuite's brute force enumerator, which checks depth 3 on every run)
+	const unsigned long long expected[] = { 17, 289, 9826, 334084 };
+	const int expectedCount = sizeof(expected) / sizeof(expected[0]);
+
+	Gameboard board;
+	int threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	std::cout << "perft on an empty board, sequence S Z L J O I T (" << threadCount << " threads)\n";
+	for (int depth{ 1 }; depth <= maxDepth; depth++)
+	{
+		Perft perft;
+		auto start = std::chrono::steady_clock::now();
+		unsigned long long leaves = perft.count(board, sequence, depth);
+		double singleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		unsigned long long parallelNodes{ 0 };
+		start = std::chrono::steady_clock::now();
+		unsigned long long parallelLeaves = countParallel(board, sequence, depth, threadCount, &parallelNodes);
+		double parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "depth " << depth << ": " << leaves;
+		if (depth <= expectedCount && leaves != expected[depth - 1])
+		{
+			std::cout << " (WRONG: expected " << expected[depth - 1] << ")";
+		}
+		if (parallelLeaves != leaves)
+		{
+			std::cout << " (MISMATCH: parallel counted " << parallelLeaves << ")";
+		}
+		std::cout << "  single: " << (singleSeconds > 0.0 ? perft.getNodes() / singleSeconds : 0.0) << " nodes/sec"
+			<< "  parallel: " << (parallelSeconds > 0.0 ? parallelNodes / parallelSeconds : 0.0) << " nodes/sec\n";
+	}
+}
+
+void Perft::prepare(const Gameboard& board, const std::vector<TetShape>& sequence, int depth)
+{
+	this->sequence = sequence;
+	// only grows, so a reused Perft doesn't reallocate for the same (or a smaller) depth
+	if (static_cast<int>(boards.size()) < depth + 1)
+	{
+		boards.resize(depth + 1);
+		placements.resize(depth + 1);
+	}
+	boards[0] = board;
+}
+
+unsigned long long Perft::countFrom(int ply, int depth)
+{
+	if (depth == 0 || sequence.empty())
+	{
+		return 1;
+	}
+
+	TetShape shape = sequence[ply % sequence.size()];
+	std::vector<Placement>& plyPlacements = placements[ply];
+	generator.generate(boards[ply], shape, plyPlacements);
+	nodes += plyPlacements.size();
+
+	// the last ply only needs counting
+	if (depth == 1)
+	{
+		return plyPlacements.size();
+	}
+
+	unsigned long long leaves{ 0 };
+	Gameboard& child = boards[ply + 1];
+	for (const Placement& placement : plyPlacements)
+	{
+		child = boards[ply];
+		generator.lockPlacement(child, shape, placement);
+		child.removeCompletedRows();
+		leaves += countFrom(ply + 1, depth - 1);
+	}
+	return leaves;
+}
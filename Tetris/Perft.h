@@ -0,0 +1,87 @@
+// Perft ("performance test") counts every distinct sequence of placements for a fixed
+// sequence of shapes, to a given depth - the same idea chess engines use to validate
+// and benchmark their move generators.
+//
+//  - depth 1 is the # of placements of the first shape,
+//  - depth 2 is, for each of those, the # of placements of the second shape (after completed rows are removed),
+//  - ...and so on.
+//
+// Known-good counts are checked in TestSuite, so any change to the collision or rotation code
+// (Gameboard, Tetromino, GridTetromino, PlacementGenerator) that changes the results is caught.
+// runBenchmark() reports nodes/sec single-threaded and across all cores.
+//
+// Each ply has its own preallocated board and placement list, so counting doesn't allocate.
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "Gameboard.h"
+#include "PlacementGenerator.h"
+#include <vector>
+
+class Perft
+{
+	friend class TestSuite;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	PlacementGenerator generator;						// finds and locks the placements
+	std::vector<Gameboard> boards;						// the board at each ply
+	std::vector<std::vector<Placement>> placements;		// the placements found at each ply
+	std::vector<TetShape> sequence;						// the shapes to place (repeats if shorter than the depth)
+	unsigned long long nodes{ 0 };						// total # of placements made by the last count
+
+public:
+	// METHODS -------------------------------------------------
+	Perft();
+
+	/// <summary>
+	/// Counts the leaf placement sequences.
+	/// </summary>
+	/// <param name="board">the starting board</param>
+	/// <param name="sequence">the shapes to place, in order (repeated if shorter than the depth)</param>
+	/// <param name="depth">the # of shapes to place</param>
+	/// <returns>the # of distinct placement sequences of length depth</returns>
+	unsigned long long count(const Gameboard& board, const std::vector<TetShape>& sequence, int depth);
+
+	/// <summary>
+	/// Same as count(), but the placements of the first shape are shared out between threads.
+	/// </summary>
+	/// <param name="board">the starting board</param>
+	/// <param name="sequence">the shapes to place</param>
+	/// <param name="depth">the # of shapes to place</param>
+	/// <param name="threadCount">the # of threads to use, 0 = one per core</param>
+	/// <param name="totalNodes">optional, set to the total # of placements made by all threads</param>
+	/// <returns>the # of distinct placement sequences of length depth</returns>
+	static unsigned long long countParallel(const Gameboard& board, const std::vector<TetShape>& sequence, int depth,
+		int threadCount, unsigned long long* totalNodes = nullptr);
+
+	/// <summary>
+	/// Gets the total # of placements made (at every ply) by the last call to count()
+	/// </summary>
+	/// <returns>the # of nodes</returns>
+	unsigned long long getNodes() const;
+
+	/// <summary>
+	/// Prints the perft counts for each depth up to maxDepth on an empty board,
+	/// along with the nodes/sec for a single thread and for all cores.
+	/// </summary>
+	/// <param name="maxDepth">the deepest count to run</param>
+	static void runBenchmark(int maxDepth);
+
+private:
+	/// <summary>
+	/// Sets up the per-ply buffers for a count.
+	/// </summary>
+	void prepare(const Gameboard& board, const std::vector<TetShape>& sequence, int depth);
+
+	/// <summary>
+	/// Counts the leaves below the board at the given ply.
+	/// </summary>
+	/// <param name="ply">the ply whose board to place on</param>
+	/// <param name="depth">the # of plies left to place</param>
+	/// <returns>the # of leaf sequences</returns>
+	unsigned long long countFrom(int ply, int depth);
+};
+
+#endif /* PERFT_H */
@@ -0,0 +1,123 @@
+#include "PlacementGenerator.h"
+#include <algorithm>
+
+PlacementGenerator::PlacementGenerator()
+{
+	// a tetromino always has 4 blocks, and a board has fewer than 64 placements per shape
+	mappedLocs.reserve(4);
+	placementKeys.reserve(64);
+}
+
+void PlacementGenerator::generate(const Gameboard& board, TetShape shape, std::vector<Placement>& placements)
+{
+	placements.clear();
+	placementKeys.clear();
+
+	rotated.setShape(shape);
+	rotated.setGridLoc(board.getSpawnLoc());
+	if (!isPositionLegal(board, rotated))
+	{
+		return;
+	}
+
+	for (int rotations{ 0 }; rotations < 4; rotations++)
+	{
+		// rotations happen at the spawn location, stop as soon as one is blocked
+		if (rotations > 0)
+		{
+			rotated.rotateClockwise();
+			if (!isPositionLegal(board, rotated))
+			{
+				break;
+			}
+		}
+
+		// slide left (-1) then right (+1) from the spawn column, dropping at each column
+		for (int direction{ -1 }; direction <= 1; direction += 2)
+		{
+			shifted = rotated;
+			do
+			{
+				dropped = shifted;
+				do
+				{
+					dropped.move(0, 1);
+				} while (isPositionLegal(board, dropped));
+				dropped.move(0, -1);
+				addPlacement(rotations, placements);
+
+				shifted.move(direction, 0);
+			} while (isPositionLegal(board, shifted));
+		}
+	}
+}
+
+bool PlacementGenerator::isPositionLegal(const Gameboard& board, const GridTetromino& shape)
+{
+	shape.getBlockLocsMappedToGrid(mappedLocs);
+	for (const Point& pt : mappedLocs)
+	{
+		// the upper border is ignored so that shapes can drop in from the top of the gameboard
+		if (pt.getX() < 0 || pt.getX() >= Gameboard::MAX_X || pt.getY() >= Gameboard::MAX_Y)
+		{
+			return false;
+		}
+		if (pt.getY() >= 0 && board.getContent(pt.getX(), pt.getY()) != Gameboard::EMPTY_BLOCK)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void PlacementGenerator::placeShape(GridTetromino& tetromino, TetShape shape, const Placement& placement)
+{
+	tetromino.setShape(shape);
+	for (int i{ 0 }; i < placement.rotations; i++)
+	{
+		tetromino.rotateClockwise();
+	}
+	tetromino.setGridLoc(placement.x, placement.y);
+}
+
+void PlacementGenerator::lockPlacement(Gameboard& board, TetShape shape, const Placement& placement)
+{
+	placeShape(dropped, shape, placement);
+	dropped.getBlockLocsMappedToGrid(mappedLocs);
+	for (const Point& pt : mappedLocs)
+	{
+		// blocks above the board are ignored by setContent()
+		board.setContent(pt, static_cast<int>(dropped.getColor()));
+	}
+}
+
+unsigned int PlacementGenerator::getPlacementKey(const std::vector<Point>& mappedLocs)
+{
+	// the 4 covered cells, sorted, 1 byte each.
+	// rows are offset by 4 so blocks sitting above the board still get a positive cell index.
+	unsigned int cells[4];
+	for (int i{ 0 }; i < 4; i++)
+	{
+		cells[i] = static_cast<unsigned int>((mappedLocs[i].getY() + 4) * Gameboard::MAX_X + mappedLocs[i].getX());
+	}
+	std::sort(cells, cells + 4);
+	return (cells[0] << 24) | (cells[1] << 16) | (cells[2] << 8) | cells[3];
+}
+
+void PlacementGenerator::addPlacement(int rotations, std::vector<Placement>& placements)
+{
+	dropped.getBlockLocsMappedToGrid(mappedLocs);
+	unsigned int key = getPlacementKey(mappedLocs);
+
+	if (std::find(placementKeys.begin(), placementKeys.end(), key) != placementKeys.end())
+	{
+		return;
+	}
+	placementKeys.push_back(key);
+
+	Placement placement;
+	placement.rotations = rotations;
+	placement.x = dropped.getGridLoc().getX();
+	placement.y = dropped.getGridLoc().getY();
+	placements.push_back(placement);
+}
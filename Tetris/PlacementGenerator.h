@@ -0,0 +1,100 @@
+// The PlacementGenerator finds every place a tetromino can come to rest on a gameboard.
+// A placement is reached the same way a player would reach it:
+//  - spawn the shape at the board's spawn location,
+//  - rotate it clockwise (0-3 times),
+//  - slide it left or right,
+//  - drop it as far as it can go.
+// Placements that end up covering the same cells (ie. an 'O' rotated, or an 'I' rotated twice)
+// are only reported once.
+//
+// The generator keeps its scratch tetrominoes and vectors as members, so that a single instance
+// can be reused for millions of searches (bots, tuners, perft) without allocating.
+
+#ifndef PLACEMENTGENERATOR_H
+#define PLACEMENTGENERATOR_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include <vector>
+
+/// <summary>
+/// A final resting place for a tetromino.
+/// </summary>
+struct Placement
+{
+	int rotations{ 0 };		// # of clockwise rotations from the spawn orientation (0-3)
+	int x{ 0 };				// the resting gridLoc x
+	int y{ 0 };				// the resting gridLoc y
+};
+
+class PlacementGenerator
+{
+	friend class TestSuite;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	GridTetromino rotated;					// scratch: the shape in its current orientation at the spawn row
+	GridTetromino shifted;					// scratch: the rotated shape slid left/right
+	GridTetromino dropped;					// scratch: the shifted shape dropped to its resting row
+	std::vector<Point> mappedLocs;			// scratch: mapped block locations (capacity is reused)
+	std::vector<unsigned int> placementKeys;// keys of the placements found so far (for removing duplicates)
+
+public:
+	// METHODS -------------------------------------------------
+	PlacementGenerator();
+
+	/// <summary>
+	/// Finds all distinct placements of a shape on the board.
+	/// The placements vector is cleared first (its capacity is reused).
+	/// If the shape can't legally spawn, no placements are found.
+	/// </summary>
+	/// <param name="board">the board to search</param>
+	/// <param name="shape">the shape to place</param>
+	/// <param name="placements">filled with the placements found</param>
+	void generate(const Gameboard& board, TetShape shape, std::vector<Placement>& placements);
+
+	/// <summary>
+	/// Determine if a Tetromino can legally be placed at its current position on the gameboard
+	/// (same rules as TetrisGame: within the left, right and bottom borders, and only over empty blocks).
+	/// </summary>
+	/// <param name="board">the board to test against</param>
+	/// <param name="shape">the shape to test</param>
+	/// <returns>true if the shape's position is legal, false otherwise</returns>
+	bool isPositionLegal(const Gameboard& board, const GridTetromino& shape);
+
+	/// <summary>
+	/// Sets up a tetromino so that it sits at the given placement.
+	/// </summary>
+	/// <param name="tetromino">the tetromino to set up</param>
+	/// <param name="shape">the shape of the tetromino</param>
+	/// <param name="placement">where the tetromino should sit</param>
+	static void placeShape(GridTetromino& tetromino, TetShape shape, const Placement& placement);
+
+	/// <summary>
+	/// Copies the colour of a placed shape into the board (the equivalent of TetrisGame::lock()).
+	/// Completed rows are NOT removed.
+	/// </summary>
+	/// <param name="board">the board to lock the shape into</param>
+	/// <param name="shape">the shape being placed</param>
+	/// <param name="placement">where the shape sits</param>
+	void lockPlacement(Gameboard& board, TetShape shape, const Placement& placement);
+
+	/// <summary>
+	/// Builds a key that identifies the cells a placed tetromino covers.
+	/// Two placements covering the same cells (however they were reached) have the same key.
+	/// </summary>
+	/// <param name="mappedLocs">the 4 mapped block locations of the placed tetromino</param>
+	/// <returns>the placement key</returns>
+	static unsigned int getPlacementKey(const std::vector<Point>& mappedLocs);
+
+private:
+	/// <summary>
+	/// Records the placement of the dropped scratch shape, unless an identical placement
+	/// (one covering the same cells) has already been recorded.
+	/// </summary>
+	/// <param name="rotations">the # of rotations used to reach the placement</param>
+	/// <param name="placements">the placements found so far</param>
+	void addPlacement(int rotations, std::vector<Placement>& placements);
+};
+
+#endif /* PLACEMENTGENERATOR_H */
@@ -0,0 +1,35 @@
+// A RenderSnapshot is everything needed to draw one frame of a TetrisGame:
+// a copy of the game state, taken by the simulation and drawn by the renderer.
+// With the simulation on its own thread, snapshots are passed to the render thread
+// through a TripleBuffer, so the renderer never reads state the simulation is changing.
+//
+// It also carries the timing information used to measure input latency and tick jitter.
+
+#ifndef RENDERSNAPSHOT_H
+#define RENDERSNAPSHOT_H
+
+#include "FramePacer.h"
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include <chrono>
+
+struct RenderSnapshot
+{
+	Gameboard board;							// the locked blocks
+	GridTetromino currentShape;					// the falling shape
+	GridTetromino nextShape;					// the shape "on deck"
+	int score{ 0 };
+	int linesCleared{ 0 };
+	int piecesPlaced{ 0 };
+	double gameSeconds{ 0.0 };					// time simulated this game
+	unsigned int shapeSerial{ 0 };				// see TetrisGame::shapeSerial (for the hint)
+	bool showHint{ false };
+	Gameboard::ClearedRows clearedRows;			// the rows removed by the latest line clear
+	unsigned int clearSerial{ 0 };				// incremented every line clear (so each one is animated once)
+
+	unsigned long long inputCount{ 0 };			// # of key presses processed so far
+	std::chrono::steady_clock::time_point lastInputReceived;	// when the newest processed key press was received
+	PacingStats tickStats;						// the simulation's tick intervals (threaded mode)
+};
+
+#endif /* RENDERSNAPSHOT_H */
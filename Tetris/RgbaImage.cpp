@@ -0,0 +1,204 @@
+#include "RgbaImage.h"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
+bool Rgba::operator==(const Rgba& other) const
+{
+	return r == other.r && g == other.g && b == other.b && a == other.a;
+}
+
+bool Rgba::operator!=(const Rgba& other) const
+{
+	return !(*this == other);
+}
+
+RgbaImage::RgbaImage(int width, int height, Rgba fill)
+{
+	create(width, height, fill);
+}
+
+RgbaImage::RgbaImage(int width, int height, const unsigned char* rgbaPixels)
+	: width{ width }, height{ height }, pixels(rgbaPixels, rgbaPixels + static_cast<size_t>(width) * height * 4)
+{
+}
+
+void RgbaImage::create(int width, int height, Rgba fill)
+{
+	this->width = width;
+	this->height = height;
+	pixels.resize(static_cast<size_t>(width) * height * 4);
+	for (size_t i{ 0 }; i < pixels.size(); i += 4)
+	{
+		pixels[i] = fill.r;
+		pixels[i + 1] = fill.g;
+		pixels[i + 2] = fill.b;
+		pixels[i + 3] = fill.a;
+	}
+}
+
+int RgbaImage::getWidth() const { return width; }
+
+int RgbaImage::getHeight() const { return height; }
+
+const unsigned char* RgbaImage::getPixels() const { return pixels.data(); }
+
+Rgba RgbaImage::getPixel(int x, int y) const
+{
+	assert(x >= 0 && x < width && y >= 0 && y < height);
+	const unsigned char* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+	Rgba colour;
+	colour.r = pixel[0];
+	colour.g = pixel[1];
+	colour.b = pixel[2];
+	colour.a = pixel[3];
+	return colour;
+}
+
+void RgbaImage::setPixel(int x, int y, Rgba colour)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height)
+	{
+		return;
+	}
+	unsigned char* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+	pixel[0] = colour.r;
+	pixel[1] = colour.g;
+	pixel[2] = colour.b;
+	pixel[3] = colour.a;
+}
+
+int RgbaImage::countDifferentPixels(const RgbaImage& other) const
+{
+	if (width != other.width || height != other.height)
+	{
+		return std::max(width * height, other.width * other.height);
+	}
+	int different{ 0 };
+	for (size_t i{ 0 }; i < pixels.size(); i += 4)
+	{
+		if (pixels[i] != other.pixels[i] || pixels[i + 1] != other.pixels[i + 1] ||
+			pixels[i + 2] != other.pixels[i + 2] || pixels[i + 3] != other.pixels[i + 3])
+		{
+			different++;
+		}
+	}
+	return different;
+}
+
+bool RgbaImage::writePpm(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	file << "P6\n" << width << " " << height << "\n255\n";
+	std::vector<unsigned char> rgb;
+	rgb.reserve(static_cast<size_t>(width) * height * 3);
+	for (size_t i{ 0 }; i < pixels.size(); i += 4)
+	{
+		rgb.push_back(pixels[i]);
+		rgb.push_back(pixels[i + 1]);
+		rgb.push_back(pixels[i + 2]);
+	}
+	file.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+	return static_cast<bool>(file);
+}
+
+bool RgbaImage::writePng(const std::string& path) const
+{
+	std::vector<unsigned char> png{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+	// IHDR: size, 8 bits per channel, colour type 6 (RGBA), no interlacing
+	std::vector<unsigned char> header;
+	for (int value : { width, height })
+	{
+		for (int shift{ 24 }; shift >= 0; shift -= 8)
+		{
+			header.push_back(static_cast<unsigned char>(value >> shift));
+		}
+	}
+	header.insert(header.end(), { 8, 6, 0, 0, 0 });
+	appendPngChunk(png, "IHDR", header);
+
+	// the rows, each starting with filter type 0 (none)
+	const size_t rowBytes{ static_cast<size_t>(width) * 4 };
+	std::vector<unsigned char> raw;
+	raw.reserve((rowBytes + 1) * height);
+	for (int y{ 0 }; y < height; y++)
+	{
+		raw.push_back(0);
+		raw.insert(raw.end(), pixels.begin() + y * rowBytes, pixels.begin() + (y + 1) * rowBytes);
+	}
+
+	// IDAT: a zlib stream of stored deflate blocks (at most 65535 bytes each), then the adler-32
+	std::vector<unsigned char> data{ 0x78, 0x01 };
+	size_t offset{ 0 };
+	do
+	{
+		size_t length = std::min<size_t>(raw.size() - offset, 65535);
+		bool last = offset + length == raw.size();
+		data.push_back(last ? 1 : 0);
+		data.push_back(static_cast<unsigned char>(length));
+		data.push_back(static_cast<unsigned char>(length >> 8));
+		data.push_back(static_cast<unsigned char>(~length));
+		data.push_back(static_cast<unsigned char>(~length >> 8));
+		data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + length);
+		offset += length;
+	} while (offset < raw.size());
+	unsigned int a{ 1 };
+	unsigned int b{ 0 };
+	for (unsigned char byte : raw)
+	{
+		a = (a + byte) % 65521;
+		b = (b + a) % 65521;
+	}
+	unsigned int adler{ (b << 16) | a };
+	for (int shift{ 24 }; shift >= 0; shift -= 8)
+	{
+		data.push_back(static_cast<unsigned char>(adler >> shift));
+	}
+	appendPngChunk(png, "IDAT", data);
+	appendPngChunk(png, "IEND", std::vector<unsigned char>());
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(png.data()), png.size());
+	return static_cast<bool>(file);
+}
+
+void RgbaImage::appendPngChunk(std::vector<unsigned char>& png, const char* type, const std::vector<unsigned char>& data)
+{
+	unsigned int length{ static_cast<unsigned int>(data.size()) };
+	for (int shift{ 24 }; shift >= 0; shift -= 8)
+	{
+		png.push_back(static_cast<unsigned char>(length >> shift));
+	}
+	size_t typeStart{ png.size() };
+	png.insert(png.end(), type, type + 4);
+	png.insert(png.end(), data.begin(), data.end());
+	// the CRC covers the type and the data
+	unsigned int crc = crc32(&png[typeStart], png.size() - typeStart);
+	for (int shift{ 24 }; shift >= 0; shift -= 8)
+	{
+		png.push_back(static_cast<unsigned char>(crc >> shift));
+	}
+}
+
+unsigned int RgbaImage::crc32(const unsigned char* data, size_t length, unsigned int crc)
+{
+	crc = ~crc;
+	for (size_t i{ 0 }; i < length; i++)
+	{
+		crc ^= data[i];
+		for (int bit{ 0 }; bit < 8; bit++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+		}
+	}
+	return ~crc;
+}
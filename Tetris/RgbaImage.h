@@ -0,0 +1,108 @@
+// An RgbaImage is a block of 8 bit RGBA pixels in CPU memory (rows top to bottom,
+// 4 bytes per pixel) - the same layout as sf::Image::getPixelsPtr(), so atlases loaded
+// with SFML can be copied straight in.  It has no dependency on SFML or a display,
+// so it can be used by headless tools on servers.
+//
+// Images can be compared pixel for pixel (golden image tests), and written as
+// binary PPM (RGB, alpha dropped) or PNG (stored without compression, so no zlib is needed).
+
+#ifndef RGBAIMAGE_H
+#define RGBAIMAGE_H
+
+#include <string>
+#include <vector>
+
+/// <summary>
+/// One pixel (8 bits per channel).
+/// </summary>
+struct Rgba
+{
+	unsigned char r{ 0 };
+	unsigned char g{ 0 };
+	unsigned char b{ 0 };
+	unsigned char a{ 255 };
+
+	bool operator==(const Rgba& other) const;
+	bool operator!=(const Rgba& other) const;
+};
+
+class RgbaImage
+{
+	friend class TestSuite;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	int width{ 0 };
+	int height{ 0 };
+	std::vector<unsigned char> pixels;		// width * height * 4 bytes
+
+public:
+	// METHODS -------------------------------------------------
+	RgbaImage() = default;
+
+	/// <summary>
+	/// Creates an image filled with one colour.
+	/// </summary>
+	RgbaImage(int width, int height, Rgba fill);
+
+	/// <summary>
+	/// Creates an image from existing RGBA pixels (ie. sf::Image::getPixelsPtr()).
+	/// </summary>
+	RgbaImage(int width, int height, const unsigned char* rgbaPixels);
+
+	/// <summary>
+	/// Resizes the image (reusing its memory when it's big enough) and fills it with one colour.
+	/// </summary>
+	void create(int width, int height, Rgba fill);
+
+	int getWidth() const;
+	int getHeight() const;
+
+	/// <summary>
+	/// Gets the pixel bytes (width * height * 4, row by row).
+	/// </summary>
+	const unsigned char* getPixels() const;
+
+	/// <summary>
+	/// Gets a pixel.  Asserts that the point is within the image.
+	/// </summary>
+	Rgba getPixel(int x, int y) const;
+
+	/// <summary>
+	/// Sets a pixel.  Points outside the image are ignored.
+	/// </summary>
+	void setPixel(int x, int y, Rgba colour);
+
+	/// <summary>
+	/// Counts the pixels that differ from another image (for golden image tests).
+	/// Images of different sizes differ in every pixel of the larger one.
+	/// </summary>
+	/// <returns>the # of different pixels (0 if the images are identical)</returns>
+	int countDifferentPixels(const RgbaImage& other) const;
+
+	/// <summary>
+	/// Writes the image as a binary PPM (P6) file.  Alpha is dropped.
+	/// </summary>
+	/// <returns>true if the file was written</returns>
+	bool writePpm(const std::string& path) const;
+
+	/// <summary>
+	/// Writes the image as an RGBA PNG file.
+	/// The image data is stored without compression (deflate "stored" blocks).
+	/// </summary>
+	/// <returns>true if the file was written</returns>
+	bool writePng(const std::string& path) const;
+
+private:
+	/// <summary>
+	/// Appends a PNG chunk (length, type, data, CRC) to a buffer.
+	/// </summary>
+	static void appendPngChunk(std::vector<unsigned char>& png, const char* type, const std::vector<unsigned char>& data);
+
+	/// <summary>
+	/// The CRC-32 used by PNG chunks.
+	/// </summary>
+	static unsigned int crc32(const unsigned char* data, size_t length, unsigned int crc = 0);
+};
+
+#endif /* RGBAIMAGE_H */
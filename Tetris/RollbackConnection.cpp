@@ -0,0 +1,160 @@
+#include "RollbackConnection.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "LatencyStats.h"
+
+RollbackConnection::RollbackConnection(sf::UdpSocket& socket, RollbackPeer& peer, const sf::IpAddress& remoteAddress, unsigned short remotePort)
+	: socket{ socket }, peer{ peer }, remoteAddress{ remoteAddress }, remotePort{ remotePort }
+{
+	socket.setBlocking(false);
+}
+
+void RollbackConnection::receive()
+{
+	std::size_t received{ 0 };
+	sf::IpAddress sender;
+	unsigned short senderPort{ 0 };
+	while (socket.receive(receiveBuffer, sizeof(receiveBuffer), received, sender, senderPort) == sf::Socket::Done)
+	{
+		// until the host knows the joiner, anything that sends a valid packet is the joiner
+		if (remotePort != 0 && (sender != remoteAddress || senderPort != remotePort))
+		{
+			packetsRejected++;
+			continue;
+		}
+		if (!peer.receive(receiveBuffer, received))
+		{
+			packetsRejected++;
+			continue;
+		}
+		packetsReceived++;
+		if (remotePort == 0)
+		{
+			remoteAddress = sender;
+			remotePort = senderPort;
+		}
+	}
+}
+
+void RollbackConnection::send()
+{
+	if (remotePort == 0)
+	{
+		return;
+	}
+	const std::vector<unsigned char>& packet = peer.buildPacket();
+	if (socket.send(packet.data(), packet.size(), remoteAddress, remotePort) == sf::Socket::Done)
+	{
+		bytesSent += packet.size();
+		packetsSent++;
+	}
+}
+
+unsigned long long RollbackConnection::getBytesSent() const { return bytesSent; }
+
+unsigned long long RollbackConnection::getPacketsSent() const { return packetsSent; }
+
+unsigned long long RollbackConnection::getPacketsReceived() const { return packetsReceived; }
+
+unsigned long long RollbackConnection::getPacketsRejected() const { return packetsRejected; }
+
+void RollbackConnection::runHarness(const ImpairmentSettings& settings, double seconds)
+{
+	const double FRAME_MS{ 1000.0 / 60.0 };
+
+	// host <- proxy <- joiner, all on 127.0.0.1
+	sf::UdpSocket hostSocket;
+	sf::UdpSocket joinSocket;
+	ImpairmentProxy proxy(ImpairmentProxy::Protocol::UDP, settings);
+	if (hostSocket.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done
+		|| joinSocket.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done
+		|| !proxy.start(sf::Socket::AnyPort, sf::IpAddress::LocalHost, hostSocket.getLocalPort()))
+	{
+		std::cout << "couldn't bind the sockets over loopback\n";
+		return;
+	}
+
+	RollbackPeer peers[2]{ RollbackPeer(0), RollbackPeer(1) };
+	RollbackConnection connections[2]{ RollbackConnection(hostSocket, peers[0], sf::IpAddress::None, 0),
+		RollbackConnection(joinSocket, peers[1], sf::IpAddress::LocalHost, proxy.getListenPort()) };
+	peers[0].host(2024);
+
+	std::mt19937 random[2]{ std::mt19937(1), std::mt19937(2) };
+	const unsigned char INPUTS[]{ LockstepGame::INPUT_LEFT, LockstepGame::INPUT_RIGHT, LockstepGame::INPUT_ROTATE,
+		LockstepGame::INPUT_SOFT_DROP, LockstepGame::INPUT_HARD_DROP };
+
+	LatencyStats delays(2, RollbackPeer::INPUT_DELAY, static_cast<size_t>(seconds * 60.0 * 2) + 1);
+	unsigned long long stalls[2]{};
+	unsigned long long ticks{ 0 };
+
+	auto start = std::chrono::steady_clock::now();
+	auto getNowMs = [&start]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+	double nextFrameMs{ 0.0 };
+	double endMs{ seconds * 1000.0 };
+	while (getNowMs() < endMs)
+	{
+		proxy.update();
+		for (RollbackConnection& connection : connections)
+		{
+			connection.receive();
+		}
+		double nowMs = getNowMs();
+		if (nowMs < nextFrameMs)
+		{
+			sf::sleep(sf::microseconds(250));
+			continue;
+		}
+		// a game tick: each peer enters an input, simulates a frame (if it isn't too far ahead), and sends a packet
+		nextFrameMs += FRAME_MS;
+		ticks++;
+		for (int player{ 0 }; player < 2; player++)
+		{
+			RollbackPeer& peer = peers[player];
+			if (peer.canAddLocalInput())
+			{
+				unsigned int roll = random[player]() % 16;
+				delays.inputEntered(player, nowMs);
+				peer.addLocalInput(roll < 5 ? INPUTS[roll] : 0);
+			}
+			unsigned int before = peer.getFrame();
+			if (peer.advance())
+			{
+				delays.frameSimulated(player, before, nowMs);
+			}
+			else if (peer.isStarted())
+			{
+				stalls[player]++;
+			}
+			connections[player].send();
+		}
+	}
+
+	std::cout << "network: latency " << settings.latencyMs << " ms, jitter " << settings.jitterMs << " ms, loss " << settings.lossPercent
+		<< "% (udp), each way\n";
+	std::cout << std::min(peers[0].getFrame(), peers[1].getFrame()) << " frames in " << ticks << " ticks (" << seconds << " sec at 60 fps)\n";
+	std::cout << "local input delay: avg " << delays.getAverage() << " ms, p95 " << delays.getPercentile(0.95) << " ms (the fixed delay is "
+		<< RollbackPeer::INPUT_DELAY << " frame)\n";
+	for (int player{ 0 }; player < 2; player++)
+	{
+		const RollbackPeer& peer = peers[player];
+		double elapsedSeconds = ticks * FRAME_MS / 1000.0;
+		double bytesPerSecond = elapsedSeconds > 0.0 ? connections[player].getBytesSent() / elapsedSeconds : 0.0;
+		double wireBytesPerSecond = elapsedSeconds > 0.0
+			? (connections[player].getBytesSent() + connections[player].getPacketsSent() * DATAGRAM_HEADER_BYTES) / elapsedSeconds : 0.0;
+		std::cout << (player == 0 ? "host: " : "join: ") << bytesPerSecond << " bytes/sec (" << wireBytesPerSecond << " with ip/udp headers), "
+			<< peer.getRollbacks() << " rollbacks (" << peer.getFramesResimulated() << " frames resimulated, the longest correction "
+			<< peer.getLongestRollback() << " frames = " << peer.getLongestRollback() * FRAME_MS << " ms), " << stalls[player] << " stalled ticks, "
+			<< peer.getPacketsIgnored() << " stale packets, "
+			<< (peer.isDesynced() ? "DESYNC at frame " + std::to_string(peer.getDesyncFrame()) : "no desync") << "\n";
+	}
+	std::cout << "remote moves are shown after the one way latency, corrected by rollback (avg "
+		<< (peers[0].getRollbacks() + peers[1].getRollbacks() > 0
+			? static_cast<double>(peers[0].getFramesResimulated() + peers[1].getFramesResimulated()) / (peers[0].getRollbacks() + peers[1].getRollbacks()) * FRAME_MS
+			: 0.0)
+		<< " ms resimulated per correction)\n";
+	std::cout << "proxy: " << proxy.getToTarget().getPacketsDropped() + proxy.getToClient().getPacketsDropped() << " of "
+		<< proxy.getToTarget().getPacketsSubmitted() + proxy.getToClient().getPacketsSubmitted() << " datagrams lost\n";
+}
@@ -0,0 +1,72 @@
+// A RollbackConnection carries a RollbackPeer's packets over an sf::UdpSocket: one datagram per
+// tick (send()), and every datagram that has arrived is handed to the peer (receive()).  Nothing
+// is retransmitted or waited for, since every packet repeats the inputs the other peer hasn't
+// acked, so a lost packet costs a prediction rather than a stall (no head-of-line blocking).
+//
+// The joiner is given the host's address.  The host learns the joiner's from its first valid
+// packet (ie. the ImpairmentProxy's, when one is in between).
+//
+// runHarness() plays two headless peers through a UDP ImpairmentProxy in real time and reports
+// the bytes/sec, the perceived latency (local input delay, and how late the remote player's moves
+// are corrected), the rollbacks and any desyncs (compare with ImpairmentProxy::runHarness(), the
+// same match over TCP lockstep).
+
+#ifndef ROLLBACKCONNECTION_H
+#define ROLLBACKCONNECTION_H
+
+#include <SFML/Network.hpp>
+#include "ImpairmentProxy.h"
+#include "RollbackPeer.h"
+
+class RollbackConnection
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int DATAGRAM_HEADER_BYTES = 28;	// the IPv4 and UDP headers (counted in the bytes/sec)
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	sf::UdpSocket& socket;
+	RollbackPeer& peer;
+	sf::IpAddress remoteAddress;
+	unsigned short remotePort{ 0 };				// 0 until the host has heard from the joiner
+	unsigned char receiveBuffer[ImpairmentProxy::MAX_DATAGRAM];
+	unsigned long long bytesSent{ 0 };			// payloads only
+	unsigned long long packetsSent{ 0 };
+	unsigned long long packetsReceived{ 0 };
+	unsigned long long packetsRejected{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor: the socket must be bound, it's switched to non-blocking.
+	/// </summary>
+	/// <param name="remoteAddress">the other peer's address (the host passes sf::IpAddress::None)</param>
+	/// <param name="remotePort">and port (0 for the host)</param>
+	RollbackConnection(sf::UdpSocket& socket, RollbackPeer& peer, const sf::IpAddress& remoteAddress, unsigned short remotePort);
+
+	/// <summary>
+	/// Hands every datagram that has arrived to the peer (never blocks).
+	/// </summary>
+	void receive();
+
+	/// <summary>
+	/// Sends the peer's packet for this tick (if the other peer's address is known).
+	/// </summary>
+	void send();
+
+	unsigned long long getBytesSent() const;
+	unsigned long long getPacketsSent() const;
+	unsigned long long getPacketsReceived() const;
+	unsigned long long getPacketsRejected() const;
+
+	/// <summary>
+	/// Plays two headless peers through a UDP proxy for a while, and reports the bytes/sec,
+	/// perceived latency, rollbacks and desyncs.
+	/// </summary>
+	static void runHarness(const ImpairmentSettings& settings, double seconds);
+};
+
+#endif /* ROLLBACKCONNECTION_H */
@@ -0,0 +1,271 @@
+#include "RollbackPeer.h"
+#include <algorithm>
+
+RollbackPeer::RollbackPeer(int localPlayer)
+	: localPlayer{ localPlayer }
+{
+	packet.reserve(HEADER_BYTES + MAX_PACKET_INPUTS);
+}
+
+void RollbackPeer::host(unsigned int seed)
+{
+	start(seed);
+}
+
+bool RollbackPeer::receive(const unsigned char* data, size_t size)
+{
+	if (size < static_cast<size_t>(HEADER_BYTES) || data[0] != PACKET_TYPE || size != static_cast<size_t>(HEADER_BYTES) + data[HEADER_BYTES - 1])
+	{
+		return false;
+	}
+	unsigned int packetSeed = static_cast<unsigned int>(readValue(data + 1, 4));
+	unsigned int sequence = static_cast<unsigned int>(readValue(data + 5, 4));
+	unsigned int ack = static_cast<unsigned int>(readValue(data + 9, 4));
+	unsigned int hashFrame = static_cast<unsigned int>(readValue(data + 13, 4));
+	unsigned long long hash = readValue(data + 17, 8);
+	unsigned int firstFrame = static_cast<unsigned int>(readValue(data + 25, 4));
+	int count = data[HEADER_BYTES - 1];
+
+	// the joiner takes the host's seed, the host ignores what the joiner sends before it has it
+	if (!started)
+	{
+		if (localPlayer == 0)
+		{
+			return true;
+		}
+		start(packetSeed);
+	}
+	else if (localPlayer != 0 && packetSeed != seed)
+	{
+		return false;
+	}
+	if (ack > localInputCount)
+	{
+		return false;
+	}
+
+	// unreliable-ordered: anything older than the newest packet has been repeated since
+	if (receivedAny && sequence <= newestSequence)
+	{
+		packetsIgnored++;
+		return true;
+	}
+	receivedAny = true;
+	newestSequence = sequence;
+	localInputsAcked = std::max(localInputsAcked, ack);
+	if (hashFrame > 0)
+	{
+		recordHash(remoteHashes, confirmedHashes, hashFrame, hash);
+	}
+
+	// the inputs repeat ones already here, then continue on from remoteInputCount
+	for (int i{ 0 }; i < count; i++)
+	{
+		unsigned int inputFrame = firstFrame + static_cast<unsigned int>(i);
+		if (inputFrame < remoteInputCount)
+		{
+			continue;
+		}
+		if (inputFrame > remoteInputCount || remoteInputCount - confirmedFrame >= static_cast<unsigned int>(INPUT_RING))
+		{
+			break;
+		}
+		remoteInputs[inputFrame % INPUT_RING] = data[HEADER_BYTES + i];
+		remoteInputCount++;
+	}
+	reconcile();
+	return true;
+}
+
+bool RollbackPeer::canAddLocalInput() const
+{
+	return started && localInputCount < frame + INPUT_DELAY + 1 && localInputCount - localInputsAcked < static_cast<unsigned int>(INPUT_RING);
+}
+
+bool RollbackPeer::addLocalInput(unsigned char bits)
+{
+	if (!canAddLocalInput())
+	{
+		return false;
+	}
+	localInputs[localInputCount % INPUT_RING] = bits;
+	localInputCount++;
+	return true;
+}
+
+bool RollbackPeer::advance()
+{
+	if (!started || frame >= localInputCount || frame >= remoteInputCount + MAX_PREDICTION)
+	{
+		return false;
+	}
+	unsigned char remoteInput = (frame < remoteInputCount) ? remoteInputs[frame % INPUT_RING]
+		: predictInput(remoteInputs[(remoteInputCount - 1) % INPUT_RING]);
+	usedRemoteInputs[frame % INPUT_RING] = remoteInput;
+	stepGames(games, localInputs[frame % INPUT_RING], remoteInput);
+	frame++;
+	reconcile();
+	return true;
+}
+
+const std::vector<unsigned char>& RollbackPeer::buildPacket()
+{
+	packet.clear();
+	packet.push_back(static_cast<unsigned char>(PACKET_TYPE));
+	writeValue(seed, 4);
+	writeValue(++sendSequence, 4);
+	writeValue(remoteInputCount, 4);
+	writeValue(localHashFrame, 4);
+	writeValue(localHash, 8);
+	writeValue(localInputsAcked, 4);
+	unsigned int count = std::min(localInputCount - localInputsAcked, static_cast<unsigned int>(MAX_PACKET_INPUTS));
+	packet.push_back(static_cast<unsigned char>(count));
+	for (unsigned int i{ 0 }; i < count; i++)
+	{
+		packet.push_back(localInputs[(localInputsAcked + i) % INPUT_RING]);
+	}
+	return packet;
+}
+
+unsigned char RollbackPeer::predictInput(unsigned char lastInput)
+{
+	// moves, rotations and drops are taps (one frame each), a soft drop is usually held
+	return lastInput & LockstepGame::INPUT_SOFT_DROP;
+}
+
+const LockstepGame& RollbackPeer::getGame(int player) const
+{
+	return games[player];
+}
+
+bool RollbackPeer::isStarted() const { return started; }
+
+bool RollbackPeer::isDesynced() const { return desynced; }
+
+unsigned int RollbackPeer::getDesyncFrame() const { return desyncFrame; }
+
+unsigned int RollbackPeer::getFrame() const { return frame; }
+
+unsigned int RollbackPeer::getConfirmedFrame() const { return confirmedFrame; }
+
+int RollbackPeer::getLocalPlayer() const { return localPlayer; }
+
+unsigned long long RollbackPeer::getRollbacks() const { return rollbacks; }
+
+unsigned long long RollbackPeer::getFramesResimulated() const { return framesResimulated; }
+
+unsigned int RollbackPeer::getLongestRollback() const { return longestRollback; }
+
+unsigned long long RollbackPeer::getPacketsIgnored() const { return packetsIgnored; }
+
+void RollbackPeer::start(unsigned int seed)
+{
+	this->seed = seed;
+	for (int player{ 0 }; player < PLAYER_COUNT; player++)
+	{
+		games[player].reset(seed);
+		confirmedGames[player].reset(seed);
+	}
+	for (int i{ 0 }; i < INPUT_DELAY; i++)
+	{
+		localInputs[i] = 0;
+		remoteInputs[i] = 0;
+	}
+	localInputCount = INPUT_DELAY;
+	localInputsAcked = INPUT_DELAY;
+	remoteInputCount = INPUT_DELAY;
+	frame = 0;
+	confirmedFrame = 0;
+	localHashFrame = 0;
+	localHash = 0;
+	for (int i{ 0 }; i < HASH_RING; i++)
+	{
+		remoteHashes[i] = HashRecord();
+		confirmedHashes[i] = HashRecord();
+	}
+	desynced = false;
+	started = true;
+}
+
+void RollbackPeer::reconcile()
+{
+	unsigned int target = std::min(remoteInputCount, frame);
+	bool mispredicted{ false };
+	unsigned int firstWrongFrame{ 0 };
+	while (confirmedFrame < target)
+	{
+		unsigned char input = remoteInputs[confirmedFrame % INPUT_RING];
+		if (!mispredicted && input != usedRemoteInputs[confirmedFrame % INPUT_RING])
+		{
+			mispredicted = true;
+			firstWrongFrame = confirmedFrame;
+		}
+		stepGames(confirmedGames, localInputs[confirmedFrame % INPUT_RING], input);
+		confirmedFrame++;
+		if (confirmedFrame % HASH_INTERVAL == 0)
+		{
+			localHashFrame = confirmedFrame;
+			localHash = confirmedGames[0].getStateHash() * 31 + confirmedGames[1].getStateHash();
+			recordHash(confirmedHashes, remoteHashes, localHashFrame, localHash);
+		}
+	}
+	if (!mispredicted)
+	{
+		return;
+	}
+
+	// roll both games back to the confirmed ones (copying reuses the games' buffers), and
+	// simulate forward again with the local inputs (still in the ring) and new guesses
+	for (int player{ 0 }; player < PLAYER_COUNT; player++)
+	{
+		games[player] = confirmedGames[player];
+	}
+	unsigned char guess = predictInput(remoteInputs[(remoteInputCount - 1) % INPUT_RING]);
+	for (unsigned int replayFrame{ confirmedFrame }; replayFrame < frame; replayFrame++)
+	{
+		usedRemoteInputs[replayFrame % INPUT_RING] = guess;
+		stepGames(games, localInputs[replayFrame % INPUT_RING], guess);
+	}
+	rollbacks++;
+	framesResimulated += frame - confirmedFrame;
+	longestRollback = std::max(longestRollback, frame - firstWrongFrame);
+}
+
+void RollbackPeer::stepGames(LockstepGame* pair, unsigned char localInput, unsigned char remoteInput)
+{
+	pair[localPlayer].step(localInput);
+	pair[1 - localPlayer].step(remoteInput);
+	LockstepGame::exchangeAttacks(pair[0], pair[1]);
+}
+
+void RollbackPeer::recordHash(HashRecord* records, const HashRecord* otherRecords, unsigned int hashFrame, unsigned long long hash)
+{
+	int slot = static_cast<int>((hashFrame / HASH_INTERVAL) % HASH_RING);
+	records[slot].frame = hashFrame;
+	records[slot].hash = hash;
+	records[slot].present = true;
+	const HashRecord& other = otherRecords[slot];
+	if (other.present && other.frame == hashFrame && other.hash != hash && !desynced)
+	{
+		desynced = true;
+		desyncFrame = hashFrame;
+	}
+}
+
+void RollbackPeer::writeValue(unsigned long long value, int bytes)
+{
+	for (int i{ 0 }; i < bytes; i++)
+	{
+		packet.push_back(static_cast<unsigned char>(value >> (8 * i)));
+	}
+}
+
+unsigned long long RollbackPeer::readValue(const unsigned char* data, int bytes)
+{
+	unsigned long long value{ 0 };
+	for (int i{ 0 }; i < bytes; i++)
+	{
+		value |= static_cast<unsigned long long>(data[i]) << (8 * i);
+	}
+	return value;
+}
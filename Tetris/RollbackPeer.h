@@ -0,0 +1,192 @@
+// A RollbackPeer is one side of a versus match over an unreliable transport (UDP), which never
+// waits on the other peer's inputs the way a LockstepPeer does.  Like a LockstepPeer it simulates
+// both players' games, with garbage exchanged between them every frame
+// (LockstepGame::exchangeAttacks()), so a remote clear changes the local game too:
+//  - the local inputs are applied INPUT_DELAY frames after they're entered.
+//  - when the remote input for a frame hasn't arrived, it's guessed (predictInput(): no taps, and
+//    a held soft drop stays held).  A second copy of both games, at confirmedFrame, is only ever
+//    stepped once the real inputs are known.  When real inputs arrive that differ from the guesses,
+//    both games are rolled back to the confirmed copies and the frames since are simulated again
+//    (with the local inputs and the new guesses).  The simulation never gets more than
+//    MAX_PREDICTION frames past the remote inputs (it stalls instead).
+//
+// Every tick, buildPacket() makes one datagram (little endian):
+//   [PACKET_TYPE][seed x4][sequence x4][ack x4][hash frame x4][hash x8][first frame x4][count][inputs...]
+//  - ack: the # of the other peer's inputs received so far, so the sender can stop resending them.
+//  - inputs: every local input the other peer hasn't acked (up to MAX_PACKET_INPUTS), so each
+//    packet repeats the recent input history and a lost packet is covered by the next one.
+//  - the newest hash of the confirmed games (every HASH_INTERVAL frames): the other peer checks it
+//    against its own at the same frame, which flags a desync.
+// Packets are unreliable-ordered: one older than the newest received (reordered or duplicated) is
+// ignored, as everything in it has been repeated since.  The joiner starts with the seed of the
+// first packet it gets, so there's no handshake to lose.
+//
+// The peer doesn't touch sockets (see RollbackConnection for sf::UdpSocket).
+
+#ifndef ROLLBACKPEER_H
+#define ROLLBACKPEER_H
+
+#include "LockstepGame.h"
+#include <cstddef>
+#include <vector>
+
+class RollbackPeer
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int PLAYER_COUNT = 2;
+	static const unsigned char PACKET_TYPE = 0x52;
+	static const int HEADER_BYTES = 30;			// a packet's size without its inputs
+	static const int INPUT_DELAY = 1;			// frames between entering a local input and it being applied
+	static const int MAX_PREDICTION = 12;		// frames the simulation can run past the last remote input
+	static const int MAX_PACKET_INPUTS = 32;	// inputs per packet (more than a peer can have unacked, normally)
+	static const int HASH_INTERVAL = 60;		// frames between state hashes (1 sec at 60 fps)
+	static const int INPUT_RING = 64;			// inputs kept per player (a power of 2)
+	static const int HASH_RING = 8;				// hashes kept for comparing
+
+private:
+	/// <summary>
+	/// A state hash, for a frame.
+	/// </summary>
+	struct HashRecord
+	{
+		unsigned int frame{ 0 };
+		unsigned long long hash{ 0 };
+		bool present{ false };
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	int localPlayer;							// 0 hosts, 1 joins
+	bool started{ false };
+	unsigned int seed{ 0 };
+	LockstepGame games[PLAYER_COUNT];			// the games at frame (guessed past confirmedFrame)
+	LockstepGame confirmedGames[PLAYER_COUNT];	// the games at confirmedFrame (real inputs only)
+	unsigned int frame{ 0 };					// # of frames simulated
+	unsigned int confirmedFrame{ 0 };			// # of frames the confirmedGames have been stepped
+
+	unsigned char localInputs[INPUT_RING]{};
+	unsigned int localInputCount{ 0 };			// # of frames the local inputs are known for
+	unsigned int localInputsAcked{ 0 };			// # of them the other peer has received
+	unsigned char remoteInputs[INPUT_RING]{};
+	unsigned int remoteInputCount{ 0 };			// # of frames the remote inputs are known for
+	unsigned char usedRemoteInputs[INPUT_RING]{};	// the remote inputs the games were stepped with
+
+	unsigned int sendSequence{ 0 };
+	unsigned int newestSequence{ 0 };			// of the packets received
+	bool receivedAny{ false };
+	unsigned int localHashFrame{ 0 };			// the newest confirmed hash (sent in every packet)
+	unsigned long long localHash{ 0 };
+	HashRecord remoteHashes[HASH_RING];			// the other peer's hashes of its confirmed games
+	HashRecord confirmedHashes[HASH_RING];		// this peer's hashes of its confirmed games
+	bool desynced{ false };
+	unsigned int desyncFrame{ 0 };
+	std::vector<unsigned char> packet;			// built by buildPacket() (reserved once)
+
+	// statistics
+	unsigned long long rollbacks{ 0 };
+	unsigned long long framesResimulated{ 0 };
+	unsigned int longestRollback{ 0 };
+	unsigned long long packetsIgnored{ 0 };		// reordered or duplicated
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="localPlayer">0 for the host, 1 for the joiner</param>
+	explicit RollbackPeer(int localPlayer);
+
+	/// <summary>
+	/// Host: starts the match with a seed (the joiner starts when the first packet arrives).
+	/// </summary>
+	void host(unsigned int seed);
+
+	/// <summary>
+	/// Handles a packet from the other peer.
+	/// </summary>
+	/// <returns>false if it isn't a valid packet (it's ignored)</returns>
+	bool receive(const unsigned char* data, size_t size);
+
+	/// <summary>
+	/// Gets whether another local input can be entered: the match has started, the input would
+	/// be applied within INPUT_DELAY frames, and the ring has room for it until it's acked.
+	/// </summary>
+	bool canAddLocalInput() const;
+
+	/// <summary>
+	/// Enters this peer's input for its next frame.
+	/// </summary>
+	/// <param name="bits">the LockstepGame::INPUT_ bits</param>
+	/// <returns>false if canAddLocalInput() is false (the input is dropped)</returns>
+	bool addLocalInput(unsigned char bits);
+
+	/// <summary>
+	/// Simulates the next frame, predicting the remote input if it hasn't arrived.
+	/// </summary>
+	/// <returns>false if the local input isn't known yet, or the prediction is MAX_PREDICTION frames ahead (a stall)</returns>
+	bool advance();
+
+	/// <summary>
+	/// Builds the packet to send this tick (acks, unacked inputs and the newest hash).
+	/// </summary>
+	const std::vector<unsigned char>& buildPacket();
+
+	/// <summary>
+	/// Gets the remote input to assume for a frame that hasn't arrived yet.
+	/// </summary>
+	/// <param name="lastInput">the last remote input received</param>
+	static unsigned char predictInput(unsigned char lastInput);
+
+	/// <summary>
+	/// Gets a player's game as this peer shows it (predicted past the confirmed frame).
+	/// </summary>
+	const LockstepGame& getGame(int player) const;
+
+	// Getters
+	bool isStarted() const;
+	bool isDesynced() const;
+	unsigned int getDesyncFrame() const;
+	unsigned int getFrame() const;
+	unsigned int getConfirmedFrame() const;
+	int getLocalPlayer() const;
+	unsigned long long getRollbacks() const;
+	unsigned long long getFramesResimulated() const;
+	unsigned int getLongestRollback() const;
+	unsigned long long getPacketsIgnored() const;
+
+private:
+	/// <summary>
+	/// Resets the games with the seed, with INPUT_DELAY empty inputs for each player.
+	/// </summary>
+	void start(unsigned int seed);
+
+	/// <summary>
+	/// Steps the confirmedGames through the remote inputs that have arrived (up to frame), and
+	/// rolls the games back if any of them weren't what was guessed.
+	/// </summary>
+	void reconcile();
+
+	/// <summary>
+	/// Steps a pair of games one frame (each with its player's input), then exchanges their attacks.
+	/// </summary>
+	void stepGames(LockstepGame* pair, unsigned char localInput, unsigned char remoteInput);
+
+	/// <summary>
+	/// Records a hash (remote, or of the confirmedGames) and compares it with the other, if it's there.
+	/// </summary>
+	void recordHash(HashRecord* records, const HashRecord* otherRecords, unsigned int hashFrame, unsigned long long hash);
+
+	/// <summary>
+	/// Appends a little endian value to the packet.
+	/// </summary>
+	void writeValue(unsigned long long value, int bytes);
+
+	/// <summary>
+	/// Reads a little endian value.
+	/// </summary>
+	static unsigned long long readValue(const unsigned char* data, int bytes);
+};
+
+#endif /* ROLLBACKPEER_H */
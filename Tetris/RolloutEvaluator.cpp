@@ -0,0 +1,196 @@
+#include "RolloutEvaluator.h"
+#include <algorithm>
+
+const double RolloutEvaluator::TOP_OUT_VALUE{ -1000.0 };
+
+RolloutEvaluator::RolloutEvaluator(const RolloutSettings& settings) : settings{ settings }
+{
+	int threadCount = settings.threadCount;
+	if (threadCount <= 0)
+	{
+		threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	workers.resize(threadCount);
+	placements.reserve(64);
+	rolloutValues.resize(settings.rolloutsPerPlacement);
+
+	// the budget starts full (one second's worth)
+	rolloutBudget = settings.maxRolloutsPerSecond;
+	lastRefill = std::chrono::steady_clock::now();
+
+	for (int i{ 1 }; i < threadCount; i++)
+	{
+		threads.emplace_back(&RolloutEvaluator::run, this, i);
+	}
+}
+
+RolloutEvaluator::~RolloutEvaluator()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		stopping = true;
+	}
+	jobReady.notify_all();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+double RolloutEvaluator::evaluatePlacement(const Gameboard& board, TetShape shape, const Placement& placement)
+{
+	evaluationCount++;
+	lastRolloutCount = takeRolloutBudget(settings.rolloutsPerPlacement);
+	return scorePlacement(board, shape, placement, lastRolloutCount);
+}
+
+bool RolloutEvaluator::choosePlacement(const Gameboard& board, TetShape shape, Placement& best)
+{
+	generator.generate(board, shape, placements);
+	if (placements.empty())
+	{
+		return false;
+	}
+
+	// one budget for the whole decision, split evenly (what doesn't divide evenly is given back)
+	evaluationCount++;
+	int candidates = static_cast<int>(placements.size());
+	int taken = takeRolloutBudget(settings.rolloutsPerPlacement * candidates);
+	lastRolloutCount = taken / candidates;
+	rolloutBudget += taken - lastRolloutCount * candidates;
+
+	double bestScore{ 0.0 };
+	for (size_t i{ 0 }; i < placements.size(); i++)
+	{
+		double score = scorePlacement(board, shape, placements[i], lastRolloutCount);
+		if (i == 0 || score > bestScore)
+		{
+			bestScore = score;
+			best = placements[i];
+		}
+	}
+	return true;
+}
+
+int RolloutEvaluator::getLastRolloutCount() const { return lastRolloutCount; }
+
+void RolloutEvaluator::setMaxRolloutsPerSecond(double maxRolloutsPerSecond)
+{
+	settings.maxRolloutsPerSecond = maxRolloutsPerSecond;
+	rolloutBudget = std::min(rolloutBudget, maxRolloutsPerSecond);
+}
+
+int RolloutEvaluator::takeRolloutBudget(int wanted)
+{
+	if (settings.maxRolloutsPerSecond <= 0.0)
+	{
+		return wanted;
+	}
+
+	// refill at the capped rate, holding at most one second's worth
+	if (!refillFrozen)
+	{
+		auto now = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(now - lastRefill).count();
+		lastRefill = now;
+		rolloutBudget = std::min(settings.maxRolloutsPerSecond, rolloutBudget + seconds * settings.maxRolloutsPerSecond);
+	}
+
+	int rollouts = std::min(wanted, static_cast<int>(rolloutBudget));
+	rolloutBudget -= rollouts;
+	return rollouts;
+}
+
+double RolloutEvaluator::scorePlacement(const Gameboard& board, TetShape shape, const Placement& placement, int rolloutCount)
+{
+	startBoard = board;
+	generator.lockPlacement(startBoard, shape, placement);
+	startLines = startBoard.removeCompletedRows();
+	if (rolloutCount == 0)
+	{
+		// out of budget: the static evaluation
+		return workers[0].policy.evaluate(startBoard, startLines);
+	}
+	return runRollouts(rolloutCount) / rolloutCount;
+}
+
+double RolloutEvaluator::runRollouts(int rolloutCount)
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		jobRollouts = rolloutCount;
+		nextRollout = 0;
+		busyWorkers = static_cast<int>(threads.size());
+		jobGeneration++;
+	}
+	jobReady.notify_all();
+
+	// the calling thread works on the job too
+	workOnJob(workers[0]);
+
+	std::unique_lock<std::mutex> lock(jobMutex);
+	jobDone.wait(lock, [this] { return busyWorkers == 0; });
+
+	double total{ 0.0 };
+	for (int i{ 0 }; i < rolloutCount; i++)
+	{
+		total += rolloutValues[i];
+	}
+	return total;
+}
+
+void RolloutEvaluator::workOnJob(Worker& worker)
+{
+	for (int i = nextRollout.fetch_add(1); i < jobRollouts; i = nextRollout.fetch_add(1))
+	{
+		rolloutValues[i] = rollout(worker, i);
+	}
+}
+
+double RolloutEvaluator::rollout(Worker& worker, int rolloutIndex)
+{
+	// each rollout gets its own stream, whichever thread runs it (and rollout i is the same
+	// stream for every candidate of a decision)
+	worker.randomGenerator.seed(settings.seed
+		+ evaluationCount * static_cast<unsigned int>(settings.rolloutsPerPlacement)
+		+ static_cast<unsigned int>(rolloutIndex));
+	worker.board = startBoard;
+
+	int completedLines{ startLines };
+	for (int depth{ 0 }; depth < settings.rolloutDepth; depth++)
+	{
+		TetShape shape = static_cast<TetShape>(worker.randomGenerator() % static_cast<unsigned int>(TetShape::COUNT));
+		if (!worker.policy.choosePlacement(worker.board, shape, worker.placement))
+		{
+			return TOP_OUT_VALUE;
+		}
+		worker.generator.lockPlacement(worker.board, shape, worker.placement);
+		completedLines += worker.board.removeCompletedRows();
+	}
+	return worker.policy.evaluate(worker.board, completedLines);
+}
+
+void RolloutEvaluator::run(int workerIndex)
+{
+	unsigned int seenGeneration{ 0 };
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(jobMutex);
+			jobReady.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+			if (stopping)
+			{
+				return;
+			}
+			seenGeneration = jobGeneration;
+		}
+
+		workOnJob(workers[workerIndex]);
+
+		{
+			std::lock_guard<std::mutex> lock(jobMutex);
+			busyWorkers--;
+		}
+		jobDone.notify_one();
+	}
+}
@@ -0,0 +1,174 @@
+// The RolloutEvaluator scores a placement by playing it out: after the placement is locked,
+// K random continuations (rollouts) are simulated, each placing rolloutDepth random shapes with
+// a cheap default policy (the greedy BoardEvaluator).  The placement's score is the average
+// value of the boards the rollouts end on, so placements that leave awkward boards for
+// unlucky shape sequences score lower than a static heuristic would give them.
+//
+//  - rollouts run in parallel on a persistent pool of worker threads (the calling thread helps),
+//  - each worker owns its random generator and a preallocated board, so a rollout doesn't allocate,
+//  - every rollout re-seeds its worker's generator from (seed, decision #, rollout #), so results
+//    don't depend on which thread ran which rollout.  Every candidate of a choosePlacement() gets
+//    the same seeds (common random numbers), so they're compared on the same shape sequences,
+//  - maxRolloutsPerSecond caps the work done, so the evaluator can be used from the live game loop.
+//    choosePlacement() takes its budget once and splits it evenly across the candidates; when
+//    there isn't one rollout for each, every candidate gets the static evaluation instead (so
+//    rollout averages are never compared with static scores).
+
+#ifndef ROLLOUTEVALUATOR_H
+#define ROLLOUTEVALUATOR_H
+
+#include "BoardEvaluator.h"
+#include "Gameboard.h"
+#include "PlacementGenerator.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Settings for a RolloutEvaluator.
+/// </summary>
+struct RolloutSettings
+{
+	int rolloutsPerPlacement{ 32 };			// K, the # of random continuations per placement
+	int rolloutDepth{ 4 };					// # of random shapes placed by each rollout
+	int threadCount{ 0 };					// # of threads (including the caller), 0 = one per core
+	double maxRolloutsPerSecond{ 0.0 };		// rollout budget, 0 = unlimited
+	unsigned int seed{ 1 };					// base seed for the rollouts
+};
+
+class RolloutEvaluator
+{
+	friend class TestSuite;
+
+public:
+	// STATIC CONSTANTS
+	static const double TOP_OUT_VALUE;		// the value of a rollout that can't spawn a shape, init to -1000
+
+private:
+	/// <summary>
+	/// The state owned by one thread, reused for every rollout it runs.
+	/// </summary>
+	struct Worker
+	{
+		std::mt19937 randomGenerator;		// picks the shapes of a rollout
+		Gameboard board;					// the rollout's board
+		PlacementGenerator generator;		// locks the policy's placements
+		BoardEvaluator policy;				// the default policy (and the final board score)
+		Placement placement;				// the policy's current choice
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	RolloutSettings settings;
+	std::vector<Worker> workers;			// workers[0] belongs to the calling thread
+	std::vector<std::thread> threads;		// one per worker, except workers[0]
+	PlacementGenerator generator;			// finds and locks the candidate placements
+	std::vector<Placement> placements;		// scratch: candidate placements
+	Gameboard startBoard;					// the board after the candidate placement (shared, read only, by the job)
+	int startLines{ 0 };					// the # of rows the candidate placement completed
+
+	// Job members -------------------------------------------------------
+	std::mutex jobMutex;
+	std::condition_variable jobReady;
+	std::condition_variable jobDone;
+	unsigned int jobGeneration{ 0 };		// incremented for every job (wakes the workers)
+	int busyWorkers{ 0 };					// # of pool threads still working on the current job
+	bool stopping{ false };
+	int jobRollouts{ 0 };					// # of rollouts in the current job
+	std::vector<double> rolloutValues;		// the value of each rollout in the current job (summed in order, so
+											// the total doesn't depend on which thread finished first)
+	std::atomic<int> nextRollout{ 0 };		// the next rollout # to run
+	unsigned int evaluationCount{ 0 };		// # of decisions so far (part of the rollout seeds)
+
+	// Rate limiting members ---------------------------------------------
+	double rolloutBudget{ 0.0 };			// rollouts that can be run right now
+	std::chrono::steady_clock::time_point lastRefill;
+	bool refillFrozen{ false };				// TestSuite: the budget doesn't refill, so budget tests don't depend on the clock
+	int lastRolloutCount{ 0 };				// # of rollouts per placement in the last evaluation
+
+public:
+	// METHODS -------------------------------------------------
+
+	/// <summary>
+	/// Constructor, allocates the workers and starts the thread pool.
+	/// </summary>
+	/// <param name="settings">the evaluator's settings</param>
+	explicit RolloutEvaluator(const RolloutSettings& settings);
+
+	/// <summary>
+	/// Destructor, stops and joins the thread pool.
+	/// </summary>
+	~RolloutEvaluator();
+
+	RolloutEvaluator(const RolloutEvaluator&) = delete;
+	RolloutEvaluator& operator=(const RolloutEvaluator&) = delete;
+
+	/// <summary>
+	/// Scores a placement by the average of its rollouts.
+	/// </summary>
+	/// <param name="board">the board before the placement</param>
+	/// <param name="shape">the shape being placed</param>
+	/// <param name="placement">the candidate placement</param>
+	/// <returns>the placement's score (higher is better)</returns>
+	double evaluatePlacement(const Gameboard& board, TetShape shape, const Placement& placement);
+
+	/// <summary>
+	/// Scores every placement of a shape with evaluatePlacement() and returns the best.
+	/// </summary>
+	/// <param name="board">the board to place the shape on</param>
+	/// <param name="shape">the shape to place</param>
+	/// <param name="best">set to the best placement</param>
+	/// <returns>false if the shape has no placements, true otherwise</returns>
+	bool choosePlacement(const Gameboard& board, TetShape shape, Placement& best);
+
+	/// <summary>
+	/// Gets the # of rollouts per placement the last evaluatePlacement() or choosePlacement() ran
+	/// (lower than K when the rate cap kicks in)
+	/// </summary>
+	int getLastRolloutCount() const;
+
+	/// <summary>
+	/// Changes the rollout budget (0 = unlimited).
+	/// </summary>
+	void setMaxRolloutsPerSecond(double maxRolloutsPerSecond);
+
+private:
+	/// <summary>
+	/// Works out how many rollouts the budget allows and takes them from the budget.
+	/// </summary>
+	/// <param name="wanted">the most rollouts to take</param>
+	int takeRolloutBudget(int wanted);
+
+	/// <summary>
+	/// Scores a placement with a # of rollouts (0 = the static evaluation), seeded by evaluationCount.
+	/// </summary>
+	double scorePlacement(const Gameboard& board, TetShape shape, const Placement& placement, int rolloutCount);
+
+	/// <summary>
+	/// Runs rollouts from startBoard across the pool.
+	/// </summary>
+	/// <param name="rolloutCount">the # of rollouts to run</param>
+	/// <returns>the sum of the rollout values</returns>
+	double runRollouts(int rolloutCount);
+
+	/// <summary>
+	/// Runs rollouts from the current job until there are none left.
+	/// </summary>
+	void workOnJob(Worker& worker);
+
+	/// <summary>
+	/// Plays a single random continuation from startBoard.
+	/// </summary>
+	/// <returns>the value of the board the rollout ends on</returns>
+	double rollout(Worker& worker, int rolloutIndex);
+
+	/// <summary>
+	/// The pool threads: wait for a job, work on it, report when done.
+	/// </summary>
+	void run(int workerIndex);
+};
+
+#endif /* ROLLOUTEVALUATOR_H */
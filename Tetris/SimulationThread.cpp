@@ -0,0 +1,88 @@
+#include "SimulationThread.h"
+
+const int SimulationThread::TICK_STATS_INTERVAL{ 600 };
+
+SimulationThread::SimulationThread(TetrisGame& game)
+	: game{ game }, pacer{ 1.0 / FramePacer::SIMULATION_STEP }
+{
+	pacer.setMode(PacingMode::LIMITED);
+}
+
+SimulationThread::~SimulationThread()
+{
+	stop();
+}
+
+void SimulationThread::start()
+{
+	if (running.load())
+	{
+		return;
+	}
+	publishSnapshot();
+	running.store(true);
+	thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop()
+{
+	running.store(false);
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+bool SimulationThread::pushInput(const sf::Event& event, std::chrono::steady_clock::time_point received)
+{
+	InputEvent input;
+	input.event = event;
+	input.received = received;
+	return inputs.push(input);
+}
+
+const RenderSnapshot& SimulationThread::acquireSnapshot()
+{
+	snapshots.acquire();
+	return snapshots.getReadSlot();
+}
+
+void SimulationThread::run()
+{
+	InputEvent input;
+	while (running.load())
+	{
+		while (inputs.pop(input))
+		{
+			if (input.event.key.code == sf::Keyboard::P)
+			{
+				paused = !paused;
+			}
+			else if (!paused)
+			{
+				game.onKeyPressed(input.event, input.received);
+			}
+		}
+		if (!paused)
+		{
+			game.processGameLoop(static_cast<float>(FramePacer::SIMULATION_STEP));
+		}
+		publishSnapshot();
+
+		pacer.waitForNextFrame();
+		pacer.markFrame();
+		if (pacer.getStats().frameCount >= TICK_STATS_INTERVAL)
+		{
+			tickStats = pacer.getStats();
+			pacer.resetStats();
+		}
+	}
+}
+
+void SimulationThread::publishSnapshot()
+{
+	RenderSnapshot& snapshot = snapshots.getWriteSlot();
+	game.captureSnapshot(snapshot);
+	snapshot.tickStats = tickStats;
+	snapshots.publish();
+}
@@ -0,0 +1,111 @@
+// The SimulationThread runs a TetrisGame's simulation on its own thread, at a fixed
+// tick rate (FramePacer::SIMULATION_STEP), independent of how fast the window draws.
+//
+//  - the render (main) thread polls the window and push()es key presses into a lock-free
+//    SpscQueue, stamped with the time they were received.
+//  - every tick, the simulation handles the queued keys, runs one processGameLoop() step,
+//    and publishes a RenderSnapshot through a TripleBuffer.
+//  - the render thread draws the newest snapshot (TetrisGame::drawSnapshot()), so neither
+//    thread ever waits for the other, and a slow frame never delays a tick.
+//
+// Used by the --threaded mode in main(), to compare input latency and tick jitter
+// against the single threaded game loop.
+
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include "FramePacer.h"
+#include "RenderSnapshot.h"
+#include "SpscQueue.h"
+#include "TetrisGame.h"
+#include "TripleBuffer.h"
+#include <SFML/Window/Event.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/// <summary>
+/// A key press on its way to the simulation thread.
+/// </summary>
+struct InputEvent
+{
+	sf::Event event;
+	std::chrono::steady_clock::time_point received;	// when it was polled from the window
+};
+
+class SimulationThread
+{
+	friend class TestSuite;
+
+public:
+	// STATIC CONSTANTS
+	static const int INPUT_CAPACITY = 256;		// key presses that can be waiting for the simulation
+	static const int TICK_STATS_INTERVAL;		// # of ticks the published tick stats cover, init to 600 (5 seconds)
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	TetrisGame& game;							// only touched by the simulation thread once started
+	SpscQueue<InputEvent, INPUT_CAPACITY> inputs;	// render thread -> simulation thread
+	TripleBuffer<RenderSnapshot> snapshots;		// simulation thread -> render thread
+	std::atomic<bool> running{ false };
+	std::thread thread;
+
+	// simulation thread members ---------------------------------------
+	FramePacer pacer;							// holds the tick rate (LIMITED mode), and measures it
+	PacingStats tickStats;						// the last full TICK_STATS_INTERVAL of tick intervals
+	bool paused{ false };						// toggled with the P key
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor (the thread isn't started until start()).
+	/// </summary>
+	/// <param name="game">the game to simulate (drawn by the caller through acquireSnapshot())</param>
+	explicit SimulationThread(TetrisGame& game);
+
+	/// <summary>
+	/// Stops the thread.
+	/// </summary>
+	~SimulationThread();
+
+	SimulationThread(const SimulationThread&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+	/// <summary>
+	/// Publishes a first snapshot and starts simulating.  From here on the game must only be
+	/// drawn through acquireSnapshot() (and never simulated by the caller).
+	/// </summary>
+	void start();
+
+	/// <summary>
+	/// Stops simulating, and waits for the thread to finish its tick.
+	/// </summary>
+	void stop();
+
+	/// <summary>
+	/// Render thread: passes a key press to the simulation (handled on its next tick).
+	/// </summary>
+	/// <param name="event">the key press</param>
+	/// <param name="received">when it was polled from the window</param>
+	/// <returns>false if the queue is full (the key press is dropped)</returns>
+	bool pushInput(const sf::Event& event, std::chrono::steady_clock::time_point received);
+
+	/// <summary>
+	/// Render thread: gets the newest snapshot (the same one again if there isn't a newer one yet).
+	/// </summary>
+	/// <returns>the snapshot, valid until the next call</returns>
+	const RenderSnapshot& acquireSnapshot();
+
+private:
+	/// <summary>
+	/// The simulation thread: one tick per SIMULATION_STEP until stop().
+	/// </summary>
+	void run();
+
+	/// <summary>
+	/// Captures the game into the TripleBuffer's write slot and publishes it.
+	/// </summary>
+	void publishSnapshot();
+};
+
+#endif /* SIMULATIONTHREAD_H */
@@ -0,0 +1,111 @@
+#include "SpectatorFeed.h"
+
+SpectatorFeed::SpectatorFeed()
+{
+	buffer.reserve(4096);
+}
+
+void SpectatorFeed::publish(unsigned int frame, const LockstepGame& game0, const LockstepGame& game1)
+{
+	if (viewerCount == 0)
+	{
+		return;
+	}
+	bool keyframe = !hasKeyframe || framesSinceKeyframe >= KEYFRAME_INTERVAL;
+	if (keyframe)
+	{
+		// keep the entries from the previous keyframe on, for the viewers still reading them
+		if (hasKeyframe && keyframeOffset > baseOffset)
+		{
+			buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(keyframeOffset - baseOffset));
+			baseOffset = keyframeOffset;
+		}
+		keyframeOffset = getEndOffset();
+		hasKeyframe = true;
+		framesSinceKeyframe = 0;
+	}
+	framesSinceKeyframe++;
+
+	// the buffer grows by the most an entry can take, and is trimmed back to what was written
+	size_t start = buffer.size();
+	buffer.resize(start + MAX_ENTRY_BYTES);
+	size_t position = start + 2;
+	appendValue(position, frame, 4);
+	appendValue(position, keyframe ? FLAG_KEYFRAME : 0, 1);
+	const LockstepGame* games[PLAYER_COUNT]{ &game0, &game1 };
+	for (int player{ 0 }; player < PLAYER_COUNT; player++)
+	{
+		const LockstepGame& game = *games[player];
+		const GridTetromino& shape = game.getFallingShape();
+		appendValue(position, static_cast<unsigned long long>(shape.getShape()), 1);
+		appendValue(position, static_cast<unsigned long long>(game.getFallingRotations()), 1);
+		appendValue(position, static_cast<unsigned char>(shape.getGridLoc().getX()), 1);
+		appendValue(position, static_cast<unsigned char>(shape.getGridLoc().getY()), 1);
+		appendValue(position, static_cast<unsigned int>(game.getScore()), 4);
+		position += static_cast<size_t>(BoardCodec::encode(game.getBoard(), keyframe ? nullptr : &lastBoards[player], &buffer[position]));
+		lastBoards[player] = game.getBoard();
+	}
+	size_t entrySize = position - start;
+	buffer[start] = static_cast<unsigned char>(entrySize);
+	buffer[start + 1] = static_cast<unsigned char>(entrySize >> 8);
+	buffer.resize(position);
+	entriesPublished++;
+	bytesPublished += entrySize;
+}
+
+void SpectatorFeed::restart()
+{
+	baseOffset = getEndOffset();
+	buffer.clear();
+	keyframeOffset = baseOffset;
+	hasKeyframe = false;
+	framesSinceKeyframe = 0;
+}
+
+unsigned long long SpectatorFeed::addViewer()
+{
+	if (viewerCount++ == 0)
+	{
+		restart();
+	}
+	return hasKeyframe ? keyframeOffset : getEndOffset();
+}
+
+void SpectatorFeed::removeViewer()
+{
+	if (viewerCount > 0)
+	{
+		viewerCount--;
+	}
+}
+
+bool SpectatorFeed::contains(unsigned long long offset) const
+{
+	return offset >= baseOffset && offset <= getEndOffset();
+}
+
+const unsigned char* SpectatorFeed::getData(unsigned long long offset, size_t& size) const
+{
+	size = static_cast<size_t>(getEndOffset() - offset);
+	return size > 0 ? &buffer[static_cast<size_t>(offset - baseOffset)] : nullptr;
+}
+
+unsigned long long SpectatorFeed::getEndOffset() const { return baseOffset + buffer.size(); }
+
+unsigned long long SpectatorFeed::getKeyframeOffset() const { return keyframeOffset; }
+
+int SpectatorFeed::getViewerCount() const { return viewerCount; }
+
+unsigned long long SpectatorFeed::getEntriesPublished() const { return entriesPublished; }
+
+unsigned long long SpectatorFeed::getBytesPublished() const { return bytesPublished; }
+
+size_t SpectatorFeed::getBufferSize() const { return buffer.size(); }
+
+void SpectatorFeed::appendValue(size_t& position, unsigned long long value, int bytes)
+{
+	for (int i{ 0 }; i < bytes; i++)
+	{
+		buffer[position++] = static_cast<unsigned char>(value >> (8 * i));
+	}
+}
@@ -0,0 +1,107 @@
+// The SpectatorFeed is one match's broadcast buffer: each frame is encoded once, here, and
+// every spectator of the match is sent bytes straight out of the same buffer - so the cost
+// of encoding doesn't grow with the # of spectators, only the sends do.
+//
+// The buffer is a byte stream of entries:
+//   [entry size: Uint16][frame: Uint32][flags: Uint8, KEYFRAME]
+//   for each player: [shape][rotations][x: Int8][y: Int8][score: Uint32][board: BoardCodec]
+// (little endian).  Every KEYFRAME_INTERVAL frames the boards are FULL (a keyframe), in
+// between they're DELTAs from the previous entry's boards, so a spectator has to start
+// reading at a keyframe and then read every entry after it.
+//
+// Spectators are positioned by absolute stream offsets (ie. bytes since the feed started).
+// The buffer keeps everything from the previous keyframe on: when a new keyframe is published,
+// the entries before the previous one are dropped.  A spectator who joins late starts at the
+// latest keyframe; one who falls so far behind that its offset is dropped (contains() is false)
+// can't be caught up mid-entry, and is disconnected by the server.
+//
+// A feed that nobody watches isn't published (publish() returns straight away), and when its
+// first viewer arrives it restarts, so the next entry is a keyframe.
+
+#ifndef SPECTATORFEED_H
+#define SPECTATORFEED_H
+
+#include "BoardCodec.h"
+#include "LockstepGame.h"
+#include <vector>
+
+class SpectatorFeed
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int PLAYER_COUNT = 2;
+	static const int KEYFRAME_INTERVAL = 120;		// frames between keyframes (2 sec at 60 fps)
+	static const unsigned char FLAG_KEYFRAME = 1;
+	static const int ENTRY_HEADER_BYTES = 7;		// size, frame, flags
+	static const int PLAYER_HEADER_BYTES = 8;		// shape, rotations, x, y, score
+	static const int MAX_ENTRY_BYTES = ENTRY_HEADER_BYTES + PLAYER_COUNT * (PLAYER_HEADER_BYTES + BoardCodec::MAX_ENCODED_BYTES);
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	std::vector<unsigned char> buffer;				// the entries from the previous keyframe on (capacity is reused)
+	unsigned long long baseOffset{ 0 };			// the stream offset of buffer[0]
+	unsigned long long keyframeOffset{ 0 };		// the stream offset of the latest keyframe
+	bool hasKeyframe{ false };
+	int framesSinceKeyframe{ 0 };
+	Gameboard lastBoards[PLAYER_COUNT];			// the boards the last entry left spectators with
+	int viewerCount{ 0 };
+	unsigned long long entriesPublished{ 0 };
+	unsigned long long bytesPublished{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	SpectatorFeed();
+
+	/// <summary>
+	/// Encodes a frame of both players' games into the buffer (a keyframe or deltas),
+	/// if the feed has any viewers.
+	/// </summary>
+	void publish(unsigned int frame, const LockstepGame& game0, const LockstepGame& game1);
+
+	/// <summary>
+	/// Drops the buffer, so the next entry is a keyframe (ie. when the match restarts).
+	/// The stream offsets carry on from where they were.
+	/// </summary>
+	void restart();
+
+	/// <summary>
+	/// Adds a viewer: the first one restarts the feed.
+	/// </summary>
+	/// <returns>the stream offset the viewer starts reading from</returns>
+	unsigned long long addViewer();
+
+	/// <summary>
+	/// Removes a viewer.
+	/// </summary>
+	void removeViewer();
+
+	/// <summary>
+	/// Gets whether a stream offset is still in the buffer.
+	/// </summary>
+	bool contains(unsigned long long offset) const;
+
+	/// <summary>
+	/// Gets the bytes from a stream offset to the end of the buffer.
+	/// </summary>
+	/// <param name="offset">an offset the buffer contains()</param>
+	/// <param name="size">receives the # of bytes</param>
+	const unsigned char* getData(unsigned long long offset, size_t& size) const;
+
+	// Getters
+	unsigned long long getEndOffset() const;
+	unsigned long long getKeyframeOffset() const;
+	int getViewerCount() const;
+	unsigned long long getEntriesPublished() const;
+	unsigned long long getBytesPublished() const;
+	size_t getBufferSize() const;
+
+private:
+	/// <summary>
+	/// Appends a little endian value.
+	/// </summary>
+	void appendValue(size_t& position, unsigned long long value, int bytes);
+};
+
+#endif /* SPECTATORFEED_H */
@@ -0,0 +1,313 @@
+#include "SpectatorServer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include "FramePacer.h"
+#include "LoadGenerator.h"
+#include "MatchServer.h"
+#include "SpectatorView.h"
+#include "TerminalInput.h"
+#include "TerminalRenderer.h"
+
+SpectatorServer::SpectatorServer(MatchPool& pool)
+	: pool{ pool }
+{
+	viewers.reserve(256);
+}
+
+bool SpectatorServer::listen(unsigned short port)
+{
+	if (listener.listen(port) != sf::Socket::Done)
+	{
+		return false;
+	}
+	listener.setBlocking(false);
+	listening = true;
+	return true;
+}
+
+unsigned short SpectatorServer::getPort() const { return listener.getLocalPort(); }
+
+void SpectatorServer::update()
+{
+	if (!listening)
+	{
+		return;
+	}
+	acceptViewers();
+	for (Viewer& viewer : viewers)
+	{
+		if (!viewer.open)
+		{
+			continue;
+		}
+		if (viewer.slot < 0)
+		{
+			readRequest(viewer);
+		}
+		else if (!pool.getMatch(viewer.slot).active || pool.getMatch(viewer.slot).generation != viewer.generation)
+		{
+			// the match ended, or its slot was released and reopened since the last update
+			closeViewer(viewer);
+		}
+		else
+		{
+			sendFeed(viewer);
+		}
+	}
+}
+
+int SpectatorServer::getViewerCount() const { return viewerCount; }
+
+unsigned long long SpectatorServer::getBytesSent() const { return bytesSent; }
+
+unsigned long long SpectatorServer::getViewersDropped() const { return viewersDropped; }
+
+void SpectatorServer::runViewer(const std::string& address, unsigned short port, int slot)
+{
+	sf::TcpSocket socket;
+	if (socket.connect(sf::IpAddress(address), port, sf::seconds(10.0f)) != sf::Socket::Done)
+	{
+		std::cout << "couldn't connect to " << address << ":" << port << "\n";
+		return;
+	}
+	unsigned char request[REQUEST_BYTES];
+	for (int i{ 0 }; i < REQUEST_BYTES; i++)
+	{
+		request[i] = static_cast<unsigned char>(static_cast<unsigned int>(slot) >> (8 * i));
+	}
+	socket.send(request, REQUEST_BYTES);
+	socket.setBlocking(false);
+
+	const int BOARD_WIDTH{ Gameboard::MAX_X * TerminalRenderer::CELL_WIDTH + 2 };
+	TerminalRenderer renderer(BOARD_WIDTH * 2 + 6, Gameboard::MAX_Y + 5);
+	TerminalInput input;
+	FramePacer pacer(60.0);
+	pacer.setMode(PacingMode::LIMITED);
+	SpectatorView view;
+	unsigned char buffer[4096];
+	unsigned long long received{ 0 };
+	bool connected{ true };
+	bool quit{ false };
+	while (!quit && connected)
+	{
+		for (TerminalKey key = input.readKey(); key != TerminalKey::NONE; key = input.readKey())
+		{
+			quit = quit || key == TerminalKey::QUIT;
+		}
+		size_t size{ 0 };
+		sf::Socket::Status status;
+		while ((status = socket.receive(buffer, sizeof(buffer), size)) == sf::Socket::Done)
+		{
+			received += size;
+			connected = view.receive(buffer, size) && connected;
+		}
+		connected = connected && status != sf::Socket::Disconnected && status != sf::Socket::Error;
+
+		renderer.clear();
+		for (int player{ 0 }; player < SpectatorFeed::PLAYER_COUNT; player++)
+		{
+			int left = 1 + player * (BOARD_WIDTH + 4);
+			renderer.drawGameboard(view.getBoard(player), left, 1);
+			if (view.isSynced())
+			{
+				renderer.drawTetromino(view.getFallingShape(player), left, 1);
+			}
+			renderer.drawText(left, Gameboard::MAX_Y + 2, "score: " + std::to_string(view.getScore(player)));
+		}
+		renderer.drawText(1, Gameboard::MAX_Y + 3, !view.isSynced() ? "waiting for a keyframe..."
+			: "match " + std::to_string(slot) + ", frame " + std::to_string(view.getFrame()) + ", "
+			+ std::to_string(received / (view.getKeyframes() + view.getDeltas())) + " bytes/frame");
+		renderer.writeFrame(stdout);
+		pacer.waitForNextFrame();
+	}
+	std::fputs(TerminalRenderer::getRestoreSequence(), stdout);
+	std::cout << (connected ? "" : "disconnected, ") << received << " bytes received, " << view.getKeyframes() << " keyframes, "
+		<< view.getDeltas() << " deltas\n";
+}
+
+void SpectatorServer::runBenchmark(int viewerCount, double seconds)
+{
+	const int MATCHES{ 200 };
+	const int WATCHED_MATCHES{ 4 };
+	int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 3);
+	MatchServer server(MATCHES, threads);
+	if (!server.listen(sf::Socket::AnyPort, sf::Socket::AnyPort))
+	{
+		std::cout << "couldn't listen\n";
+		return;
+	}
+	unsigned short port = server.getPort();
+	unsigned short spectatorPort = server.getSpectatorPort();
+	std::atomic<bool> stop{ false };
+	LoadGenerator load(MATCHES, 11);
+	std::thread loadThread([&load, &stop, port]() {
+		if (load.connect(sf::IpAddress::LocalHost, port))
+		{
+			load.run(stop);
+		}
+	});
+
+	// the spectators' end: each one reads its socket into its own SpectatorView
+	std::vector<std::unique_ptr<sf::TcpSocket>> sockets;
+	std::vector<SpectatorView> views(static_cast<size_t>(viewerCount));
+	unsigned long long received{ 0 };
+	int invalid{ 0 };
+	std::thread viewerThread([&]() {
+		// the load generator's matches take the lowest slots, once it has connected
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		for (int i{ 0 }; i < viewerCount; i++)
+		{
+			sockets.push_back(std::unique_ptr<sf::TcpSocket>(new sf::TcpSocket()));
+			unsigned char request[REQUEST_BYTES]{ static_cast<unsigned char>(i % WATCHED_MATCHES), 0, 0, 0 };
+			if (sockets.back()->connect(sf::IpAddress::LocalHost, spectatorPort, sf::seconds(5.0f)) != sf::Socket::Done
+				|| sockets.back()->send(request, REQUEST_BYTES) != sf::Socket::Done)
+			{
+				sockets.pop_back();
+				break;
+			}
+			sockets.back()->setBlocking(false);
+		}
+		unsigned char buffer[4096];
+		std::vector<bool> valid(sockets.size(), true);
+		while (!stop)
+		{
+			for (size_t i{ 0 }; i < sockets.size(); i++)
+			{
+				size_t size{ 0 };
+				while (valid[i] && sockets[i]->receive(buffer, sizeof(buffer), size) == sf::Socket::Done)
+				{
+					received += size;
+					valid[i] = views[i].receive(buffer, size);
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+		for (bool viewerValid : valid)
+		{
+			invalid += viewerValid ? 0 : 1;
+		}
+	});
+
+	std::cout << MATCHES << " matches, " << viewerCount << " spectators on " << WATCHED_MATCHES << " of them, "
+		<< seconds << " sec\n";
+	server.run(seconds, 5.0);
+	stop = true;
+	loadThread.join();
+	viewerThread.join();
+
+	MatchServer::printReport(server.getReport());
+	int synced{ 0 };
+	unsigned long long keyframes{ 0 };
+	unsigned long long deltas{ 0 };
+	for (size_t i{ 0 }; i < sockets.size(); i++)
+	{
+		synced += views[i].isSynced() ? 1 : 0;
+		keyframes += views[i].getKeyframes();
+		deltas += views[i].getDeltas();
+	}
+	std::cout << sockets.size() << " spectators connected, " << synced << " synced, " << invalid << " invalid streams, "
+		<< keyframes << " keyframes and " << deltas << " deltas read, " << received << " bytes received\n";
+}
+
+void SpectatorServer::acceptViewers()
+{
+	for (;;)
+	{
+		std::unique_ptr<sf::TcpSocket> socket(new sf::TcpSocket());
+		if (listener.accept(*socket) != sf::Socket::Done)
+		{
+			return;
+		}
+		Viewer* viewer{ nullptr };
+		for (size_t i{ 0 }; i < viewers.size() && viewer == nullptr; i++)
+		{
+			viewer = viewers[i].open ? nullptr : &viewers[i];
+		}
+		if (viewer == nullptr)
+		{
+			if (static_cast<int>(viewers.size()) >= MAX_VIEWERS)
+			{
+				continue;		// the socket is closed as it goes out of scope
+			}
+			viewers.push_back(Viewer());
+			viewer = &viewers.back();
+		}
+		socket->setBlocking(false);
+		viewer->socket = std::move(socket);
+		viewer->slot = -1;
+		viewer->requestBytes = 0;
+		viewer->open = true;
+		viewerCount++;
+	}
+}
+
+void SpectatorServer::readRequest(Viewer& viewer)
+{
+	size_t size{ 0 };
+	sf::Socket::Status status = viewer.socket->receive(viewer.request + viewer.requestBytes, REQUEST_BYTES - viewer.requestBytes, size);
+	if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+	{
+		closeViewer(viewer);
+		return;
+	}
+	viewer.requestBytes += static_cast<int>(size);
+	if (viewer.requestBytes < REQUEST_BYTES)
+	{
+		return;
+	}
+	unsigned int slot{ 0 };
+	for (int i{ 0 }; i < REQUEST_BYTES; i++)
+	{
+		slot |= static_cast<unsigned int>(viewer.request[i]) << (8 * i);
+	}
+	if (slot >= static_cast<unsigned int>(pool.getCapacity()) || !pool.getMatch(static_cast<int>(slot)).active)
+	{
+		closeViewer(viewer);
+		return;
+	}
+	viewer.slot = static_cast<int>(slot);
+	viewer.generation = pool.getMatch(viewer.slot).generation;
+	viewer.offset = pool.getFeed(viewer.slot).addViewer();
+}
+
+void SpectatorServer::sendFeed(Viewer& viewer)
+{
+	const SpectatorFeed& feed = pool.getFeed(viewer.slot);
+	if (!feed.contains(viewer.offset))
+	{
+		viewersDropped++;
+		closeViewer(viewer);
+		return;
+	}
+	size_t size{ 0 };
+	const unsigned char* data = feed.getData(viewer.offset, size);
+	if (size == 0)
+	{
+		return;
+	}
+	size_t sent{ 0 };
+	sf::Socket::Status status = viewer.socket->send(data, size, sent);
+	if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+	{
+		closeViewer(viewer);
+		return;
+	}
+	viewer.offset += sent;
+	bytesSent += sent;
+}
+
+void SpectatorServer::closeViewer(Viewer& viewer)
+{
+	if (viewer.slot >= 0)
+	{
+		pool.getFeed(viewer.slot).removeViewer();
+	}
+	viewer.socket->disconnect();
+	viewer.slot = -1;
+	viewer.open = false;
+	viewerCount--;
+}
@@ -0,0 +1,111 @@
+// The SpectatorServer sends matches to spectators.  A spectator connects and sends the
+// match # it wants to watch ([slot: Uint32], little endian); from then on it's sent the raw
+// bytes of that match's SpectatorFeed, starting at the latest keyframe.
+//
+// There's no per-spectator encoding or packet: each send() goes straight out of the match's
+// shared buffer, from the spectator's offset, and a partial send just leaves the offset
+// part way through an entry.  The sockets are non-blocking and aren't in a selector (a send
+// that can't go out returns NotReady), so the # of spectators isn't limited by select().
+// A spectator that falls behind the feed's buffer is disconnected, and so is one whose match
+// has ended (even if its slot has already been reused by another match).
+//
+// update() runs on the MatchServer's thread, between ticks, so the feeds aren't being written.
+
+#ifndef SPECTATORSERVER_H
+#define SPECTATORSERVER_H
+
+#include <SFML/Network.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MatchPool.h"
+
+class SpectatorServer
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const unsigned short DEFAULT_PORT = 53101;		// (the MatchServer's DEFAULT_PORT + 1)
+	static const int MAX_VIEWERS = 8192;
+	static const int REQUEST_BYTES = 4;
+
+private:
+	/// <summary>
+	/// A spectator's connection.
+	/// </summary>
+	struct Viewer
+	{
+		std::unique_ptr<sf::TcpSocket> socket;
+		int slot{ -1 };								// the match being watched (-1 until the request arrives)
+		unsigned int generation{ 0 };				// the slot's generation when the request arrived
+		unsigned char request[REQUEST_BYTES]{};
+		int requestBytes{ 0 };
+		unsigned long long offset{ 0 };			// the next byte of the feed to send
+		bool open{ false };
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	MatchPool& pool;
+	sf::TcpListener listener;
+	bool listening{ false };
+	std::vector<Viewer> viewers;					// closed viewers' entries are reused
+	int viewerCount{ 0 };
+	unsigned long long bytesSent{ 0 };
+	unsigned long long viewersDropped{ 0 };		// disconnected for falling behind
+
+public:
+	// METHODS -------------------------------------------------
+	explicit SpectatorServer(MatchPool& pool);
+
+	/// <summary>
+	/// Starts listening for spectators.
+	/// </summary>
+	bool listen(unsigned short port);
+
+	unsigned short getPort() const;
+
+	/// <summary>
+	/// Accepts spectators, reads their requests, and sends each one what's new in its match's feed.
+	/// </summary>
+	void update();
+
+	// Getters
+	int getViewerCount() const;
+	unsigned long long getBytesSent() const;
+	unsigned long long getViewersDropped() const;
+
+	/// <summary>
+	/// Watches a match in a text terminal (the --spectate mode).
+	/// </summary>
+	static void runViewer(const std::string& address, unsigned short port, int slot);
+
+	/// <summary>
+	/// Runs a MatchServer with a LoadGenerator, and connects spectators to a few of its matches
+	/// (on another thread), then reports the bytes encoded vs sent and the tick times.
+	/// </summary>
+	static void runBenchmark(int viewers, double seconds);
+
+private:
+	/// <summary>
+	/// Accepts every pending spectator.
+	/// </summary>
+	void acceptViewers();
+
+	/// <summary>
+	/// Reads a spectator's request, and starts it watching.
+	/// </summary>
+	void readRequest(Viewer& viewer);
+
+	/// <summary>
+	/// Sends a spectator what's new in its feed.
+	/// </summary>
+	void sendFeed(Viewer& viewer);
+
+	/// <summary>
+	/// Disconnects a spectator.
+	/// </summary>
+	void closeViewer(Viewer& viewer);
+};
+
+#endif /* SPECTATORSERVER_H */
@@ -0,0 +1,103 @@
+#include "SpectatorView.h"
+#include "PlacementGenerator.h"
+
+SpectatorView::SpectatorView()
+{
+	pending.reserve(SpectatorFeed::MAX_ENTRY_BYTES * 2);
+}
+
+bool SpectatorView::receive(const unsigned char* data, size_t size)
+{
+	pending.insert(pending.end(), data, data + size);
+	size_t position{ 0 };
+	while (pending.size() - position >= 2)
+	{
+		int entrySize = static_cast<int>(readValue(&pending[position], 2));
+		if (entrySize < SpectatorFeed::ENTRY_HEADER_BYTES || entrySize > SpectatorFeed::MAX_ENTRY_BYTES)
+		{
+			return false;
+		}
+		if (pending.size() - position < static_cast<size_t>(entrySize))
+		{
+			break;
+		}
+		if (!readEntry(&pending[position], entrySize))
+		{
+			return false;
+		}
+		position += static_cast<size_t>(entrySize);
+	}
+	pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(position));
+	return true;
+}
+
+bool SpectatorView::isSynced() const { return synced; }
+
+unsigned int SpectatorView::getFrame() const { return frame; }
+
+const Gameboard& SpectatorView::getBoard(int player) const { return boards[player]; }
+
+const GridTetromino& SpectatorView::getFallingShape(int player) const { return fallingShapes[player]; }
+
+int SpectatorView::getScore(int player) const { return scores[player]; }
+
+unsigned long long SpectatorView::getKeyframes() const { return keyframes; }
+
+unsigned long long SpectatorView::getDeltas() const { return deltas; }
+
+bool SpectatorView::readEntry(const unsigned char* entry, int size)
+{
+	bool keyframe = (entry[6] & SpectatorFeed::FLAG_KEYFRAME) != 0;
+	if (!keyframe && !synced)
+	{
+		return true;
+	}
+	int position{ SpectatorFeed::ENTRY_HEADER_BYTES };
+	for (int player{ 0 }; player < SpectatorFeed::PLAYER_COUNT; player++)
+	{
+		if (size - position < SpectatorFeed::PLAYER_HEADER_BYTES)
+		{
+			return false;
+		}
+		const unsigned char* header = entry + position;
+		if (header[0] >= static_cast<unsigned char>(TetShape::COUNT))
+		{
+			return false;
+		}
+		Placement placement;
+		placement.rotations = header[1] % 4;
+		placement.x = static_cast<signed char>(header[2]);
+		placement.y = static_cast<signed char>(header[3]);
+		PlacementGenerator::placeShape(fallingShapes[player], static_cast<TetShape>(header[0]), placement);
+		scores[player] = static_cast<int>(readValue(header + 4, 4));
+		position += SpectatorFeed::PLAYER_HEADER_BYTES;
+
+		int read = BoardCodec::decode(entry + position, size - position, keyframe ? nullptr : &boards[player], boards[player]);
+		if (read < 0)
+		{
+			return false;
+		}
+		position += read;
+	}
+	frame = readValue(entry + 2, 4);
+	synced = true;
+	if (keyframe)
+	{
+		keyframes++;
+	}
+	else
+	{
+		deltas++;
+	}
+	return true;
+}
+
+unsigned int SpectatorView::readValue(const unsigned char* data, int bytes)
+{
+	unsigned int value{ 0 };
+	for (int i{ 0 }; i < bytes; i++)
+	{
+		value |= static_cast<unsigned int>(data[i]) << (8 * i);
+	}
+	return value;
+}
@@ -0,0 +1,59 @@
+// The SpectatorView is the spectator's end of a SpectatorFeed: it's given the bytes of the
+// stream as they arrive (in any size pieces), and rebuilds both players' boards, falling shapes
+// and scores from the entries.  Entries before the first keyframe are skipped, so the view can
+// start reading anywhere on an entry boundary.
+
+#ifndef SPECTATORVIEW_H
+#define SPECTATORVIEW_H
+
+#include "SpectatorFeed.h"
+#include <vector>
+
+class SpectatorView
+{
+	friend class TestSuite;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	std::vector<unsigned char> pending;			// bytes of an entry that hasn't all arrived (capacity is reused)
+	Gameboard boards[SpectatorFeed::PLAYER_COUNT];
+	GridTetromino fallingShapes[SpectatorFeed::PLAYER_COUNT];
+	int scores[SpectatorFeed::PLAYER_COUNT]{};
+	unsigned int frame{ 0 };
+	bool synced{ false };						// true once a keyframe has been read
+	unsigned long long keyframes{ 0 };
+	unsigned long long deltas{ 0 };
+
+public:
+	// METHODS -------------------------------------------------
+	SpectatorView();
+
+	/// <summary>
+	/// Reads the bytes that arrived.
+	/// </summary>
+	/// <returns>false if the stream is invalid</returns>
+	bool receive(const unsigned char* data, size_t size);
+
+	// Getters
+	bool isSynced() const;
+	unsigned int getFrame() const;
+	const Gameboard& getBoard(int player) const;
+	const GridTetromino& getFallingShape(int player) const;
+	int getScore(int player) const;
+	unsigned long long getKeyframes() const;
+	unsigned long long getDeltas() const;
+
+private:
+	/// <summary>
+	/// Reads one whole entry.
+	/// </summary>
+	/// <returns>false if the entry is invalid</returns>
+	bool readEntry(const unsigned char* entry, int size);
+
+	/// <summary>
+	/// Reads a little endian value.
+	/// </summary>
+	static unsigned int readValue(const unsigned char* data, int bytes);
+};
+
+#endif /* SPECTATORVIEW_H */
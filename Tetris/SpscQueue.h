@@ -0,0 +1,84 @@
+// A SpscQueue is a fixed size, lock-free, single producer / single consumer queue:
+// one thread push()es, another thread pop()s, and neither ever blocks.
+// Items live in a ring of CAPACITY slots (a power of 2) allocated with the queue;
+// a push to a full queue fails rather than waiting.
+//
+// The head and tail counters sit on separate cache lines, so the producer and
+// consumer don't slow each other down by writing to the same line.
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t CAPACITY>
+class SpscQueue
+{
+	static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "SpscQueue CAPACITY must be a power of 2");
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	T items[CAPACITY];
+	alignas(64) std::atomic<size_t> head{ 0 };	// next item to pop (written by the consumer)
+	alignas(64) std::atomic<size_t> tail{ 0 };	// next slot to push into (written by the producer)
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Producer: adds an item to the back of the queue.
+	/// </summary>
+	/// <returns>false if the queue is full (the item isn't added)</returns>
+	bool push(const T& item)
+	{
+		size_t position = tail.load(std::memory_order_relaxed);
+		if (position - head.load(std::memory_order_acquire) == CAPACITY)
+		{
+			return false;
+		}
+		items[position & (CAPACITY - 1)] = item;
+		tail.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Consumer: takes the item at the front of the queue.
+	/// </summary>
+	/// <returns>false if the queue is empty</returns>
+	bool pop(T& item)
+	{
+		size_t position = head.load(std::memory_order_relaxed);
+		if (position == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		item = items[position & (CAPACITY - 1)];
+		head.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Consumer: looks at the item at the front of the queue, without taking it.
+	/// </summary>
+	/// <returns>false if the queue is empty</returns>
+	bool peek(T& item) const
+	{
+		size_t position = head.load(std::memory_order_relaxed);
+		if (position == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		item = items[position & (CAPACITY - 1)];
+		return true;
+	}
+
+	/// <summary>
+	/// Gets the # of items waiting (exact only when called from the producer or consumer while the other is idle).
+	/// </summary>
+	size_t size() const
+	{
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+};
+
+#endif /* SPSCQUEUE_H */
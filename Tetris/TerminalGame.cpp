@@ -0,0 +1,224 @@
+#include "TerminalGame.h"
+#include "FramePacer.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+const double TerminalGame::SECONDS_PER_TICK{ 0.5 };
+const double TerminalGame::BOT_SECONDS_PER_INPUT{ 0.05 };
+
+TerminalGame::TerminalGame(unsigned int seed)
+{
+	reset(seed);
+}
+
+void TerminalGame::reset(unsigned int seed)
+{
+	this->seed = seed;
+	game.reset(seed);
+	secondsSinceLastTick = 0.0;
+	spawn();
+}
+
+void TerminalGame::setBot(bool enabled)
+{
+	bot = enabled;
+	botPlanned = false;
+}
+
+bool TerminalGame::isBot() const { return bot; }
+
+bool TerminalGame::attemptMove(int x, int y)
+{
+	GridTetromino temp = fallingShape;
+	temp.move(x, y);
+	if (generator.isPositionLegal(game.getBoard(), temp))
+	{
+		fallingShape = temp;
+		return true;
+	}
+	return false;
+}
+
+bool TerminalGame::attemptRotate()
+{
+	GridTetromino temp = fallingShape;
+	temp.rotateClockwise();
+	if (generator.isPositionLegal(game.getBoard(), temp))
+	{
+		fallingShape = temp;
+		fallingRotations = (fallingRotations + 1) % 4;
+		return true;
+	}
+	return false;
+}
+
+void TerminalGame::drop()
+{
+	while (attemptMove(0, 1)) {};
+	lock();
+}
+
+void TerminalGame::onKey(TerminalKey key)
+{
+	switch (key)
+	{
+		case TerminalKey::LEFT: attemptMove(-1, 0); break;
+		case TerminalKey::RIGHT: attemptMove(1, 0); break;
+		case TerminalKey::UP: attemptRotate(); break;
+		case TerminalKey::DOWN: attemptMove(0, 1); break;
+		case TerminalKey::SPACE: drop(); break;
+		case TerminalKey::BOT: setBot(!bot); break;
+		default: break;
+	}
+}
+
+void TerminalGame::update(double seconds)
+{
+	if (bot)
+	{
+		updateBot(seconds);
+	}
+	secondsSinceLastTick += seconds;
+	if (secondsSinceLastTick >= SECONDS_PER_TICK)
+	{
+		secondsSinceLastTick -= SECONDS_PER_TICK;
+		// if the tick fails, the shape is locked
+		if (!attemptMove(0, 1))
+		{
+			lock();
+		}
+	}
+}
+
+void TerminalGame::draw(TerminalRenderer& renderer) const
+{
+	const int boardLeft{ 1 };
+	const int boardTop{ 1 };
+	const int panelLeft{ boardLeft + Gameboard::MAX_X * TerminalRenderer::CELL_WIDTH + 5 };
+	renderer.clear();
+	renderer.drawGameboard(game.getBoard(), boardLeft, boardTop);
+	renderer.drawTetromino(fallingShape, boardLeft, boardTop);
+
+	renderer.drawText(panelLeft, boardTop, "next:");
+	GridTetromino next = game.getNextShape();
+	next.setGridLoc(2, 3);
+	renderer.drawTetromino(next, panelLeft - 1, boardTop);
+
+	renderer.drawText(panelLeft, boardTop + 7, "score: " + std::to_string(game.getScore()));
+	renderer.drawText(panelLeft, boardTop + 8, "games: " + std::to_string(gamesPlayed));
+	renderer.drawText(panelLeft, boardTop + 10, bot ? "bot: on  (b)" : "bot: off (b)");
+	renderer.drawText(panelLeft, boardTop + 11, "arrows/wasd, space");
+	renderer.drawText(panelLeft, boardTop + 12, "q to quit");
+}
+
+void TerminalGame::runInTerminal(bool watchBot)
+{
+	const int SCREEN_WIDTH{ 50 };
+	const int SCREEN_HEIGHT{ Gameboard::MAX_Y + 3 };
+	TerminalRenderer renderer(SCREEN_WIDTH, SCREEN_HEIGHT);
+	TerminalInput input;
+	TerminalGame game(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
+	game.setBot(watchBot);
+
+	FramePacer pacer(60.0);
+	pacer.setMode(PacingMode::LIMITED);
+	auto lastFrame = std::chrono::steady_clock::now();
+	unsigned long long bytesWritten{ 0 };
+	unsigned long long frames{ 0 };
+	bool quit{ false };
+	while (!quit)
+	{
+		for (TerminalKey key = input.readKey(); key != TerminalKey::NONE; key = input.readKey())
+		{
+			if (key == TerminalKey::QUIT)
+			{
+				quit = true;
+			}
+			game.onKey(key);
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		int steps = pacer.takeSimulationSteps(std::chrono::duration<double>(now - lastFrame).count());
+		lastFrame = now;
+		for (int step{ 0 }; step < steps; step++)
+		{
+			game.update(FramePacer::SIMULATION_STEP);
+		}
+
+		game.draw(renderer);
+		bytesWritten += renderer.writeFrame(stdout);
+		frames++;
+		pacer.waitForNextFrame();
+	}
+	std::fputs(TerminalRenderer::getRestoreSequence(), stdout);
+	std::cout << frames << " frames, " << (frames > 0 ? bytesWritten / frames : 0) << " bytes/frame on average ("
+		<< (frames > 0 ? bytesWritten * 60.0 / frames / 1024.0 : 0.0) << " KB/sec at 60 fps)\n";
+}
+
+const Gameboard& TerminalGame::getBoard() const { return game.getBoard(); }
+
+const GridTetromino& TerminalGame::getFallingShape() const { return fallingShape; }
+
+int TerminalGame::getScore() const { return game.getScore(); }
+
+int TerminalGame::getGamesPlayed() const { return gamesPlayed; }
+
+void TerminalGame::lock()
+{
+	Placement placement;
+	placement.rotations = fallingRotations;
+	placement.x = fallingShape.getGridLoc().getX();
+	placement.y = fallingShape.getGridLoc().getY();
+	if (!game.applyPlacement(placement))
+	{
+		gamesPlayed++;
+		reset(seed + 1);
+		return;
+	}
+	spawn();
+}
+
+void TerminalGame::spawn()
+{
+	fallingShape = game.getCurrentShape();
+	fallingRotations = 0;
+	botPlanned = false;
+}
+
+void TerminalGame::pressInput(FinesseInput input)
+{
+	switch (input)
+	{
+		case FinesseInput::LEFT: attemptMove(-1, 0); break;
+		case FinesseInput::RIGHT: attemptMove(1, 0); break;
+		case FinesseInput::DAS_LEFT: while (attemptMove(-1, 0)) {}; break;
+		case FinesseInput::DAS_RIGHT: while (attemptMove(1, 0)) {}; break;
+		case FinesseInput::ROTATE: attemptRotate(); break;
+		case FinesseInput::SOFT_DROP: attemptMove(0, 1); break;
+		default: drop(); break;
+	}
+}
+
+void TerminalGame::updateBot(double seconds)
+{
+	if (!botPlanned)
+	{
+		Placement best;
+		if (!evaluator.choosePlacement(game.getBoard(), fallingShape.getShape(), best) ||
+			!finesse.findInputs(game.getBoard(), fallingShape.getShape(), best, botInputs))
+		{
+			botInputs.assign(1, FinesseInput::HARD_DROP);
+		}
+		nextBotInput = 0;
+		botPlanned = true;
+		secondsSinceLastInput = 0.0;
+	}
+	secondsSinceLastInput += seconds;
+	if (nextBotInput < botInputs.size() && secondsSinceLastInput >= BOT_SECONDS_PER_INPUT)
+	{
+		secondsSinceLastInput = 0.0;
+		pressInput(botInputs[nextBotInput++]);
+	}
+}
@@ -0,0 +1,137 @@
+// The TerminalGame is a playable tetris game for the TerminalRenderer (no window, no SFML).
+// The rules (locking, removing rows, scoring, the shape sequence) come from a HeadlessGame:
+// the falling shape is moved here, and when it locks its placement is handed to
+// HeadlessGame::applyPlacement().
+//
+// With the bot on, the BoardEvaluator picks a placement for each shape and the
+// FinesseAnalyzer turns it into key presses, one every BOT_SECONDS_PER_INPUT,
+// so watching the bot looks like watching a player (like TetrisGame's autoplay).
+
+#ifndef TERMINALGAME_H
+#define TERMINALGAME_H
+
+#include "BoardEvaluator.h"
+#include "FinesseAnalyzer.h"
+#include "HeadlessGame.h"
+#include "PlacementGenerator.h"
+#include "TerminalInput.h"
+#include "TerminalRenderer.h"
+#include <vector>
+
+class TerminalGame
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const double SECONDS_PER_TICK;			// how often the shape falls a row, init to 0.5
+	static const double BOT_SECONDS_PER_INPUT;		// how often the bot presses a key, init to 0.05
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	HeadlessGame game;							// the board, shape sequence and score
+	GridTetromino fallingShape;					// the current shape where the player has moved it
+	int fallingRotations{ 0 };					// # of clockwise rotations of the fallingShape (0-3)
+	PlacementGenerator generator;				// legality tests
+	unsigned int seed;							// the seed of the current game
+	double secondsSinceLastTick{ 0.0 };
+	int gamesPlayed{ 0 };
+
+	// bot members
+	bool bot{ false };
+	BoardEvaluator evaluator;
+	FinesseAnalyzer finesse;
+	std::vector<FinesseInput> botInputs;		// the keys to press for the fallingShape
+	size_t nextBotInput{ 0 };
+	bool botPlanned{ false };					// true once the inputs for the fallingShape are planned
+	double secondsSinceLastInput{ 0.0 };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="seed">the seed for the first game's shape sequence</param>
+	explicit TerminalGame(unsigned int seed);
+
+	/// <summary>
+	/// Starts a new game.
+	/// </summary>
+	void reset(unsigned int seed);
+
+	/// <summary>
+	/// Turns the bot on or off.
+	/// </summary>
+	void setBot(bool enabled);
+	bool isBot() const;
+
+	/// <summary>
+	/// Moves the fallingShape if the move is legal (same rules as TetrisGame::attemptMove()).
+	/// </summary>
+	/// <returns>true if the shape moved</returns>
+	bool attemptMove(int x, int y);
+
+	/// <summary>
+	/// Rotates the fallingShape clockwise if the rotation is legal.
+	/// </summary>
+	/// <returns>true if the shape rotated</returns>
+	bool attemptRotate();
+
+	/// <summary>
+	/// Drops the fallingShape as far as it goes and locks it.
+	/// </summary>
+	void drop();
+
+	/// <summary>
+	/// Handles a key (QUIT is handled by the caller).
+	/// </summary>
+	void onKey(TerminalKey key);
+
+	/// <summary>
+	/// Advances the game: ticks (the shape falls, and locks when it can't),
+	/// and the bot's key presses.  A new game starts when the game is over.
+	/// </summary>
+	/// <param name="seconds">the time since the last update</param>
+	void update(double seconds);
+
+	/// <summary>
+	/// Draws the board, the fallingShape, the next shape and the score.
+	/// </summary>
+	void draw(TerminalRenderer& renderer) const;
+
+	/// <summary>
+	/// Plays in the terminal at 60 frames per second until q is pressed, then reports
+	/// the average # of bytes written per frame.
+	/// </summary>
+	/// <param name="watchBot">true to start with the bot playing</param>
+	static void runInTerminal(bool watchBot);
+
+	// Getters
+	const Gameboard& getBoard() const;
+	const GridTetromino& getFallingShape() const;
+	int getScore() const;
+	int getGamesPlayed() const;
+
+private:
+	/// <summary>
+	/// Locks the fallingShape (through the HeadlessGame) and spawns the next one.
+	/// </summary>
+	void lock();
+
+	/// <summary>
+	/// Copies the HeadlessGame's new current shape into the fallingShape.
+	/// </summary>
+	void spawn();
+
+	/// <summary>
+	/// Presses the key(s) for a finesse input (DAS inputs repeat until the shape stops moving).
+	/// </summary>
+	void pressInput(FinesseInput input);
+
+	/// <summary>
+	/// Plans and presses the bot's keys.
+	/// </summary>
+	void updateBot(double seconds);
+};
+
+#endif /* TERMINALGAME_H */
@@ -0,0 +1,156 @@
+#include "TerminalInput.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <conio.h>
+#else
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+const double TerminalInput::ESCAPE_SECONDS{ 0.05 };
+
+TerminalInput::TerminalInput()
+{
+#ifndef _WIN32
+	termios settings;
+	static_assert(sizeof(termios) <= sizeof(savedSettings), "savedSettings is too small for termios");
+	if (tcgetattr(STDIN_FILENO, &settings) == 0)
+	{
+		std::memcpy(savedSettings, &settings, sizeof(settings));
+		// no echo, no line buffering, and read() returns immediately.  Ctrl-C doesn't raise SIGINT
+		// (which would skip the destructors that restore the terminal), it's read as a QUIT.
+		settings.c_lflag &= ~(ICANON | ECHO | ISIG);
+		settings.c_cc[VMIN] = 0;
+		settings.c_cc[VTIME] = 0;
+		rawMode = tcsetattr(STDIN_FILENO, TCSANOW, &settings) == 0;
+	}
+#endif
+}
+
+TerminalInput::~TerminalInput()
+{
+#ifndef _WIN32
+	if (rawMode)
+	{
+		termios settings;
+		std::memcpy(&settings, savedSettings, sizeof(settings));
+		tcsetattr(STDIN_FILENO, TCSANOW, &settings);
+	}
+#endif
+}
+
+TerminalKey TerminalInput::readKey()
+{
+#ifdef _WIN32
+	if (!_kbhit())
+	{
+		return TerminalKey::NONE;
+	}
+	int key = _getch();
+	if (key == 0 || key == 224)
+	{
+		// arrow keys come as 2 codes
+		switch (_getch())
+		{
+			case 75: return TerminalKey::LEFT;
+			case 77: return TerminalKey::RIGHT;
+			case 72: return TerminalKey::UP;
+			case 80: return TerminalKey::DOWN;
+			default: return TerminalKey::NONE;
+		}
+	}
+	return mapKey(key);
+#else
+	Clock::time_point now = Clock::now();
+	unsigned char bytes[PENDING_SIZE];
+	ssize_t count = read(STDIN_FILENO, bytes, static_cast<size_t>(PENDING_SIZE - pendingCount));
+	if (count > 0)
+	{
+		addBytes(bytes, static_cast<int>(count), now);
+	}
+	return takeKey(now);
+#endif
+}
+
+int TerminalInput::addBytes(const unsigned char* bytes, int count, Clock::time_point now)
+{
+	if (pendingCount == 0)
+	{
+		pendingTime = now;
+	}
+	int added{ 0 };
+	for (; added < count && pendingCount < PENDING_SIZE; added++)
+	{
+		pending[pendingCount++] = bytes[added];
+	}
+	return added;
+}
+
+TerminalKey TerminalInput::takeKey(Clock::time_point now)
+{
+	if (pendingCount == 0)
+	{
+		return TerminalKey::NONE;
+	}
+	if (pending[0] != 27)
+	{
+		int key = pending[0];
+		dropPending(1, now);
+		return mapKey(key);
+	}
+
+	// arrow keys are "ESC [ A-D"
+	if (pendingCount >= 2 && pending[1] != '[')
+	{
+		// an escape followed by another key
+		dropPending(1, now);
+		return TerminalKey::QUIT;
+	}
+	if (pendingCount < 3)
+	{
+		// the rest of the sequence may still be on its way, a lone escape is a quit once it's waited long enough
+		if (std::chrono::duration<double>(now - pendingTime).count() < ESCAPE_SECONDS)
+		{
+			return TerminalKey::NONE;
+		}
+		dropPending(pendingCount, now);
+		return TerminalKey::QUIT;
+	}
+	int code = pending[2];
+	dropPending(3, now);
+	switch (code)
+	{
+		case 'D': return TerminalKey::LEFT;
+		case 'C': return TerminalKey::RIGHT;
+		case 'A': return TerminalKey::UP;
+		case 'B': return TerminalKey::DOWN;
+		default: return TerminalKey::NONE;
+	}
+}
+
+void TerminalInput::dropPending(int count, Clock::time_point now)
+{
+	for (int i{ count }; i < pendingCount; i++)
+	{
+		pending[i - count] = pending[i];
+	}
+	pendingCount -= count;
+	// the bytes left were read together, so their wait starts now
+	pendingTime = now;
+}
+
+TerminalKey TerminalInput::mapKey(int key)
+{
+	switch (key)
+	{
+		case 'a': return TerminalKey::LEFT;
+		case 'd': return TerminalKey::RIGHT;
+		case 'w': return TerminalKey::UP;
+		case 's': return TerminalKey::DOWN;
+		case ' ': return TerminalKey::SPACE;
+		case 'b': return TerminalKey::BOT;
+		case 'q': case 27: case 3: return TerminalKey::QUIT;
+		default: return TerminalKey::NONE;
+	}
+}
@@ -0,0 +1,78 @@
+// TerminalInput reads keys from a text terminal without waiting for Enter.
+// On construction the terminal is switched to raw input (POSIX: termios with echo and
+// line buffering off; Windows: the console is read through conio), and it's restored
+// on destruction.  readKey() never blocks.  Signals are off in raw mode, so Ctrl-C is read as a
+// QUIT key and the game exits normally, restoring the terminal.
+//
+// POSIX terminals send the arrow keys as "ESC [ A-D", and the 3 bytes don't always arrive in
+// the same read(), so bytes are kept between readKey() calls until a whole key is there.  An
+// ESC only counts as the escape key once nothing has followed it for ESCAPE_SECONDS.
+
+#ifndef TERMINALINPUT_H
+#define TERMINALINPUT_H
+
+#include <chrono>
+
+enum class TerminalKey { NONE, LEFT, RIGHT, UP, DOWN, SPACE, BOT, QUIT };
+
+class TerminalInput
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const double ESCAPE_SECONDS;		// how long a lone ESC waits for the rest of a sequence, init to 0.05
+
+private:
+	typedef std::chrono::steady_clock Clock;
+	static const int PENDING_SIZE = 3;		// the longest key sequence
+
+	// MEMBER VARIABLES -------------------------------------------------
+	bool rawMode{ false };				// true if the terminal settings were changed (and must be restored)
+	unsigned char savedSettings[256];	// POSIX: the original termios settings
+	unsigned char pending[PENDING_SIZE];// POSIX: bytes read that aren't a whole key yet
+	int pendingCount{ 0 };
+	Clock::time_point pendingTime;		// when the first pending byte arrived
+
+public:
+	// METHODS -------------------------------------------------
+	TerminalInput();
+	~TerminalInput();
+	TerminalInput(const TerminalInput&) = delete;
+	TerminalInput& operator=(const TerminalInput&) = delete;
+
+	/// <summary>
+	/// Reads the next key, if one has been pressed.
+	///		arrow keys or w/a/s/d:	LEFT, RIGHT, UP (rotate), DOWN
+	///		space:					SPACE (drop)
+	///		b:						BOT (toggle the bot)
+	///		q, escape or Ctrl-C:	QUIT
+	/// </summary>
+	/// <returns>the key, or NONE if no key is waiting</returns>
+	TerminalKey readKey();
+
+private:
+	/// <summary>
+	/// Adds bytes read from the terminal to the pending bytes (as many as there's room for).
+	/// </summary>
+	/// <returns>the # of bytes added</returns>
+	int addBytes(const unsigned char* bytes, int count, Clock::time_point now);
+
+	/// <summary>
+	/// Takes the first whole key from the pending bytes.
+	/// </summary>
+	/// <returns>the key, or NONE if there isn't a whole key yet</returns>
+	TerminalKey takeKey(Clock::time_point now);
+
+	/// <summary>
+	/// Removes bytes from the front of the pending bytes.
+	/// </summary>
+	void dropPending(int count, Clock::time_point now);
+
+	/// <summary>
+	/// Maps a single byte key (w/a/s/d, space, b, q, escape).
+	/// </summary>
+	static TerminalKey mapKey(int key);
+};
+
+#endif /* TERMINALINPUT_H */
@@ -0,0 +1,231 @@
+#include "TerminalRenderer.h"
+#include <algorithm>
+
+bool TerminalCell::operator==(const TerminalCell& other) const
+{
+	return glyph == other.glyph && foreground == other.foreground && background == other.background;
+}
+
+bool TerminalCell::operator!=(const TerminalCell& other) const
+{
+	return !(*this == other);
+}
+
+TerminalRenderer::TerminalRenderer(int width, int height)
+	: width{ width }, height{ height }, frame(width * height), shadow(width * height)
+{
+	// a full redraw is ~20 bytes per cell at worst
+	output.reserve(static_cast<size_t>(width) * height * 20);
+}
+
+void TerminalRenderer::clear()
+{
+	std::fill(frame.begin(), frame.end(), TerminalCell());
+}
+
+void TerminalRenderer::setCell(int x, int y, char glyph, unsigned char foreground, unsigned char background)
+{
+	if (x < 0 || x >= width || y < 0 || y >= height)
+	{
+		return;
+	}
+	TerminalCell& cell = frame[y * width + x];
+	cell.glyph = glyph;
+	cell.foreground = foreground;
+	cell.background = background;
+}
+
+void TerminalRenderer::drawText(int x, int y, const std::string& text)
+{
+	for (size_t i{ 0 }; i < text.size(); i++)
+	{
+		setCell(x + static_cast<int>(i), y, text[i], DEFAULT_COLOUR, DEFAULT_COLOUR);
+	}
+}
+
+void TerminalRenderer::drawGameboard(const Gameboard& board, int left, int top)
+{
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+	{
+		setCell(left, top + y, '|', DEFAULT_COLOUR, DEFAULT_COLOUR);
+		setCell(left + 1 + Gameboard::MAX_X * CELL_WIDTH, top + y, '|', DEFAULT_COLOUR, DEFAULT_COLOUR);
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			int content = board.getContent(x, y);
+			unsigned char colour = content == Gameboard::EMPTY_BLOCK ? EMPTY_COLOUR : getBlockColour(static_cast<TetColor>(content));
+			for (int column{ 0 }; column < CELL_WIDTH; column++)
+			{
+				setCell(left + 1 + x * CELL_WIDTH + column, top + y, ' ', DEFAULT_COLOUR, colour);
+			}
+		}
+	}
+	for (int x{ 0 }; x < Gameboard::MAX_X * CELL_WIDTH + 2; x++)
+	{
+		setCell(left + x, top + Gameboard::MAX_Y, '-', DEFAULT_COLOUR, DEFAULT_COLOUR);
+	}
+}
+
+void TerminalRenderer::drawTetromino(const GridTetromino& tetromino, int left, int top, bool ghost)
+{
+	unsigned char colour = getBlockColour(tetromino.getColor());
+	for (const Point& pt : tetromino.getBlockLocsMappedToGrid())
+	{
+		if (pt.getY() < 0)
+		{
+			continue;
+		}
+		int x = left + 1 + pt.getX() * CELL_WIDTH;
+		if (ghost)
+		{
+			setCell(x, top + pt.getY(), '[', colour, EMPTY_COLOUR);
+			setCell(x + 1, top + pt.getY(), ']', colour, EMPTY_COLOUR);
+		}
+		else {
+			setCell(x, top + pt.getY(), ' ', DEFAULT_COLOUR, colour);
+			setCell(x + 1, top + pt.getY(), ' ', DEFAULT_COLOUR, colour);
+		}
+	}
+}
+
+const std::string& TerminalRenderer::present()
+{
+	output.clear();
+	if (fullRedraw)
+	{
+		// reset the colours, clear the screen and hide the cursor
+		output += "\x1b[0m\x1b[2J\x1b[?25l";
+		penForeground = DEFAULT_COLOUR;
+		penBackground = DEFAULT_COLOUR;
+		cursorX = -1;
+		cursorY = -1;
+		// the screen is now blank, so only non-blank cells need to be sent
+		std::fill(shadow.begin(), shadow.end(), TerminalCell());
+		fullRedraw = false;
+	}
+
+	for (int y{ 0 }; y < height; y++)
+	{
+		for (int x{ 0 }; x < width; x++)
+		{
+			const TerminalCell& cell = frame[y * width + x];
+			TerminalCell& shown = shadow[y * width + x];
+			if (cell == shown)
+			{
+				continue;
+			}
+			moveCursor(x, y);
+			setColours(cell.foreground, cell.background);
+			output += cell.glyph;
+			cursorX++;
+			shown = cell;
+		}
+	}
+	return output;
+}
+
+size_t TerminalRenderer::writeFrame(std::FILE* file)
+{
+	const std::string& bytes = present();
+	if (!bytes.empty())
+	{
+		std::fwrite(bytes.data(), 1, bytes.size(), file);
+		std::fflush(file);
+	}
+	return bytes.size();
+}
+
+void TerminalRenderer::invalidate()
+{
+	fullRedraw = true;
+}
+
+const char* TerminalRenderer::getRestoreSequence()
+{
+	return "\x1b[0m\x1b[?25h\n";
+}
+
+unsigned char TerminalRenderer::getBlockColour(TetColor colour)
+{
+	switch (colour)
+	{
+		case TetColor::RED: return 196;
+		case TetColor::ORANGE: return 208;
+		case TetColor::YELLOW: return 226;
+		case TetColor::GREEN: return 46;
+		case TetColor::BLUE_LIGHT: return 51;
+		case TetColor::BLUE_DARK: return 21;
+		case TetColor::PURPLE: return 129;
+		default: return DEFAULT_COLOUR;
+	}
+}
+
+void TerminalRenderer::moveCursor(int x, int y)
+{
+	if (x == cursorX && y == cursorY)
+	{
+		return;
+	}
+	// rows and columns are 1 based
+	output += "\x1b[";
+	appendNumber(y + 1);
+	output += ';';
+	appendNumber(x + 1);
+	output += 'H';
+	cursorX = x;
+	cursorY = y;
+}
+
+void TerminalRenderer::setColours(unsigned char foreground, unsigned char background)
+{
+	if (foreground == penForeground && background == penBackground)
+	{
+		return;
+	}
+	output += "\x1b[";
+	if ((foreground == DEFAULT_COLOUR && penForeground != DEFAULT_COLOUR) ||
+		(background == DEFAULT_COLOUR && penBackground != DEFAULT_COLOUR))
+	{
+		// going back to a default colour takes a reset (then the other colour is set again)
+		output += "0;";
+		penForeground = DEFAULT_COLOUR;
+		penBackground = DEFAULT_COLOUR;
+	}
+	bool separator{ false };
+	if (foreground != penForeground)
+	{
+		output += "38;5;";
+		appendNumber(foreground);
+		separator = true;
+	}
+	if (background != penBackground)
+	{
+		if (separator)
+		{
+			output += ';';
+		}
+		output += "48;5;";
+		appendNumber(background);
+	}
+	if (output.back() == ';')
+	{
+		output.pop_back();
+	}
+	output += 'm';
+	penForeground = foreground;
+	penBackground = background;
+}
+
+void TerminalRenderer::appendNumber(int number)
+{
+	char digits[12];
+	int count{ 0 };
+	do
+	{
+		digits[count++] = static_cast<char>('0' + number % 10);
+		number /= 10;
+	} while (number > 0);
+	while (count > 0)
+	{
+		output += digits[--count];
+	}
+}
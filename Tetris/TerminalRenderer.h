@@ -0,0 +1,140 @@
+// The TerminalRenderer draws the game in a text terminal (ie. over SSH) with ANSI escape sequences.
+//
+// Each frame is drawn into a framebuffer of character cells (a character, a foreground
+// and a background colour).  present() compares it with a shadow copy of what the
+// terminal is already showing, and only emits the cells that changed: a cursor move
+// (skipped when the cursor is already there), a colour change (skipped when the colours
+// are already set), then the character.  The output is built in one reused string and
+// written with a single write per frame, so an unchanged frame costs nothing and a
+// falling shape costs a few dozen bytes.
+//
+// Colours are xterm 256 colour indices (DEFAULT_COLOUR is the terminal's own colour).
+// Board blocks are 2 characters wide, so they look roughly square.
+
+#ifndef TERMINALRENDERER_H
+#define TERMINALRENDERER_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// One character cell of the terminal.
+/// </summary>
+struct TerminalCell
+{
+	char glyph{ ' ' };
+	unsigned char foreground{ 255 };	// 255 = the terminal's default colour
+	unsigned char background{ 255 };
+
+	bool operator==(const TerminalCell& other) const;
+	bool operator!=(const TerminalCell& other) const;
+};
+
+class TerminalRenderer
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const unsigned char DEFAULT_COLOUR = 255;	// the terminal's default colour
+	static const unsigned char EMPTY_COLOUR = 236;		// the background of empty board cells (dark grey)
+	static const int CELL_WIDTH = 2;					// terminal columns per board block
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+	int width;									// terminal columns used
+	int height;									// terminal rows used
+	std::vector<TerminalCell> frame;			// the frame being drawn
+	std::vector<TerminalCell> shadow;			// what the terminal is showing
+	bool fullRedraw{ true };					// clear the terminal and emit every cell on the next present()
+	std::string output;							// the escape sequences for one frame (capacity is reused)
+	int cursorX{ -1 };							// where the terminal's cursor is (-1 = unknown)
+	int cursorY{ -1 };
+	unsigned char penForeground{ DEFAULT_COLOUR };	// the colours the terminal is set to
+	unsigned char penBackground{ DEFAULT_COLOUR };
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="width">terminal columns to use</param>
+	/// <param name="height">terminal rows to use</param>
+	TerminalRenderer(int width, int height);
+
+	/// <summary>
+	/// Blanks the frame being drawn (the terminal isn't touched until present()).
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Sets a cell of the frame.  Cells outside the frame are ignored.
+	/// </summary>
+	void setCell(int x, int y, char glyph, unsigned char foreground, unsigned char background);
+
+	/// <summary>
+	/// Draws text into the frame in the default colours.
+	/// </summary>
+	void drawText(int x, int y, const std::string& text);
+
+	/// <summary>
+	/// Draws a board (with a border) into the frame.  The board's inside starts at (left + 1, top).
+	/// </summary>
+	void drawGameboard(const Gameboard& board, int left, int top);
+
+	/// <summary>
+	/// Draws a tetromino's blocks into the frame, using the same offsets as drawGameboard().
+	/// Blocks above the board are skipped.
+	/// </summary>
+	/// <param name="ghost">draw the blocks as an outline (ie. a hint) rather than solid</param>
+	void drawTetromino(const GridTetromino& tetromino, int left, int top, bool ghost = false);
+
+	/// <summary>
+	/// Builds the escape sequences that bring the terminal from the shadow to the frame,
+	/// and updates the shadow.  Nothing is written.
+	/// </summary>
+	/// <returns>the escape sequences (valid until the next present())</returns>
+	const std::string& present();
+
+	/// <summary>
+	/// present()s the frame and writes it with a single fwrite() and flush.
+	/// </summary>
+	/// <returns>the # of bytes written</returns>
+	size_t writeFrame(std::FILE* file);
+
+	/// <summary>
+	/// Makes the next present() clear the terminal and redraw everything (ie. after the terminal was resized).
+	/// </summary>
+	void invalidate();
+
+	/// <summary>
+	/// Gets the escape sequence that puts the terminal back to normal (colours, cursor) on exit.
+	/// </summary>
+	static const char* getRestoreSequence();
+
+	/// <summary>
+	/// Gets the 256 colour index of a block colour.
+	/// </summary>
+	static unsigned char getBlockColour(TetColor colour);
+
+private:
+	/// <summary>
+	/// Appends a cursor move (if the cursor isn't already there).
+	/// </summary>
+	void moveCursor(int x, int y);
+
+	/// <summary>
+	/// Appends colour changes (if the colours aren't already set).
+	/// </summary>
+	void setColours(unsigned char foreground, unsigned char background);
+
+	/// <summary>
+	/// Appends a number in decimal (without allocating).
+	/// </summary>
+	void appendNumber(int number);
+};
+
+#endif /* TERMINALRENDERER_H */
@@ -16,7 +16,159 @@
 #include "GridTetromino.h"
 #endif
 
+#ifdef PLACEMENTGENERATOR
+#include "PlacementGenerator.h"
+#endif
+
+#ifdef HEADLESSGAME
+#include "HeadlessGame.h"
+#endif
+
+#ifdef BOARDEVALUATOR
+#include "BoardEvaluator.h"
+#endif
+
+#ifdef WEIGHTTUNER
+#include "WeightTuner.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#endif
+
+#ifdef PERFT
+#include "Perft.h"
+#include <algorithm>
+#include <set>
+#endif
+
+#ifdef ROLLOUTEVALUATOR
+#include "RolloutEvaluator.h"
+#endif
+
+#ifdef FINESSEANALYZER
+#include "FinesseAnalyzer.h"
+#endif
+
+#ifdef BOARDRASTERIZER
+#include "BoardRasterizer.h"
+#include <cstdio>
+#include <fstream>
+#endif
+
+#ifdef FRAMEPROFILER
+#include "FrameProfiler.h"
+#include <chrono>
+#include <thread>
+#endif
+
+#ifdef FRAMEPACER
+#include "FramePacer.h"
+#include <chrono>
+#endif
+
+#ifdef TERMINALRENDERER
+#include "TerminalRenderer.h"
+#endif
+
+#ifdef TERMINALGAME
+#include "TerminalGame.h"
+#endif
+
+#ifdef TERMINALINPUT
+#include "TerminalInput.h"
+#endif
+
+#ifdef SPSCQUEUE
+#include "SpscQueue.h"
+#include <thread>
+#endif
+
+#ifdef TRIPLEBUFFER
+#include "TripleBuffer.h"
+#include <thread>
+#endif
+
+#ifdef LINECLEARANIMATOR
+#include "LineClearAnimator.h"
+#endif
+
+#ifdef HUDTEXT
+#include "HudText.h"
+#include <climits>
+#endif
+
+#ifdef BOARDWALL
+#include "BoardWall.h"
+#endif
+
+#ifdef LOCKSTEPGAME
+#include "LockstepGame.h"
+#endif
+
+#ifdef LOCKSTEPPEER
+#include "LockstepPeer.h"
+#include <random>
+#endif
+
+#ifdef WORKERPOOL
+#include "WorkerPool.h"
+#include <atomic>
+#endif
+
+#ifdef MATCHPOOL
+#include "MatchPool.h"
+#endif
+
+#ifdef BOARDCODEC
+#include "BoardCodec.h"
+#endif
+
+#ifdef SPECTATORFEED
+#include "SpectatorFeed.h"
+#include "SpectatorView.h"
+#endif
+
+#ifdef GARBAGEEXCHANGE
+#include "GarbageExchange.h"
+#include "MatchPool.h"
+#include <thread>
+#include <climits>
+#endif
+
+#ifdef TOURNAMENT
+#include "Tournament.h"
+#include <cstdio>
+#include <fstream>
+#endif
+
+#ifdef NETWORKIMPAIRMENT
+#include "NetworkImpairment.h"
+#include <algorithm>
+#endif
+
+#ifdef ROLLBACKPEER
+#include "RollbackPeer.h"
+#include "NetworkImpairment.h"
+#include <random>
+#endif
+
+#ifdef MATCHMAKER
+#include "Matchmaker.h"
+#include "MatchmakingLoad.h"
+#endif
+
+#ifdef LATENCYSTATS
+#include "LatencyStats.h"
+#endif
+
+#ifdef HINTWORKER
+#include "HintWorker.h"
+#include <chrono>
+#include <thread>
+#endif
+
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <string>
 
@@ -30,9 +182,207 @@ void TestSuite::runTestSuite()
 	testTetrominoClass();
 	testGameboardClass();
 	testGridTetrominoClass();
+	testPlacementGeneratorClass();
+	testHeadlessGameClass();
+	testBoardEvaluatorClass();
+	testWeightTunerClass();
+	testPerftClass();
+	testHintWorkerClass();
+	testRolloutEvaluatorClass();
+	testFinesseAnalyzerClass();
+	testBoardRasterizerClass();
+	testFrameProfilerClass();
+	testFramePacerClass();
+	testTerminalRendererClass();
+	testTerminalGameClass();
+	testTerminalInputClass();
+	testSpscQueueClass();
+	testTripleBufferClass();
+	testLineClearAnimatorClass();
+	testHudTextClass();
+	testBoardWallClass();
+	testLockstepGameClass();
+	testLockstepPeerClass();
+	testWorkerPoolClass();
+	testMatchPoolClass();
+	testBoardCodecClass();
+	testSpectatorFeedClass();
+	testGarbageExchangeClass();
+	testTournamentClass();
+	testNetworkImpairmentClass();
+	testRollbackPeerClass();
+	testMatchmakerClass();
+	testLatencyStatsClass();
 	std::cout << "=== TestSuite complete ========================" << "\n\n";
 }
 
+#ifdef PERFT
+unsigned long long TestSuite::bruteForcePerft(const Gameboard& board, const std::vector<TetShape>& sequence, int depth)
+{
+	std::vector<int> grid(Gameboard::MAX_Y * Gameboard::MAX_X);
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			grid[y * Gameboard::MAX_X + x] = board.getContent(x, y) != Gameboard::EMPTY_BLOCK ? 1 : 0;
+		}
+	}
+	return bruteForcePerftFrom(grid, sequence, 0, depth);
+}
+
+unsigned long long TestSuite::bruteForcePerftFrom(const std::vector<int>& grid, const std::vector<TetShape>& sequence, int ply, int depth)
+{
+	if (depth == 0 || sequence.empty())
+	{
+		return 1;
+	}
+	const int W = Gameboard::MAX_X;
+	const int H = Gameboard::MAX_Y;
+	const int spawnX = W / 2;		// Gameboard's spawnLoc
+	const int spawnY = 0;
+
+	// the block offsets of each rotation
+	TetShape shape = sequence[ply % sequence.size()];
+	Tetromino tetromino;
+	tetromino.setShape(shape);
+	int offsets[4][BLOCK_COUNT][2];
+	for (int r = 0; r < 4; r++)
+	{
+		std::vector<Point> blocks = tetromino.getBlockLocs();
+		for (int b = 0; b < BLOCK_COUNT; b++)
+		{
+			offsets[r][b][0] = blocks[b].getX();
+			offsets[r][b][1] = blocks[b].getY();
+		}
+		tetromino.rotateClockwise();
+	}
+	auto fits = [&](int r, int x, int y)
+	{
+		for (int b = 0; b < BLOCK_COUNT; b++)
+		{
+			int bx = x + offsets[r][b][0];
+			int by = y + offsets[r][b][1];
+			if (bx < 0 || bx >= W || by >= H || (by >= 0 && grid[by * W + bx] != 0))
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	std::set<std::vector<int>> seen;
+	unsigned long long leaves{ 0 };
+	for (int r = 0; r < 4; r++)
+	{
+		bool rotates = true;
+		for (int k = 0; k <= r; k++) { rotates = rotates && fits(k, spawnX, spawnY); }
+		for (int x = -4; x < W + 4 && rotates; x++)
+		{
+			bool slides = true;
+			for (int step = spawnX; step != x && slides; step += x > spawnX ? 1 : -1) { slides = fits(r, step, spawnY); }
+			for (int y = spawnY; y < H + 4 && slides; y++)
+			{
+				bool drops = true;
+				for (int step = spawnY; step <= y && drops; step++) { drops = fits(r, x, step); }
+				if (!drops || fits(r, x, y + 1))
+				{
+					continue;
+				}
+				std::vector<int> cells;
+				for (int b = 0; b < BLOCK_COUNT; b++) { cells.push_back((y + offsets[r][b][1] + 4) * W + x + offsets[r][b][0]); }
+				std::sort(cells.begin(), cells.end());
+				if (!seen.insert(cells).second)
+				{
+					continue;
+				}
+				if (depth == 1)
+				{
+					leaves++;
+					continue;
+				}
+				// lock, then drop the complete rows
+				std::vector<int> locked = grid;
+				for (int b = 0; b < BLOCK_COUNT; b++)
+				{
+					int by = y + offsets[r][b][1];
+					if (by >= 0) { locked[by * W + x + offsets[r][b][0]] = 1; }
+				}
+				std::vector<int> child(H * W, 0);
+				int target = H - 1;
+				for (int row = H - 1; row >= 0; row--)
+				{
+					bool complete = std::all_of(locked.begin() + row * W, locked.begin() + (row + 1) * W, [](int cell) { return cell != 0; });
+					if (!complete)
+					{
+						std::copy(locked.begin() + row * W, locked.begin() + (row + 1) * W, child.begin() + target * W);
+						target--;
+					}
+				}
+				leaves += bruteForcePerftFrom(child, sequence, ply + 1, depth - 1);
+			}
+		}
+	}
+	return leaves;
+}
+#endif
+
+#if defined(LOCKSTEPPEER) || defined(GARBAGEEXCHANGE)
+unsigned int TestSuite::findMultiRowClearSeed()
+{
+	LockstepGame scratch;
+	unsigned int seed{ 1 };
+	while (true)
+	{
+		scratch.reset(seed);
+		if (fillForFirstDrop(seed, scratch) >= 2)
+		{
+			return seed;
+		}
+		seed++;
+	}
+}
+
+int TestSuite::fillForFirstDrop(unsigned int seed, LockstepGame& game)
+{
+	LockstepGame probe;
+	probe.reset(seed);
+	probe.step(LockstepGame::INPUT_HARD_DROP);
+	int completed{ 0 };
+	for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+	{
+		bool covered{ false };
+		bool complete{ true };
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			covered = covered || probe.getBoard().getContent(x, y) != Gameboard::EMPTY_BLOCK;
+		}
+		for (int x{ 0 }; covered && x < Gameboard::MAX_X; x++)
+		{
+			if (probe.getBoard().getContent(x, y) != Gameboard::EMPTY_BLOCK)
+			{
+				continue;
+			}
+			// the shape falls through the blocks above its own in a column
+			bool fallsThrough{ false };
+			for (int below{ y + 1 }; below < Gameboard::MAX_Y; below++)
+			{
+				fallsThrough = fallsThrough || probe.getBoard().getContent(x, below) != Gameboard::EMPTY_BLOCK;
+			}
+			if (fallsThrough)
+			{
+				complete = false;
+			}
+			else
+			{
+				game.game.board.setContent(x, y, 0);
+			}
+		}
+		completed += (covered && complete) ? 1 : 0;
+	}
+	return completed;
+}
+#endif
+
 void TestSuite::announceTest(const std::string& className) {
 	std::cout << "Testing " << className << " class...";
 }
@@ -362,6 +712,31 @@ void TestSuite::testGameboardClass()
 	assert(g.getContent(1, 3) == 2 && "Gameboard.removeCompletedRows() unexpected results");	// row 2 copied into row 3
 	assert(g.getContent(1, 4) == Gameboard::EMPTY_BLOCK && "Gameboard.removeCompletedRows() unexpected results");	// row 4 is still empty
 
+	// test removeCompletedRows() with incomplete rows between and above the completed rows
+	g.empty();
+	g.setContent(0, Gameboard::MAX_Y - 4, 4);				// partial row above
+	g.fillRow(Gameboard::MAX_Y - 3, 3);						// completed
+	g.setContent(1, Gameboard::MAX_Y - 2, 2);				// partial row in between
+	g.fillRow(Gameboard::MAX_Y - 1, 1);						// completed
+	assert(g.removeCompletedRows() == 2 && "Gameboard.removeCompletedRows() should return 2");
+	assert(g.getContent(1, Gameboard::MAX_Y - 1) == 2 && "Gameboard.removeCompletedRows() in between row not moved down");
+	assert(g.getContent(0, Gameboard::MAX_Y - 2) == 4 && "Gameboard.removeCompletedRows() upper row not moved down");
+	assert(g.getContent(0, Gameboard::MAX_Y - 1) == Gameboard::EMPTY_BLOCK && "Gameboard.removeCompletedRows() unexpected results");
+	assert(g.getContent(0, Gameboard::MAX_Y - 3) == Gameboard::EMPTY_BLOCK && "Gameboard.removeCompletedRows() unexpected results");
+
+	// test removeCompletedRows() reporting the rows it removed (and what was in them)
+	g.empty();
+	g.fillRow(Gameboard::MAX_Y - 1, 3);
+	g.fillRow(Gameboard::MAX_Y - 3, 5);
+	g.setContent(0, Gameboard::MAX_Y - 2, 1);
+	Gameboard::ClearedRows cleared;
+	assert(g.removeCompletedRows(&cleared) == 2 && cleared.count == 2 && "Gameboard.removeCompletedRows() should report 2 rows");
+	assert(cleared.rows[0] == Gameboard::MAX_Y - 1 && cleared.rows[1] == Gameboard::MAX_Y - 3 &&
+		"Gameboard.removeCompletedRows() reported the wrong rows");
+	assert(cleared.contents[0][Gameboard::MAX_X - 1] == 3 && cleared.contents[1][0] == 5 &&
+		"Gameboard.removeCompletedRows() reported the wrong row contents");
+	assert(g.removeCompletedRows(&cleared) == 0 && cleared.count == 0 && "Gameboard.removeCompletedRows() should report no rows");
+
 
 	// test areLocsEmpty()
 	g.empty();
@@ -431,6 +806,50 @@ void TestSuite::testGameboardClass()
 	std::vector<Point> invalidPoints2{ Point(-5,-5), Point(50,50) };
 	g3.setContent(invalidPoints2, 1);
 
+	// test the dirty cell range
+	int firstCell, lastCell;
+	Gameboard g4;
+	assert(g4.getDirtyCells(firstCell, lastCell) == true && firstCell == 0 &&
+		lastCell == Gameboard::MAX_X * Gameboard::MAX_Y - 1 && "Gameboard.getDirtyCells() a new board should be all dirty");
+	g4.clearDirtyCells();
+	assert(g4.getDirtyCells(firstCell, lastCell) == false && "Gameboard.getDirtyCells() expected no dirty cells");
+	g4.setContent(-1, 3, 1);	// invalid points don't dirty anything
+	assert(g4.getDirtyCells(firstCell, lastCell) == false && "Gameboard.getDirtyCells() expected no dirty cells");
+	g4.setContent(3, 2, 1);
+	g4.setContent(Point(1, 4), 1);
+	assert(g4.getDirtyCells(firstCell, lastCell) == true &&
+		firstCell == 2 * Gameboard::MAX_X + 3 && lastCell == 4 * Gameboard::MAX_X + 1 &&
+		"Gameboard.getDirtyCells() unexpected range after setContent()");
+	g4.clearDirtyCells();
+	assert(g4.removeCompletedRows() == 0 && g4.getDirtyCells(firstCell, lastCell) == false &&
+		"Gameboard.removeCompletedRows() with no completed rows shouldn't dirty anything");
+	g4.fillRow(Gameboard::MAX_Y - 1, 1);
+	g4.clearDirtyCells();
+	assert(g4.removeCompletedRows() == 1 && g4.getDirtyCells(firstCell, lastCell) == true &&
+		firstCell == 0 && lastCell == Gameboard::MAX_X * Gameboard::MAX_Y - 1 &&
+		"Gameboard.getDirtyCells() removing the bottom row should dirty every row above it");
+
+	// copyChangedCells() only dirties the cells that differ
+	Gameboard copy = g4;
+	copy.clearDirtyCells();
+	g4.setContent(5, 7, 3);
+	assert(copy.copyChangedCells(g4) == 1 && copy.getContent(5, 7) == 3 && "Gameboard.copyChangedCells() should copy 1 cell");
+	assert(copy.getDirtyCells(firstCell, lastCell) == true && firstCell == 7 * Gameboard::MAX_X + 5 && lastCell == firstCell &&
+		"Gameboard.copyChangedCells() should only dirty the changed cell");
+
+	// insertGarbageRows() pushes the board up, and fills the bottom rows except for the hole
+	Gameboard g5;
+	g5.setContent(2, Gameboard::MAX_Y - 1, 4);
+	assert(g5.insertGarbageRows(2, 7, 1) == false && "Gameboard.insertGarbageRows() shouldn't top out an empty top");
+	assert(g5.getContent(2, Gameboard::MAX_Y - 3) == 4 && g5.getContent(2, Gameboard::MAX_Y - 1) == 1 &&
+		"Gameboard.insertGarbageRows() should move the board up");
+	assert(g5.getContent(7, Gameboard::MAX_Y - 1) == Gameboard::EMPTY_BLOCK && g5.getContent(7, Gameboard::MAX_Y - 2) == Gameboard::EMPTY_BLOCK &&
+		g5.getContent(6, Gameboard::MAX_Y - 2) == 1 && g5.getContent(7, Gameboard::MAX_Y - 3) == Gameboard::EMPTY_BLOCK &&
+		"Gameboard.insertGarbageRows() should leave the hole in every garbage row");
+	g5.setContent(0, 1, 3);
+	assert(g5.insertGarbageRows(1, 0, 1) == false && g5.getContent(0, 0) == 3 && "Gameboard.insertGarbageRows() shouldn't top out below row 0");
+	assert(g5.insertGarbageRows(1, 0, 1) == true && "Gameboard.insertGarbageRows() should top out when a block is pushed off");
+
 
 	announceTestCompletion();
 #else
@@ -489,5 +908,2279 @@ void TestSuite::testGameboardClass()
 
 
 
+void TestSuite::testPlacementGeneratorClass()
+{
+#ifdef PLACEMENTGENERATOR
+	announceTest("PlacementGenerator");
+
+	PlacementGenerator generator;
+	Gameboard board;
+	std::vector<Placement> placements;
+
+	// the # of distinct placements of each shape on an empty board
+	// (S, Z & I have 2 orientations, O has 1, L, J & T have 4)
+	const int expectedCounts[] = { 17, 17, 34, 34, 9, 17, 34 };
+	for (int shape{ 0 }; shape < static_cast<int>(TetShape::COUNT); shape++)
+	{
+		generator.generate(board, static_cast<TetShape>(shape), placements);
+		assert(placements.size() == expectedCounts[shape] && "PlacementGenerator.generate() unexpected # of placements on an empty board");
+	}
+
+	// every placement rests on the floor of an empty board, and is legal
+	GridTetromino placed;
+	generator.generate(board, TetShape::T, placements);
+	for (const Placement& placement : placements)
+	{
+		PlacementGenerator::placeShape(placed, TetShape::T, placement);
+		assert(generator.isPositionLegal(board, placed) && "PlacementGenerator placement is not legal");
+		placed.move(0, 1);
+		assert(!generator.isPositionLegal(board, placed) && "PlacementGenerator placement is not resting");
+	}
+
+	// lockPlacement() copies the shape's colour into the board
+	generator.generate(board, TetShape::O, placements);
+	generator.lockPlacement(board, TetShape::O, placements[0]);
+	int lockedBlocks{ 0 };
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			if (board.getContent(x, y) == static_cast<int>(TetColor::YELLOW)) { lockedBlocks++; }
+		}
+	}
+	assert(lockedBlocks == 4 && "PlacementGenerator.lockPlacement() should lock 4 blocks");
+
+	// a blocked spawn location has no placements
+	board.empty();
+	board.fillRow(0, 1);
+	board.fillRow(1, 1);
+	generator.generate(board, TetShape::T, placements);
+	assert(placements.empty() && "PlacementGenerator.generate() should find no placements when the spawn is blocked");
+
+	announceTestCompletion();
+#else
+	announceNotTested("PlacementGenerator");
+#endif
+}
+
+
+
+void TestSuite::testHeadlessGameClass()
+{
+#ifdef HEADLESSGAME
+	announceTest("HeadlessGame");
+
+	// the same seed gives the same shape sequence
+	HeadlessGame a;
+	HeadlessGame b;
+	a.reset(1234);
+	b.reset(1234);
+	std::vector<Placement> placements;
+	for (int i = 0; i < 20 && !a.isGameOver(); i++)
+	{
+		assert(a.getCurrentShape().getShape() == b.getCurrentShape().getShape() &&
+			"HeadlessGame with the same seed produced different shapes");
+		a.getPlacements(placements);
+		assert(!placements.empty() && "HeadlessGame.getPlacements() found no placements");
+		a.applyPlacement(placements[0]);
+		b.applyPlacement(placements[0]);
+	}
+	assert(a.getPiecesPlaced() == b.getPiecesPlaced() && "HeadlessGame piece counts differ");
+
+	// stacking everything in the same place eventually ends the game
+	a.reset(99);
+	int safety{ 0 };
+	while (!a.isGameOver() && safety++ < 1000)
+	{
+		a.getPlacements(placements);
+		a.applyPlacement(placements[0]);
+	}
+	assert(a.isGameOver() && "HeadlessGame should end when shapes can no longer spawn");
+	assert(!a.applyPlacement(Placement()) && "HeadlessGame.applyPlacement() should fail once the game is over");
+
+	// reset() starts a fresh game
+	a.reset(99);
+	assert(!a.isGameOver() && a.getScore() == 0 && a.getPiecesPlaced() == 0 && "HeadlessGame.reset() failed");
+
+	announceTestCompletion();
+#else
+	announceNotTested("HeadlessGame");
+#endif
+}
+
+
+
+void TestSuite::testBoardEvaluatorClass()
+{
+#ifdef BOARDEVALUATOR
+	announceTest("BoardEvaluator");
+
+	Gameboard board;
+	double features[EvalWeights::COUNT];
+
+	// an empty board has no height, holes or bumpiness
+	BoardEvaluator::getFeatures(board, 0, features);
+	for (int i = 0; i < EvalWeights::COUNT; i++)
+	{
+		assert(features[i] == 0.0 && "BoardEvaluator.getFeatures() empty board should have no features");
+	}
+
+	// a block 2 rows up with a hole under it
+	board.setContent(0, Gameboard::MAX_Y - 2, 1);
+	BoardEvaluator::getFeatures(board, 1, features);
+	assert(features[static_cast<int>(EvalFeature::AGGREGATE_HEIGHT)] == 2 && "BoardEvaluator.getFeatures() unexpected height");
+	assert(features[static_cast<int>(EvalFeature::HOLES)] == 1 && "BoardEvaluator.getFeatures() unexpected holes");
+	assert(features[static_cast<int>(EvalFeature::BUMPINESS)] == 2 && "BoardEvaluator.getFeatures() unexpected bumpiness");
+	assert(features[static_cast<int>(EvalFeature::COMPLETED_LINES)] == 1 && "BoardEvaluator.getFeatures() unexpected lines");
+
+	// the bot should fill the gap in an almost complete row with an I
+	board.empty();
+	for (int x = 0; x < Gameboard::MAX_X - 1; x++)
+	{
+		board.setContent(x, Gameboard::MAX_Y - 1, 1);
+	}
+	BoardEvaluator evaluator;
+	Placement best;
+	assert(evaluator.choosePlacement(board, TetShape::I, best) && "BoardEvaluator.choosePlacement() found no placement");
+	GridTetromino placed;
+	PlacementGenerator::placeShape(placed, TetShape::I, best);
+	std::vector<Point> locs = placed.getBlockLocsMappedToGrid();
+	bool fillsGap{ false };
+	for (const Point& pt : locs)
+	{
+		if (pt.getX() == Gameboard::MAX_X - 1 && pt.getY() == Gameboard::MAX_Y - 1) { fillsGap = true; }
+	}
+	assert(fillsGap && "BoardEvaluator.choosePlacement() should complete the row");
+
+	announceTestCompletion();
+#else
+	announceNotTested("BoardEvaluator");
+#endif
+}
+
+
+
+void TestSuite::testWeightTunerClass()
+{
+#ifdef WEIGHTTUNER
+	announceTest("WeightTuner");
+
+	TunerSettings settings;
+	settings.populationSize = 4;
+	settings.eliteCount = 1;
+	settings.gamesPerCandidate = 2;
+	settings.maxPiecesPerGame = 30;
+	settings.threadCount = 1;
+	settings.seed = 7;
+	settings.checkpointPath = "tuner_test_checkpoint.txt";
+	std::remove(settings.checkpointPath.c_str());
+
+	auto sameWeights = [](const EvalWeights& a, const EvalWeights& b)
+	{
+		return std::equal(a.values, a.values + EvalWeights::COUNT, b.values);
+	};
+
+	// a checkpoint written after 2 generations...
+	WeightTuner first(settings);
+	first.runGeneration();
+	first.runGeneration();
+	assert(first.saveCheckpoint() && "WeightTuner.saveCheckpoint() failed");
+	assert(first.saveCheckpoint() && "WeightTuner.saveCheckpoint() should replace an existing checkpoint");
+	assert(!std::ifstream(settings.checkpointPath + ".tmp") && "WeightTuner.saveCheckpoint() left its temporary file");
+
+	// ...is read back exactly
+	WeightTuner resumed(settings);
+	assert(resumed.loadCheckpoint() && "WeightTuner.loadCheckpoint() failed");
+	assert(resumed.getGeneration() == 2 && "WeightTuner should resume at the saved generation");
+	assert(resumed.getBestFitness() == first.getBestFitness() && "WeightTuner should resume with the saved best fitness");
+	assert(sameWeights(resumed.getBestWeights(), first.getBestWeights()) && "WeightTuner should resume with the saved best weights");
+	for (int i = 0; i < settings.populationSize; i++)
+	{
+		assert(sameWeights(resumed.population[i], first.population[i]) && "WeightTuner should resume with the saved population");
+	}
+	assert(resumed.randomGenerator == first.randomGenerator && "WeightTuner should resume with the saved random generator");
+
+	// and the resumed run carries on exactly as the first one does
+	first.runGeneration();
+	resumed.runGeneration();
+	assert(resumed.getGeneration() == 3 && "WeightTuner.runGeneration() should count the generation");
+	for (int i = 0; i < settings.populationSize; i++)
+	{
+		assert(sameWeights(resumed.population[i], first.population[i]) && "WeightTuner resumed run bred a different generation");
+	}
+	assert(resumed.getBestFitness() == first.getBestFitness() && "WeightTuner resumed run found a different best fitness");
+
+	std::remove(settings.checkpointPath.c_str());
+
+	announceTestCompletion();
+#else
+	announceNotTested("WeightTuner");
+#endif
+}
+
+
+
+void TestSuite::testPerftClass()
+{
+#ifdef PERFT
+	announceTest("Perft");
+
+	// Every count is checked in, and also checked against bruteForcePerft() (a separate enumerator of
+	// the same rules).  If a change to Gameboard, Tetromino, GridTetromino or PlacementGenerator
+	// breaks them, the set of reachable placements has changed.
+	Perft perft;
+	Gameboard board;
+
+	std::vector<TetShape> tiol = { TetShape::T, TetShape::I, TetShape::O, TetShape::L };
+	assert(perft.count(board, tiol, 1) == 34 && "Perft depth 1 (T) on an empty board should be 34");
+	assert(perft.count(board, tiol, 2) == 578 && "Perft depth 2 (T I) on an empty board should be 578");
+	assert(perft.count(board, tiol, 3) == 5202 && "Perft depth 3 (T I O) on an empty board should be 5202");
+	assert(perft.getNodes() == 5814 && "Perft depth 3 (T I O) should visit 5814 nodes");
+
+	// the benchmark sequence (see Perft::runBenchmark() for the deeper counts)
+	std::vector<TetShape> all = { TetShape::S, TetShape::Z, TetShape::L, TetShape::J, TetShape::O, TetShape::I, TetShape::T };
+	assert(perft.count(board, all, 3) == 9826 && "Perft depth 3 (S Z L) on an empty board should be 9826");
+	assert(bruteForcePerft(board, tiol, 3) == 5202 && bruteForcePerft(board, all, 3) == 9826 &&
+		"Perft brute force enumerator disagrees on an empty board");
+
+	// a partly filled board
+	for (int x = 0; x < Gameboard::MAX_X - 1; x++) { board.setContent(x, Gameboard::MAX_Y - 1, 1); }
+	for (int x = 1; x < Gameboard::MAX_X; x++) { board.setContent(x, Gameboard::MAX_Y - 2, 2); }
+	board.setContent(4, Gameboard::MAX_Y - 3, 3);
+	std::vector<TetShape> isz = { TetShape::I, TetShape::S, TetShape::Z };
+	assert(perft.count(board, isz, 3) == 4913 && "Perft depth 3 (I S Z) on a partly filled board should be 4913");
+	assert(bruteForcePerft(board, isz, 3) == 4913 && "Perft brute force enumerator disagrees on a partly filled board");
+
+	// the parallel count should match
+	unsigned long long parallelNodes{ 0 };
+	assert(Perft::countParallel(board, isz, 3, 2, &parallelNodes) == 4913 && "Perft.countParallel() does not match count()");
+	assert(parallelNodes == perft.getNodes() && "Perft.countParallel() node count does not match count()");
+
+	// The counts above are all products of the per-shape slide counts, so none of them depend on one
+	// placement blocking the next.  This pocket does: a full height wall in column 2 and a stack up to
+	// row 3 leave columns 3-9, rows 0-2 open (columns 0-1 stay empty, so no row is complete).
+	// Counted by hand:
+	//  - I: 7 columns standing up + 4 lying down = 11,
+	//  - O: 6 (columns 3-4 ... 8-9),
+	//  - O then O: an O over column 5 or 6 blocks the spawn (0), one at 3-4 stops the next sliding left
+	//    (5-6 ... 8-9 = 4), 7-8 stops it sliding right (3-4 ... 5-6 = 3), 8-9 leaves 3-4 ... 6-7 (4) = 11.
+	Gameboard pocket;
+	for (int y = 0; y < Gameboard::MAX_Y; y++) { pocket.setContent(2, y, 1); }
+	for (int y = 3; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 3; x < Gameboard::MAX_X; x++) { pocket.setContent(x, y, 2); }
+	}
+	std::vector<TetShape> i = { TetShape::I };
+	std::vector<TetShape> o = { TetShape::O };
+	assert(perft.count(pocket, i, 1) == 11 && "Perft depth 1 (I) in the pocket should be 11");
+	assert(perft.count(pocket, o, 1) == 6 && "Perft depth 1 (O) in the pocket should be 6");
+	assert(perft.count(pocket, o, 2) == 11 && "Perft depth 2 (O O) in the pocket should be 11 (placements block the spawn and slides)");
+	assert(perft.getNodes() == 17 && "Perft depth 2 (O O) in the pocket should visit 17 nodes");
+	assert(Perft::countParallel(pocket, o, 2, 2, &parallelNodes) == 11 && "Perft.countParallel() does not match count() in the pocket");
+	assert(parallelNodes == 17 && "Perft.countParallel() node count does not match count() in the pocket");
+	assert(bruteForcePerft(pocket, i, 1) == 11 && bruteForcePerft(pocket, o, 2) == 11 &&
+		"Perft brute force enumerator disagrees in the pocket");
+
+	// a high stack (rows 5 down) with a well in the right column, an overhang over columns 3-4
+	// (the gap under it can't be reached) and a bump in column 7: the shapes land near the spawn
+	// row, so they cut off each other's slides and rotations, and an I in the well clears rows
+	Gameboard stack;
+	for (int y = 5; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X - 1; x++) { stack.setContent(x, y, 1); }
+	}
+	for (int x = 3; x <= 4; x++)
+	{
+		stack.setContent(x, 5, Gameboard::EMPTY_BLOCK);
+		stack.setContent(x, 4, 2);
+	}
+	stack.setContent(7, 4, 2);
+	stack.setContent(7, 3, 2);
+	std::vector<TetShape> tsl = { TetShape::T, TetShape::S, TetShape::L };
+	std::vector<TetShape> ioz = { TetShape::I, TetShape::O, TetShape::Z };
+	std::vector<TetShape> jit = { TetShape::J, TetShape::I, TetShape::T };
+	assert(perft.count(stack, tsl, 2) == 482 && "Perft depth 2 (T S) on a high stack should be 482");
+	assert(perft.count(stack, tsl, 3) == 9885 && "Perft depth 3 (T S L) on a high stack should be 9885");
+	assert(perft.getNodes() == 10401 && "Perft depth 3 (T S L) on a high stack should visit 10401 nodes");
+	assert(perft.count(stack, ioz, 3) == 1308 && "Perft depth 3 (I O Z) on a high stack should be 1308");
+	assert(perft.count(stack, jit, 3) == 8068 && "Perft depth 3 (J I T) on a high stack should be 8068");
+	assert(bruteForcePerft(stack, tsl, 3) == 9885 && bruteForcePerft(stack, ioz, 3) == 1308 && bruteForcePerft(stack, jit, 3) == 8068 &&
+		"Perft brute force enumerator disagrees on a high stack");
+	assert(Perft::countParallel(stack, jit, 3, 2, &parallelNodes) == 8068 && "Perft.countParallel() does not match count() on a high stack");
+
+	announceTestCompletion();
+#else
+	announceNotTested("Perft");
+#endif
+}
+
+
+
+void TestSuite::testHintWorkerClass()
+{
+#ifdef HINTWORKER
+	announceTest("HintWorker");
+
+	HintWorker worker;
+	Placement hint;
+	assert(!worker.tryGetHint(1, hint) && "HintWorker.tryGetHint() should have no hint before a request");
+
+	// the worker should fill the gap in an almost complete row with an I
+	Gameboard board;
+	for (int x = 0; x < Gameboard::MAX_X - 1; x++)
+	{
+		board.setContent(x, Gameboard::MAX_Y - 1, 1);
+	}
+	worker.requestHint(board, TetShape::I, 1);
+	bool ready{ false };
+	for (int i = 0; i < 2000 && !ready; i++)		// wait up to ~2 seconds
+	{
+		ready = worker.tryGetHint(1, hint);
+		if (!ready) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+	}
+	assert(ready && "HintWorker did not publish a hint");
+	BoardEvaluator evaluator;
+	Placement expected;
+	evaluator.choosePlacement(board, TetShape::I, expected);
+	assert(hint.rotations == expected.rotations && hint.x == expected.x && hint.y == expected.y &&
+		"HintWorker hint does not match BoardEvaluator.choosePlacement()");
+
+	// a hint for another shape (serial) is stale
+	assert(!worker.tryGetHint(2, hint) && "HintWorker.tryGetHint() returned a stale hint");
+
+	announceTestCompletion();
+#else
+	announceNotTested("HintWorker");
+#endif
+}
+
+
+
+void TestSuite::testRolloutEvaluatorClass()
+{
+#ifdef ROLLOUTEVALUATOR
+	announceTest("RolloutEvaluator");
+
+	RolloutSettings settings;
+	settings.rolloutsPerPlacement = 8;
+	settings.rolloutDepth = 2;
+	settings.threadCount = 3;
+
+	// an almost complete bottom row, missing the rightmost block
+	Gameboard board;
+	for (int x = 0; x < Gameboard::MAX_X - 1; x++)
+	{
+		board.setContent(x, Gameboard::MAX_Y - 1, 1);
+	}
+
+	// the same seed gives the same score, however many threads run the rollouts
+	RolloutEvaluator evaluator(settings);
+	settings.threadCount = 1;
+	RolloutEvaluator singleThreaded(settings);
+	std::vector<Placement> placements;
+	PlacementGenerator generator;
+	generator.generate(board, TetShape::I, placements);
+	double score = evaluator.evaluatePlacement(board, TetShape::I, placements[0]);
+	assert(score == singleThreaded.evaluatePlacement(board, TetShape::I, placements[0]) &&
+		"RolloutEvaluator scores should not depend on the # of threads");
+	assert(evaluator.getLastRolloutCount() == settings.rolloutsPerPlacement && "RolloutEvaluator unexpected rollout count");
+
+	// the rollouts should still fill the gap with an I
+	Placement best;
+	assert(evaluator.choosePlacement(board, TetShape::I, best) && "RolloutEvaluator.choosePlacement() found no placement");
+	GridTetromino placed;
+	PlacementGenerator::placeShape(placed, TetShape::I, best);
+	bool fillsGap{ false };
+	for (const Point& pt : placed.getBlockLocsMappedToGrid())
+	{
+		if (pt.getX() == Gameboard::MAX_X - 1 && pt.getY() == Gameboard::MAX_Y - 1) { fillsGap = true; }
+	}
+	assert(fillsGap && "RolloutEvaluator.choosePlacement() should complete the row");
+
+	// the rate cap (with the refill frozen, so the counts don't depend on the clock):
+	// a budget of 10 allows 8 rollouts, then only the 2 that are left
+	evaluator.setMaxRolloutsPerSecond(10.0);
+	evaluator.refillFrozen = true;
+	evaluator.rolloutBudget = 10.0;
+	evaluator.evaluatePlacement(board, TetShape::I, placements[0]);
+	assert(evaluator.getLastRolloutCount() == 8 && "RolloutEvaluator should run K rollouts within budget");
+	evaluator.evaluatePlacement(board, TetShape::I, placements[0]);
+	assert(evaluator.getLastRolloutCount() == 2 && "RolloutEvaluator should run only what is left once over budget");
+
+	// choosePlacement() splits one budget evenly across its candidates, or goes static for all of them
+	int candidates = static_cast<int>(placements.size());
+	evaluator.setMaxRolloutsPerSecond(1000.0);
+	evaluator.rolloutBudget = candidates * 3 + 1;
+	evaluator.choosePlacement(board, TetShape::I, best);
+	assert(evaluator.getLastRolloutCount() == 3 && evaluator.rolloutBudget == 1.0 &&
+		"RolloutEvaluator.choosePlacement() should split its budget evenly");
+	evaluator.rolloutBudget = candidates - 1;
+	evaluator.choosePlacement(board, TetShape::I, best);
+	assert(evaluator.getLastRolloutCount() == 0 && evaluator.rolloutBudget == candidates - 1 &&
+		"RolloutEvaluator.choosePlacement() should score every candidate statically when short");
+	evaluator.refillFrozen = false;
+
+	// every candidate of a decision is played out on the same shape sequences
+	double first = evaluator.scorePlacement(board, TetShape::I, placements[1], 4);
+	evaluator.scorePlacement(board, TetShape::I, placements[0], 4);
+	assert(first == evaluator.scorePlacement(board, TetShape::I, placements[1], 4) && "RolloutEvaluator rollouts should reuse the decision's seeds");
+
+	announceTestCompletion();
+#else
+	announceNotTested("RolloutEvaluator");
+#endif
+}
+
+
+
+void TestSuite::testFinesseAnalyzerClass()
+{
+#ifdef FINESSEANALYZER
+	announceTest("FinesseAnalyzer");
+
+	FinesseAnalyzer finesse;
+	Gameboard board;
+	std::vector<FinesseInput> inputs;
+	Placement placement;
+
+	// straight down from spawn: just a hard drop
+	placement.rotations = 0;
+	placement.x = board.getSpawnLoc().getX();
+	placement.y = Gameboard::MAX_Y - 1;
+	assert(finesse.findInputs(board, TetShape::T, placement, inputs) && "FinesseAnalyzer.findInputs() failed");
+	assert(inputs.size() == 1 && inputs[0] == FinesseInput::HARD_DROP && "FinesseAnalyzer expected a single hard drop");
+
+	// against the left wall: DAS left, hard drop
+	placement.x = 1;
+	assert(finesse.findInputs(board, TetShape::T, placement, inputs) && "FinesseAnalyzer.findInputs() failed");
+	assert(inputs.size() == 2 && inputs[0] == FinesseInput::DAS_LEFT && "FinesseAnalyzer expected DAS left, hard drop");
+
+	// one column right, rotated once: 3 inputs
+	placement.rotations = 1;
+	placement.x = board.getSpawnLoc().getX() + 1;
+	placement.y = Gameboard::MAX_Y - 2;
+	assert(finesse.getMinimalInputCount(board, TetShape::T, placement) == 3 && "FinesseAnalyzer expected 3 inputs");
+
+	// every placement from the PlacementGenerator is reachable (an empty board has no overhangs)
+	PlacementGenerator generator;
+	std::vector<Placement> placements;
+	for (int shape = 0; shape < static_cast<int>(TetShape::COUNT); shape++)
+	{
+		generator.generate(board, static_cast<TetShape>(shape), placements);
+		for (const Placement& p : placements)
+		{
+			assert(finesse.getMinimalInputCount(board, static_cast<TetShape>(shape), p) > 0 &&
+				"FinesseAnalyzer could not reach a placement");
+		}
+	}
+	assert(finesse.getCacheSize() == static_cast<size_t>(TetShape::COUNT) && "FinesseAnalyzer should cache one search per shape");
+
+	// a hole below the surface doesn't change the cache key
+	board.setContent(0, Gameboard::MAX_Y - 2, 1);
+	unsigned long long surfaceKey = FinesseAnalyzer::getSurfaceKey(board, TetShape::T);
+	board.setContent(0, Gameboard::MAX_Y - 1, 1);
+	assert(surfaceKey == FinesseAnalyzer::getSurfaceKey(board, TetShape::T) && "FinesseAnalyzer surface key should ignore holes");
+
+	// a placement that isn't reachable
+	placement.rotations = 0;
+	placement.x = 5;
+	placement.y = 5;	// floating in mid air
+	assert(!finesse.findInputs(board, TetShape::T, placement, inputs) && "FinesseAnalyzer found a path to a floating placement");
+
+	// the cache is bounded: two surfaces that share a slot replace each other (there are more
+	// surfaces of the 3 left columns than slots, so two of them must share one)
+	finesse.clearCache();
+	assert(finesse.getCacheSize() == 0 && "FinesseAnalyzer.clearCache() should empty the cache");
+	std::vector<int> slotSurfaces(FinesseAnalyzer::CACHE_SLOTS, -1);
+	int surfaces[2]{ -1, -1 };
+	for (int surface = 0; surface < 11 * 11 * 11 && surfaces[1] < 0; surface++)
+	{
+		Gameboard stack;
+		for (int x = 0; x < 3; x++)
+		{
+			int height = surface / (x == 0 ? 1 : x == 1 ? 11 : 121) % 11;
+			for (int y = Gameboard::MAX_Y - height; y < Gameboard::MAX_Y; y++) { stack.setContent(x, y, 1); }
+		}
+		int slot = FinesseAnalyzer::getCacheSlot(FinesseAnalyzer::getSurfaceKey(stack, TetShape::T));
+		if (slotSurfaces[slot] >= 0)
+		{
+			surfaces[0] = slotSurfaces[slot];
+			surfaces[1] = surface;
+		}
+		slotSurfaces[slot] = surface;
+	}
+	assert(surfaces[1] >= 0 && "FinesseAnalyzer has more cache slots than surfaces tested");
+	Gameboard stacks[2];
+	for (int i = 0; i < 2; i++)
+	{
+		for (int x = 0; x < 3; x++)
+		{
+			int height = surfaces[i] / (x == 0 ? 1 : x == 1 ? 11 : 121) % 11;
+			for (int y = Gameboard::MAX_Y - height; y < Gameboard::MAX_Y; y++) { stacks[i].setContent(x, y, 1); }
+		}
+	}
+	placement.rotations = 0;
+	placement.x = board.getSpawnLoc().getX();
+	placement.y = Gameboard::MAX_Y - 1;
+	for (int round = 0; round < 2; round++)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			assert(finesse.findInputs(stacks[i], TetShape::T, placement, inputs) && inputs.size() == 1 &&
+				"FinesseAnalyzer gave the wrong inputs after a cache slot was replaced");
+			assert(finesse.getCacheSize() == 1 && "FinesseAnalyzer should keep one search per cache slot");
+		}
+	}
+
+	announceTestCompletion();
+#else
+	announceNotTested("FinesseAnalyzer");
+#endif
+}
+
 
 
+void TestSuite::testBoardRasterizerClass()
+{
+#ifdef BOARDRASTERIZER
+	announceTest("BoardRasterizer");
+
+	// a synthetic 2x2 pixel atlas: tile n is colour (n * 10, 100 + n, 200), with one odd pixel
+	// in its bottom right corner, so copying the wrong part of a tile is caught
+	const int BLOCK_SIZE{ 2 };
+	const int TILE_COUNT{ 7 };
+	const Rgba background{ 1, 2, 3, 255 };
+	RgbaImage tiles(TILE_COUNT * BLOCK_SIZE, BLOCK_SIZE, background);
+	for (int tile = 0; tile < TILE_COUNT; tile++)
+	{
+		Rgba colour{ static_cast<unsigned char>(tile * 10), static_cast<unsigned char>(100 + tile), 200, 255 };
+		for (int y = 0; y < BLOCK_SIZE; y++)
+		{
+			for (int x = 0; x < BLOCK_SIZE; x++)
+			{
+				tiles.setPixel(tile * BLOCK_SIZE + x, y, colour);
+			}
+		}
+		tiles.setPixel(tile * BLOCK_SIZE + 1, 1, Rgba{ 255, 255, static_cast<unsigned char>(tile), 255 });
+	}
+	BoardRasterizer rasterizer(tiles, BLOCK_SIZE, BLOCK_SIZE, background);
+
+	// an empty board is all background
+	Gameboard board;
+	RgbaImage empty;
+	rasterizer.drawGameboard(board, empty);
+	assert(empty.getWidth() == Gameboard::MAX_X * BLOCK_SIZE && empty.getHeight() == Gameboard::MAX_Y * BLOCK_SIZE &&
+		"BoardRasterizer.drawGameboard() unexpected image size");
+	assert(empty.countDifferentPixels(RgbaImage(empty.getWidth(), empty.getHeight(), background)) == 0 &&
+		"BoardRasterizer.drawGameboard() an empty board should be all background");
+
+	// one block: exactly its 4 pixels change, copied from its tile
+	board.setContent(2, 3, static_cast<int>(TetColor::BLUE_LIGHT));
+	RgbaImage image;
+	rasterizer.drawGameboard(board, image);
+	assert(image.countDifferentPixels(empty) == 4 && "BoardRasterizer.drawGameboard() should change 4 pixels");
+	assert(image.getPixel(4, 6) == (Rgba{ 40, 104, 200, 255 }) && "BoardRasterizer.drawGameboard() wrong tile pixel");
+	assert(image.getPixel(5, 7) == (Rgba{ 255, 255, 4, 255 }) && "BoardRasterizer.drawGameboard() wrong tile pixel");
+	assert(image.getPixel(3, 6) == background && image.getPixel(6, 6) == background &&
+		"BoardRasterizer.drawGameboard() drew outside the block");
+
+	// the same input always renders the same image (golden image comparison)
+	RgbaImage again;
+	rasterizer.drawGameboard(board, again);
+	assert(image.countDifferentPixels(again) == 0 && "BoardRasterizer should be deterministic");
+
+	// a half transparent tetromino blends over the background (integer maths: exact values)
+	GridTetromino shape;
+	shape.setShape(TetShape::O);
+	shape.setGridLoc(0, 10);
+	rasterizer.drawTetromino(shape, image, 128);
+	std::vector<Point> blocks = shape.getBlockLocsMappedToGrid();
+	Rgba tile = tiles.getPixel(static_cast<int>(shape.getColor()) * BLOCK_SIZE, 0);
+	Rgba blended = image.getPixel(blocks[0].getX() * BLOCK_SIZE, blocks[0].getY() * BLOCK_SIZE);
+	assert(blended.r == (tile.r * 128 + background.r * 127) / 255 && blended.g == (tile.g * 128 + background.g * 127) / 255 &&
+		blended.b == (tile.b * 128 + background.b * 127) / 255 && "BoardRasterizer.drawTetromino() unexpected blend");
+	assert(image.countDifferentPixels(again) == 16 && "BoardRasterizer.drawTetromino() should change 4 blocks");
+
+	// blocks above the board are clipped
+	shape.setGridLoc(4, -2);
+	RgbaImage clipped = again;
+	rasterizer.drawTetromino(shape, clipped);
+	assert(clipped.countDifferentPixels(again) < 16 && "BoardRasterizer.drawTetromino() should clip blocks above the board");
+
+	// PPM: the header, then 3 bytes per pixel
+	const std::string ppmPath{ "rasterizer_test.ppm" };
+	assert(image.writePpm(ppmPath) && "RgbaImage.writePpm() failed");
+	std::ifstream ppm(ppmPath, std::ios::binary);
+	std::string ppmData((std::istreambuf_iterator<char>(ppm)), std::istreambuf_iterator<char>());
+	ppm.close();
+	std::string ppmHeader = "P6\n" + std::to_string(image.getWidth()) + " " + std::to_string(image.getHeight()) + "\n255\n";
+	assert(ppmData.compare(0, ppmHeader.size(), ppmHeader) == 0 && "RgbaImage.writePpm() wrong header");
+	assert(ppmData.size() == ppmHeader.size() + image.getWidth() * image.getHeight() * 3 && "RgbaImage.writePpm() wrong size");
+	assert(static_cast<unsigned char>(ppmData[ppmHeader.size() + (6 * image.getWidth() + 4) * 3]) == 40 &&
+		"RgbaImage.writePpm() wrong pixel");
+	std::remove(ppmPath.c_str());
+
+	// PNG: the signature, the known CRC of IEND, and the standard CRC check value
+	const std::string pngPath{ "rasterizer_test.png" };
+	assert(image.writePng(pngPath) && "RgbaImage.writePng() failed");
+	std::ifstream png(pngPath, std::ios::binary);
+	std::string pngData((std::istreambuf_iterator<char>(png)), std::istreambuf_iterator<char>());
+	png.close();
+	assert(pngData.compare(0, 8, "\x89PNG\r\n\x1A\n") == 0 && "RgbaImage.writePng() wrong signature");
+	assert(pngData.compare(pngData.size() - 8, 8, std::string("IEND\xAE\x42\x60\x82", 8)) == 0 &&
+		"RgbaImage.writePng() wrong IEND chunk");
+	assert(RgbaImage::crc32(reinterpret_cast<const unsigned char*>("123456789"), 9) == 0xCBF43926 && "RgbaImage.crc32() wrong value");
+	std::remove(pngPath.c_str());
+
+	announceTestCompletion();
+#else
+	announceNotTested("BoardRasterizer");
+#endif
+}
+
+
+
+void TestSuite::testFrameProfilerClass()
+{
+#ifdef FRAMEPROFILER
+	announceTest("FrameProfiler");
+
+	FrameProfiler profiler;
+	assert(profiler.getStats().frameCount == 0 && "FrameProfiler should start empty");
+
+	// frames of 1ms to 100ms: nearest rank percentiles
+	for (int ms = 1; ms <= 100; ms++)
+	{
+		double phases[FrameProfiler::PHASE_COUNT]{ 0.001, 0.002, 0.003, 0.004 };
+		profiler.recordFrame(ms / 1000.0, phases);
+	}
+	FrameStats stats = profiler.getStats();
+	assert(stats.frameCount == 100 && "FrameProfiler.getStats() wrong frame count");
+	assert(stats.p50 == 0.050 && stats.p99 == 0.099 && stats.max == 0.100 && "FrameProfiler.getStats() wrong percentiles");
+	assert(std::abs(stats.phaseMean[static_cast<int>(FramePhase::DRAW)] - 0.003) < 1e-9 && "FrameProfiler.getStats() wrong phase mean");
+	assert(profiler.getFrameSeconds(0) == 0.100 && profiler.getFrameSeconds(99) == 0.001 &&
+		"FrameProfiler.getFrameSeconds() wrong order");
+
+	// the ring buffer keeps only the last HISTORY frames
+	for (int frame = 0; frame < FrameProfiler::HISTORY; frame++)
+	{
+		profiler.recordFrame(0.010);
+	}
+	stats = profiler.getStats();
+	assert(stats.frameCount == FrameProfiler::HISTORY && stats.max == 0.010 && "FrameProfiler should forget old frames");
+
+	// scoped timers add to the current frame's phases
+	profiler.clear();
+	profiler.beginFrame();
+	{
+		FrameProfiler::ScopedTimer timer(profiler, FramePhase::SIMULATION);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+	profiler.endFrame();
+	stats = profiler.getStats();
+	assert(stats.frameCount == 1 && "FrameProfiler.endFrame() should record a frame");
+	assert(stats.phaseMean[static_cast<int>(FramePhase::SIMULATION)] >= 0.002 &&
+		stats.phaseMean[static_cast<int>(FramePhase::INPUT)] == 0.0 && "FrameProfiler.ScopedTimer wrong phase time");
+	assert(stats.max >= stats.phaseMean[static_cast<int>(FramePhase::SIMULATION)] && "FrameProfiler frame shorter than its phase");
+	profiler.endFrame();	// no frame started: ignored
+	assert(profiler.getFrameCount() == 1 && "FrameProfiler.endFrame() without beginFrame() should be ignored");
+
+	announceTestCompletion();
+#else
+	announceNotTested("FrameProfiler");
+#endif
+}
+
+
+
+void TestSuite::testFramePacerClass()
+{
+#ifdef FRAMEPACER
+	announceTest("FramePacer");
+
+	// fixed simulation steps: the remainder carries over to the next frame
+	FramePacer pacer(100.0);
+	assert(pacer.takeSimulationSteps(FramePacer::SIMULATION_STEP * 2.5) == 2 && "FramePacer expected 2 steps");
+	assert(pacer.takeSimulationSteps(FramePacer::SIMULATION_STEP * 0.6) == 1 && "FramePacer expected the remainder to carry over");
+	assert(pacer.takeSimulationSteps(10.0) == FramePacer::MAX_SIMULATION_STEPS && "FramePacer should cap the steps after a stall");
+	assert(pacer.takeSimulationSteps(FramePacer::SIMULATION_STEP * 0.5) == 0 && "FramePacer should drop the time past the cap");
+	pacer.resetSimulationTime();
+	assert(pacer.takeSimulationSteps(FramePacer::SIMULATION_STEP * 0.6) == 0 && "FramePacer.resetSimulationTime() failed");
+
+	// interval stats: mean, standard deviation and max
+	pacer.recordInterval(0.010);
+	pacer.recordInterval(0.020);
+	pacer.recordInterval(0.030);
+	PacingStats stats = pacer.getStats();
+	assert(stats.frameCount == 3 && std::abs(stats.mean - 0.020) < 1e-12 && std::abs(stats.jitter - 0.010) < 1e-12 &&
+		stats.max == 0.030 && "FramePacer.getStats() unexpected results");
+	pacer.setMode(PacingMode::UNCAPPED);
+	assert(pacer.getStats().frameCount == 0 && "FramePacer.setMode() should reset the stats");
+	assert(!pacer.shouldWaitWhenPaused() && "FramePacer only the idle mode waits when paused");
+
+	// the limiter never starts a frame early: 10 frames at 100 fps take at least 100ms
+	pacer.setMode(PacingMode::LIMITED);
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame <= 10; frame++)
+	{
+		pacer.waitForNextFrame();
+		pacer.markFrame();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	assert(seconds >= 0.100 && "FramePacer limited frames ran early");
+	assert(pacer.getStats().frameCount == 10 && pacer.getStats().mean >= 0.0099 && "FramePacer limited frame interval too short");
+
+	// the sleep margin rises with oversleeps (at most half a frame), and decays back to the floor
+	FramePacer coarse(60.0);
+	for (int sleep = 0; sleep < 50; sleep++)
+	{
+		coarse.adjustSpin(0.0156);
+	}
+	assert(coarse.spinSeconds > 0.008 && coarse.spinSeconds <= 0.5 / 60.0 + 1e-12 && "FramePacer should spin longer after oversleeps");
+	for (int sleep = 0; sleep < 100; sleep++)
+	{
+		coarse.adjustSpin(0.0);
+	}
+	assert(coarse.spinSeconds == FramePacer::MIN_SPIN_SECONDS && "FramePacer sleep margin should decay to the floor");
+
+	announceTestCompletion();
+#else
+	announceNotTested("FramePacer");
+#endif
+}
+
+
+
+void TestSuite::testTerminalRendererClass()
+{
+#ifdef TERMINALRENDERER
+	announceTest("TerminalRenderer");
+
+	TerminalRenderer renderer(30, 22);
+	Gameboard board;
+
+	// the first frame clears the screen and sends every non-blank cell
+	renderer.clear();
+	renderer.drawGameboard(board, 0, 0);
+	std::string first = renderer.present();
+	assert(first.compare(0, 4, "\x1b[0m") == 0 && first.find("\x1b[2J") != std::string::npos &&
+		"TerminalRenderer first frame should clear the screen");
+
+	// an unchanged frame sends nothing
+	renderer.clear();
+	renderer.drawGameboard(board, 0, 0);
+	assert(renderer.present().empty() && "TerminalRenderer an unchanged frame should send nothing");
+
+	// one block: one cursor move, one colour change, 2 characters
+	board.setContent(3, 5, static_cast<int>(TetColor::RED));
+	renderer.clear();
+	renderer.drawGameboard(board, 0, 0);
+	std::string diff = renderer.present();
+	assert(diff == "\x1b[6;8H\x1b[48;5;196m  " && "TerminalRenderer unexpected diff for one block");
+
+	// the block next to it: the cursor and the colours are already right
+	board.setContent(4, 5, static_cast<int>(TetColor::RED));
+	renderer.clear();
+	renderer.drawGameboard(board, 0, 0);
+	assert(renderer.present() == "  " && "TerminalRenderer should skip cursor moves and colours that are already set");
+
+	// text in default colours resets the pen
+	renderer.drawText(25, 0, "hi");
+	assert(renderer.present() == "\x1b[1;26H\x1b[0mhi" && "TerminalRenderer unexpected diff for text");
+
+	// cells outside the frame are ignored, and invalidate() forces a full redraw
+	renderer.setCell(-1, 0, 'x', 1, 1);
+	renderer.setCell(30, 22, 'x', 1, 1);
+	assert(renderer.present().empty() && "TerminalRenderer cells outside the frame should be ignored");
+	renderer.invalidate();
+	assert(renderer.present().size() > first.size() / 2 && "TerminalRenderer.invalidate() should redraw everything");
+
+	announceTestCompletion();
+#else
+	announceNotTested("TerminalRenderer");
+#endif
+}
+
+
+
+void TestSuite::testTerminalGameClass()
+{
+#ifdef TERMINALGAME
+	announceTest("TerminalGame");
+
+	TerminalGame game(1);
+	Point spawn = game.getFallingShape().getGridLoc();
+
+	// moves and rotations
+	assert(game.attemptMove(1, 0) && game.getFallingShape().getGridLoc().getX() == spawn.getX() + 1 &&
+		"TerminalGame.attemptMove() failed");
+	assert(game.attemptRotate() && game.fallingRotations == 1 && "TerminalGame.attemptRotate() failed");
+	while (game.attemptMove(-1, 0)) {};
+	assert(!game.attemptMove(-1, 0) && "TerminalGame.attemptMove() moved through the wall");
+
+	// dropping locks the shape where it fell (4 blocks on the board) and spawns the next shape
+	TetShape next = game.game.getNextShape().getShape();
+	game.drop();
+	int blocks = 0;
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			blocks += game.getBoard().getContent(x, y) != Gameboard::EMPTY_BLOCK ? 1 : 0;
+		}
+	}
+	assert(blocks == 4 && "TerminalGame.drop() should lock 4 blocks");
+	assert(game.getFallingShape().getShape() == next && game.getFallingShape().getGridLoc().getY() == spawn.getY() &&
+		"TerminalGame.drop() should spawn the next shape");
+
+	// ticks: the shape falls a row every SECONDS_PER_TICK
+	game.update(TerminalGame::SECONDS_PER_TICK);
+	assert(game.getFallingShape().getGridLoc().getY() == spawn.getY() + 1 && "TerminalGame.update() should tick");
+
+	// the bot clears lines and keeps playing by itself
+	TerminalRenderer renderer(50, 22);
+	game.reset(7);
+	game.setBot(true);
+	for (int frame = 0; frame < 60 * 60 && game.getScore() == 0; frame++)
+	{
+		game.update(1.0 / 60.0);
+		game.draw(renderer);
+	}
+	assert(game.getScore() > 0 && game.getGamesPlayed() == 0 && "TerminalGame bot should clear a line within a minute");
+
+	announceTestCompletion();
+#else
+	announceNotTested("TerminalGame");
+#endif
+}
+
+
+
+void TestSuite::testTerminalInputClass()
+{
+#ifdef TERMINALINPUT
+	announceTest("TerminalInput");
+
+	// bytes are fed in directly, with made up times, so the terminal isn't read
+	TerminalInput input;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	auto at = [start](int ms) { return start + std::chrono::milliseconds(ms); };
+	const unsigned char escape[] = { 27 };
+	const unsigned char bracket[] = { '[' };
+	const unsigned char left[] = { 'D' };
+
+	// an arrow key split across reads
+	assert(input.addBytes(escape, 1, at(0)) == 1 && "TerminalInput.addBytes() should take the ESC");
+	assert(input.takeKey(at(0)) == TerminalKey::NONE && "TerminalInput shouldn't take a lone ESC straight away");
+	input.addBytes(bracket, 1, at(10));
+	assert(input.takeKey(at(10)) == TerminalKey::NONE && "TerminalInput shouldn't take ESC [ straight away");
+	input.addBytes(left, 1, at(20));
+	assert(input.takeKey(at(20)) == TerminalKey::LEFT && "TerminalInput should join ESC [ D across reads");
+	assert(input.takeKey(at(20)) == TerminalKey::NONE && "TerminalInput should have nothing left");
+
+	// a lone escape is a quit once the rest of a sequence hasn't come
+	input.addBytes(escape, 1, at(100));
+	int waitMs = static_cast<int>(TerminalInput::ESCAPE_SECONDS * 1000.0);
+	assert(input.takeKey(at(100 + waitMs / 2)) == TerminalKey::NONE && "TerminalInput took a lone ESC too soon");
+	assert(input.takeKey(at(100 + waitMs + 1)) == TerminalKey::QUIT && "TerminalInput should take a lone ESC as QUIT");
+
+	// an escape followed by another key, and keys after a sequence in the same read
+	const unsigned char escapeThenA[] = { 27, 'a' };
+	input.addBytes(escapeThenA, 2, at(200));
+	assert(input.takeKey(at(200)) == TerminalKey::QUIT && "TerminalInput should take ESC a as QUIT");
+	assert(input.takeKey(at(200)) == TerminalKey::LEFT && "TerminalInput should keep the a after ESC");
+	const unsigned char rightThenSpace[] = { 27, '[', 'C', ' ' };
+	assert(input.addBytes(rightThenSpace, 4, at(300)) == 3 && "TerminalInput should only take a whole sequence's worth");
+	assert(input.takeKey(at(300)) == TerminalKey::RIGHT && "TerminalInput should read ESC [ C as RIGHT");
+	input.addBytes(rightThenSpace + 3, 1, at(300));
+	assert(input.takeKey(at(300)) == TerminalKey::SPACE && "TerminalInput should read the space after the sequence");
+
+	// Ctrl-C is read as a key (raw mode turns signals off)
+	const unsigned char ctrlC[] = { 3 };
+	input.addBytes(ctrlC, 1, at(400));
+	assert(input.takeKey(at(400)) == TerminalKey::QUIT && "TerminalInput should read Ctrl-C as QUIT");
+
+	announceTestCompletion();
+#else
+	announceNotTested("TerminalInput");
+#endif
+}
+
+
+
+void TestSuite::testSpscQueueClass()
+{
+#ifdef SPSCQUEUE
+	announceTest("SpscQueue");
+
+	// single thread: first in, first out, and a full queue refuses items
+	SpscQueue<int, 4> small;
+	int item{ -1 };
+	assert(!small.pop(item) && "SpscQueue.pop() should fail when empty");
+	for (int i = 0; i < 4; i++)
+	{
+		assert(small.push(i) && "SpscQueue.push() failed");
+	}
+	assert(!small.push(4) && small.size() == 4 && "SpscQueue.push() should fail when full");
+	assert(small.pop(item) && item == 0 && small.push(4) && "SpscQueue should reuse a popped slot");
+	for (int i = 1; i <= 4; i++)
+	{
+		assert(small.pop(item) && item == i && "SpscQueue.pop() should return items in order");
+	}
+
+	// a producer thread: every item arrives once, in order, across many wraps of the ring
+	const int ITEMS{ 5000 };
+	SpscQueue<int, 64> queue;
+	std::thread producer([&queue, ITEMS]()
+	{
+		for (int i = 0; i < ITEMS; i++)
+		{
+			while (!queue.push(i))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+	int expected{ 0 };
+	while (expected < ITEMS)
+	{
+		if (queue.pop(item))
+		{
+			assert(item == expected && "SpscQueue items arrived out of order between threads");
+			expected++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	assert(!queue.pop(item) && "SpscQueue should be empty once every item is popped");
+
+	announceTestCompletion();
+#else
+	announceNotTested("SpscQueue");
+#endif
+}
+
+
+
+void TestSuite::testTripleBufferClass()
+{
+#ifdef TRIPLEBUFFER
+	announceTest("TripleBuffer");
+
+	// a value whose fields must always agree (a torn read would mix two writes)
+	struct Sample
+	{
+		int serial{ 0 };
+		int values[64]{};
+	};
+
+	// single thread: nothing to acquire until something is published, then only the latest value
+	TripleBuffer<Sample> buffer;
+	assert(!buffer.acquire() && "TripleBuffer.acquire() should fail before a publish()");
+	for (int serial = 1; serial <= 3; serial++)
+	{
+		buffer.getWriteSlot().serial = serial;
+		buffer.publish();
+	}
+	assert(buffer.acquire() && buffer.getReadSlot().serial == 3 && "TripleBuffer.acquire() should get the latest value");
+	assert(!buffer.acquire() && buffer.getReadSlot().serial == 3 && "TripleBuffer.acquire() should fail with nothing new");
+
+	// a writer thread: the reader only ever sees whole values, and never goes backwards
+	const int WRITES{ 100000 };
+	TripleBuffer<Sample> shared;
+	std::thread writer([&shared, WRITES]()
+	{
+		for (int serial = 1; serial <= WRITES; serial++)
+		{
+			Sample& slot = shared.getWriteSlot();
+			slot.serial = serial;
+			for (int& value : slot.values)
+			{
+				value = serial;
+			}
+			shared.publish();
+		}
+	});
+	int lastSerial{ 0 };
+	while (lastSerial < WRITES)
+	{
+		if (shared.acquire())
+		{
+			const Sample& sample = shared.getReadSlot();
+			assert(sample.serial > lastSerial && "TripleBuffer reader went backwards");
+			for (int value : sample.values)
+			{
+				assert(value == sample.serial && "TripleBuffer reader saw a torn value");
+			}
+			lastSerial = sample.serial;
+		}
+	}
+	writer.join();
+
+	announceTestCompletion();
+#else
+	announceNotTested("TripleBuffer");
+#endif
+}
+
+
+
+void TestSuite::testLineClearAnimatorClass()
+{
+#ifdef LINECLEARANIMATOR
+	announceTest("LineClearAnimator");
+
+	Gameboard::ClearedRows cleared;
+	cleared.count = 2;
+	cleared.rows[0] = 18;
+	cleared.rows[1] = 17;
+	for (int x = 0; x < Gameboard::MAX_X; x++)
+	{
+		cleared.contents[0][x] = 2;
+		cleared.contents[1][x] = 4;
+	}
+
+	// each cleared block gets a flash, a collapse and its particles
+	LineClearAnimator animator;
+	const int EFFECTS_PER_ROW = Gameboard::MAX_X * (2 + LineClearAnimator::PARTICLES_PER_BLOCK);
+	animator.start(cleared);
+	assert(animator.getActiveCount() == 2 * EFFECTS_PER_ROW && "LineClearAnimator.start() should start every effect");
+
+	// to begin with, only the flashes are showing: whole blocks, in place, with the row's colour
+	const std::vector<EffectQuad>& flashes = animator.buildQuads();
+	assert(flashes.size() == 2 * Gameboard::MAX_X && "LineClearAnimator should only show the flashes at first");
+	assert(flashes[0].x == 0.f && flashes[0].y == 18.f && flashes[0].width == 1.f && flashes[0].colour == 2 &&
+		"LineClearAnimator flash quad is wrong");
+
+	// blinked off
+	animator.update(LineClearAnimator::BLINK_SECONDS * 1.5);
+	assert(animator.buildQuads().empty() && "LineClearAnimator flashes should blink");
+
+	// once the flash is over, the blocks collapse and particles fly (upwards, to start with)
+	animator.update(LineClearAnimator::FLASH_SECONDS - LineClearAnimator::BLINK_SECONDS * 1.5 + 0.05);
+	assert(animator.getActiveCount() == 2 * (EFFECTS_PER_ROW - Gameboard::MAX_X) && "LineClearAnimator flashes should finish");
+	const std::vector<EffectQuad>& quads = animator.buildQuads();
+	assert(quads.size() == static_cast<size_t>(animator.getActiveCount()) && "LineClearAnimator should show every started effect");
+	bool collapsing{ false };
+	bool flying{ false };
+	for (const EffectQuad& quad : quads)
+	{
+		collapsing = collapsing || (quad.width == 1.f && quad.height < 1.f && quad.alpha < 255);
+		// particles start at the centre of their block (17.35 for the upper row)
+		flying = flying || (quad.width == LineClearAnimator::PARTICLE_SIZE && quad.y < 17.3f);
+	}
+	assert(collapsing && flying && "LineClearAnimator should collapse the blocks and throw particles");
+
+	// everything finishes, and the pool is reused without growing
+	animator.update(LineClearAnimator::PARTICLE_SECONDS);
+	assert(animator.getActiveCount() == 0 && animator.buildQuads().empty() && "LineClearAnimator effects should finish");
+	size_t capacity = animator.quads.capacity();
+	for (int clear = 0; clear < 10; clear++)
+	{
+		animator.start(cleared);
+	}
+	assert(animator.getActiveCount() == LineClearAnimator::MAX_EFFECTS && "LineClearAnimator pool should fill up, not grow");
+	assert(animator.buildQuads().size() <= static_cast<size_t>(LineClearAnimator::MAX_EFFECTS) &&
+		animator.quads.capacity() == capacity && "LineClearAnimator.buildQuads() shouldn't allocate");
+
+	announceTestCompletion();
+#else
+	announceNotTested("LineClearAnimator");
+#endif
+}
+
+
+
+void TestSuite::testHudTextClass()
+{
+#ifdef HUDTEXT
+	announceTest("HudText");
+
+	HudText text;
+	auto matches = [&text](const std::string& expected)
+	{
+		return std::string(text.getChars(), text.getLength()) == expected;
+	};
+
+	// labels and integers
+	text.append("score: ").appendInt(1200);
+	assert(matches("score: 1200") && "HudText.appendInt() failed");
+	text.clear();
+	text.appendInt(0).append(" ").appendInt(-45).append(" ").appendInt(7, 3);
+	assert(matches("0 -45 007") && "HudText.appendInt() failed for 0, negatives or padding");
+	text.clear();
+	text.appendInt(LLONG_MIN);
+	assert(matches("-9223372036854775808") && "HudText.appendInt() failed for the most negative value");
+
+	// fixed decimals are rounded
+	text.clear();
+	text.appendFixed(1.526, 2).append(" ").appendFixed(0.0, 2).append(" ").appendFixed(2.999, 1).append(" ").appendFixed(-0.25, 1);
+	assert(matches("1.53 0.00 3.0 -0.3") && "HudText.appendFixed() failed");
+
+	// minutes:seconds, rounded down
+	text.clear();
+	text.appendTime(185.9).append(" ").appendTime(0.4).append(" ").appendTime(3600.0);
+	assert(matches("3:05 0:00 60:00") && "HudText.appendTime() failed");
+
+	// text past the capacity is dropped
+	text.clear();
+	for (int i = 0; i < HudText::CAPACITY; i++)
+	{
+		text.append("ab");
+	}
+	assert(text.getLength() == HudText::CAPACITY && text.getChars()[HudText::CAPACITY - 1] == 'b' &&
+		"HudText should stop at its capacity");
+
+	announceTestCompletion();
+#else
+	announceNotTested("HudText");
+#endif
+}
+
+
+
+void TestSuite::testBoardWallClass()
+{
+#ifdef BOARDWALL
+	announceTest("BoardWall");
+
+	// grids: the boards are shown as large as possible
+	int columns{ 0 };
+	int rows{ 0 };
+	BoardWall::computeGrid(2, 352, 640, 640, 800, columns, rows);
+	assert(columns == 2 && rows == 1 && "BoardWall.computeGrid() 2 boards should sit side by side");
+	BoardWall::computeGrid(64, 352, 640, 1920, 1080, columns, rows);
+	assert(columns == 16 && rows == 4 && "BoardWall.computeGrid() 64 boards on a wide window failed");
+	BoardWall::computeGrid(5, 1, 1, 100, 100, columns, rows);
+	assert(columns == 2 && rows == 3 && "BoardWall.computeGrid() should prefer fewer columns on a tie");
+
+	// the # of boards is clamped
+	assert(BoardWall(1).getBoardCount() == BoardWall::MIN_BOARDS && BoardWall(100).getBoardCount() == BoardWall::MAX_BOARDS &&
+		"BoardWall should clamp the # of boards");
+
+	// every board plays its own game, one shape per SECONDS_PER_PIECE
+	BoardWall wall(4);
+	for (int board = 0; board < wall.getBoardCount(); board++)
+	{
+		assert(wall.getGame(board).getPiecesPlaced() == 0 && "BoardWall games should start empty");
+	}
+	wall.update(BoardWall::SECONDS_PER_PIECE * 10);
+	for (int board = 0; board < wall.getBoardCount(); board++)
+	{
+		int pieces = wall.getGame(board).getPiecesPlaced();
+		assert(pieces >= 10 && pieces <= 11 && "BoardWall.update() should place a shape every SECONDS_PER_PIECE");
+	}
+	bool different{ false };
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			different = different || wall.getGame(0).getBoard().getContent(x, y) != wall.getGame(1).getBoard().getContent(x, y);
+		}
+	}
+	assert(different && "BoardWall boards should be playing different games");
+
+	announceTestCompletion();
+#else
+	announceNotTested("BoardWall");
+#endif
+}
+
+
+
+void TestSuite::testLockstepGameClass()
+{
+#ifdef LOCKSTEPGAME
+	announceTest("LockstepGame");
+
+	// the board hash follows the contents
+	Gameboard board;
+	unsigned long long emptyHash = board.getHash();
+	board.setContent(3, 5, 2);
+	assert(board.getHash() != emptyHash && "Gameboard.getHash() should change with the contents");
+	board.setContent(3, 5, Gameboard::EMPTY_BLOCK);
+	assert(board.getHash() == emptyHash && "Gameboard.getHash() should only depend on the contents");
+
+	// the same seed and inputs give the same state, frame for frame
+	LockstepGame a;
+	LockstepGame b;
+	a.reset(77);
+	b.reset(77);
+	assert(a.getStateHash() == b.getStateHash() && "LockstepGame.reset() with the same seed should give the same state");
+	const unsigned char INPUTS[]{ LockstepGame::INPUT_LEFT, 0, LockstepGame::INPUT_ROTATE, LockstepGame::INPUT_RIGHT | LockstepGame::INPUT_SOFT_DROP,
+		0, LockstepGame::INPUT_HARD_DROP, 0, 0 };
+	for (int frame = 0; frame < 2000; frame++)
+	{
+		unsigned char inputs = INPUTS[(frame * 7 + frame / 11) % 8];
+		a.step(inputs);
+		b.step(inputs);
+		assert(a.getStateHash() == b.getStateHash() && "LockstepGame.step() should be deterministic");
+	}
+	assert(a.getBoard().getHash() == b.getBoard().getHash() && a.getScore() == b.getScore() && "LockstepGame boards should match");
+	b.step(LockstepGame::INPUT_LEFT);
+	if (!a.isGameOver())
+	{
+		assert(a.getStateHash() != b.getStateHash() && "LockstepGame.getStateHash() should change with the frame");
+	}
+
+	// gravity timing and the garbage hole generator are hashed too, so a desync in them is caught before it reaches the board
+	LockstepGame gravity;
+	LockstepGame holes;
+	gravity.reset(5);
+	holes.reset(5);
+	unsigned long long freshHash = gravity.getStateHash();
+	gravity.framesUntilFall--;
+	holes.holeRandom++;
+	assert(gravity.getStateHash() != freshHash && holes.getStateHash() != freshHash &&
+		"LockstepGame.getStateHash() should cover the gravity countdown and the hole generator");
+
+	// a hard drop locks the shape on the floor and spawns the next one
+	LockstepGame dropped;
+	dropped.reset(5);
+	TetShape next = dropped.getNextShape().getShape();
+	dropped.step(LockstepGame::INPUT_HARD_DROP);
+	int blocks{ 0 };
+	for (int x = 0; x < Gameboard::MAX_X; x++)
+	{
+		blocks += dropped.getBoard().getContent(x, Gameboard::MAX_Y - 1) != Gameboard::EMPTY_BLOCK ? 1 : 0;
+	}
+	assert(blocks > 0 && dropped.getFallingShape().getShape() == next && "LockstepGame hard drop should lock the shape");
+
+	// gravity is counted in frames
+	LockstepGame falling;
+	falling.reset(5);
+	int startY = falling.getFallingShape().getGridLoc().getY();
+	for (int frame = 0; frame < LockstepGame::FRAMES_PER_ROW; frame++)
+	{
+		falling.step(0);
+	}
+	assert(falling.getFallingShape().getGridLoc().getY() == startY + 1 && "LockstepGame should fall a row every FRAMES_PER_ROW frames");
+
+	announceTestCompletion();
+#else
+	announceNotTested("LockstepGame");
+#endif
+}
+
+
+
+void TestSuite::testLockstepPeerClass()
+{
+#ifdef LOCKSTEPPEER
+	announceTest("LockstepPeer");
+
+	LockstepPeer peers[2]{ LockstepPeer(0), LockstepPeer(1) };
+	unsigned long long bytesSent[2]{ 0, 0 };
+	// delivers each peer's outgoing messages to the other (in order, as TCP would)
+	auto deliver = [&peers, &bytesSent]() {
+		for (int player = 0; player < 2; player++)
+		{
+			for (const LockstepMessage& message : peers[player].getOutgoing())
+			{
+				bool valid = peers[1 - player].receive(message.bytes, static_cast<size_t>(message.size));
+				assert(valid && "LockstepPeer.receive() rejected a valid message");
+				bytesSent[player] += static_cast<unsigned long long>(message.size);
+			}
+			peers[player].clearOutgoing();
+		}
+	};
+
+	// the joiner waits for the host's seed
+	assert(!peers[1].isStarted() && !peers[1].canAddLocalInput() && !peers[1].advance() && "LockstepPeer shouldn't run before the HELLO");
+	peers[0].host(99);
+	deliver();
+	assert(peers[1].isStarted() && "LockstepPeer should start on the HELLO");
+
+	// a peer can't get more than INPUT_DELAY frames ahead of the other's inputs
+	int added{ 0 };
+	for (int loop = 0; loop < 10; loop++)
+	{
+		while (peers[0].addLocalInput(0))
+		{
+			added++;
+		}
+		while (peers[0].advance()) {};
+	}
+	assert(added == LockstepPeer::INPUT_DELAY + 1 && peers[0].getFrame() == LockstepPeer::INPUT_DELAY && "LockstepPeer should wait for the other peer's inputs");
+	assert(!peers[0].canAddLocalInput() && "LockstepPeer should stop taking inputs while it waits");
+
+	// random inputs, delivered every 3rd frame: both peers simulate the same games
+	std::mt19937 random(3);
+	const unsigned int FRAMES{ LockstepPeer::HASH_INTERVAL * 10 };
+	for (int loop = 0; peers[0].getFrame() < FRAMES || peers[1].getFrame() < FRAMES; loop++)
+	{
+		for (int player = 0; player < 2; player++)
+		{
+			if (peers[player].canAddLocalInput())
+			{
+				peers[player].addLocalInput(static_cast<unsigned char>(random() % 32));
+			}
+			while (peers[player].getFrame() < FRAMES && peers[player].advance()) {};
+		}
+		if (loop % 3 == 0)
+		{
+			deliver();
+		}
+		assert(loop < 100000 && "LockstepPeer stalled");
+	}
+	deliver();
+	assert(peers[0].getStateHash() == peers[1].getStateHash() && "LockstepPeer games should match");
+	assert(peers[0].getGame(1).getBoard().getHash() == peers[1].getGame(1).getBoard().getHash() && "LockstepPeer boards should match");
+	assert(!peers[0].isDesynced() && !peers[1].isDesynced() && "LockstepPeer matching games shouldn't be desynced");
+	// 2 bytes an input, plus a 13 byte hash a second
+	assert(bytesSent[1] <= FRAMES * 2 + (FRAMES / LockstepPeer::HASH_INTERVAL) * 13 + 2 * (LockstepPeer::INPUT_DELAY + 1) &&
+		"LockstepPeer should only send inputs and hashes");
+
+	// a board that diverges is caught at the next hash
+	peers[1].games[0].game.board.setContent(0, Gameboard::MAX_Y - 1, 3);
+	unsigned int corruptedAt = peers[1].getFrame();
+	for (int loop = 0; !(peers[0].isDesynced() && peers[1].isDesynced()); loop++)
+	{
+		for (int player = 0; player < 2; player++)
+		{
+			if (peers[player].canAddLocalInput())
+			{
+				peers[player].addLocalInput(0);
+			}
+			while (peers[player].advance()) {};
+		}
+		deliver();
+		assert(loop < LockstepPeer::HASH_INTERVAL * 4 && "LockstepPeer desync wasn't detected");
+	}
+	assert(peers[0].getDesyncFrame() > corruptedAt && peers[0].getDesyncFrame() <= corruptedAt + LockstepPeer::HASH_INTERVAL &&
+		peers[0].getDesyncFrame() % LockstepPeer::HASH_INTERVAL == 0 && "LockstepPeer should report the first hash that differed");
+
+	// anything that isn't a message is rejected
+	const unsigned char GARBAGE[]{ 9, 1, 2 };
+	const unsigned char TRUNCATED[]{ LockstepPeer::MESSAGE_HASH, 1, 2 };
+	assert(!peers[0].receive(GARBAGE, 3) && !peers[0].receive(TRUNCATED, 3) && "LockstepPeer.receive() should reject bad messages");
+
+	// a HELLO to the host, or a second one to the joiner, would restart the match
+	const unsigned char HELLO[]{ LockstepPeer::MESSAGE_HELLO, 7, 0, 0, 0 };
+	unsigned int frameBefore = peers[1].getFrame();
+	assert(!peers[0].receive(HELLO, 5) && !peers[1].receive(HELLO, 5) && "LockstepPeer.receive() should reject a HELLO once started");
+	assert(peers[1].getFrame() == frameBefore && peers[1].seed == 99 && "LockstepPeer shouldn't restart on a late HELLO");
+
+	// a multi-row clear in one game puts garbage on the other's board, on both peers
+	unsigned int clearSeed = findMultiRowClearSeed();
+	peers[0] = LockstepPeer(0);
+	peers[1] = LockstepPeer(1);
+	peers[0].host(clearSeed);
+	deliver();
+	fillForFirstDrop(clearSeed, peers[0].games[0]);
+	fillForFirstDrop(clearSeed, peers[1].games[0]);
+	// player 0 hard drops (clearing), then player 1 hard drops (locking the garbage in)
+	for (int loop = 0; loop < 40; loop++)
+	{
+		for (int player = 0; player < 2; player++)
+		{
+			unsigned char bits = (loop == 0 && player == 0) || (loop == 20 && player == 1) ? LockstepGame::INPUT_HARD_DROP : 0;
+			peers[player].addLocalInput(bits);
+			while (peers[player].advance()) {};
+		}
+		deliver();
+	}
+	for (const LockstepPeer& peer : peers)
+	{
+		bool garbage{ false };
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			garbage = garbage || peer.getGame(1).getBoard().getContent(x, Gameboard::MAX_Y - 1) == HeadlessGame::GARBAGE_CONTENT;
+		}
+		assert(garbage && peer.getGame(0).game.getLinesCleared() >= 2 && peer.getGame(0).getAttack() == 0 &&
+			"LockstepPeer should send a clear's attack to the opponent");
+	}
+	assert(peers[0].getStateHash() == peers[1].getStateHash() && "LockstepPeer garbage should be deterministic");
+
+	announceTestCompletion();
+#else
+	announceNotTested("LockstepPeer");
+#endif
+}
+
+
+
+void TestSuite::testWorkerPoolClass()
+{
+#ifdef WORKERPOOL
+	announceTest("WorkerPool");
+
+	// every batch runs exactly once, on every run()
+	WorkerPool pool(3);
+	assert(pool.getThreadCount() == 3 && "WorkerPool should start its threads");
+	const int BATCHES{ 100 };
+	std::atomic<int> runs[BATCHES];
+	for (std::atomic<int>& count : runs)
+	{
+		count = 0;
+	}
+	std::function<void(int)> task = [&runs](int batch) { runs[batch]++; };
+	for (int run = 0; run < 50; run++)
+	{
+		pool.run(BATCHES, task);
+		for (int batch = 0; batch < BATCHES; batch++)
+		{
+			assert(runs[batch] == run + 1 && "WorkerPool.run() should run every batch once and wait for them");
+		}
+	}
+
+	// fewer batches than threads, and none at all
+	std::atomic<int> total{ 0 };
+	pool.run(1, [&total](int batch) { total += batch + 1; });
+	pool.run(0, [&total](int) { total += 100; });
+	assert(total == 1 && "WorkerPool.run() with 1 or 0 batches failed");
+
+	// a pool without workers runs everything on the calling thread
+	WorkerPool inline0(0);
+	int sum{ 0 };
+	inline0.run(10, [&sum](int batch) { sum += batch; });
+	assert(sum == 45 && "WorkerPool with no threads should run the batches itself");
+
+	announceTestCompletion();
+#else
+	announceNotTested("WorkerPool");
+#endif
+}
+
+
+
+void TestSuite::testMatchPoolClass()
+{
+#ifdef MATCHPOOL
+	announceTest("MatchPool");
+
+	// slots are handed out lowest first, and reused once released
+	MatchPool pool(3);
+	int a = pool.allocate(10, 0);
+	int b = pool.allocate(11, 0);
+	int c = pool.allocate(12, 1);
+	assert(a == 0 && b == 1 && c == 2 && pool.getActiveCount() == 3 && "MatchPool.allocate() should use the lowest slots");
+	assert(pool.allocate(13, 1) == -1 && "MatchPool.allocate() should fail when the pool is full");
+	unsigned int generation = pool.getMatch(b).generation;
+	pool.release(b);
+	pool.release(b);
+	assert(pool.getActiveCount() == 2 && "MatchPool.release() should only free a slot once");
+	assert(pool.allocate(14, 2) == b && pool.getMatch(b).owner == 2 && "MatchPool should reuse a released slot");
+	assert(pool.getMatch(b).generation == generation + 1 && "MatchPool.release() should start a new generation of the slot");
+	const ServerMatch* first = &pool.getMatch(0);
+	pool.release(a);
+	pool.allocate(15, 0);
+	assert(first == &pool.getMatch(0) && "MatchPool matches should never move");
+
+	// stepping applies each player's inputs (OR-ed since the last step) to their own game
+	pool.addInputs(c, 0, LockstepGame::INPUT_LEFT);
+	pool.addInputs(c, 0, LockstepGame::INPUT_HARD_DROP);
+	LockstepGame expected;
+	expected.reset(12);
+	expected.step(LockstepGame::INPUT_LEFT | LockstepGame::INPUT_HARD_DROP);
+	LockstepGame idle;
+	idle.reset(12);
+	idle.step(0);
+	pool.stepRange(0, pool.getCapacity());
+	assert(pool.getMatch(c).games[0].getStateHash() == expected.getStateHash() && "MatchPool.stepRange() should apply the inputs");
+	assert(pool.getMatch(c).games[1].getStateHash() == idle.getStateHash() && "MatchPool inputs should only go to their player");
+	assert(pool.getMatch(c).pendingInputs[0] == 0 && "MatchPool.stepRange() should use up the inputs");
+
+	// inactive slots aren't stepped, and a finished match restarts
+	pool.release(c);
+	unsigned int frame = pool.getMatch(c).games[0].getFrame();
+	pool.stepRange(0, pool.getCapacity());
+	assert(pool.getMatch(c).games[0].getFrame() == frame && "MatchPool.stepRange() should skip inactive slots");
+	int slot = pool.allocate(20, 0);
+	for (int step = 0; step < 100000 && pool.getMatch(slot).gamesFinished == 0; step++)
+	{
+		pool.addInputs(slot, 0, LockstepGame::INPUT_HARD_DROP);
+		pool.stepRange(slot, slot + 1);
+	}
+	assert(pool.getMatch(slot).gamesFinished == 1 && !pool.getMatch(slot).games[0].isGameOver() && "MatchPool should restart finished matches");
+	assert(MatchPool(MatchPool::BATCH_SIZE + 1).getBatchCount() == 2 && "MatchPool.getBatchCount() should cover every slot");
+
+	announceTestCompletion();
+#else
+	announceNotTested("MatchPool");
+#endif
+}
+
+
+
+void TestSuite::testBoardCodecClass()
+{
+#ifdef BOARDCODEC
+	announceTest("BoardCodec");
+
+	unsigned char buffer[BoardCodec::MAX_ENCODED_BYTES];
+	Gameboard decoded;
+
+	// an empty board is the header and the row mask
+	Gameboard board;
+	int size = BoardCodec::encode(board, nullptr, buffer);
+	assert(size == 3 && !BoardCodec::isDelta(buffer, size) && "BoardCodec empty board should be 3 bytes");
+	decoded.setContent(4, 4, 2);
+	assert(BoardCodec::decode(buffer, size, nullptr, decoded) == size && decoded.getHash() == board.getHash() &&
+		"BoardCodec should decode an empty board");
+
+	// a stack of rows, in several colours
+	for (int y = Gameboard::MAX_Y - 6; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			if (x != y % Gameboard::MAX_X)
+			{
+				board.setContent(x, y, (x / 3 + y) % 7);
+			}
+		}
+	}
+	size = BoardCodec::encode(board, nullptr, buffer);
+	assert(size * 10 <= BoardCodec::RAW_BYTES && "BoardCodec full board should be 10x smaller than the grid");
+	assert(BoardCodec::decode(buffer, size, nullptr, decoded) == size && decoded.getHash() == board.getHash() &&
+		"BoardCodec full board round trip failed");
+
+	// a delta with one changed row, decoded into a copy of the base
+	Gameboard base = board;
+	board.setContent(0, Gameboard::MAX_Y - 7, 5);
+	size = BoardCodec::encode(board, &base, buffer);
+	assert(BoardCodec::isDelta(buffer, size) && size <= 6 && "BoardCodec one row delta should be a few bytes");
+	Gameboard copy = base;
+	assert(BoardCodec::decode(buffer, size, &copy, copy) == size && copy.getHash() == board.getHash() &&
+		"BoardCodec delta round trip (in place) failed");
+	assert(BoardCodec::decode(buffer, size, nullptr, decoded) == -1 && "BoardCodec delta without a base should fail");
+
+	// a line clear: every row above it moves down, and is sent as a copy
+	base = board;
+	for (int x = 0; x < Gameboard::MAX_X; x++)
+	{
+		board.setContent(x, Gameboard::MAX_Y - 2, 1);
+	}
+	board.removeCompletedRows();
+	size = BoardCodec::encode(board, &base, buffer);
+	assert(size <= 8 && "BoardCodec line clear delta should copy the rows that moved");
+	assert(BoardCodec::decode(buffer, size, &base, decoded) == size && decoded.getHash() == board.getHash() &&
+		"BoardCodec line clear round trip failed");
+	assert(BoardCodec::decode(buffer, size, &base, base) == size && base.getHash() == board.getHash() &&
+		"BoardCodec line clear round trip (in place) failed");
+
+	// an unchanged board, and a board of alternating colours (the worst case)
+	assert(BoardCodec::encode(board, &board, buffer) == 3 && "BoardCodec delta of an unchanged board should be 3 bytes");
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			board.setContent(x, y, (x + y) % 2 == 0 ? 0 : 7);
+		}
+	}
+	size = BoardCodec::encode(board, nullptr, buffer);
+	assert(size <= BoardCodec::MAX_ENCODED_BYTES && BoardCodec::decode(buffer, size, nullptr, decoded) == size &&
+		decoded.getHash() == board.getHash() && "BoardCodec worst case round trip failed");
+
+	// truncated data is rejected
+	assert(BoardCodec::decode(buffer, size - 1, nullptr, decoded) == -1 && "BoardCodec should reject truncated data");
+
+	announceTestCompletion();
+#else
+	announceNotTested("BoardCodec");
+#endif
+}
+
+
+
+void TestSuite::testSpectatorFeedClass()
+{
+#ifdef SPECTATORFEED
+	announceTest("SpectatorFeed");
+
+	LockstepGame games[2];
+	games[0].reset(8);
+	games[1].reset(8);
+	// plays a frame of both games (taps now and then) and publishes it
+	int frame{ 0 };
+	auto play = [&games, &frame](SpectatorFeed& feed) {
+		const unsigned char INPUTS[]{ 0, LockstepGame::INPUT_LEFT, 0, LockstepGame::INPUT_ROTATE, 0, LockstepGame::INPUT_HARD_DROP };
+		games[0].step(INPUTS[frame % 6]);
+		games[1].step(INPUTS[(frame / 5) % 6]);
+		feed.publish(static_cast<unsigned int>(frame), games[0], games[1]);
+		frame++;
+	};
+
+	// nothing is encoded without viewers
+	SpectatorFeed feed;
+	play(feed);
+	assert(feed.getEntriesPublished() == 0 && feed.getEndOffset() == 0 && "SpectatorFeed shouldn't publish without viewers");
+
+	// the first viewer starts at the first entry, a keyframe
+	unsigned long long first = feed.addViewer();
+	for (int i = 0; i < SpectatorFeed::KEYFRAME_INTERVAL / 2; i++)
+	{
+		play(feed);
+	}
+	SpectatorView view;
+	size_t size{ 0 };
+	const unsigned char* data = feed.getData(first, size);
+	// delivered a byte at a time, as a slow socket might
+	for (size_t i = 0; i < size; i++)
+	{
+		assert(view.receive(data + i, 1) && "SpectatorView.receive() rejected a valid stream");
+	}
+	unsigned long long offset = first + size;
+	assert(view.isSynced() && view.getKeyframes() == 1 && view.getDeltas() == SpectatorFeed::KEYFRAME_INTERVAL / 2 - 1 &&
+		"SpectatorView should read a keyframe and then deltas");
+	for (int player = 0; player < 2; player++)
+	{
+		assert(view.getBoard(player).getHash() == games[player].getBoard().getHash() && view.getScore(player) == games[player].getScore() &&
+			view.getFallingShape(player).getGridLoc().getY() == games[player].getFallingShape().getGridLoc().getY() &&
+			"SpectatorView should match the games");
+	}
+	// deltas are a few bytes: the entry header, and mostly unchanged boards
+	assert(static_cast<double>(size) / (SpectatorFeed::KEYFRAME_INTERVAL / 2) < 40.0 && "SpectatorFeed entries should be small");
+
+	// a late joiner starts at the latest keyframe, and ends up in the same place
+	for (int i = 0; i < SpectatorFeed::KEYFRAME_INTERVAL; i++)
+	{
+		play(feed);
+	}
+	unsigned long long late = feed.addViewer();
+	assert(late == feed.getKeyframeOffset() && late > first && feed.getViewerCount() == 2 && "SpectatorFeed late joiners should start at a keyframe");
+	SpectatorView lateView;
+	data = feed.getData(late, size);
+	assert(lateView.receive(data, size) && lateView.getKeyframes() == 1 && "SpectatorView late joiner should read from the keyframe");
+	data = feed.getData(offset, size);
+	assert(view.receive(data, size) && "SpectatorView.receive() rejected a valid stream");
+	offset += size;
+	for (int player = 0; player < 2; player++)
+	{
+		assert(lateView.getBoard(player).getHash() == view.getBoard(player).getHash() && lateView.getFrame() == view.getFrame() &&
+			"SpectatorView late joiner should match the first viewer");
+	}
+
+	// the buffer only keeps the entries from the previous keyframe on
+	for (int i = 0; i < SpectatorFeed::KEYFRAME_INTERVAL * 3; i++)
+	{
+		play(feed);
+	}
+	assert(!feed.contains(first) && feed.contains(feed.getKeyframeOffset()) && "SpectatorFeed should drop old entries");
+	assert(feed.getBufferSize() < static_cast<size_t>(SpectatorFeed::KEYFRAME_INTERVAL * 2 * SpectatorFeed::MAX_ENTRY_BYTES / 10) &&
+		"SpectatorFeed buffer should stay bounded");
+
+	// a new first viewer restarts the feed with a keyframe
+	feed.removeViewer();
+	feed.removeViewer();
+	play(feed);
+	unsigned long long restarted = feed.addViewer();
+	play(feed);
+	SpectatorView freshView;
+	data = feed.getData(restarted, size);
+	assert(freshView.receive(data, size) && freshView.getKeyframes() == 1 && freshView.getBoard(0).getHash() == games[0].getBoard().getHash() &&
+		"SpectatorFeed should restart with a keyframe for a new viewer");
+
+	// garbage is rejected
+	const unsigned char GARBAGE[]{ 2, 0, 1 };
+	SpectatorView badView;
+	assert(!badView.receive(GARBAGE, 3) && "SpectatorView should reject an entry too small to be valid");
+
+	announceTestCompletion();
+#else
+	announceNotTested("SpectatorFeed");
+#endif
+}
+
+
+
+void TestSuite::testGarbageExchangeClass()
+{
+#ifdef GARBAGEEXCHANGE
+	announceTest("GarbageExchange");
+
+	// a multi-row clear attacks (after cancelling the garbage waiting)
+	unsigned int clearSeed = findMultiRowClearSeed();
+	LockstepGame attacker;
+	attacker.reset(clearSeed);
+	int rowsCleared = fillForFirstDrop(clearSeed, attacker);
+	attacker.receiveGarbage(1);
+	attacker.step(LockstepGame::INPUT_HARD_DROP);
+	int attackRows = LockstepGame::ATTACK_ROWS[rowsCleared];
+	assert(attacker.game.getLastClearedRows() == rowsCleared && attacker.getAttack() == attackRows - 1 && attacker.getPendingGarbage() == 0 &&
+		"LockstepGame attack should cancel the garbage waiting first");
+	attacker.clearAttack();
+	assert(attacker.getAttack() == 0 && "LockstepGame.clearAttack() should clear the attack");
+
+	// garbage waits for a lock, then comes in under the board with one hole column
+	LockstepGame victim;
+	LockstepGame twin;
+	victim.reset(9);
+	twin.reset(9);
+	victim.receiveGarbage(3);
+	twin.receiveGarbage(3);
+	unsigned long long waitingHash = victim.getStateHash();
+	victim.step(0);
+	assert(victim.getPendingGarbage() == 3 && victim.getStateHash() != waitingHash && "LockstepGame garbage should wait for a lock");
+	victim.step(LockstepGame::INPUT_HARD_DROP);
+	twin.step(0);
+	twin.step(LockstepGame::INPUT_HARD_DROP);
+	assert(victim.getPendingGarbage() == 0 && victim.getStateHash() == twin.getStateHash() && "LockstepGame garbage should be deterministic");
+	int holes{ 0 };
+	for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+	{
+		holes += victim.getBoard().getContent(x, Gameboard::MAX_Y - 1) == Gameboard::EMPTY_BLOCK ? 1 : 0;
+		assert(victim.getBoard().getContent(x, Gameboard::MAX_Y - 1) == victim.getBoard().getContent(x, Gameboard::MAX_Y - 3) &&
+			"LockstepGame garbage rows should share the hole column");
+	}
+	assert(holes == 1 && victim.getBoard().getContent((victim.getBoard().getContent(0, Gameboard::MAX_Y - 1) == Gameboard::EMPTY_BLOCK) ? 1 : 0,
+		Gameboard::MAX_Y - 1) == HeadlessGame::GARBAGE_CONTENT && "LockstepGame garbage rows should have 1 hole");
+
+	// attacks are only received once the receiver reaches the frame they were sent on
+	GarbageExchange exchange;
+	assert(exchange.send(0, 5, 2) && exchange.receive(1, 4) == 0 && exchange.receive(0, 10) == 0 &&
+		"GarbageExchange.receive() shouldn't take an attack early (or the player's own)");
+	assert(exchange.receive(1, 5) == 2 && exchange.receive(1, 5) == 0 && "GarbageExchange.receive() should take an attack once");
+
+	// a full queue refuses attacks until the receiver catches up, clear() drops them
+	for (size_t i = 0; i < GarbageExchange::CAPACITY; i++)
+	{
+		assert(exchange.send(1, 1, 1) && "GarbageExchange.send() should fill the queue");
+	}
+	assert(!exchange.send(1, 1, 1) && "GarbageExchange.send() should fail when the queue is full");
+	exchange.clear();
+	assert(exchange.receive(0, UINT_MAX) == 0 && exchange.send(1, 1, 1) && "GarbageExchange.clear() should empty the queues");
+	exchange.clear();
+
+	// one thread sending while another receives, no row is lost
+	const int ATTACKS = 2000;
+	std::thread sender([&exchange, ATTACKS]() {
+		for (int i = 0; i < ATTACKS; i++)
+		{
+			while (!exchange.send(0, static_cast<unsigned int>(i), 1))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+	int received{ 0 };
+	while (received < ATTACKS)
+	{
+		int rows = exchange.receive(1, UINT_MAX);
+		if (rows == 0)
+		{
+			std::this_thread::yield();
+		}
+		received += rows;
+	}
+	sender.join();
+	assert(received == ATTACKS && exchange.receive(1, UINT_MAX) == 0 && "GarbageExchange should deliver every row across threads");
+
+	// a match's two games stepped on two threads at once end up just like stepping them in turn
+	MatchPool serial(1);
+	MatchPool parallel(1);
+	serial.allocate(21, 0);
+	parallel.allocate(21, 0);
+	bool garbageArrived{ false };
+	for (int frame = 0; frame < 160; frame++)
+	{
+		unsigned char inputs = (frame % 40 == 39) ? LockstepGame::INPUT_HARD_DROP : ((frame % 3 == 0) ? LockstepGame::INPUT_LEFT : 0);
+		for (MatchPool* pool : { &serial, &parallel })
+		{
+			if (frame % 50 == 0)
+			{
+				// stands in for a line clear, so garbage crosses on a steady beat
+				pool->matches[0].games[frame % 100 == 0 ? 0 : 1].attack += 2;
+			}
+			pool->addInputs(0, 0, inputs);
+			pool->addInputs(0, 1, static_cast<unsigned char>(inputs ^ LockstepGame::INPUT_LEFT));
+		}
+		serial.stepRange(0, 1);
+		std::thread player1([&parallel]() { parallel.stepGames(1, 2); });
+		parallel.stepGames(0, 1);
+		player1.join();
+		parallel.finishMatches(0, 1);
+		for (int player{ 0 }; player < ServerMatch::PLAYER_COUNT; player++)
+		{
+			assert(serial.getMatch(0).games[player].getStateHash() == parallel.getMatch(0).games[player].getStateHash() &&
+				"MatchPool.stepGames() on separate threads should match stepping in turn");
+			garbageArrived = garbageArrived || parallel.getMatch(0).games[player].getBoard().getContent(0, Gameboard::MAX_Y - 1) ==
+				HeadlessGame::GARBAGE_CONTENT || parallel.getMatch(0).games[player].getBoard().getContent(1, Gameboard::MAX_Y - 1) ==
+				HeadlessGame::GARBAGE_CONTENT;
+		}
+	}
+	assert(garbageArrived && "MatchPool should carry garbage between the games of a match");
+
+	announceTestCompletion();
+#else
+	announceNotTested("GarbageExchange");
+#endif
+}
+
+
+
+void TestSuite::testTournamentClass()
+{
+#ifdef TOURNAMENT
+	announceTest("Tournament");
+
+	// round robin: every pair plays gamesPerPairing matches, and the greedy bot beats the random one
+	TournamentSettings settings;
+	settings.gamesPerPairing = 4;
+	settings.maxTurns = 150;
+	settings.threadCount = 2;
+	settings.logPath = "tournament_test_log.txt";
+	Tournament roundRobin(settings);
+	int greedy = roundRobin.addBot("greedy", Tournament::makeGreedyPolicy(EvalWeights::getDefaults()));
+	int random = roundRobin.addBot("random", Tournament::makeRandomPolicy());
+	roundRobin.run();
+	assert(roundRobin.getRoundsPlayed() == 1 && roundRobin.getRecords().size() == 4 && "Tournament round robin should play 1 round of 4 matches");
+	assert(roundRobin.getStanding(greedy).wins == 4 && roundRobin.getStanding(random).losses == 4 &&
+		"Tournament greedy bot should beat the random bot");
+	assert(roundRobin.getStanding(greedy).elo > Tournament::ELO_START && roundRobin.getStanding(random).elo < Tournament::ELO_START &&
+		roundRobin.getStanding(greedy).glicko > Tournament::GLICKO_START &&
+		roundRobin.getStanding(greedy).glickoDeviation < Tournament::GLICKO_START_DEVIATION && "Tournament ratings should follow the results");
+	assert(!roundRobin.playRound() && "Tournament round robin should only have 1 round");
+
+	// seats swap, seeds repeat per pairing, and every replay plays back to the same result
+	for (size_t match = 0; match < roundRobin.getRecords().size(); match++)
+	{
+		const MatchRecord& record = roundRobin.getRecords()[match];
+		assert(record.bots[0] == static_cast<int>(match % 2) && record.seed == settings.seed + match && "Tournament schedule unexpected");
+		MatchRecord replayed;
+		assert(Tournament::replayMatch(record, replayed) && replayed.winner == record.winner && replayed.turns == record.turns &&
+			replayed.rowsSent[0] == record.rowsSent[0] && replayed.rowsSent[1] == record.rowsSent[1] &&
+			replayed.piecesPlaced == record.piecesPlaced && "Tournament.replayMatch() should reproduce the match");
+	}
+	MatchRecord broken = roundRobin.getRecords()[0];
+	MatchRecord replayed;
+	broken.replay.pop_back();
+	assert(!Tournament::replayMatch(broken, replayed) && "Tournament.replayMatch() should reject a truncated replay");
+
+	// the results don't depend on the # of threads
+	settings.threadCount = 1;
+	Tournament serial(settings);
+	serial.addBot("greedy", Tournament::makeGreedyPolicy(EvalWeights::getDefaults()));
+	serial.addBot("random", Tournament::makeRandomPolicy());
+	serial.run();
+	for (size_t match = 0; match < serial.getRecords().size(); match++)
+	{
+		assert(serial.getRecords()[match].replay == roundRobin.getRecords()[match].replay && "Tournament should be deterministic");
+	}
+
+	// the log has a line per match, then the standings
+	assert(roundRobin.writeLog() && "Tournament.writeLog() should write the log");
+	std::ifstream log(settings.logPath);
+	std::string line;
+	int matchLines{ 0 };
+	while (std::getline(log, line))
+	{
+		matchLines += (!line.empty() && line[0] != '#') ? 1 : 0;
+	}
+	log.close();
+	std::remove(settings.logPath.c_str());
+	assert(matchLines == 4 && "Tournament log should have a line per match");
+
+	// swiss: 3 bots, so one bye a round (never twice to the same bot), and no rematch in round 2
+	settings.format = TournamentFormat::SWISS;
+	settings.rounds = 2;
+	settings.gamesPerPairing = 2;
+	Tournament swiss(settings);
+	EvalWeights flat = EvalWeights::getDefaults();
+	flat[EvalFeature::BUMPINESS] *= 3.0;
+	swiss.addBot("greedy", Tournament::makeGreedyPolicy(EvalWeights::getDefaults()));
+	swiss.addBot("flat", Tournament::makeGreedyPolicy(flat));
+	swiss.addBot("random", Tournament::makeRandomPolicy());
+	swiss.run();
+	assert(swiss.getRoundsPlayed() == 2 && swiss.getRecords().size() == 4 && "Tournament swiss should play 2 rounds of 1 pairing");
+	int byes{ 0 };
+	for (int bot = 0; bot < 3; bot++)
+	{
+		byes += swiss.getStanding(bot).hadBye ? 1 : 0;
+	}
+	const MatchRecord& first = swiss.getRecords()[0];
+	const MatchRecord& second = swiss.getRecords()[2];
+	assert(byes == 2 && "Tournament swiss should give the bye to a different bot each round");
+	assert(!(std::min(first.bots[0], first.bots[1]) == std::min(second.bots[0], second.bots[1]) &&
+		std::max(first.bots[0], first.bots[1]) == std::max(second.bots[0], second.bots[1])) && "Tournament swiss should avoid rematches");
+
+	announceTestCompletion();
+#else
+	announceNotTested("Tournament");
+#endif
+}
+
+
+
+void TestSuite::testNetworkImpairmentClass()
+{
+#ifdef NETWORKIMPAIRMENT
+	announceTest("NetworkImpairment");
+
+	std::vector<unsigned char> packet;
+	unsigned char data[4]{ 0 };
+
+	// a clean network passes packets straight through, in order
+	NetworkImpairment clean(ImpairmentSettings(), false);
+	for (unsigned char i = 0; i < 5; i++)
+	{
+		data[0] = i;
+		clean.submit(data, 4, 0.0);
+	}
+	for (unsigned char i = 0; i < 5; i++)
+	{
+		assert(clean.release(0.0, packet) && packet.size() == 4 && packet[0] == i && "NetworkImpairment clean should keep the order");
+	}
+	assert(!clean.release(100.0, packet) && clean.getBytesReleased() == 20 && "NetworkImpairment clean should release each packet once");
+
+	// latency holds every packet back
+	ImpairmentSettings slow;
+	slow.latencyMs = 50.0;
+	NetworkImpairment delayed(slow, false);
+	delayed.submit(data, 4, 10.0);
+	assert(!delayed.release(59.0, packet) && delayed.getHeldCount() == 1 && "NetworkImpairment should hold a packet for the latency");
+	assert(delayed.release(60.0, packet) && delayed.getHeldCount() == 0 && "NetworkImpairment should release a packet after the latency");
+
+	// loss and duplication
+	ImpairmentSettings lossy;
+	lossy.lossPercent = 100.0;
+	NetworkImpairment dropping(lossy, false);
+	dropping.submit(data, 4, 0.0);
+	assert(!dropping.release(1000.0, packet) && dropping.getPacketsDropped() == 1 && "NetworkImpairment 100% loss should drop");
+	ImpairmentSettings doubled;
+	doubled.duplicatePercent = 100.0;
+	NetworkImpairment duplicating(doubled, false);
+	duplicating.submit(data, 4, 0.0);
+	assert(duplicating.release(0.0, packet) && duplicating.release(0.0, packet) && !duplicating.release(0.0, packet) &&
+		"NetworkImpairment 100% duplication should send 2 copies");
+
+	// jitter and reordering swap packets, the same way for the same seed
+	ImpairmentSettings shuffled;
+	shuffled.latencyMs = 20.0;
+	shuffled.jitterMs = 10.0;
+	shuffled.reorderPercent = 20.0;
+	shuffled.seed = 7;
+	NetworkImpairment first(shuffled, false);
+	NetworkImpairment second(shuffled, false);
+	std::vector<unsigned char> order[2];
+	for (unsigned char i = 0; i < 100; i++)
+	{
+		data[0] = i;
+		first.submit(data, 4, i * 2.0);
+		second.submit(data, 4, i * 2.0);
+	}
+	NetworkImpairment* impairments[2]{ &first, &second };
+	for (int side = 0; side < 2; side++)
+	{
+		while (impairments[side]->release(1000.0, packet))
+		{
+			order[side].push_back(packet[0]);
+		}
+	}
+	assert(order[0].size() == 100 && order[0] == order[1] && "NetworkImpairment should be reproducible for a seed");
+	assert(!std::is_sorted(order[0].begin(), order[0].end()) && first.getPacketsReordered() > 0 && "NetworkImpairment should reorder");
+
+	// ordered (TCP): a lost chunk is retransmitted late, and holds up everything behind it
+	ImpairmentSettings stream;
+	stream.latencyMs = 10.0;
+	stream.jitterMs = 10.0;
+	stream.lossPercent = 10.0;
+	stream.duplicatePercent = 50.0;
+	NetworkImpairment tcp(stream, true);
+	for (unsigned char i = 0; i < 100; i++)
+	{
+		data[0] = i;
+		tcp.submit(data, 4, i * 1.0);
+	}
+	std::vector<unsigned char> tcpOrder;
+	double nowMs{ 0.0 };
+	bool stalled{ false };
+	while (tcpOrder.size() < 100 && nowMs < 10000.0)
+	{
+		size_t before = tcpOrder.size();
+		while (tcp.release(nowMs, packet))
+		{
+			tcpOrder.push_back(packet[0]);
+		}
+		stalled = stalled || (before == tcpOrder.size() && nowMs > 120.0 && nowMs < NetworkImpairment::RETRANSMIT_MS);
+		nowMs += 1.0;
+	}
+	assert(tcpOrder.size() == 100 && std::is_sorted(tcpOrder.begin(), tcpOrder.end()) && tcp.getPacketsDuplicated() == 0 &&
+		"NetworkImpairment ordered should deliver every chunk once, in order");
+	assert(tcp.getPacketsRetransmitted() > 0 && stalled && "NetworkImpairment ordered loss should stall the stream");
+
+	announceTestCompletion();
+#else
+	announceNotTested("NetworkImpairment");
+#endif
+}
+
+
+
+void TestSuite::testRollbackPeerClass()
+{
+#ifdef ROLLBACKPEER
+	announceTest("RollbackPeer");
+
+	const double FRAME_MS{ 1000.0 / 60.0 };
+	ImpairmentSettings lossy;
+	lossy.latencyMs = 40.0;
+	lossy.jitterMs = 10.0;
+	lossy.lossPercent = 5.0;
+	lossy.duplicatePercent = 2.0;
+	lossy.reorderPercent = 5.0;
+	NetworkImpairment links[2]{ NetworkImpairment(lossy, false), NetworkImpairment(lossy, false) };	// from each peer
+	RollbackPeer peers[2]{ RollbackPeer(0), RollbackPeer(1) };
+	std::mt19937 random(5);
+	std::vector<unsigned char> packet;
+	double nowMs{ 0.0 };
+	auto exchange = [&]()
+	{
+		for (int player = 0; player < 2; player++)
+		{
+			const std::vector<unsigned char>& sent = peers[player].buildPacket();
+			links[player].submit(sent.data(), sent.size(), nowMs);
+			while (links[player].release(nowMs, packet))
+			{
+				assert(peers[1 - player].receive(packet.data(), packet.size()) && "RollbackPeer should take its own packets");
+			}
+		}
+		nowMs += FRAME_MS;
+	};
+
+	// the joiner waits for the host's first packet, and takes its seed
+	peers[0].host(99);
+	exchange();
+	assert(peers[0].isStarted() && !peers[1].isStarted() && !peers[1].advance() && "RollbackPeer joiner should wait for the host");
+
+	// 30 seconds of random play: the remote games are predicted and rolled back, but never desync
+	const unsigned char INPUTS[]{ LockstepGame::INPUT_LEFT, LockstepGame::INPUT_RIGHT, LockstepGame::INPUT_ROTATE,
+		LockstepGame::INPUT_SOFT_DROP, LockstepGame::INPUT_HARD_DROP };
+	for (int tick = 0; tick < 1800; tick++)
+	{
+		for (RollbackPeer& peer : peers)
+		{
+			unsigned int roll = random() % 16;
+			peer.addLocalInput(roll < 5 ? INPUTS[roll] : 0);
+			peer.advance();
+		}
+		exchange();
+	}
+	for (const RollbackPeer& peer : peers)
+	{
+		assert(peer.isStarted() && peer.getFrame() > 1500 && "RollbackPeer should keep playing through 5% loss");
+		assert(peer.getRollbacks() > 0 && peer.getConfirmedFrame() < peer.getFrame() + 1 && "RollbackPeer should roll back mispredictions");
+		assert(peer.getLongestRollback() <= static_cast<unsigned int>(RollbackPeer::MAX_PREDICTION) && "RollbackPeer should limit predictions");
+		assert(!peer.isDesynced() && "RollbackPeer shouldn't desync");
+	}
+	assert(peers[0].getPacketsIgnored() + peers[1].getPacketsIgnored() > 0 && "RollbackPeer should ignore stale packets");
+
+	// once the inputs stop at the same frame, the redundant packets confirm everything, and both peers agree
+	unsigned int lastFrame = std::max(peers[0].localInputCount, peers[1].localInputCount) + 1;
+	for (int tick = 0; tick < 600; tick++)
+	{
+		for (RollbackPeer& peer : peers)
+		{
+			if (peer.localInputCount < lastFrame)
+			{
+				peer.addLocalInput(0);
+			}
+			peer.advance();
+		}
+		exchange();
+	}
+	for (int player = 0; player < 2; player++)
+	{
+		assert(peers[player].getFrame() == lastFrame && peers[player].getConfirmedFrame() == lastFrame && "RollbackPeer should confirm every frame");
+		assert(peers[0].getGame(player).getStateHash() == peers[1].getGame(player).getStateHash() && "RollbackPeer games should match");
+	}
+
+	// malformed and stale packets
+	std::vector<unsigned char> good = peers[0].buildPacket();
+	std::vector<unsigned char> corrupt = good;
+	corrupt[0] = 0;
+	assert(!peers[1].receive(corrupt.data(), corrupt.size()) && !peers[1].receive(good.data(), good.size() - 1) &&
+		!peers[1].receive(good.data(), 3) && "RollbackPeer should reject malformed packets");
+	unsigned long long ignored = peers[1].getPacketsIgnored();
+	assert(peers[1].receive(good.data(), good.size()) && peers[1].receive(good.data(), good.size()) && peers[1].getPacketsIgnored() == ignored + 1 &&
+		"RollbackPeer should ignore a duplicated packet");
+
+	// a remote clear that arrives late is rolled back into the local game too: the joiner guesses
+	// the host didn't hard drop, then the host's clear turns out to have sent the joiner garbage
+	unsigned int clearSeed = findMultiRowClearSeed();
+	ImpairmentSettings latent;
+	latent.latencyMs = 50.0;
+	peers[0] = RollbackPeer(0);
+	peers[1] = RollbackPeer(1);
+	links[0] = NetworkImpairment(latent, false);
+	links[1] = NetworkImpairment(latent, false);
+	peers[0].host(clearSeed);
+	for (int loop = 0; !peers[1].isStarted(); loop++)
+	{
+		exchange();
+		assert(loop < 10 && "RollbackPeer joiner should start");
+	}
+	for (RollbackPeer& peer : peers)
+	{
+		fillForFirstDrop(clearSeed, peer.games[0]);
+		fillForFirstDrop(clearSeed, peer.confirmedGames[0]);
+	}
+	for (int tick = 0; tick < 240; tick++)
+	{
+		for (int player = 0; player < 2; player++)
+		{
+			bool drop = (player == 0 && tick == 0) || (player == 1 && tick == 60);
+			if (tick < 120)
+			{
+				peers[player].addLocalInput(drop ? LockstepGame::INPUT_HARD_DROP : 0);
+			}
+			else if (peers[player].localInputCount < peers[1 - player].localInputCount)
+			{
+				peers[player].addLocalInput(0);
+			}
+			peers[player].advance();
+		}
+		exchange();
+	}
+	assert(peers[1].getRollbacks() > 0 && "RollbackPeer joiner should mispredict the host's drop");
+	for (const RollbackPeer& peer : peers)
+	{
+		bool garbage{ false };
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			garbage = garbage || peer.getGame(1).getBoard().getContent(x, Gameboard::MAX_Y - 1) == HeadlessGame::GARBAGE_CONTENT;
+		}
+		assert(garbage && peer.getGame(0).game.getLinesCleared() >= 2 && "RollbackPeer should carry garbage between the games");
+		assert(peer.getConfirmedFrame() == peer.getFrame() && peer.getFrame() == peers[0].getFrame() && !peer.isDesynced() &&
+			"RollbackPeer should confirm the garbage frames");
+	}
+	for (int player = 0; player < 2; player++)
+	{
+		assert(peers[0].getGame(player).getStateHash() == peers[1].getGame(player).getStateHash() && "RollbackPeer garbage should match");
+	}
+
+	announceTestCompletion();
+#else
+	announceNotTested("RollbackPeer");
+#endif
+}
+
+
+
+void TestSuite::testMatchmakerClass()
+{
+#ifdef MATCHMAKER
+	announceTest("Matchmaker");
+
+	MatchPool pool(4);
+	Matchmaker matchmaker(pool, 8, 100);
+	MatchResult result;
+
+	// close ratings with the same ping bucket match straight away, into a pool slot
+	assert(matchmaker.enqueue(1, 1500, 30, 0.0) >= 0 && !matchmaker.pollMatch(result) && "Matchmaker should wait for a second player");
+	matchmaker.enqueue(2, 1540, 35, 0.0);
+	assert(matchmaker.pollMatch(result) && result.players[0] == 2 && result.players[1] == 1 && result.slot >= 0 && "Matchmaker should match close players");
+	assert(pool.getActiveCount() == 1 && pool.getMatch(result.slot).seed == 100 && pool.getMatch(result.slot).games[0].getFrame() == 0 &&
+		matchmaker.getWaitingCount() == 0 && "Matchmaker should start the match in the pool");
+
+	// different ping buckets don't match, and far ratings only match once the windows have widened
+	int farPing = matchmaker.enqueue(4, 1500, 100, 0.0);
+	matchmaker.enqueue(3, 1500, 10, 0.0);
+	matchmaker.enqueue(5, 2000, 10, 0.0);
+	matchmaker.enqueue(6, 2100, 10, 0.0);
+	matchmaker.update(1000.0);
+	assert(!matchmaker.pollMatch(result) && matchmaker.getWaitingCount() == 4 && Matchmaker::getWindow(1000.0) < 100 && "Matchmaker shouldn't match far players");
+	matchmaker.update(2000.0);
+	assert(matchmaker.pollMatch(result) && result.waitMs[0] == 2000.0 && std::abs(result.ratings[0] - result.ratings[1]) == 100 &&
+		"Matchmaker should widen the rating window");
+	assert(Matchmaker::getWindow(1000000.0) == Matchmaker::MAX_WINDOW && "Matchmaker should limit the window");
+
+	// after PING_RELAX_MS, the neighbouring ping bucket is searched
+	matchmaker.enqueue(7, 1500, 50, 2000.0);
+	matchmaker.update(9000.0);
+	assert(!matchmaker.pollMatch(result) && "Matchmaker shouldn't match across ping buckets early");
+	matchmaker.update(Matchmaker::PING_RELAX_MS);
+	assert(matchmaker.pollMatch(result) && result.players[0] == 3 && result.players[1] == 7 && "Matchmaker should relax the ping bucket");
+
+	// cancelling
+	assert(!matchmaker.cancel(farPing, 3) && matchmaker.cancel(farPing, 4) && !matchmaker.cancel(farPing, 4) &&
+		matchmaker.getWaitingCount() == 0 && "Matchmaker should cancel a waiting ticket once");
+
+	// a full pool leaves players waiting until a slot is free
+	matchmaker.enqueue(8, 1200, 20, 11000.0);
+	matchmaker.enqueue(9, 1200, 20, 11000.0);
+	assert(matchmaker.pollMatch(result) && pool.getActiveCount() == 4 && "Matchmaker should fill the pool");
+	matchmaker.enqueue(10, 1200, 20, 11000.0);
+	matchmaker.enqueue(11, 1200, 20, 11000.0);
+	assert(!matchmaker.pollMatch(result) && matchmaker.getWaitingCount() == 2 && matchmaker.getSearchesDeferred() > 0 &&
+		"Matchmaker should defer matches while the pool is full");
+	pool.release(result.slot);
+	matchmaker.update(12000.0);
+	assert(matchmaker.pollMatch(result) && result.players[0] + result.players[1] == 21 && "Matchmaker should match once the pool has room");
+
+	// a full queue turns players away
+	Matchmaker small(pool, 2, 0);
+	assert(small.enqueue(1, 0, 0, 0.0) >= 0 && small.enqueue(2, 3000, 0, 0.0) >= 0 && small.enqueue(3, 1500, 0, 0.0) == -1 &&
+		"Matchmaker should turn players away when full");
+
+	// synthetic clients: everyone is accounted for, and every match starts in the pool
+	MatchmakingLoadSettings settings;
+	settings.clientsPerSecond = 500.0;
+	settings.seconds = 20.0;
+	settings.poolCapacity = 1024;
+	settings.queueCapacity = 2048;
+	MatchmakingReport report = MatchmakingLoad::run(settings);
+	assert(report.matches > 4000 && report.matchesStarted == report.matches && report.rejected == 0 && "MatchmakingLoad should match most clients");
+	assert(report.clients == report.matches * 2 + report.cancelled + report.stillWaiting && "MatchmakingLoad should account for every client");
+	assert(report.maxRatingGap <= Matchmaker::MAX_WINDOW && report.operations > report.clients && report.latencyP50Us <= report.latencyMaxUs &&
+		report.waitP50Ms <= report.waitP95Ms && "MatchmakingLoad should report the matches and latencies");
+
+	announceTestCompletion();
+#else
+	announceNotTested("Matchmaker");
+#endif
+}
+
+
+
+void TestSuite::testLatencyStatsClass()
+{
+#ifdef LATENCYSTATS
+	announceTest("LatencyStats");
+
+	LatencyStats empty(1, 0, 0);
+	assert(empty.getCount() == 0 && empty.getAverage() == 0.0 && empty.getPercentile(0.95) == 0.0 && empty.getMax() == 0.0 &&
+		"LatencyStats should report 0 with no samples");
+
+	// nearest rank percentiles of 1 ... 100 (added out of order)
+	LatencyStats stats(1, 0, 100);
+	for (int i = 0; i < 100; i++)
+	{
+		stats.add((i * 37) % 100 + 1.0);
+	}
+	assert(stats.getCount() == 100 && stats.getAverage() == 50.5 && stats.getMax() == 100.0 && "LatencyStats wrong average or max");
+	assert(stats.getPercentile(0.5) == 50.0 && stats.getPercentile(0.95) == 95.0 && stats.getPercentile(0.0) == 1.0 &&
+		stats.getPercentile(1.0) == 100.0 && "LatencyStats wrong percentiles");
+	double samples[]{ 4.0, 2.0, 5.0, 1.0, 3.0 };
+	assert(LatencyStats::getPercentile(samples, 5, 0.5) == 3.0 && LatencyStats::getPercentile(samples, 4, 0.99) == 5.0 &&
+		LatencyStats::getPercentile(samples, 0, 0.5) == 0.0 && "LatencyStats.getPercentile() should use the first count samples");
+
+	// input k is simulated at frame k + inputDelay: the first inputDelay frames have no delay, and each player has their own inputs
+	LatencyStats delays(2, 2, 16);
+	delays.inputEntered(0, 0.0);
+	delays.inputEntered(0, 10.0);
+	delays.inputEntered(1, 100.0);
+	delays.frameSimulated(0, 0, 5.0);
+	delays.frameSimulated(0, 1, 5.0);
+	assert(delays.getCount() == 0 && "LatencyStats frames before the input delay shouldn't have a delay");
+	delays.frameSimulated(0, 2, 30.0);
+	delays.frameSimulated(0, 3, 45.0);
+	delays.frameSimulated(1, 2, 150.0);
+	assert(delays.getCount() == 3 && delays.getPercentile(0.0) == 30.0 && delays.getPercentile(0.5) == 35.0 && delays.getMax() == 50.0 &&
+		"LatencyStats should measure each input's delay");
+
+	// the ring wraps
+	LatencyStats ring(1, 0, 1);
+	for (int input = 0; input <= LatencyStats::DELAY_RING; input++)
+	{
+		ring.inputEntered(0, input * 1.0);
+	}
+	ring.frameSimulated(0, LatencyStats::DELAY_RING, LatencyStats::DELAY_RING + 7.0);
+	assert(ring.getMax() == 7.0 && "LatencyStats should wrap its ring of inputs");
+
+	announceTestCompletion();
+#else
+	announceNotTested("LatencyStats");
+#endif
+}
@@ -6,8 +6,44 @@
 #define TETROMINO
 #define GAMEBOARD
 #define GRIDTETROMINO
+#define PLACEMENTGENERATOR
+#define HEADLESSGAME
+#define BOARDEVALUATOR
+#define WEIGHTTUNER
+#define PERFT
+#define HINTWORKER
+#define ROLLOUTEVALUATOR
+#define FINESSEANALYZER
+#define BOARDRASTERIZER
+#define FRAMEPROFILER
+#define FRAMEPACER
+#define TERMINALRENDERER
+#define TERMINALGAME
+#define TERMINALINPUT
+#define SPSCQUEUE
+#define TRIPLEBUFFER
+#define LINECLEARANIMATOR
+#define HUDTEXT
+#define BOARDWALL
+#define LOCKSTEPGAME
+#define LOCKSTEPPEER
+#define WORKERPOOL
+#define MATCHPOOL
+#define BOARDCODEC
+#define SPECTATORFEED
+#define GARBAGEEXCHANGE
+#define TOURNAMENT
+#define NETWORKIMPAIRMENT
+#define ROLLBACKPEER
+#define MATCHMAKER
+#define LATENCYSTATS
 
 #include <string>
+#include <vector>
+
+class Gameboard;
+class LockstepGame;
+enum class TetShape;
 
 class TestSuite {
 
@@ -17,6 +53,48 @@ private:
 	static void testTetrominoClass();	// tests for the Tetromino class
 	static void testGameboardClass();
 	static void testGridTetrominoClass(); // tests for the GridTetromino class
+	static void testPlacementGeneratorClass();	// tests for the PlacementGenerator class
+	static void testHeadlessGameClass();		// tests for the HeadlessGame class
+	static void testBoardEvaluatorClass();		// tests for the BoardEvaluator class
+	static void testWeightTunerClass();			// tests for the WeightTuner class (checkpoint save and resume)
+	static void testPerftClass();				// known-good placement counts (move generation oracle)
+	static void testHintWorkerClass();			// tests for the HintWorker class
+	static void testRolloutEvaluatorClass();	// tests for the RolloutEvaluator class
+	static void testFinesseAnalyzerClass();		// tests for the FinesseAnalyzer class
+	static void testBoardRasterizerClass();		// pixel-exact tests for the BoardRasterizer and RgbaImage classes
+	static void testFrameProfilerClass();		// tests for the FrameProfiler class
+	static void testFramePacerClass();			// tests for the FramePacer class
+	static void testTerminalRendererClass();	// tests for the TerminalRenderer class
+	static void testTerminalGameClass();		// tests for the TerminalGame class
+	static void testTerminalInputClass();		// tests for the TerminalInput class (key sequences split across reads)
+	static void testSpscQueueClass();			// tests for the SpscQueue class (with a producer thread)
+	static void testTripleBufferClass();		// tests for the TripleBuffer class (with a writer thread)
+	static void testLineClearAnimatorClass();	// tests for the LineClearAnimator class
+	static void testHudTextClass();				// tests for the HudText class
+	static void testBoardWallClass();			// tests for the BoardWall class
+	static void testLockstepGameClass();		// determinism tests for the LockstepGame class
+	static void testLockstepPeerClass();		// tests for the LockstepPeer class (two peers connected in memory)
+	static void testWorkerPoolClass();			// tests for the WorkerPool class
+	static void testMatchPoolClass();			// tests for the MatchPool class
+	static void testBoardCodecClass();			// round trip tests for the BoardCodec class
+	static void testSpectatorFeedClass();		// tests for the SpectatorFeed and SpectatorView classes
+	static void testGarbageExchangeClass();		// tests for garbage (Gameboard, LockstepGame, GarbageExchange with a sender thread, MatchPool)
+	static void testTournamentClass();			// tests for the Tournament class (scheduling, ratings, replays)
+	static void testNetworkImpairmentClass();	// tests for the NetworkImpairment class
+	static void testRollbackPeerClass();		// tests for the RollbackPeer class (two peers over lossy links)
+	static void testMatchmakerClass();			// tests for the Matchmaker class (and a short MatchmakingLoad run)
+	static void testLatencyStatsClass();		// tests for the LatencyStats class
+
+	// a brute force placement enumerator for the perft tests, written separately from PlacementGenerator
+	// and Perft: every (rotation, x, y) is tried, and kept if it's resting and the spawn, rotations,
+	// slide and drop leading to it are all legal.  grid is MAX_Y rows of MAX_X cells (non-zero = filled).
+	static unsigned long long bruteForcePerft(const Gameboard& board, const std::vector<TetShape>& sequence, int depth);
+	static unsigned long long bruteForcePerftFrom(const std::vector<int>& grid, const std::vector<TetShape>& sequence, int ply, int depth);
+
+	// a multi-row clear for the versus tests: a seed whose first shape, hard dropped, can complete 2+
+	// rows, and the blocks that complete them (leaving the columns the shape falls through empty)
+	static unsigned int findMultiRowClearSeed();
+	static int fillForFirstDrop(unsigned int seed, LockstepGame& game);
 
 	static void announceTest(const std::string& className);
 	static void announceTestCompletion();
@@ -1,16 +1,84 @@
 #include "TetrisGame.h"
+#include "PlacementGenerator.h"
+#include <cmath>
 
 	// initializing static constants 
 	const int TetrisGame::BLOCK_WIDTH{ 32 };
 	const int TetrisGame::BLOCK_HEIGHT{ 32 };
 	const double TetrisGame::MAX_SECONDS_PER_TICK{ 0.75 };
 	const double TetrisGame::MIN_SECONDS_PER_TICK { 0.20 };
+	const sf::Uint8 TetrisGame::HINT_ALPHA{ 80 };
+	const double TetrisGame::AUTOPLAY_SECONDS_PER_INPUT{ 0.08 };
+	const int TetrisGame::MAX_BATCHED_BLOCKS{ Gameboard::MAX_X * Gameboard::MAX_Y + 3 * 4 + LineClearAnimator::MAX_EFFECTS +
+		HUD_FIELD_COUNT * HudText::CAPACITY };
+	const int TetrisGame::LINES_PER_LEVEL{ 10 };
 
 	void TetrisGame::draw() {
+		captureSnapshot(frameSnapshot);
+		drawSnapshot(frameSnapshot);
+	}
+
+	void TetrisGame::captureSnapshot(RenderSnapshot& snapshot) const {
+		// only the cells that changed since this snapshot was last filled are written
+		snapshot.board.copyChangedCells(board);
+		snapshot.currentShape = currentShape;
+		snapshot.nextShape = nextShape;
+		snapshot.score = score;
+		snapshot.linesCleared = linesCleared;
+		snapshot.piecesPlaced = piecesPlaced;
+		snapshot.gameSeconds = gameSeconds;
+		snapshot.shapeSerial = shapeSerial;
+		snapshot.showHint = showHint;
+		snapshot.clearedRows = clearedRows;
+		snapshot.clearSerial = clearSerial;
+		snapshot.inputCount = inputCount;
+		snapshot.lastInputReceived = lastInputReceived;
+	}
+
+	void TetrisGame::drawSnapshot(const RenderSnapshot& snapshot) {
+		if (renderBoard.copyChangedCells(snapshot.board) > 0)
+		{
+			stackDirty = true;
+		}
+		updateHud(snapshot);
+		if (snapshot.clearSerial != animatedClearSerial)
+		{
+			animatedClearSerial = snapshot.clearSerial;
+			lineClears.start(snapshot.clearedRows);
+		}
 		drawGameboard();
-		drawTetromino(currentShape, gameboardOffset);
-		drawTetromino(nextShape, nextShapeOffset);
-		window.draw(scoreText);
+		drawHint(snapshot);
+		drawTetromino(snapshot.currentShape, gameboardOffset);
+		drawTetromino(snapshot.nextShape, nextShapeOffset);
+		drawLineClears();
+		drawHud();
+		flushBlocks(window);
+	}
+
+	void TetrisGame::animate(float secondsSinceLastFrame) {
+		lineClears.update(secondsSinceLastFrame);
+	}
+
+	void TetrisGame::setBatchedRendering(bool batched) {
+		batchedRendering = batched;
+	}
+
+	bool TetrisGame::isBatchedRendering() const {
+		return batchedRendering;
+	}
+
+	void TetrisGame::setStackRendering(StackRendering rendering) {
+		stackRendering = rendering;
+		// the board may have changed while the other mode was drawing it
+		stackDirty = true;
+		if (stackRendering == StackRendering::VERTEX_BUFFER)
+		{
+			boardMesh.rebuild(renderBoard);
+		}
+	}
+
+	StackRendering TetrisGame::getStackRendering() const {
+		return stackRendering;
 	}
 
 	void TetrisGame::onKeyPressed(sf::Event& event) {
@@ -21,26 +89,44 @@
 			case sf::Keyboard::Right: attemptMove(currentShape, 1, 0); break;
 			case sf::Keyboard::Down: attemptMove(currentShape, 0, 1); break;
 			case sf::Keyboard::Space: drop(currentShape); lock(currentShape); break;
+			case sf::Keyboard::H: showHint = !showHint; requestHint(); break;
+			case sf::Keyboard::A: autoplay = !autoplay; autoplaySerial = 0; requestHint(); break;
 		}
 	}
 
+	void TetrisGame::onKeyPressed(sf::Event& event, std::chrono::steady_clock::time_point received) {
+		onKeyPressed(event);
+		inputCount++;
+		lastInputReceived = received;
+	}
+
 	void TetrisGame::processGameLoop(float secondsSinceLastLoop) {
+		gameSeconds += secondsSinceLastLoop;
 		// once a shape has been placed
 		if (shapePlacedSinceLastGameLoop) {
 			if (spawnNextShape())
 			{
 				pickNextShape();
-				int completedRows = board.removeCompletedRows();
+				int completedRows = board.removeCompletedRows(&clearedRows);
+				if (completedRows > 0)
+				{
+					clearSerial++;
+				}
 				// 100 points for each completed row
 				score += (completedRows * 100);
-				updateScoreDisplay();
+				linesCleared += completedRows;
 				determineSecondsPerTick();
+				requestHint();
 			}
 			else  {
 				reset();
 			}
 			shapePlacedSinceLastGameLoop = false;
 		}
+		if (autoplay)
+		{
+			processAutoplay(secondsSinceLastLoop);
+		}
 		secondsSinceLastTick += secondsSinceLastLoop;
 		if (secondsSinceLastTick > TetrisGame::secondsPerTick)
 		{
@@ -60,7 +146,9 @@
 
 	void TetrisGame::reset() {
 		score = 0;
-		updateScoreDisplay();
+		linesCleared = 0;
+		piecesPlaced = 0;
+		gameSeconds = 0.0;
 		determineSecondsPerTick();
 		board.empty();
 		pickNextShape();
@@ -73,6 +161,7 @@
 			spawnNextShape();
 		}
 		pickNextShape();
+		requestHint();
 	}
 
 	void TetrisGame::pickNextShape() {
@@ -82,6 +171,7 @@
 	bool TetrisGame::spawnNextShape() {
 		currentShape = nextShape;
 		currentShape.setGridLoc(board.getSpawnLoc());
+		shapeSerial++;
 		return isPositionLegal(currentShape);
 	}
 
@@ -124,44 +214,264 @@
 			board.setContent(pt, static_cast<int>(shape.getColor()));
 		}
 		shapePlacedSinceLastGameLoop = true;		// shape is placed
+		piecesPlaced++;
+	}
+
+	void TetrisGame::requestHint() {
+		if (showHint || autoplay)
+		{
+			hintWorker.requestHint(board, currentShape.getShape(), shapeSerial);
+		}
+	}
+
+	void TetrisGame::processAutoplay(float secondsSinceLastLoop) {
+		// plan the keys once the hint for this shape is ready
+		if (autoplaySerial != shapeSerial)
+		{
+			Placement hint;
+			if (!hintWorker.tryGetHint(shapeSerial, hint))
+			{
+				return;
+			}
+			if (!finesse.findInputs(board, currentShape.getShape(), hint, autoplayInputs))
+			{
+				autoplayInputs.assign(1, FinesseInput::HARD_DROP);
+			}
+			nextAutoplayInput = 0;
+			autoplaySerial = shapeSerial;
+			secondsSinceLastInput = 0.0;
+		}
+
+		secondsSinceLastInput += secondsSinceLastLoop;
+		if (nextAutoplayInput < autoplayInputs.size() && secondsSinceLastInput >= AUTOPLAY_SECONDS_PER_INPUT)
+		{
+			secondsSinceLastInput = 0.0;
+			pressInput(autoplayInputs[nextAutoplayInput++]);
+		}
 	}
 
-	void TetrisGame::drawBlock(const Point& topLeft, int xOffset, int yOffset, TetColor colour) {
+	void TetrisGame::pressInput(FinesseInput input) {
+		sf::Event event;
+		event.type = sf::Event::KeyPressed;
+		switch (input)
+		{
+			case FinesseInput::LEFT: case FinesseInput::DAS_LEFT: event.key.code = sf::Keyboard::Left; break;
+			case FinesseInput::RIGHT: case FinesseInput::DAS_RIGHT: event.key.code = sf::Keyboard::Right; break;
+			case FinesseInput::ROTATE: event.key.code = sf::Keyboard::Up; break;
+			case FinesseInput::SOFT_DROP: event.key.code = sf::Keyboard::Down; break;
+			default: event.key.code = sf::Keyboard::Space; break;
+		}
+
+		if (input == FinesseInput::DAS_LEFT || input == FinesseInput::DAS_RIGHT)
+		{
+			// hold the key: repeat until the shape stops moving
+			Point before;
+			do
+			{
+				before = currentShape.getGridLoc();
+				onKeyPressed(event);
+			} while (currentShape.getGridLoc().getX() != before.getX());
+		}
+		else {
+			onKeyPressed(event);
+		}
+	}
+
+	void TetrisGame::drawBlock(const Point& topLeft, int xOffset, int yOffset, TetColor colour, sf::Uint8 alpha) {
 		float xPixelOffset = static_cast<float>(xOffset * BLOCK_WIDTH);
 		float yPixelOffset = static_cast<float>(yOffset * BLOCK_HEIGHT);
 		// casts Tetcolor to an int, is multiplied by the width of the block to determine its position
 		int xTilePixelOffset = static_cast<int>(colour) * BLOCK_WIDTH;
+
+		if (batchedRendering)
+		{
+			addBlockQuad(topLeft, xOffset, yOffset, colour, alpha);
+			return;
+		}
+
 		blockSprite.setTextureRect(sf::IntRect(xTilePixelOffset, 0, BLOCK_WIDTH, BLOCK_HEIGHT));
 		blockSprite.setPosition(topLeft.getX() + xPixelOffset, topLeft.getY() + yPixelOffset);
+		blockSprite.setColor(sf::Color(255, 255, 255, alpha));
 		window.draw(blockSprite);
 	}
 
+	void TetrisGame::addBlockQuad(const Point& topLeft, int xOffset, int yOffset, TetColor colour, sf::Uint8 alpha) {
+		float left = static_cast<float>(topLeft.getX() + xOffset * BLOCK_WIDTH);
+		float top = static_cast<float>(topLeft.getY() + yOffset * BLOCK_HEIGHT);
+		addQuad(left, top, static_cast<float>(BLOCK_WIDTH), static_cast<float>(BLOCK_HEIGHT), colour, alpha);
+	}
+
+	void TetrisGame::addQuad(float left, float top, float width, float height, TetColor colour, sf::Uint8 alpha) {
+		float tileLeft = static_cast<float>(static_cast<int>(colour) * BLOCK_WIDTH);
+		addTexturedQuad(sf::FloatRect(left, top, width, height),
+			sf::FloatRect(tileLeft, 0.f, static_cast<float>(BLOCK_WIDTH), static_cast<float>(BLOCK_HEIGHT)), sf::Color(255, 255, 255, alpha));
+	}
+
+	void TetrisGame::addTexturedQuad(const sf::FloatRect& bounds, const sf::FloatRect& textureRect, sf::Color tint) {
+		if (blockVertexCount + 4 > blockVertices.getVertexCount())
+		{
+			return;
+		}
+		float right = bounds.left + bounds.width;
+		float bottom = bounds.top + bounds.height;
+		float textureRight = textureRect.left + textureRect.width;
+		float textureBottom = textureRect.top + textureRect.height;
+		sf::Vertex* quad = &blockVertices[blockVertexCount];
+		quad[0] = sf::Vertex(sf::Vector2f(bounds.left, bounds.top), tint, sf::Vector2f(textureRect.left, textureRect.top));
+		quad[1] = sf::Vertex(sf::Vector2f(right, bounds.top), tint, sf::Vector2f(textureRight, textureRect.top));
+		quad[2] = sf::Vertex(sf::Vector2f(right, bottom), tint, sf::Vector2f(textureRight, textureBottom));
+		quad[3] = sf::Vertex(sf::Vector2f(bounds.left, bottom), tint, sf::Vector2f(textureRect.left, textureBottom));
+		blockVertexCount += 4;
+	}
+
+	void TetrisGame::flushBlocks(sf::RenderTarget& target) {
+		if (blockVertexCount > 0)
+		{
+			sf::RenderStates states;
+			states.texture = blockSprite.getTexture();
+			target.draw(&blockVertices[0], blockVertexCount, sf::Quads, states);
+		}
+		blockVertexCount = 0;
+	}
+
 	void TetrisGame::drawGameboard() {
+		switch (stackRendering)
+		{
+			case StackRendering::REDRAWN:
+				drawLockedBlocks(gameboardOffset);
+				break;
+			case StackRendering::RENDER_TEXTURE:
+				if (stackDirty)
+				{
+					rebuildStackLayer();
+				}
+				window.draw(stackSprite);
+				break;
+			default:
+				boardMesh.update(renderBoard);
+				window.draw(boardMesh);
+				break;
+		}
+	}
+
+	void TetrisGame::drawLockedBlocks(const Point& topLeft) {
 		for (int x { 0 }; x < Gameboard::MAX_X; x++)
 		{
 			for (int y { 0 }; y < Gameboard::MAX_Y; y++)
 			{
 				// if the grid at this point is not empty
-				if (board.getContent(x, y) != Gameboard::EMPTY_BLOCK)
+				int content = renderBoard.getContent(x, y);
+				if (content != Gameboard::EMPTY_BLOCK)
 				{
 					// draw a block
-					drawBlock(gameboardOffset, x, y, static_cast<TetColor>(board.getContent(x, y)));
+					drawBlock(topLeft, x, y, static_cast<TetColor>(content));
+				}
+			}
+		}
+	}
+
+	void TetrisGame::rebuildStackLayer() {
+		// the batch is drawn to the window at the end of draw(), so it's always empty here
+		stackLayer.clear(sf::Color::Transparent);
+		for (int x{ 0 }; x < Gameboard::MAX_X; x++)
+		{
+			for (int y{ 0 }; y < Gameboard::MAX_Y; y++)
+			{
+				int content = renderBoard.getContent(x, y);
+				if (content != Gameboard::EMPTY_BLOCK)
+				{
+					addBlockQuad(Point(0, 0), x, y, static_cast<TetColor>(content), 255);
 				}
 			}
 		}
+		flushBlocks(stackLayer);
+		stackLayer.display();
+		stackDirty = false;
 	}
 
-	void TetrisGame::drawTetromino(GridTetromino& tetromino, const Point& topLeft) {
+	void TetrisGame::drawTetromino(const GridTetromino& tetromino, const Point& topLeft, sf::Uint8 alpha) {
 		std::vector<Point> mappedPoints = tetromino.getBlockLocsMappedToGrid();
 		for (auto& mappedLoc : mappedPoints)
 		{
-			drawBlock(topLeft, mappedLoc.getX(), mappedLoc.getY(), tetromino.getColor());
+			drawBlock(topLeft, mappedLoc.getX(), mappedLoc.getY(), tetromino.getColor(), alpha);
 		}
 	}
 
-	void TetrisGame::updateScoreDisplay() {
-		std::string scoreString = "score: " + std::to_string(score);
-		scoreText.setString(scoreString);
+	void TetrisGame::drawHint(const RenderSnapshot& snapshot) {
+		Placement hint;
+		// a hint for an older shape has a different serial, and is never returned
+		if (snapshot.showHint && hintWorker.tryGetHint(snapshot.shapeSerial, hint))
+		{
+			GridTetromino hintShape;
+			PlacementGenerator::placeShape(hintShape, snapshot.currentShape.getShape(), hint);
+			drawTetromino(hintShape, gameboardOffset, HINT_ALPHA);
+		}
+	}
+
+	void TetrisGame::drawLineClears() {
+		for (const EffectQuad& effect : lineClears.buildQuads())
+		{
+			addQuad(gameboardOffset.getX() + effect.x * BLOCK_WIDTH, gameboardOffset.getY() + effect.y * BLOCK_HEIGHT,
+				effect.width * BLOCK_WIDTH, effect.height * BLOCK_HEIGHT, static_cast<TetColor>(effect.colour), effect.alpha);
+		}
+	}
+
+	void TetrisGame::updateHud(const RenderSnapshot& snapshot) {
+		static const char* const LABELS[HUD_FIELD_COUNT]{ "score: ", "level: ", "lines: ", "pps: ", "time: " };
+		// pieces/sec is shown to 2 decimals, so it's compared in hundredths
+		long long piecesPerSecondX100 = snapshot.gameSeconds > 0.0 ?
+			std::llround(snapshot.piecesPlaced * 100 / snapshot.gameSeconds) : 0;
+		long long values[HUD_FIELD_COUNT]{
+			snapshot.score,
+			1 + snapshot.linesCleared / LINES_PER_LEVEL,
+			snapshot.linesCleared,
+			piecesPerSecondX100,
+			static_cast<long long>(snapshot.gameSeconds)
+		};
+		for (int field{ 0 }; field < HUD_FIELD_COUNT; field++)
+		{
+			if (values[field] == hudValues[field])
+			{
+				continue;
+			}
+			hudValues[field] = values[field];
+			HudText& line = hudLines[field];
+			line.clear();
+			line.append(LABELS[field]);
+			switch (static_cast<HudField>(field))
+			{
+				case HudField::PPS: line.appendFixed(values[field] / 100.0, 2); break;
+				case HudField::TIME: line.appendTime(snapshot.gameSeconds); break;
+				default: line.appendInt(values[field]); break;
+			}
+		}
+	}
+
+	void TetrisGame::drawHud() {
+		float left = static_cast<float>(hudOffset.getX());
+		for (int field{ 0 }; field < HUD_FIELD_COUNT; field++)
+		{
+			float baseline = hudOffset.getY() + glyphs.getLineSpacing() * (field + 1);
+			addText(hudLines[field], left, baseline);
+		}
+	}
+
+	void TetrisGame::addText(const HudText& text, float left, float baseline) {
+		const char* chars = text.getChars();
+		for (int i{ 0 }; i < text.getLength(); i++)
+		{
+			const AtlasGlyph& glyph = glyphs.getGlyph(chars[i]);
+			if (!glyph.present)
+			{
+				continue;
+			}
+			if (glyph.bounds.width > 0.f)
+			{
+				sf::FloatRect bounds(left + glyph.bounds.left, baseline + glyph.bounds.top, glyph.bounds.width, glyph.bounds.height);
+				addTexturedQuad(bounds, glyph.textureRect, sf::Color::White);
+			}
+			left += glyph.advance;
+		}
 	}
 
 	bool TetrisGame::isPositionLegal(const GridTetromino& shape) const { 
@@ -17,11 +17,26 @@
 #ifndef TETRISGAME_H
 #define TETRISGAME_H
 
+#include "BoardMesh.h"
+#include "FinesseAnalyzer.h"
 #include "Gameboard.h"
+#include "GlyphAtlas.h"
 #include "GridTetromino.h"
+#include "HintWorker.h"
+#include "HudText.h"
+#include "LineClearAnimator.h"
+#include "RenderSnapshot.h"
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
 
 
+// how the locked blocks are drawn (switchable, so the frame times can be compared)
+enum class StackRendering { REDRAWN, RENDER_TEXTURE, VERTEX_BUFFER, COUNT };
+
+// the lines of the HUD, top to bottom
+enum class HudField { SCORE, LEVEL, LINES, PPS, TIME, COUNT };
+
 class TetrisGame
 {
 public:
@@ -30,6 +45,11 @@ public:
 	static const int BLOCK_HEIGHT;					// pixel height of a tetris block, init to 32
 	static const double MAX_SECONDS_PER_TICK;		// the slowest "tick" rate (in seconds), init to 0.75
 	static const double MIN_SECONDS_PER_TICK;		// the fastest "tick" rate (in seconds), init to 0.20
+	static const sf::Uint8 HINT_ALPHA;				// opacity of the best placement hint, init to 80
+	static const double AUTOPLAY_SECONDS_PER_INPUT;	// how often the autoplayer presses a key, init to 0.08
+	static const int HUD_FIELD_COUNT = static_cast<int>(HudField::COUNT);
+	static const int MAX_BATCHED_BLOCKS;			// quads the vertex batch can hold (a full board + 3 tetrominoes + the line clear effects + the HUD text)
+	static const int LINES_PER_LEVEL;				// lines cleared to go up a level (shown in the HUD), init to 10
 
 private:	
 	// MEMBER VARIABLES
@@ -39,6 +59,11 @@ private:
     Gameboard board;								// the gameboard (grid) to represent where all the blocks are.
     GridTetromino nextShape;						// the tetromino shape that is "on deck".
     GridTetromino currentShape;						// the tetromino that is currently falling.
+	Gameboard::ClearedRows clearedRows;				// the rows removed by the latest line clear
+	unsigned int clearSerial{ 0 };					// incremented every line clear
+	int linesCleared{ 0 };							// lines cleared this game
+	int piecesPlaced{ 0 };							// shapes locked this game
+	double gameSeconds{ 0.0 };						// time simulated this game
 	
 	// Graphics members ------------------------------------------
 	sf::Sprite& blockSprite;						// the sprite used for all the blocks.
@@ -46,8 +71,25 @@ private:
 	const Point gameboardOffset{ 0, 0 };			// pixel XY offset of the gameboard on the screen
 	const Point nextShapeOffset{ 0, 0 };			// pixel XY offset to the nextShape
 
-	sf::Font scoreFont;								// SFML font for displaying the score.
-	sf::Text scoreText;								// SFML text object for displaying the score
+	sf::VertexArray blockVertices{ sf::Quads };		// one quad per block, filled every frame and drawn with a single draw call
+	size_t blockVertexCount{ 0 };					// # of vertices used in blockVertices this frame
+	bool batchedRendering{ true };					// false = the original one draw call per block (for comparison)
+
+	StackRendering stackRendering{ StackRendering::VERTEX_BUFFER };	// how the locked blocks are drawn
+	sf::RenderTexture stackLayer;					// RENDER_TEXTURE: the locked blocks, drawn off-screen and reused until they change
+	sf::Sprite stackSprite;							// RENDER_TEXTURE: draws the stackLayer at the gameboardOffset
+	bool stackDirty{ true };						// RENDER_TEXTURE: set when the renderBoard changes
+	BoardMesh boardMesh;							// VERTEX_BUFFER: the locked blocks' geometry, updated from the renderBoard's dirty cells
+
+	Gameboard renderBoard;							// the locked blocks as last drawn: only the cells that differ from a snapshot are copied in
+	RenderSnapshot frameSnapshot;					// draw(): the snapshot of this game, taken every frame
+	const GlyphAtlas& glyphs;						// the atlas of tiles and HUD glyphs (the blockSprite's texture)
+	const Point hudOffset{ 425, 325 };				// pixel XY offset of the top of the HUD text
+	HudText hudLines[HUD_FIELD_COUNT];				// the HUD text, rebuilt one line at a time when its value changes
+	long long hudValues[HUD_FIELD_COUNT];			// the value each hud line is showing
+	LineClearAnimator lineClears;					// the line clear effects, drawn over the board
+	unsigned int animatedClearSerial{ 0 };			// the clearSerial of the last line clear started
+
 									
 	// Time members ----------------------------------------------
 	// Note: a "tick" is the amount of time it takes a block to fall one line.
@@ -57,6 +99,23 @@ private:
 													// we then know to trigger a tick.  Reduce this var (by a tick) & repeat.
 	bool shapePlacedSinceLastGameLoop{ false };		// Tracks whether we have placed (locked) a shape on
 													// the gameboard in the current gameloop	
+
+	// Hint members ----------------------------------------------
+	HintWorker hintWorker;							// searches for the best placement in the background
+	unsigned int shapeSerial{ 0 };					// incremented every time a shape spawns (so stale hints are ignored)
+	bool showHint{ false };							// toggled with the H key
+
+	// Autoplay members ------------------------------------------
+	bool autoplay{ false };							// toggled with the A key
+	FinesseAnalyzer finesse;						// turns the hint into the keys a player would press
+	std::vector<FinesseInput> autoplayInputs;		// the keys to press for the currentShape
+	size_t nextAutoplayInput{ 0 };					// index of the next key to press
+	unsigned int autoplaySerial{ 0 };				// the shapeSerial the inputs were planned for
+	double secondsSinceLastInput{ 0.0 };			// time since the autoplayer last pressed a key
+
+	// Latency members -------------------------------------------
+	unsigned long long inputCount{ 0 };				// # of received key presses processed
+	std::chrono::steady_clock::time_point lastInputReceived;	// when the newest processed key press was received
 public:
 	// MEMBER FUNCTIONS
 
@@ -64,45 +123,107 @@ public:
 	/// Constructor
 	/// Private member variable names are initialized to parameters which match
 	/// reset() the game
-	/// load font from file: fonts/RedOctober.tff
-	/// setsup score text
+	/// the HUD text is drawn from the glyph atlas (which must also be the blockSprite's texture)
 	/// </summary>
 	/// <param name="window">sf::RenderWindow window</param>
 	/// <param name="blockSprite">sf::Sprite blockSprite</param>
+	/// <param name="glyphs">the atlas the blockSprite's texture comes from</param>
 	/// <param name="gameboardOffset">st::Point gameboardOffset</param>
 	/// <param name="nextShapeOffset">const Point nextShapeOffset</param>
-	TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, const Point& gameboardOffset, const Point& nextShapeOffset)
-		: window{ window }, blockSprite{ blockSprite }, gameboardOffset{ gameboardOffset }, nextShapeOffset{ nextShapeOffset }
+	TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, const GlyphAtlas& glyphs, const Point& gameboardOffset, const Point& nextShapeOffset)
+		: blockSprite{ blockSprite }, window{ window }, gameboardOffset{ gameboardOffset }, nextShapeOffset{ nextShapeOffset },
+		boardMesh{ blockSprite.getTexture(), BLOCK_WIDTH, BLOCK_HEIGHT }, glyphs{ glyphs }
 	{
-		if (!scoreFont.loadFromFile("fonts/RedOctober.ttf"))
+		std::fill(hudValues, hudValues + HUD_FIELD_COUNT, -1);
+		// allocated once, blocks are written into it every frame
+		blockVertices.resize(MAX_BATCHED_BLOCKS * 4);
+		if (!stackLayer.create(Gameboard::MAX_X * BLOCK_WIDTH, Gameboard::MAX_Y * BLOCK_HEIGHT))
 		{
-			assert(false && "Missing font: RedOctober.ttf");
-		};
-		scoreText.setFont(scoreFont);
-		scoreText.setCharacterSize(18);
-		scoreText.setFillColor(sf::Color::White);
-		scoreText.setPosition(425, 325);
+			assert(false && "Unable to create the gameboard render texture");
+		}
+		stackSprite.setTexture(stackLayer.getTexture());
+		stackSprite.setPosition(static_cast<float>(gameboardOffset.getX()), static_cast<float>(gameboardOffset.getY()));
+		boardMesh.setPosition(static_cast<float>(gameboardOffset.getX()), static_cast<float>(gameboardOffset.getY()));
 		reset();
 	}
 
 	/// <summary>
 	/// Draw anything to do with the game,
-	/// including: the board, currentShape, nextShape, and score
-	/// Called every game loop.
+	/// including: the board, currentShape, nextShape, and the HUD (score, level, lines, pieces/sec, time)
+	/// Called every game loop (single threaded): takes a snapshot and draws it with drawSnapshot().
+	/// When batchedRendering is on, every block is added to blockVertices and
+	/// submitted with a single window.draw() against the tiles texture.
 	/// </summary>
 	void draw();								
 
+	/// <summary>
+	/// Copies the state needed to draw a frame into a snapshot (board, shapes, HUD numbers, hint and input count).
+	/// Called on the simulation's thread; the snapshot's tickStats are left for the caller.
+	/// </summary>
+	/// <param name="snapshot">the snapshot to fill (every field but tickStats is written)</param>
+	void captureSnapshot(RenderSnapshot& snapshot) const;
+
+	/// <summary>
+	/// Draws a snapshot of the game.  Only touches the graphics members, so it can run on a
+	/// render thread while the simulation carries on with the next snapshot.
+	/// The cells that changed since the last frame are copied into the renderBoard,
+	/// which marks them dirty for the boardMesh (and the stackLayer).
+	/// </summary>
+	/// <param name="snapshot">the snapshot to draw</param>
+	void drawSnapshot(const RenderSnapshot& snapshot);
+
+	/// <summary>
+	/// Advances the line clear effects (render side, called once per frame).
+	/// </summary>
+	/// <param name="secondsSinceLastFrame">the frame delta (0 while paused)</param>
+	void animate(float secondsSinceLastFrame);
+
+	/// <summary>
+	/// Switches between the batched renderer and the original one-draw-per-block renderer
+	/// (so their frame times can be compared).
+	/// </summary>
+	/// <param name="batched">true for the batched renderer</param>
+	void setBatchedRendering(bool batched);
+
+	/// <summary>
+	/// Gets whether the batched renderer is being used.
+	/// </summary>
+	bool isBatchedRendering() const;
+
+	/// <summary>
+	/// Chooses how the locked blocks are drawn (so their frame times can be compared):
+	///		REDRAWN:		every locked block is drawn every frame
+	///		RENDER_TEXTURE:	the cached stackLayer is drawn, and rebuilt when the stack changes
+	///		VERTEX_BUFFER:	the boardMesh is drawn, re-uploading only the board's dirty cells
+	/// </summary>
+	/// <param name="rendering">how to draw the locked blocks</param>
+	void setStackRendering(StackRendering rendering);
+
+	/// <summary>
+	/// Gets how the locked blocks are being drawn.
+	/// </summary>
+	StackRendering getStackRendering() const;
+
 	/// <summary>
 	/// Event and game loop processing
 	/// handles keypress events (up, left, right, down, space)
+	/// H toggles the best placement hint, A toggles the autoplayer
 	/// </summary>
 	/// <param name="event">sf::Event event</param>
 	void onKeyPressed(sf::Event& event);
 
+	/// <summary>
+	/// Handles a key press from the player, and records when it was received
+	/// (carried in the next snapshot, to measure input latency).
+	/// </summary>
+	/// <param name="event">sf::Event event</param>
+	/// <param name="received">when the event was polled from the window</param>
+	void onKeyPressed(sf::Event& event, std::chrono::steady_clock::time_point received);
+
 	/// <summary>
 	/// Called every game loop to handle ticks and tetromino placement (locking)
 	/// If a new shape is spawned, picks a new shape, removes completed rows,
-	/// sets and updates the score. If it fails the game is reset.
+	/// and sets the score and line count. If it fails the game is reset.
 	/// </summary>
 	/// <param name="secondsSinceLastLoop">a float representing seconds since the game last operated</param>
 	void processGameLoop(float secondsSinceLastLoop);
@@ -118,7 +239,7 @@ public:
 private:
 	/// <summary>
 	/// Resets everything for a new game (using existing functions)
-	///		- the score is set to 0, and updateScoreDisplay() is used to update display
+	///		- the score, lines, pieces and time are set to 0 (the HUD catches up in drawSnapshot())
 	///		- determineSecondsPerTick() is used to determine the tick rate
 	///		- the gameboard is cleared
 	///		- next shape is picked and spawned
@@ -134,6 +255,7 @@ private:
 	/// <summary>
 	/// Copies the nextShape into the currentShape (through assignment)
 	/// Position the currentShape to its spawn location.
+	/// Increments shapeSerial, so any hint for the previous shape becomes stale.
 	/// </summary>
 	/// <returns>true or false based on isPositionLegal()</returns>
 	bool spawnNextShape();																	
@@ -175,9 +297,31 @@ private:
 	///		1) get the tetromino's mapped locs via tetromino.getBlockLocsMappedToGrid()
 	///		2) use the board's setContent() method to set the content at the mapped locations
 	///		3) record the fact that we placed a shape by setting shapePlacedSinceLastGameLoop to true
+	///		4) count the piece (for the HUD's pieces/sec)
 	/// </summary>
 	/// <param name="shape">GridTetromino shape</param>
 	void lock(const GridTetromino& shape);
+
+	/// <summary>
+	/// Asks the hint worker for the best placement of the currentShape (if the hint is showing, or autoplay is on).
+	/// Called once the board has settled after a spawn (ie. completed rows have been removed).
+	/// </summary>
+	void requestHint();
+
+	/// <summary>
+	/// Called every game loop while autoplay is on.
+	/// Once the hint for the currentShape is ready, the FinesseAnalyzer plans the shortest key sequence to it,
+	/// and one key is pressed every AUTOPLAY_SECONDS_PER_INPUT (through onKeyPressed(), like a player).
+	/// </summary>
+	/// <param name="secondsSinceLastLoop">a float representing seconds since the game last operated</param>
+	void processAutoplay(float secondsSinceLastLoop);
+
+	/// <summary>
+	/// Presses the key(s) for a finesse input.
+	/// DAS inputs keep pressing the key until the shape stops moving.
+	/// </summary>
+	/// <param name="input">the input to press</param>
+	void pressInput(FinesseInput input);
 	
 	// Graphics methods ==============================================
 
@@ -190,20 +334,74 @@ private:
 	/// 2) set the block colour using blockSprite.setTextureRect()
 	/// 3) set the block location using blockSprite.setPosition()
 	/// 4) draw the block using window.draw()
+	/// When batchedRendering is on, steps 2-4 are replaced by adding a quad to blockVertices
+	/// (with the same position and texture rect), which is drawn by flushBlocks().
+	/// </summary>
+	/// <param name="topLeft">Point topLeft</param>
+	/// <param name="xOffset">int xOffset</param>
+	/// <param name="yOffset">int yOffset</param>
+	/// <param name="color">TetColor colour</param>
+	/// <param name="alpha">the opacity of the block (255 is opaque)</param>
+	void drawBlock(const Point& topLeft, int xOffset, int yOffset, TetColor colour, sf::Uint8 alpha = 255);
+
+	/// <summary>
+	/// Adds a block to blockVertices as a quad (same position and texture rect as drawBlock()).
+	/// Blocks that don't fit in the batch are dropped.
 	/// </summary>
 	/// <param name="topLeft">Point topLeft</param>
 	/// <param name="xOffset">int xOffset</param>
 	/// <param name="yOffset">int yOffset</param>
 	/// <param name="color">TetColor colour</param>
-	void drawBlock(const Point& topLeft, int xOffset, int yOffset, TetColor colour);
+	/// <param name="alpha">the opacity of the block (255 is opaque)</param>
+	void addBlockQuad(const Point& topLeft, int xOffset, int yOffset, TetColor colour, sf::Uint8 alpha);
+
+	/// <summary>
+	/// Adds a quad textured with a whole tile to blockVertices (any size, ie. a shrinking or particle block).
+	/// Quads that don't fit in the batch are dropped.
+	/// </summary>
+	/// <param name="left">pixel x</param>
+	/// <param name="top">pixel y</param>
+	/// <param name="width">pixel width</param>
+	/// <param name="height">pixel height</param>
+	/// <param name="colour">TetColor colour</param>
+	/// <param name="alpha">the opacity of the quad (255 is opaque)</param>
+	void addQuad(float left, float top, float width, float height, TetColor colour, sf::Uint8 alpha);
+
+	/// <summary>
+	/// Adds a quad with any part of the atlas to blockVertices (ie. a glyph).
+	/// Quads that don't fit in the batch are dropped.
+	/// </summary>
+	/// <param name="bounds">pixel position and size</param>
+	/// <param name="textureRect">the part of the atlas texture</param>
+	/// <param name="tint">the vertex colour</param>
+	void addTexturedQuad(const sf::FloatRect& bounds, const sf::FloatRect& textureRect, sf::Color tint);
+
+	/// <summary>
+	/// Draws the blocks batched in blockVertices onto a target with a single draw call, then empties the batch.
+	/// </summary>
+	/// <param name="target">the window or render texture to draw on</param>
+	void flushBlocks(sf::RenderTarget& target);
 										
 	/// <summary>
-	/// Draw the gameboard blocks on the window.
-	/// Iterate through each row & col,
-	/// using drawBlock() to draw a block if it isn't empty.
+	/// Draw the gameboard blocks on the window, depending on the stackRendering:
+	///		REDRAWN:		every locked block is drawn (see drawLockedBlocks())
+	///		RENDER_TEXTURE:	the stackLayer is rebuilt if it's dirty and then drawn as a single sprite
+	///		VERTEX_BUFFER:	the boardMesh is updated from the renderBoard's dirty cells and drawn with one draw call
 	/// </summary>
 	void drawGameboard();
 
+	/// <summary>
+	/// Iterate through each row & col of the renderBoard,
+	/// using drawBlock() to draw a block if it isn't empty.
+	/// </summary>
+	/// <param name="topLeft">the pixel offset of the gameboard</param>
+	void drawLockedBlocks(const Point& topLeft);
+
+	/// <summary>
+	/// Redraws the locked blocks into the stackLayer (one batched draw call) and clears stackDirty.
+	/// </summary>
+	void rebuildStackLayer();
+
 	/// <summary>
 	/// Draw a tetromino on the window
 	///		Iterate through each mapped loc and drawBlock() for each
@@ -212,14 +410,40 @@ private:
 	/// </summary>
 	/// <param name="tetromino">GridTetromino tetromino</param>
 	/// <param name="topLeft">Point topLeft</param>
-	void drawTetromino(GridTetromino& tetromino, const Point& topLeft);
+	/// <param name="alpha">the opacity of the blocks (255 is opaque)</param>
+	void drawTetromino(const GridTetromino& tetromino, const Point& topLeft, sf::Uint8 alpha = 255);
+
+	/// <summary>
+	/// Draws the best placement hint as a translucent tetromino, if the hint is showing and
+	/// the worker has published a hint for the snapshot's currentShape.  Never waits for the worker.
+	/// </summary>
+	/// <param name="snapshot">the snapshot being drawn</param>
+	void drawHint(const RenderSnapshot& snapshot);
+
+	/// <summary>
+	/// Adds the line clear effects to the batch (see LineClearAnimator).
+	/// </summary>
+	void drawLineClears();
+
+	/// <summary>
+	/// Update the HUD text from a snapshot: a line is only rebuilt (into its fixed buffer) when the
+	/// value it shows has changed, ie. the time once a second.
+	/// </summary>
+	/// <param name="snapshot">the snapshot being drawn</param>
+	void updateHud(const RenderSnapshot& snapshot);
+
+	/// <summary>
+	/// Adds the HUD text to the batch, one glyph quad per character.
+	/// </summary>
+	void drawHud();
 
 	/// <summary>
-	/// Update the score display
-	/// Form a string "score: ##" to display the current score
-	/// scoreText.setString() is used to display it
+	/// Adds a line of text to the batch, using the glyph atlas.
 	/// </summary>
-	void updateScoreDisplay();
+	/// <param name="text">the text</param>
+	/// <param name="left">pixel x of the start of the line</param>
+	/// <param name="baseline">pixel y of the line's baseline</param>
+	void addText(const HudText& text, float left, float baseline);
 
 	// State & gameplay/logic methods ================================
 
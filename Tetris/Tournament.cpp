@@ -0,0 +1,496 @@
+#include "Tournament.h"
+#include "LockstepGame.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+const double Tournament::ELO_START{ 1500.0 };
+const double Tournament::ELO_K{ 16.0 };
+const double Tournament::GLICKO_START{ 1500.0 };
+const double Tournament::GLICKO_START_DEVIATION{ 350.0 };
+const double Tournament::GLICKO_MIN_DEVIATION{ 30.0 };
+const double Tournament::GLICKO_Q{ std::log(10.0) / 400.0 };
+
+Tournament::Tournament(const TournamentSettings& settings)
+	: settings{ settings }, pool{ getWorkerThreadCount(settings.threadCount) }
+{
+	workers.resize(static_cast<size_t>(pool.getThreadCount() + 1));
+}
+
+int Tournament::addBot(const std::string& name, const BotPolicy& policy)
+{
+	TournamentBot bot;
+	bot.name = name;
+	bot.policy = policy;
+	bots.push_back(bot);
+
+	BotStanding standing;
+	standing.elo = ELO_START;
+	standing.glicko = GLICKO_START;
+	standing.glickoDeviation = GLICKO_START_DEVIATION;
+	standings.push_back(standing);
+
+	for (std::vector<bool>& row : met)
+	{
+		row.push_back(false);
+	}
+	met.push_back(std::vector<bool>(bots.size(), false));
+	return static_cast<int>(bots.size()) - 1;
+}
+
+BotPolicy Tournament::makeGreedyPolicy(const EvalWeights& weights)
+{
+	return [weights](const HeadlessGame& game, BotContext& context, Placement& placement) {
+		context.evaluator.setWeights(weights);
+		return context.evaluator.choosePlacement(game.getBoard(), game.getCurrentShape().getShape(), placement);
+	};
+}
+
+BotPolicy Tournament::makeRandomPolicy()
+{
+	return [](const HeadlessGame& game, BotContext& context, Placement& placement) {
+		context.generator.generate(game.getBoard(), game.getCurrentShape().getShape(), context.placements);
+		if (context.placements.empty())
+		{
+			return false;
+		}
+		std::uniform_int_distribution<size_t> pick(0, context.placements.size() - 1);
+		placement = context.placements[pick(context.randomGenerator)];
+		return true;
+	};
+}
+
+void Tournament::run()
+{
+	while (playRound())
+	{
+	}
+}
+
+bool Tournament::playRound()
+{
+	if (round >= getRoundCount() || bots.size() < 2)
+	{
+		return false;
+	}
+	std::vector<Pairing> pairings;
+	pairRound(pairings);
+
+	size_t firstRecord = records.size();
+	records.resize(firstRecord + pairings.size());
+	std::atomic<size_t> nextMatch{ 0 };
+	auto start = std::chrono::steady_clock::now();
+	// one batch per lane: each lane keeps taking matches, so a long match doesn't hold up the others
+	pool.run(static_cast<int>(workers.size()), [&](int lane) {
+		for (size_t match = nextMatch++; match < pairings.size(); match = nextMatch++)
+		{
+			records[firstRecord + match] = playMatch(workers[lane], pairings[match]);
+		}
+	});
+	playSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	round++;
+	for (size_t match{ firstRecord }; match < records.size(); match++)
+	{
+		records[match].round = round;
+	}
+	rateRound(firstRecord);
+	return true;
+}
+
+int Tournament::getRoundCount() const
+{
+	return settings.format == TournamentFormat::SWISS ? settings.rounds : 1;
+}
+
+void Tournament::pairRound(std::vector<Pairing>& pairings)
+{
+	int botCount = static_cast<int>(bots.size());
+	std::vector<std::pair<int, int>> pairs;
+	if (settings.format == TournamentFormat::ROUND_ROBIN)
+	{
+		for (int a{ 0 }; a < botCount; a++)
+		{
+			for (int b{ a + 1 }; b < botCount; b++)
+			{
+				pairs.push_back(std::make_pair(a, b));
+			}
+		}
+	}
+	else
+	{
+		// rank by points (then Elo, then entry #), and pair each bot with the next one down it hasn't met
+		std::vector<int> ranking(botCount);
+		for (int bot{ 0 }; bot < botCount; bot++)
+		{
+			ranking[bot] = bot;
+		}
+		std::sort(ranking.begin(), ranking.end(), [this](int a, int b) {
+			if (standings[a].points != standings[b].points)
+			{
+				return standings[a].points > standings[b].points;
+			}
+			if (standings[a].elo != standings[b].elo)
+			{
+				return standings[a].elo > standings[b].elo;
+			}
+			return a < b;
+		});
+
+		// the bye goes to the lowest ranked bot that hasn't had one
+		if (botCount % 2 == 1)
+		{
+			int byeRank = botCount - 1;
+			while (byeRank > 0 && standings[ranking[byeRank]].hadBye)
+			{
+				byeRank--;
+			}
+			BotStanding& bye = standings[ranking[byeRank]];
+			bye.hadBye = true;
+			bye.points += 1.0;
+			ranking.erase(ranking.begin() + byeRank);
+		}
+
+		std::vector<bool> paired(ranking.size(), false);
+		for (size_t i{ 0 }; i < ranking.size(); i++)
+		{
+			if (paired[i])
+			{
+				continue;
+			}
+			// a rematch only if everyone left has been met
+			size_t opponent = ranking.size();
+			for (size_t j{ i + 1 }; j < ranking.size(); j++)
+			{
+				if (paired[j])
+				{
+					continue;
+				}
+				if (opponent == ranking.size())
+				{
+					opponent = j;
+				}
+				if (!met[ranking[i]][ranking[j]])
+				{
+					opponent = j;
+					break;
+				}
+			}
+			if (opponent < ranking.size())
+			{
+				paired[i] = true;
+				paired[opponent] = true;
+				pairs.push_back(std::make_pair(ranking[i], ranking[opponent]));
+			}
+		}
+	}
+
+	for (const std::pair<int, int>& pair : pairs)
+	{
+		met[pair.first][pair.second] = true;
+		met[pair.second][pair.first] = true;
+		for (int game{ 0 }; game < settings.gamesPerPairing; game++)
+		{
+			// the bots swap sides every game
+			Pairing pairing;
+			pairing.bots[0] = (game % 2 == 0) ? pair.first : pair.second;
+			pairing.bots[1] = (game % 2 == 0) ? pair.second : pair.first;
+			pairing.seed = settings.seed + static_cast<unsigned int>(game);
+			pairings.push_back(pairing);
+		}
+	}
+}
+
+MatchRecord Tournament::playMatch(Worker& worker, const Pairing& pairing) const
+{
+	MatchRecord record;
+	record.bots[0] = pairing.bots[0];
+	record.bots[1] = pairing.bots[1];
+	record.seed = pairing.seed;
+	record.replay.reserve(static_cast<size_t>(settings.maxTurns) * 2 * REPLAY_CHARS);
+
+	VersusState& versus = worker.versus;
+	resetVersus(versus, pairing.seed);
+	for (int player{ 0 }; player < 2; player++)
+	{
+		worker.contexts[player].randomGenerator.seed(pairing.seed * 2 + static_cast<unsigned int>(player));
+	}
+
+	Placement placements[2];
+	bool over{ false };
+	while (!over && versus.turns < settings.maxTurns)
+	{
+		for (int player{ 0 }; player < 2; player++)
+		{
+			const HeadlessGame& game = versus.games[player];
+			if (!bots[pairing.bots[player]].policy(game, worker.contexts[player], placements[player]))
+			{
+				// a bot that can't choose drops its shape where it spawned
+				placements[player].rotations = 0;
+				placements[player].x = game.getCurrentShape().getGridLoc().getX();
+				placements[player].y = game.getCurrentShape().getGridLoc().getY();
+			}
+			record.replay += static_cast<char>('0' + placements[player].rotations);
+			record.replay += static_cast<char>('A' + placements[player].x + REPLAY_OFFSET);
+			record.replay += static_cast<char>('A' + placements[player].y + REPLAY_OFFSET);
+		}
+		over = playTurn(versus, placements);
+	}
+	finishRecord(versus, record);
+	return record;
+}
+
+bool Tournament::replayMatch(const MatchRecord& record, MatchRecord& result)
+{
+	const size_t TURN_CHARS = 2 * REPLAY_CHARS;
+	if (record.replay.size() % TURN_CHARS != 0)
+	{
+		return false;
+	}
+	result = record;
+	VersusState versus;
+	resetVersus(versus, record.seed);
+	Placement placements[2];
+	for (size_t turn{ 0 }; turn < record.replay.size(); turn += TURN_CHARS)
+	{
+		if (versus.games[0].isGameOver() || versus.games[1].isGameOver())
+		{
+			return false;		// moves after the end
+		}
+		for (int player{ 0 }; player < 2; player++)
+		{
+			const char* move = record.replay.c_str() + turn + player * REPLAY_CHARS;
+			placements[player].rotations = move[0] - '0';
+			placements[player].x = move[1] - 'A' - REPLAY_OFFSET;
+			placements[player].y = move[2] - 'A' - REPLAY_OFFSET;
+			if (placements[player].rotations < 0 || placements[player].rotations > 3)
+			{
+				return false;
+			}
+		}
+		playTurn(versus, placements);
+	}
+	finishRecord(versus, result);
+	return true;
+}
+
+void Tournament::resetVersus(VersusState& versus, unsigned int seed)
+{
+	for (int player{ 0 }; player < 2; player++)
+	{
+		versus.games[player].reset(seed);
+		versus.pendingGarbage[player] = 0;
+		versus.holeRandom[player] = seed * 2654435761u + 1 + static_cast<unsigned int>(player);
+		versus.rowsSent[player] = 0;
+	}
+	versus.turns = 0;
+}
+
+bool Tournament::playTurn(VersusState& versus, const Placement placements[2])
+{
+	int attacks[2]{};
+	for (int player{ 0 }; player < 2; player++)
+	{
+		attacks[player] = LockstepGame::applyVersusPlacement(versus.games[player], placements[player],
+			versus.pendingGarbage[player], versus.holeRandom[player]);
+	}
+	// the attacks cross after both players have placed, so neither side goes first
+	for (int player{ 0 }; player < 2; player++)
+	{
+		versus.pendingGarbage[1 - player] += attacks[player];
+		versus.rowsSent[player] += attacks[player];
+	}
+	versus.turns++;
+	return versus.games[0].isGameOver() || versus.games[1].isGameOver();
+}
+
+void Tournament::finishRecord(const VersusState& versus, MatchRecord& record)
+{
+	record.turns = versus.turns;
+	record.piecesPlaced = versus.games[0].getPiecesPlaced() + versus.games[1].getPiecesPlaced();
+	record.rowsSent[0] = versus.rowsSent[0];
+	record.rowsSent[1] = versus.rowsSent[1];
+	bool lost[2]{ versus.games[0].isGameOver(), versus.games[1].isGameOver() };
+	if (lost[0] != lost[1])
+	{
+		record.winner = lost[0] ? 1 : 0;
+	}
+	else if (versus.rowsSent[0] != versus.rowsSent[1])
+	{
+		record.winner = versus.rowsSent[0] > versus.rowsSent[1] ? 0 : 1;
+	}
+	else
+	{
+		record.winner = -1;
+	}
+}
+
+int Tournament::getWorkerThreadCount(int requested)
+{
+	if (requested > 0)
+	{
+		return requested;
+	}
+	// the calling thread works too
+	return std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+}
+
+double Tournament::glickoWeight(double deviation)
+{
+	const double PI{ 3.14159265358979323846 };
+	return 1.0 / std::sqrt(1.0 + 3.0 * GLICKO_Q * GLICKO_Q * deviation * deviation / (PI * PI));
+}
+
+void Tournament::rateRound(size_t firstRecord)
+{
+	// Glicko uses the ratings from the start of the round (one rating period)
+	std::vector<BotStanding> before = standings;
+	std::vector<double> sumImpact(bots.size(), 0.0);		// sum of g * (score - expected)
+	std::vector<double> sumVariance(bots.size(), 0.0);		// sum of g^2 * expected * (1 - expected)
+
+	for (size_t match{ firstRecord }; match < records.size(); match++)
+	{
+		const MatchRecord& record = records[match];
+		int a = record.bots[0];
+		int b = record.bots[1];
+		double scoreA = record.winner == 0 ? 1.0 : (record.winner == 1 ? 0.0 : 0.5);
+
+		standings[a].points += scoreA;
+		standings[b].points += 1.0 - scoreA;
+		if (record.winner == -1)
+		{
+			standings[a].draws++;
+			standings[b].draws++;
+		}
+		else
+		{
+			standings[record.winner == 0 ? a : b].wins++;
+			standings[record.winner == 0 ? b : a].losses++;
+		}
+
+		// Elo, match by match
+		double expectedA = 1.0 / (1.0 + std::pow(10.0, (standings[b].elo - standings[a].elo) / 400.0));
+		standings[a].elo += ELO_K * (scoreA - expectedA);
+		standings[b].elo -= ELO_K * (scoreA - expectedA);
+
+		// Glicko, accumulated for the end of the round
+		for (int side{ 0 }; side < 2; side++)
+		{
+			int bot = side == 0 ? a : b;
+			int opponent = side == 0 ? b : a;
+			double score = side == 0 ? scoreA : 1.0 - scoreA;
+			double weight = glickoWeight(before[opponent].glickoDeviation);
+			double expected = 1.0 / (1.0 + std::pow(10.0, -weight * (before[bot].glicko - before[opponent].glicko) / 400.0));
+			sumImpact[bot] += weight * (score - expected);
+			sumVariance[bot] += weight * weight * expected * (1.0 - expected);
+		}
+	}
+
+	for (size_t bot{ 0 }; bot < bots.size(); bot++)
+	{
+		if (sumVariance[bot] <= 0.0)
+		{
+			continue;		// didn't play this round
+		}
+		double deviation = before[bot].glickoDeviation;
+		double inverseDSquared = GLICKO_Q * GLICKO_Q * sumVariance[bot];
+		double precision = 1.0 / (deviation * deviation) + inverseDSquared;
+		standings[bot].glicko = before[bot].glicko + GLICKO_Q / precision * sumImpact[bot];
+		standings[bot].glickoDeviation = std::max(GLICKO_MIN_DEVIATION, std::sqrt(1.0 / precision));
+	}
+}
+
+bool Tournament::writeLog() const
+{
+	std::ofstream file(settings.logPath);
+	if (!file)
+	{
+		return false;
+	}
+	file << "# round bot0 bot1 seed winner turns sent0 sent1 replay\n";
+	for (const MatchRecord& record : records)
+	{
+		file << record.round << " " << bots[record.bots[0]].name << " " << bots[record.bots[1]].name << " " << record.seed << " "
+			<< (record.winner == -1 ? std::string("draw") : bots[record.bots[record.winner]].name) << " " << record.turns << " "
+			<< record.rowsSent[0] << " " << record.rowsSent[1] << " " << record.replay << "\n";
+	}
+	printSummary(file);
+	return static_cast<bool>(file);
+}
+
+void Tournament::printSummary(std::ostream& out) const
+{
+	std::vector<int> ranking(bots.size());
+	for (size_t bot{ 0 }; bot < bots.size(); bot++)
+	{
+		ranking[bot] = static_cast<int>(bot);
+	}
+	std::sort(ranking.begin(), ranking.end(), [this](int a, int b) { return standings[a].elo > standings[b].elo; });
+
+	out << "# " << std::left << std::setw(16) << "bot" << std::right << std::setw(8) << "points" << std::setw(6) << "won"
+		<< std::setw(6) << "drawn" << std::setw(6) << "lost" << std::setw(8) << "elo" << std::setw(8) << "glicko" << std::setw(6) << "rd" << "\n";
+	out << std::fixed << std::setprecision(1);
+	for (int bot : ranking)
+	{
+		const BotStanding& standing = standings[bot];
+		out << "# " << std::left << std::setw(16) << bots[bot].name << std::right << std::setw(8) << standing.points
+			<< std::setw(6) << standing.wins << std::setw(6) << standing.draws << std::setw(6) << standing.losses
+			<< std::setw(8) << standing.elo << std::setw(8) << standing.glicko << std::setw(6) << standing.glickoDeviation << "\n";
+	}
+	long long pieces{ 0 };
+	for (const MatchRecord& record : records)
+	{
+		pieces += record.piecesPlaced;
+	}
+	int lanes = static_cast<int>(workers.size());
+	out << "# " << records.size() << " matches in " << std::setprecision(2) << playSeconds << " sec on " << lanes << " threads: "
+		<< std::setprecision(0) << getMatchesPerHour() << " matches/hour (" << getMatchesPerHour() / lanes << " per thread), "
+		<< (playSeconds > 0.0 ? pieces / playSeconds : 0.0) << " pieces/sec\n";
+	out << std::defaultfloat << std::setprecision(6);
+}
+
+void Tournament::runTournament(TournamentFormat format, int gamesPerPairing)
+{
+	TournamentSettings settings;
+	settings.format = format;
+	settings.gamesPerPairing = gamesPerPairing;
+	Tournament tournament(settings);
+
+	// the default weights, plus variations that each neglect one feature
+	EvalWeights noHoles = EvalWeights::getDefaults();
+	noHoles[EvalFeature::HOLES] = 0.0;
+	EvalWeights flat = EvalWeights::getDefaults();
+	flat[EvalFeature::BUMPINESS] *= 3.0;
+	EvalWeights stacker = EvalWeights::getDefaults();
+	stacker[EvalFeature::AGGREGATE_HEIGHT] *= 0.25;
+	tournament.addBot("greedy", makeGreedyPolicy(EvalWeights::getDefaults()));
+	tournament.addBot("flat", makeGreedyPolicy(flat));
+	tournament.addBot("stacker", makeGreedyPolicy(stacker));
+	tournament.addBot("ignore-holes", makeGreedyPolicy(noHoles));
+	tournament.addBot("random", makeRandomPolicy());
+
+	while (tournament.playRound())
+	{
+		std::cout << "round " << tournament.getRoundsPlayed() << " done, " << tournament.getRecords().size() << " matches\n";
+	}
+	tournament.printSummary(std::cout);
+	if (tournament.writeLog())
+	{
+		std::cout << "log and replays written to " << settings.logPath << "\n";
+	}
+}
+
+const std::vector<MatchRecord>& Tournament::getRecords() const { return records; }
+
+const BotStanding& Tournament::getStanding(int bot) const { return standings[bot]; }
+
+int Tournament::getRoundsPlayed() const { return round; }
+
+double Tournament::getMatchesPerHour() const
+{
+	return playSeconds > 0.0 ? records.size() * 3600.0 / playSeconds : 0.0;
+}
@@ -0,0 +1,282 @@
+// The Tournament plays bots against each other in headless versus matches, for nightly bot
+// regression runs.  Bots are pluggable: a TournamentBot is a name plus a BotPolicy, any function
+// that picks a placement for the current shape (see makeGreedyPolicy() and makeRandomPolicy()).
+//
+// A versus match is two HeadlessGames with the same seed, played in turns: each turn both bots
+// place a shape with LockstepGame::applyVersusPlacement() (clears send LockstepGame::ATTACK_ROWS
+// garbage rows, which cancel the garbage waiting first, and garbage is pushed in at the next
+// placement that doesn't clear), then the attacks are exchanged.  A bot that tops out loses; if both top
+// out on the same turn, or neither has after maxTurns, the bot that sent more garbage wins (or
+// it's a draw).
+//
+// Formats:
+//  - ROUND_ROBIN: a single round where every pair of bots plays gamesPerPairing matches.
+//  - SWISS: each round pairs bots with similar points that haven't met yet (the bye, for an odd
+//    # of bots, is worth a win), for the given # of rounds.
+// Game g of every pairing uses seed settings.seed + g, so every bot faces the same shapes.
+//
+// The matches of a round are spread over a WorkerPool: each lane (worker) owns the games and bot
+// scratch it reuses for every match it takes from a shared counter.  Results are stored by match
+// #, so the ratings don't depend on which thread finished first.  Ratings:
+//  - Elo: updated match by match, in schedule order.
+//  - Glicko (Glicko-1): updated once per round (a rating period), with a rating deviation.
+//
+// Every match is logged with a replay (each placement as rotation, x and y), which replayMatch()
+// plays back to the same result without the bots.
+
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "BoardEvaluator.h"
+#include "HeadlessGame.h"
+#include "WorkerPool.h"
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+enum class TournamentFormat { ROUND_ROBIN, SWISS };
+
+/// <summary>
+/// Settings for a tournament.
+/// </summary>
+struct TournamentSettings
+{
+	TournamentFormat format{ TournamentFormat::ROUND_ROBIN };
+	int rounds{ 5 };						// # of rounds (SWISS only)
+	int gamesPerPairing{ 4 };				// # of matches each pair of bots plays per round
+	int maxTurns{ 500 };					// a match is scored after this many turns
+	int threadCount{ 0 };					// # of worker threads, 0 = one per core (less the calling thread)
+	unsigned int seed{ 1 };					// the seed of the first game of every pairing
+	std::string logPath{ "tournament_log.txt" };
+};
+
+/// <summary>
+/// A bot's scratch space, owned by a worker lane and reused for every placement.
+/// </summary>
+struct BotContext
+{
+	BoardEvaluator evaluator;
+	PlacementGenerator generator;
+	std::vector<Placement> placements;
+	std::mt19937 randomGenerator;			// reseeded for every match (so random bots are reproducible)
+};
+
+/// <summary>
+/// Picks where to place the game's current shape.  Returns false if it can't be placed.
+/// </summary>
+using BotPolicy = std::function<bool(const HeadlessGame& game, BotContext& context, Placement& placement)>;
+
+/// <summary>
+/// A bot entered in the tournament.
+/// </summary>
+struct TournamentBot
+{
+	std::string name;						// (no spaces, it's written to the log)
+	BotPolicy policy;
+};
+
+/// <summary>
+/// The result of one match.
+/// </summary>
+struct MatchRecord
+{
+	int round{ 0 };
+	int bots[2]{};							// the bots, by entry #
+	unsigned int seed{ 0 };
+	int winner{ -1 };						// 0 or 1 (a player of this match), -1 for a draw
+	int turns{ 0 };
+	int rowsSent[2]{};						// garbage rows sent by each player
+	int piecesPlaced{ 0 };					// by both players
+	std::string replay;						// REPLAY_CHARS per placement, both players each turn
+};
+
+/// <summary>
+/// A bot's standing and ratings.
+/// </summary>
+struct BotStanding
+{
+	double points{ 0.0 };					// 1 per win (or bye), 0.5 per draw
+	int wins{ 0 };
+	int draws{ 0 };
+	int losses{ 0 };
+	bool hadBye{ false };
+	double elo{ 0.0 };
+	double glicko{ 0.0 };
+	double glickoDeviation{ 0.0 };
+};
+
+class Tournament
+{
+	friend class TestSuite;
+
+public:
+	// CONSTANTS
+	static const int REPLAY_CHARS = 3;		// rotations, x and y of a placement
+	static const int REPLAY_OFFSET = 8;		// added to x and y (placements can start left of, or above, the board)
+	static const double ELO_START;			// init to 1500
+	static const double ELO_K;				// init to 16
+	static const double GLICKO_START;		// init to 1500
+	static const double GLICKO_START_DEVIATION;	// init to 350
+	static const double GLICKO_MIN_DEVIATION;	// init to 30 (so a rating keeps moving)
+	static const double GLICKO_Q;			// init to ln(10) / 400
+
+private:
+	/// <summary>
+	/// A match being played (or replayed).
+	/// </summary>
+	struct VersusState
+	{
+		HeadlessGame games[2];
+		int pendingGarbage[2]{};
+		unsigned int holeRandom[2]{};		// picks each player's garbage hole columns
+		int rowsSent[2]{};
+		int turns{ 0 };
+	};
+
+	/// <summary>
+	/// The state owned by one worker lane, reused for every match it plays.
+	/// </summary>
+	struct Worker
+	{
+		VersusState versus;
+		BotContext contexts[2];
+	};
+
+	/// <summary>
+	/// A match to be played.
+	/// </summary>
+	struct Pairing
+	{
+		int bots[2]{};
+		unsigned int seed{ 0 };
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	TournamentSettings settings;
+	std::vector<TournamentBot> bots;
+	std::vector<BotStanding> standings;		// one per bot
+	std::vector<std::vector<bool>> met;		// met[a][b]: a and b have been paired (SWISS)
+	std::vector<MatchRecord> records;		// every match played, in schedule order
+	WorkerPool pool;
+	std::vector<Worker> workers;			// one per lane (the pool's threads + the calling thread)
+	int round{ 0 };							// # of rounds played
+	double playSeconds{ 0.0 };				// time spent playing matches
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor, starts the worker threads.
+	/// </summary>
+	/// <param name="settings">the settings for this tournament</param>
+	explicit Tournament(const TournamentSettings& settings);
+
+	/// <summary>
+	/// Enters a bot (before the first round).
+	/// </summary>
+	/// <returns>the bot's entry #</returns>
+	int addBot(const std::string& name, const BotPolicy& policy);
+
+	/// <summary>
+	/// A bot that places each shape where a BoardEvaluator with the given weights scores best.
+	/// </summary>
+	static BotPolicy makeGreedyPolicy(const EvalWeights& weights);
+
+	/// <summary>
+	/// A bot that places each shape at a random placement (a baseline every bot should beat).
+	/// </summary>
+	static BotPolicy makeRandomPolicy();
+
+	/// <summary>
+	/// Plays every round of the tournament.
+	/// </summary>
+	void run();
+
+	/// <summary>
+	/// Pairs the bots for the next round, plays its matches in parallel, and updates the ratings.
+	/// </summary>
+	/// <returns>false if every round has been played</returns>
+	bool playRound();
+
+	/// <summary>
+	/// Plays a match back from its replay.
+	/// </summary>
+	/// <param name="record">the match (its seed and replay are used)</param>
+	/// <param name="result">set to the replayed result (rows sent, turns, pieces and winner)</param>
+	/// <returns>false if the replay is malformed</returns>
+	static bool replayMatch(const MatchRecord& record, MatchRecord& result);
+
+	/// <summary>
+	/// Writes every match (with its replay) and the final standings to settings.logPath.
+	/// </summary>
+	/// <returns>true if the log was written</returns>
+	bool writeLog() const;
+
+	/// <summary>
+	/// Prints the standings (best Elo first) and the throughput.
+	/// </summary>
+	void printSummary(std::ostream& out) const;
+
+	/// <summary>
+	/// Runs a tournament between the built-in bots, logs it and prints the summary.
+	/// </summary>
+	/// <param name="format">the tournament format</param>
+	/// <param name="gamesPerPairing">the # of matches each pair plays per round</param>
+	static void runTournament(TournamentFormat format, int gamesPerPairing);
+
+	// Getters
+	const std::vector<MatchRecord>& getRecords() const;
+	const BotStanding& getStanding(int bot) const;
+	int getRoundsPlayed() const;
+	double getMatchesPerHour() const;
+
+private:
+	/// <summary>
+	/// Gets the # of rounds in this tournament's format.
+	/// </summary>
+	int getRoundCount() const;
+
+	/// <summary>
+	/// Fills in the matches of the next round (and awards any bye).
+	/// </summary>
+	void pairRound(std::vector<Pairing>& pairings);
+
+	/// <summary>
+	/// Plays one match with the bots' policies.
+	/// </summary>
+	MatchRecord playMatch(Worker& worker, const Pairing& pairing) const;
+
+	/// <summary>
+	/// Starts a match.
+	/// </summary>
+	static void resetVersus(VersusState& versus, unsigned int seed);
+
+	/// <summary>
+	/// Places both players' shapes, then exchanges their attacks.
+	/// </summary>
+	/// <returns>true if the match is over</returns>
+	static bool playTurn(VersusState& versus, const Placement placements[2]);
+
+	/// <summary>
+	/// Scores a finished (or maxTurns long) match into a record.
+	/// </summary>
+	static void finishRecord(const VersusState& versus, MatchRecord& record);
+
+	/// <summary>
+	/// Updates the points, Elo and Glicko ratings with the matches of a round.
+	/// </summary>
+	void rateRound(size_t firstRecord);
+
+	/// <summary>
+	/// Gets the # of pool threads for a settings.threadCount (0 = one per core, less the calling thread).
+	/// </summary>
+	static int getWorkerThreadCount(int requested);
+
+	/// <summary>
+	/// The Glicko g() function: how much a result counts, given the opponent's rating deviation.
+	/// </summary>
+	static double glickoWeight(double deviation);
+};
+
+#endif /* TOURNAMENT_H */
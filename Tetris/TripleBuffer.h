@@ -0,0 +1,66 @@
+// A TripleBuffer passes the latest value from one writer thread to one reader thread
+// without locks, and without either thread ever waiting for the other.
+//
+// There are 3 slots: the writer fills its back slot and publish()es it (swapping it with
+// the middle slot), the reader acquire()s the middle slot when it has something new
+// (swapping it with its front slot).  The writer can publish faster than the reader
+// reads - the reader just gets the most recent value, and values in between are dropped.
+//
+// The slots are allocated once, and a slot is never read and written at the same time,
+// so T can be anything copyable (ie. a whole RenderSnapshot).
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer
+{
+private:
+	// CONSTANTS
+	static const unsigned int INDEX_MASK = 3;	// the slot index part of middle
+	static const unsigned int FRESH = 4;		// set in middle when it holds a value the reader hasn't seen
+
+	// MEMBER VARIABLES -------------------------------------------------
+	T slots[3];
+	std::atomic<unsigned int> middle{ 2 };		// index of the middle slot (| FRESH)
+	unsigned int back{ 0 };						// the writer's slot (only used by the writer)
+	unsigned int front{ 1 };					// the reader's slot (only used by the reader)
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Writer: gets the slot to fill (it may hold an old value, so every field should be written).
+	/// </summary>
+	T& getWriteSlot() { return slots[back]; }
+
+	/// <summary>
+	/// Writer: makes the filled slot the latest value, and takes a new slot to fill.
+	/// </summary>
+	void publish()
+	{
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	/// <summary>
+	/// Reader: takes the latest value, if one has been published since the last acquire().
+	/// </summary>
+	/// <returns>true if getReadSlot() now holds a newer value</returns>
+	bool acquire()
+	{
+		if ((middle.load(std::memory_order_acquire) & FRESH) == 0)
+		{
+			return false;
+		}
+		front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	/// <summary>
+	/// Reader: gets the latest acquired value (stays valid until the next acquire()).
+	/// </summary>
+	const T& getReadSlot() const { return slots[front]; }
+};
+
+#endif /* TRIPLEBUFFER_H */
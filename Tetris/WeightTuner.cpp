@@ -0,0 +1,322 @@
+#include "WeightTuner.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+WeightTuner::WeightTuner(const TunerSettings& settings) : settings{ settings }, randomGenerator{ settings.seed }
+{
+	int threadCount = settings.threadCount;
+	if (threadCount <= 0)
+	{
+		threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	workers.resize(threadCount);
+
+	population.resize(settings.populationSize);
+	nextPopulation.resize(settings.populationSize);
+	gameResults.resize(settings.populationSize * settings.gamesPerCandidate);
+	fitness.resize(settings.populationSize);
+	ranking.resize(settings.populationSize);
+
+	// the first candidate is the hand tuned default, the rest are random
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	for (int i{ 0 }; i < settings.populationSize; i++)
+	{
+		if (i == 0)
+		{
+			population[i] = EvalWeights::getDefaults();
+		}
+		else {
+			for (double& value : population[i].values)
+			{
+				value = distribution(randomGenerator);
+			}
+		}
+		normalize(population[i]);
+	}
+	bestWeights = population[0];
+}
+
+void WeightTuner::run()
+{
+	if (loadCheckpoint())
+	{
+		std::cout << "Resuming from checkpoint " << settings.checkpointPath
+			<< " at generation " << generation << "\n";
+	}
+
+	while (generation < settings.generations)
+	{
+		auto start = std::chrono::steady_clock::now();
+		runGeneration();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		int games = settings.populationSize * settings.gamesPerCandidate;
+
+		std::cout << "generation " << generation
+			<< "  best: " << fitness[ranking[0]]
+			<< "  best ever: " << bestFitness
+			<< "  games/sec: " << (seconds > 0.0 ? games / seconds : 0.0) << "\n";
+		saveCheckpoint();
+	}
+
+	std::cout << "best weights (avg lines " << bestFitness << "):";
+	for (double value : bestWeights.values)
+	{
+		std::cout << " " << value;
+	}
+	std::cout << "\n";
+}
+
+void WeightTuner::runGeneration()
+{
+	evaluatePopulation();
+
+	for (int i{ 0 }; i < settings.populationSize; i++)
+	{
+		ranking[i] = i;
+	}
+	std::sort(ranking.begin(), ranking.end(), [this](int a, int b) { return fitness[a] > fitness[b]; });
+
+	if (fitness[ranking[0]] > bestFitness)
+	{
+		bestFitness = fitness[ranking[0]];
+		bestWeights = population[ranking[0]];
+	}
+
+	breedNextGeneration();
+	generation++;
+}
+
+const EvalWeights& WeightTuner::getBestWeights() const { return bestWeights; }
+
+double WeightTuner::getBestFitness() const { return bestFitness; }
+
+int WeightTuner::getGeneration() const { return generation; }
+
+int WeightTuner::playGame(Worker& worker, const EvalWeights& weights, unsigned int seed, int maxPieces)
+{
+	worker.game.reset(seed);
+	worker.evaluator.setWeights(weights);
+	while (!worker.game.isGameOver() && worker.game.getPiecesPlaced() < maxPieces)
+	{
+		if (!worker.evaluator.choosePlacement(worker.game.getBoard(), worker.game.getCurrentShape().getShape(), worker.placement))
+		{
+			break;
+		}
+		worker.game.applyPlacement(worker.placement);
+	}
+	return worker.game.getLinesCleared();
+}
+
+bool WeightTuner::saveCheckpoint() const
+{
+	std::string tempPath = settings.checkpointPath + ".tmp";
+	{
+		std::ofstream file(tempPath);
+		if (!file)
+		{
+			return false;
+		}
+		file.precision(17);
+		file << "generation " << generation << "\n";
+		file << "population " << settings.populationSize << "\n";
+		file << "best " << bestFitness;
+		for (double value : bestWeights.values)
+		{
+			file << " " << value;
+		}
+		file << "\n";
+		for (const EvalWeights& candidate : population)
+		{
+			file << "candidate";
+			for (double value : candidate.values)
+			{
+				file << " " << value;
+			}
+			file << "\n";
+		}
+		file << "rng " << randomGenerator << "\n";
+		if (!file)
+		{
+			return false;
+		}
+	}
+	// replaced in one step, so a crash leaves either the old checkpoint or the new one
+	// (std::rename() won't replace an existing file on Windows, but MoveFileEx() will)
+#ifdef _WIN32
+	return MoveFileExA(tempPath.c_str(), settings.checkpointPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return std::rename(tempPath.c_str(), settings.checkpointPath.c_str()) == 0;
+#endif
+}
+
+bool WeightTuner::loadCheckpoint()
+{
+	std::ifstream file(settings.checkpointPath);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::string label;
+	int loadedGeneration{ 0 };
+	int loadedPopulationSize{ 0 };
+	file >> label >> loadedGeneration;
+	file >> label >> loadedPopulationSize;
+	if (!file || loadedPopulationSize != settings.populationSize)
+	{
+		std::cout << "Ignoring checkpoint " << settings.checkpointPath << " (it doesn't match these settings)\n";
+		return false;
+	}
+
+	// read into the spare buffer, so a truncated file leaves the tuner untouched
+	EvalWeights loadedBest;
+	double loadedBestFitness{ 0.0 };
+	file >> label >> loadedBestFitness;
+	for (double& value : loadedBest.values)
+	{
+		file >> value;
+	}
+	for (EvalWeights& candidate : nextPopulation)
+	{
+		file >> label;
+		for (double& value : candidate.values)
+		{
+			file >> value;
+		}
+	}
+	std::mt19937 loadedGenerator;
+	file >> label >> loadedGenerator;
+	if (!file)
+	{
+		std::cout << "Ignoring checkpoint " << settings.checkpointPath << " (it is incomplete)\n";
+		return false;
+	}
+
+	generation = loadedGeneration;
+	bestFitness = loadedBestFitness;
+	bestWeights = loadedBest;
+	population.swap(nextPopulation);
+	randomGenerator = loadedGenerator;
+	return true;
+}
+
+void WeightTuner::evaluatePopulation()
+{
+	const int jobCount = settings.populationSize * settings.gamesPerCandidate;
+	std::atomic<int> nextJob{ 0 };
+
+	// every candidate plays the same seeds within a generation, so they are compared on equal terms
+	const unsigned int generationSeed = settings.seed + static_cast<unsigned int>(generation * settings.gamesPerCandidate);
+
+	auto workerLoop = [&](Worker& worker)
+	{
+		for (int job = nextJob.fetch_add(1); job < jobCount; job = nextJob.fetch_add(1))
+		{
+			int candidate = job / settings.gamesPerCandidate;
+			int game = job % settings.gamesPerCandidate;
+			gameResults[job] = playGame(worker, population[candidate], generationSeed + game, settings.maxPiecesPerGame);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(workers.size());
+	for (size_t i{ 1 }; i < workers.size(); i++)
+	{
+		threads.emplace_back(workerLoop, std::ref(workers[i]));
+	}
+	workerLoop(workers[0]);		// this thread does its share too
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (int candidate{ 0 }; candidate < settings.populationSize; candidate++)
+	{
+		double total{ 0.0 };
+		for (int game{ 0 }; game < settings.gamesPerCandidate; game++)
+		{
+			total += gameResults[candidate * settings.gamesPerCandidate + game];
+		}
+		fitness[candidate] = total / settings.gamesPerCandidate;
+	}
+}
+
+void WeightTuner::breedNextGeneration()
+{
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::normal_distribution<double> mutation(0.0, settings.mutationStrength);
+
+	for (int i{ 0 }; i < settings.populationSize; i++)
+	{
+		EvalWeights& child = nextPopulation[i];
+		if (i < settings.eliteCount)
+		{
+			child = population[ranking[i]];
+			continue;
+		}
+
+		// blend crossover, weighted towards the fitter parent (a gets 50-100% of the blend)
+		int first = selectParent();
+		int second = selectParent();
+		if (fitness[second] > fitness[first])
+		{
+			std::swap(first, second);
+		}
+		const EvalWeights& a = population[first];
+		const EvalWeights& b = population[second];
+		double blend = 0.5 + 0.5 * unit(randomGenerator);
+		for (int w{ 0 }; w < EvalWeights::COUNT; w++)
+		{
+			child.values[w] = blend * a.values[w] + (1.0 - blend) * b.values[w];
+			if (unit(randomGenerator) < settings.mutationRate)
+			{
+				child.values[w] += mutation(randomGenerator);
+			}
+		}
+		normalize(child);
+	}
+	population.swap(nextPopulation);
+}
+
+int WeightTuner::selectParent()
+{
+	std::uniform_int_distribution<int> pick(0, settings.populationSize - 1);
+	int best = pick(randomGenerator);
+	for (int i{ 1 }; i < 3; i++)
+	{
+		int challenger = pick(randomGenerator);
+		if (fitness[challenger] > fitness[best])
+		{
+			best = challenger;
+		}
+	}
+	return best;
+}
+
+void WeightTuner::normalize(EvalWeights& weights)
+{
+	double length{ 0.0 };
+	for (double value : weights.values)
+	{
+		length += value * value;
+	}
+	length = std::sqrt(length);
+	if (length > 0.0)
+	{
+		for (double& value : weights.values)
+		{
+			value /= length;
+		}
+	}
+}
@@ -0,0 +1,142 @@
+// The WeightTuner searches for better BoardEvaluator weights with a genetic algorithm.
+//
+// Each generation:
+//  1) every candidate (a set of EvalWeights) plays the same seeded headless games,
+//     its fitness is the average # of lines cleared.
+//     The games are spread across one worker thread per core.  Each worker owns a single
+//     HeadlessGame and BoardEvaluator which are reset and reused for every game it plays.
+//  2) the best candidates are kept (elitism), the rest of the next generation is bred
+//     by tournament selection, crossover and mutation.
+//  3) progress is written to a checkpoint file, so a long run can be stopped and resumed.
+//
+// Throughput (games per second) is reported after every generation.
+
+#ifndef WEIGHTTUNER_H
+#define WEIGHTTUNER_H
+
+#include "BoardEvaluator.h"
+#include "HeadlessGame.h"
+#include <random>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Settings for a tuning run.
+/// </summary>
+struct TunerSettings
+{
+	int populationSize{ 32 };			// # of candidates per generation
+	int eliteCount{ 2 };				// # of best candidates copied unchanged into the next generation
+	int gamesPerCandidate{ 16 };		// # of games each candidate plays per generation
+	int maxPiecesPerGame{ 500 };		// games are stopped after this many pieces (so good bots don't play forever)
+	int generations{ 50 };				// # of generations to run (including any loaded from the checkpoint)
+	int threadCount{ 0 };				// # of worker threads, 0 = one per core
+	double mutationRate{ 0.3 };			// chance of mutating each weight
+	double mutationStrength{ 0.2 };		// standard deviation of a mutation
+	unsigned int seed{ 1 };				// seeds the game sequences and the genetic algorithm
+	std::string checkpointPath{ "tuner_checkpoint.txt" };
+};
+
+class WeightTuner
+{
+	friend class TestSuite;
+
+private:
+	/// <summary>
+	/// The state owned by one worker thread, reused for every game the worker plays.
+	/// </summary>
+	struct Worker
+	{
+		HeadlessGame game;
+		BoardEvaluator evaluator;
+		Placement placement;
+	};
+
+	// MEMBER VARIABLES -------------------------------------------------
+	TunerSettings settings;
+	std::vector<Worker> workers;				// one per thread (allocated once)
+	std::vector<EvalWeights> population;		// the current generation's candidates
+	std::vector<EvalWeights> nextPopulation;	// the generation being bred (swapped with population)
+	std::vector<double> gameResults;			// lines cleared, one slot per (candidate, game)
+	std::vector<double> fitness;				// average lines cleared, per candidate
+	std::vector<int> ranking;					// candidate indices sorted by fitness (best first)
+	std::mt19937 randomGenerator;				// drives selection, crossover & mutation
+
+	int generation{ 0 };						// # of generations completed
+	EvalWeights bestWeights;					// the best candidate seen so far
+	double bestFitness{ -1.0 };					// and its fitness
+
+public:
+	// METHODS -------------------------------------------------
+
+	/// <summary>
+	/// Constructor
+	/// Allocates the workers and population buffers, and seeds the first generation
+	/// with the default weights plus random candidates.
+	/// </summary>
+	/// <param name="settings">the settings for this run</param>
+	explicit WeightTuner(const TunerSettings& settings);
+
+	/// <summary>
+	/// Runs the tuner until settings.generations have been completed.
+	/// If the checkpoint file exists, the run resumes from it.
+	/// </summary>
+	void run();
+
+	/// <summary>
+	/// Runs a single generation: evaluate the population, record the best, breed the next generation.
+	/// </summary>
+	void runGeneration();
+
+	const EvalWeights& getBestWeights() const;
+	double getBestFitness() const;
+	int getGeneration() const;
+
+	/// <summary>
+	/// Writes the generation #, best candidate, population and random generator state to the checkpoint file.
+	/// The file is written to a temporary file first, which then replaces the checkpoint in one step,
+	/// so a crash can't leave a half written checkpoint (or none at all).
+	/// </summary>
+	/// <returns>true if the checkpoint was written</returns>
+	bool saveCheckpoint() const;
+
+	/// <summary>
+	/// Restores the tuner from the checkpoint file.
+	/// </summary>
+	/// <returns>true if a valid checkpoint was loaded</returns>
+	bool loadCheckpoint();
+
+private:
+	/// <summary>
+	/// Plays a single seeded game with the given weights.
+	/// </summary>
+	/// <param name="worker">the worker state to (re)use</param>
+	/// <param name="weights">the evaluator weights</param>
+	/// <param name="seed">the seed for the game's shape sequence</param>
+	/// <param name="maxPieces">the game is stopped after this many pieces</param>
+	/// <returns>the # of lines cleared</returns>
+	static int playGame(Worker& worker, const EvalWeights& weights, unsigned int seed, int maxPieces);
+
+	/// <summary>
+	/// Plays every (candidate, game) pair across the worker threads and fills in the fitness of each candidate.
+	/// </summary>
+	void evaluatePopulation();
+
+	/// <summary>
+	/// Fills nextPopulation from the ranked population (elites, then bred children), then swaps the two.
+	/// </summary>
+	void breedNextGeneration();
+
+	/// <summary>
+	/// Picks the fittest of 3 random candidates.
+	/// </summary>
+	/// <returns>the index of the selected candidate</returns>
+	int selectParent();
+
+	/// <summary>
+	/// Scales the weights to unit length (the evaluator only cares about their direction).
+	/// </summary>
+	static void normalize(EvalWeights& weights);
+};
+
+#endif /* WEIGHTTUNER_H */
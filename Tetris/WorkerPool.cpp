@@ -0,0 +1,85 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int threadCount)
+{
+	threads.reserve(static_cast<size_t>(threadCount > 0 ? threadCount : 0));
+	for (int i{ 0 }; i < threadCount; i++)
+	{
+		threads.push_back(std::thread(&WorkerPool::workerLoop, this));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workReady.notify_all();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+void WorkerPool::run(int batchCount, const std::function<void(int)>& task)
+{
+	if (batchCount <= 0)
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->task = &task;
+		this->batchCount = batchCount;
+		nextBatch.store(0, std::memory_order_relaxed);
+		busyWorkers = static_cast<int>(threads.size());
+		generation++;
+	}
+	workReady.notify_all();
+	runBatches(task, batchCount);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	workDone.wait(lock, [this] { return busyWorkers == 0; });
+	this->task = nullptr;
+}
+
+int WorkerPool::getThreadCount() const { return static_cast<int>(threads.size()); }
+
+void WorkerPool::workerLoop()
+{
+	unsigned long long seenGeneration{ 0 };
+	for (;;)
+	{
+		const std::function<void(int)>* work;
+		int count;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			workReady.wait(lock, [this, seenGeneration] { return generation != seenGeneration || stopping; });
+			if (stopping)
+			{
+				return;
+			}
+			seenGeneration = generation;
+			work = task;
+			count = batchCount;
+		}
+		runBatches(*work, count);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			busyWorkers--;
+			if (busyWorkers == 0)
+			{
+				workDone.notify_one();
+			}
+		}
+	}
+}
+
+void WorkerPool::runBatches(const std::function<void(int)>& work, int count)
+{
+	for (int batch = nextBatch.fetch_add(1, std::memory_order_relaxed); batch < count; batch = nextBatch.fetch_add(1, std::memory_order_relaxed))
+	{
+		work(batch);
+	}
+}
@@ -0,0 +1,78 @@
+// The WorkerPool runs batches of work on a fixed set of threads, and waits for all of them:
+// run(batchCount, task) calls task(0) ... task(batchCount - 1), spread over the workers and
+// the calling thread, and returns once every batch is done.
+//
+// Workers take the next batch # from an atomic counter, so a slow batch doesn't hold up the
+// others.  Between run()s the workers sleep on a condition variable (no spinning), and the
+// threads are started once, in the constructor.  Used by the MatchServer to step its matches
+// each tick.
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+	friend class TestSuite;
+
+private:
+	// MEMBER VARIABLES -------------------------------------------------
+
+	// Work members (guarded by mutex) ----------------------------------
+	std::mutex mutex;
+	std::condition_variable workReady;			// signalled when a run() starts (or on stopping)
+	std::condition_variable workDone;			// signalled when the last worker finishes a run()
+	const std::function<void(int)>* task{ nullptr };
+	int batchCount{ 0 };
+	unsigned long long generation{ 0 };			// # of run()s started (workers wait for it to change)
+	int busyWorkers{ 0 };						// # of workers still in the current run()
+	bool stopping{ false };
+
+	std::atomic<int> nextBatch{ 0 };			// the next batch # to take
+	std::vector<std::thread> threads;
+
+public:
+	// METHODS -------------------------------------------------
+	/// <summary>
+	/// Constructor, starts the worker threads.
+	/// </summary>
+	/// <param name="threadCount">the # of worker threads (the thread calling run() also works)</param>
+	explicit WorkerPool(int threadCount);
+
+	/// <summary>
+	/// Destructor, stops and joins the worker threads.
+	/// </summary>
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/// <summary>
+	/// Runs task(batch) for every batch # in 0 ... batchCount - 1, and waits for them all.
+	/// </summary>
+	void run(int batchCount, const std::function<void(int)>& task);
+
+	/// <summary>
+	/// Gets the # of worker threads.
+	/// </summary>
+	int getThreadCount() const;
+
+private:
+	/// <summary>
+	/// A worker thread: wait for a run(), take batches until there are none left, repeat.
+	/// </summary>
+	void workerLoop();
+
+	/// <summary>
+	/// Takes and runs batches until there are none left.
+	/// </summary>
+	void runBatches(const std::function<void(int)>& work, int count);
+};
+
+#endif /* WORKERPOOL_H */